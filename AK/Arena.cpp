@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Arena.h>
+#include <AK/Atomic.h>
+#include <AK/NumericLimits.h>
+
+namespace AK {
+
+#ifdef NO_TLS
+static Arena* s_current_arena;
+#else
+static __thread Arena* s_current_arena;
+#endif
+
+// To keep atomics off the allocation path, the reference count of a chunk starts out with a bias
+// that is much larger than the number of allocations that can fit into it. Deallocations subtract
+// from it as they come, and once the arena is done with the chunk, it trades the bias for the
+// number of counted allocations it actually made. Whoever brings the count to zero frees the chunk.
+static constexpr size_t chunk_ref_count_bias = NumericLimits<size_t>::max() / 2;
+
+struct Arena::Chunk {
+    Chunk* next { nullptr };
+    size_t size { 0 };
+    size_t counted_allocations { 0 };
+    Atomic<size_t> ref_count { chunk_ref_count_bias };
+};
+
+// Counted allocations are preceded by a pointer back to their chunk, or by nullptr if they
+// live on the heap. The header is padded to keep the allocation aligned like malloc() would.
+static constexpr size_t counted_allocation_alignment = 2 * sizeof(void*);
+static constexpr size_t counted_allocation_header_size = counted_allocation_alignment;
+
+static constexpr FlatPtr round_up_to_alignment(FlatPtr value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(FlatPtr)(alignment - 1);
+}
+
+Arena::Arena(size_t chunk_size)
+    : m_chunk_size(chunk_size)
+{
+}
+
+Arena::~Arena()
+{
+    ASSERT(s_current_arena != this);
+    for (auto* destructor = m_destructors; destructor; destructor = destructor->next)
+        destructor->destroy(destructor->object);
+    for (auto* chunk = m_chunks; chunk;) {
+        auto* next = chunk->next;
+        unref_chunk(*chunk, chunk_ref_count_bias - chunk->counted_allocations);
+        chunk = next;
+    }
+}
+
+Arena::Scope::Scope(Arena& arena)
+    : m_previous_arena(s_current_arena)
+{
+    s_current_arena = &arena;
+}
+
+Arena::Scope::~Scope()
+{
+    s_current_arena = m_previous_arena;
+}
+
+Arena* Arena::current()
+{
+    return s_current_arena;
+}
+
+size_t Arena::chunk_header_size()
+{
+    return round_up_to_alignment(sizeof(Chunk), counted_allocation_alignment);
+}
+
+Arena::Chunk* Arena::create_chunk(size_t minimum_size)
+{
+    auto size = max(m_chunk_size, chunk_header_size() + minimum_size);
+    void* memory = kmalloc(size);
+    ASSERT(memory);
+    auto* chunk = new (memory) Chunk;
+    chunk->size = size;
+    ++m_allocated_chunk_count;
+    return chunk;
+}
+
+void Arena::allocate_chunk(size_t minimum_size)
+{
+    auto* chunk = create_chunk(minimum_size);
+    chunk->next = m_chunks;
+    m_chunks = chunk;
+    m_used_in_current_chunk = chunk_header_size();
+}
+
+u8* Arena::allocate_in_current_chunk(size_t size, size_t alignment)
+{
+    if (!m_chunks)
+        return nullptr;
+    auto base = reinterpret_cast<FlatPtr>(m_chunks);
+    auto address = round_up_to_alignment(base + m_used_in_current_chunk, alignment);
+    if (address + size > base + m_chunks->size)
+        return nullptr;
+    m_used_in_current_chunk = address + size - base;
+    return reinterpret_cast<u8*>(address);
+}
+
+void* Arena::allocate(size_t size, size_t alignment)
+{
+    ASSERT(alignment && !(alignment & (alignment - 1)));
+    if (auto* slot = allocate_in_current_chunk(size, alignment))
+        return slot;
+
+    if (m_chunks && size > m_chunk_size / 4) {
+        // Give large allocations a chunk of their own behind the current one, so we can keep going in that.
+        auto* chunk = create_chunk(size + alignment);
+        chunk->next = m_chunks->next;
+        m_chunks->next = chunk;
+        return reinterpret_cast<void*>(round_up_to_alignment(reinterpret_cast<FlatPtr>(chunk) + chunk_header_size(), alignment));
+    }
+
+    allocate_chunk(size + alignment);
+    auto* slot = allocate_in_current_chunk(size, alignment);
+    ASSERT(slot);
+    return slot;
+}
+
+void* Arena::allocate_counted(size_t size)
+{
+    auto total_size = counted_allocation_header_size + size;
+    if (total_size > m_chunk_size / 4)
+        return nullptr;
+
+    auto* header = allocate_in_current_chunk(total_size, counted_allocation_alignment);
+    if (!header) {
+        allocate_chunk(total_size);
+        header = allocate_in_current_chunk(total_size, counted_allocation_alignment);
+        ASSERT(header);
+    }
+    *reinterpret_cast<Chunk**>(header) = m_chunks;
+    ++m_chunks->counted_allocations;
+    return header + counted_allocation_header_size;
+}
+
+void Arena::deallocate_counted(void* ptr)
+{
+    auto* header = reinterpret_cast<u8*>(ptr) - counted_allocation_header_size;
+    unref_chunk(**reinterpret_cast<Chunk**>(header), 1);
+}
+
+void Arena::unref_chunk(Chunk& chunk, size_t count)
+{
+    // Counted allocations may be deallocated on any thread, not just the one that made them.
+    if (chunk.ref_count.fetch_sub(count, AK::MemoryOrder::memory_order_acq_rel) != count)
+        return;
+    chunk.~Chunk();
+    kfree(&chunk);
+}
+
+void* ArenaAllocated::operator new(size_t size)
+{
+    if (auto* arena = Arena::current()) {
+        if (auto* slot = arena->allocate_counted(size))
+            return slot;
+    }
+    auto* header = reinterpret_cast<u8*>(kmalloc(counted_allocation_header_size + size));
+    ASSERT(header);
+    *reinterpret_cast<void**>(header) = nullptr;
+    return header + counted_allocation_header_size;
+}
+
+void ArenaAllocated::operator delete(void* ptr)
+{
+    if (!ptr)
+        return;
+    auto* header = reinterpret_cast<u8*>(ptr) - counted_allocation_header_size;
+    if (*reinterpret_cast<void**>(header)) {
+        Arena::deallocate_counted(ptr);
+        return;
+    }
+    kfree(header);
+}
+
+}
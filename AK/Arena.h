@@ -0,0 +1,136 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Noncopyable.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+#include <AK/kmalloc.h>
+
+namespace AK {
+
+// Arena is a bump allocator for workloads that create lots of small objects and then drop
+// them all at once, like parsers. Memory is carved out of chunks that are allocated as needed,
+// and there is no way to give back an individual allocation.
+//
+// There are two ways to put things into an arena:
+//
+// - allocate() and make<T>() hand out memory that lives exactly as long as the arena. Objects
+//   created with make<T>() have their destructors run (in reverse order of creation) when the
+//   arena is destroyed, unless they are trivially destructible. Refer to them with plain
+//   pointers or references, never with OwnPtr or RefPtr.
+//
+// - Classes deriving from ArenaAllocated are placed into the current thread's arena (see Scope)
+//   when created with `new`, and deleted as usual, so they can be held by RefPtr and OwnPtr and
+//   may outlive the arena. Every chunk counts the objects that are still alive in it, and is only
+//   freed once the arena is gone and the last of them has been deleted. Keep in mind that this
+//   means a single long-lived object keeps its whole chunk around.
+class Arena {
+    AK_MAKE_NONCOPYABLE(Arena);
+    AK_MAKE_NONMOVABLE(Arena);
+
+public:
+    static constexpr size_t default_chunk_size = 16 * KiB;
+
+    explicit Arena(size_t chunk_size = default_chunk_size);
+    ~Arena();
+
+    class Scope {
+        AK_MAKE_NONCOPYABLE(Scope);
+        AK_MAKE_NONMOVABLE(Scope);
+
+    public:
+        explicit Scope(Arena&);
+        ~Scope();
+
+    private:
+        Arena* m_previous_arena { nullptr };
+    };
+
+    static Arena* current();
+
+    void* allocate(size_t size, size_t alignment = sizeof(void*));
+
+    template<typename T, typename... Args>
+    T& make(Args&&... args)
+    {
+        if constexpr (is_trivially_destructible<T>()) {
+            return *new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+        } else {
+            auto& destructor = *new (allocate(sizeof(Destructor), alignof(Destructor))) Destructor;
+            auto* object = new (allocate(sizeof(T), alignof(T))) T(forward<Args>(args)...);
+            destructor.object = object;
+            destructor.destroy = [](void* object) { static_cast<T*>(object)->~T(); };
+            destructor.next = m_destructors;
+            m_destructors = &destructor;
+            return *object;
+        }
+    }
+
+    // Memory that may outlive the arena and has to be given back with deallocate_counted().
+    // Returns nullptr for allocations that are too large to be worth putting into a chunk.
+    void* allocate_counted(size_t);
+    static void deallocate_counted(void*);
+
+    size_t allocated_chunk_count() const { return m_allocated_chunk_count; }
+
+private:
+    struct Chunk;
+    struct Destructor {
+        Destructor* next { nullptr };
+        void* object { nullptr };
+        void (*destroy)(void*) { nullptr };
+    };
+
+    static size_t chunk_header_size();
+    Chunk* create_chunk(size_t minimum_size);
+    void allocate_chunk(size_t minimum_size);
+    u8* allocate_in_current_chunk(size_t size, size_t alignment);
+    static void unref_chunk(Chunk&, size_t count);
+
+    size_t m_chunk_size { 0 };
+    Chunk* m_chunks { nullptr };
+    size_t m_used_in_current_chunk { 0 };
+    size_t m_allocated_chunk_count { 0 };
+    Destructor* m_destructors { nullptr };
+};
+
+// Deriving from ArenaAllocated makes `new` put objects of a class into Arena::current() if
+// there is one, and into a heap allocation of their own otherwise. Either kind is destroyed
+// with plain `delete`.
+class ArenaAllocated {
+public:
+    void* operator new(size_t);
+    void* operator new(size_t, void* slot) { return slot; }
+    void operator delete(void*);
+};
+
+}
+
+using AK::Arena;
+using AK::ArenaAllocated;
@@ -136,6 +136,11 @@ static inline void atomic_store(volatile T** var, std::nullptr_t, MemoryOrder or
     __atomic_store_n(const_cast<V**>(var), nullptr, order);
 }
 
+static inline void atomic_thread_fence(MemoryOrder order = memory_order_seq_cst) noexcept
+{
+    __atomic_thread_fence(order);
+}
+
 template<typename T, MemoryOrder DefaultMemoryOrder = AK::MemoryOrder::memory_order_seq_cst>
 class Atomic {
     T m_value { 0 };
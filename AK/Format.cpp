@@ -96,6 +96,21 @@ void vformat_impl(TypeErasedFormatParams& params, FormatBuilder& builder, Format
     vformat_impl(params, builder, parser);
 }
 
+void vformat_compiled(TypeErasedFormatParams& params, FormatBuilder& builder, TypeErasedFormatString fmtstr)
+{
+    const auto fields = fmtstr.fields();
+    const auto view = fmtstr.view();
+
+    for (auto& field : fields) {
+        builder.put_literal(view.substring_view(field.literal_start, field.literal_length));
+
+        auto& parameter = params.parameters()[field.argument_index];
+        parameter.compiled_formatter(params, builder, field.specifier, parameter.value);
+    }
+
+    builder.put_literal(view.substring_view(fields.is_empty() ? 0 : fields[fields.size() - 1].end));
+}
+
 } // namespace AK::{anonymous}
 
 size_t TypeErasedParameter::to_size() const
@@ -223,11 +238,16 @@ void FormatBuilder::put_padding(char fill, size_t amount)
 }
 void FormatBuilder::put_literal(StringView value)
 {
+    // Braces are escaped by doubling them, copy everything in between in one go.
+    size_t start = 0;
     for (size_t i = 0; i < value.length(); ++i) {
-        m_builder.append(value[i]);
-        if (value[i] == '{' || value[i] == '}')
-            ++i;
+        if (value[i] == '{' || value[i] == '}') {
+            m_builder.append(value.characters_without_null_termination() + start, i + 1 - start);
+            start = ++i + 1;
+        }
     }
+    if (start < value.length())
+        m_builder.append(value.characters_without_null_termination() + start, value.length() - start);
 }
 void FormatBuilder::put_string(
     StringView value,
@@ -410,14 +430,19 @@ void FormatBuilder::put_f64(
 }
 #endif
 
-void vformat(StringBuilder& builder, StringView fmtstr, TypeErasedFormatParams params)
+void vformat(StringBuilder& builder, TypeErasedFormatString fmtstr, TypeErasedFormatParams params)
 {
     FormatBuilder fmtbuilder { builder };
-    FormatParser parser { fmtstr };
 
+    if (fmtstr.is_compiled()) {
+        vformat_compiled(params, fmtbuilder, fmtstr);
+        return;
+    }
+
+    FormatParser parser { fmtstr.view() };
     vformat_impl(params, fmtbuilder, parser);
 }
-void vformat(const LogStream& stream, StringView fmtstr, TypeErasedFormatParams params)
+void vformat(const LogStream& stream, TypeErasedFormatString fmtstr, TypeErasedFormatParams params)
 {
     StringBuilder builder;
     vformat(builder, fmtstr, params);
@@ -501,6 +526,25 @@ void StandardFormatter::parse(TypeErasedFormatParams& params, FormatParser& pars
 
     ASSERT(parser.is_eof());
 }
+void StandardFormatter::apply(TypeErasedFormatParams& params, const CompiledFormatSpecifier& specifier)
+{
+    m_fill = specifier.fill;
+    m_align = specifier.align;
+    m_sign_mode = specifier.sign_mode;
+    m_alternative_form = specifier.alternative_form;
+    m_zero_pad = specifier.zero_pad;
+    m_mode = specifier.mode;
+
+    if (specifier.width_argument != CompiledFormatSpecifier::no_argument)
+        m_width = params.parameters().at(specifier.width_argument).to_size();
+    else if (specifier.has_width)
+        m_width = specifier.width;
+
+    if (specifier.precision_argument != CompiledFormatSpecifier::no_argument)
+        m_precision = params.parameters().at(specifier.precision_argument).to_size();
+    else if (specifier.has_precision)
+        m_precision = specifier.precision;
+}
 
 void Formatter<StringView>::format(FormatBuilder& builder, StringView value)
 {
@@ -633,7 +677,7 @@ void Formatter<float>::format(FormatBuilder& builder, float value)
 #endif
 
 #ifndef KERNEL
-void vout(FILE* file, StringView fmtstr, TypeErasedFormatParams params, bool newline)
+void vout(FILE* file, TypeErasedFormatString fmtstr, TypeErasedFormatParams params, bool newline)
 {
     StringBuilder builder;
     vformat(builder, fmtstr, params);
@@ -647,7 +691,7 @@ void vout(FILE* file, StringView fmtstr, TypeErasedFormatParams params, bool new
 }
 #endif
 
-void vdbgln(StringView fmtstr, TypeErasedFormatParams params)
+void vdbgln(TypeErasedFormatString fmtstr, TypeErasedFormatParams params)
 {
     StringBuilder builder;
 
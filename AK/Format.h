@@ -40,6 +40,8 @@ namespace AK {
 class TypeErasedFormatParams;
 class FormatParser;
 class FormatBuilder;
+struct CompiledFormatField;
+struct CompiledFormatSpecifier;
 
 template<typename T, typename = void>
 struct Formatter {
@@ -102,6 +104,7 @@ struct TypeErasedParameter {
     const void* value;
     Type type;
     void (*formatter)(TypeErasedFormatParams&, FormatBuilder&, FormatParser&, const void* value);
+    void (*compiled_formatter)(TypeErasedFormatParams&, FormatBuilder&, const CompiledFormatSpecifier&, const void* value);
 };
 
 class FormatParser : public GenericLexer {
@@ -207,6 +210,31 @@ private:
     size_t m_next_index { 0 };
 };
 
+// A format string as it is handed to vformat(). If it came from a CheckedFormatString, its replacement
+// fields have already been parsed at compile time and are formatted without looking at the specifiers again.
+class TypeErasedFormatString {
+public:
+    TypeErasedFormatString(StringView fmtstr)
+        : m_fmtstr(fmtstr)
+    {
+    }
+    TypeErasedFormatString(StringView fmtstr, Span<const CompiledFormatField> fields)
+        : m_fmtstr(fmtstr)
+        , m_fields(fields)
+        , m_is_compiled(true)
+    {
+    }
+
+    StringView view() const { return m_fmtstr; }
+    Span<const CompiledFormatField> fields() const { return m_fields; }
+    bool is_compiled() const { return m_is_compiled; }
+
+private:
+    StringView m_fmtstr;
+    Span<const CompiledFormatField> m_fields;
+    bool m_is_compiled { false };
+};
+
 template<typename T>
 void __format_value(TypeErasedFormatParams& params, FormatBuilder& builder, FormatParser& parser, const void* value)
 {
@@ -216,13 +244,16 @@ void __format_value(TypeErasedFormatParams& params, FormatBuilder& builder, Form
     formatter.format(builder, *static_cast<const T*>(value));
 }
 
+template<typename T>
+void __format_compiled_value(TypeErasedFormatParams&, FormatBuilder&, const CompiledFormatSpecifier&, const void* value);
+
 template<typename... Parameters>
 class VariadicFormatParams : public TypeErasedFormatParams {
 public:
     static_assert(sizeof...(Parameters) <= max_format_arguments);
 
     explicit VariadicFormatParams(const Parameters&... parameters)
-        : m_data({ TypeErasedParameter { &parameters, TypeErasedParameter::get_type<Parameters>(), __format_value<Parameters> }... })
+        : m_data({ TypeErasedParameter { &parameters, TypeErasedParameter::get_type<Parameters>(), __format_value<Parameters>, __format_compiled_value<Parameters> }... })
     {
         this->set_parameters(m_data);
     }
@@ -262,8 +293,46 @@ struct StandardFormatter {
     Optional<size_t> m_precision;
 
     void parse(TypeErasedFormatParams&, FormatParser&);
+    void apply(TypeErasedFormatParams&, const CompiledFormatSpecifier&);
 };
 
+// The result of parsing the flags of a replacement field at compile time, see CheckedFormatString.
+struct CompiledFormatSpecifier {
+    static constexpr u16 no_argument = 0xffff;
+
+    FormatBuilder::Align align { FormatBuilder::Align::Default };
+    FormatBuilder::SignMode sign_mode { FormatBuilder::SignMode::OnlyIfNeeded };
+    StandardFormatter::Mode mode { StandardFormatter::Mode::Default };
+    char fill { ' ' };
+    bool alternative_form { false };
+    bool zero_pad { false };
+    bool has_width { false };
+    bool has_precision { false };
+    u16 width { 0 };
+    u16 precision { 0 };
+    u16 width_argument { no_argument };
+    u16 precision_argument { no_argument };
+};
+
+struct CompiledFormatField {
+    // The literal text preceding this field, which may still contain escaped braces.
+    u16 literal_start { 0 };
+    u16 literal_length { 0 };
+    // Offset just past the closing brace of this field.
+    u16 end { 0 };
+    u16 argument_index { 0 };
+    CompiledFormatSpecifier specifier;
+};
+
+template<typename T>
+void __format_compiled_value(TypeErasedFormatParams& params, FormatBuilder& builder, const CompiledFormatSpecifier& specifier, const void* value)
+{
+    Formatter<T> formatter;
+
+    formatter.apply(params, specifier);
+    formatter.format(builder, *static_cast<const T*>(value));
+}
+
 template<typename T>
 struct Formatter<T, typename EnableIf<IsIntegral<T>::value>::Type> : StandardFormatter {
     Formatter() { }
@@ -359,43 +428,308 @@ struct Formatter<std::nullptr_t> : Formatter<FlatPtr> {
     }
 };
 
-void vformat(StringBuilder& builder, StringView fmtstr, TypeErasedFormatParams);
-void vformat(const LogStream& stream, StringView fmtstr, TypeErasedFormatParams);
+namespace Detail {
 
-#ifndef KERNEL
-void vout(FILE*, StringView fmtstr, TypeErasedFormatParams, bool newline = false);
+// Not constexpr on purpose: reaching this while compiling a format string in a constant
+// expression fails the compilation, and the message shows up in the diagnostic.
+void compiletime_fail(const char* message);
+
+// Parses a format string and the flags of its replacement fields the same way vformat() and
+// StandardFormatter::parse() do at runtime, but in a constant expression.
+class FormatStringCompiler {
+public:
+    constexpr FormatStringCompiler(const char* characters, size_t length, size_t parameter_count)
+        : m_characters(characters)
+        , m_length(length)
+        , m_end(length)
+        , m_parameter_count(parameter_count)
+    {
+        if (length > CompiledFormatSpecifier::no_argument)
+            compiletime_fail("Format string is too long to be compiled");
+    }
+
+    // Returns the number of replacement fields; only the first 'capacity' of them are stored.
+    constexpr size_t compile(CompiledFormatField* fields, size_t capacity)
+    {
+        size_t field_count = 0;
+        size_t literal_start = 0;
+
+        while (!is_eof()) {
+            if (consume_specific('}')) {
+                if (!consume_specific('}'))
+                    compiletime_fail("Unmatched '}' in format string");
+                continue;
+            }
+            if (!next_is('{')) {
+                ++m_position;
+                continue;
+            }
+            if (peek(1) == '{') {
+                m_position += 2;
+                continue;
+            }
+
+            CompiledFormatField field;
+            field.literal_start = literal_start;
+            field.literal_length = m_position - literal_start;
+            ++m_position;
+
+            field.argument_index = consume_argument_index();
+
+            if (consume_specific(':'))
+                compile_specifier(field.specifier);
+            else if (!consume_specific('}'))
+                compiletime_fail("Expected ':' or '}' after the argument index");
+
+            field.end = m_position;
+            literal_start = m_position;
+
+            if (field_count < capacity)
+                fields[field_count] = field;
+            ++field_count;
+        }
+
+        return field_count;
+    }
+
+private:
+    constexpr bool is_eof() const { return m_position >= m_end; }
+    constexpr char peek(size_t offset = 0) const { return m_position + offset < m_end ? m_characters[m_position + offset] : 0; }
+    constexpr bool next_is(char ch) const { return peek() == ch; }
+
+    constexpr bool consume_specific(char ch)
+    {
+        if (!next_is(ch))
+            return false;
+        ++m_position;
+        return true;
+    }
+
+    constexpr bool consume_number(size_t& value)
+    {
+        value = 0;
+
+        bool consumed_at_least_one = false;
+        while (peek() >= '0' && peek() <= '9') {
+            value = value * 10 + (m_characters[m_position++] - '0');
+            if (value > CompiledFormatSpecifier::no_argument)
+                compiletime_fail("Number in format string is too large");
+            consumed_at_least_one = true;
+        }
+
+        return consumed_at_least_one;
+    }
+
+    constexpr u16 consume_argument_index()
+    {
+        size_t index = 0;
+        if (!consume_number(index))
+            index = m_next_index++;
+
+        if (index >= m_parameter_count)
+            compiletime_fail("Format string refers to an argument that was not passed");
+
+        return index;
+    }
+
+    constexpr u16 consume_replacement_field()
+    {
+        auto index = consume_argument_index();
+        if (!consume_specific('}'))
+            compiletime_fail("Expected '}' after the argument index");
+        return index;
+    }
+
+    constexpr void compile_specifier(CompiledFormatSpecifier& specifier)
+    {
+        const auto begin = m_position;
+
+        size_t level = 1;
+        while (level > 0) {
+            if (is_eof())
+                compiletime_fail("Unterminated replacement field in format string");
+
+            if (consume_specific('{'))
+                ++level;
+            else if (consume_specific('}'))
+                --level;
+            else
+                ++m_position;
+        }
+
+        // Like StandardFormatter::parse(), only look at the flags themselves.
+        const auto field_end = m_position;
+        m_position = begin;
+        m_end = field_end - 1;
+
+        if (peek(1) == '<' || peek(1) == '^' || peek(1) == '>') {
+            if (next_is('{') || next_is('}'))
+                compiletime_fail("Braces can't be used as fill character");
+            specifier.fill = m_characters[m_position++];
+        }
+
+        if (consume_specific('<'))
+            specifier.align = FormatBuilder::Align::Left;
+        else if (consume_specific('^'))
+            specifier.align = FormatBuilder::Align::Center;
+        else if (consume_specific('>'))
+            specifier.align = FormatBuilder::Align::Right;
+
+        if (consume_specific('-'))
+            specifier.sign_mode = FormatBuilder::SignMode::OnlyIfNeeded;
+        else if (consume_specific('+'))
+            specifier.sign_mode = FormatBuilder::SignMode::Always;
+        else if (consume_specific(' '))
+            specifier.sign_mode = FormatBuilder::SignMode::Reserved;
+
+        if (consume_specific('#'))
+            specifier.alternative_form = true;
+
+        if (consume_specific('0'))
+            specifier.zero_pad = true;
+
+        if (size_t width = 0; consume_specific('{')) {
+            specifier.width_argument = consume_replacement_field();
+            specifier.has_width = true;
+        } else if (consume_number(width)) {
+            specifier.width = width;
+            specifier.has_width = true;
+        }
 
+        if (consume_specific('.')) {
+            if (size_t precision = 0; consume_specific('{')) {
+                specifier.precision_argument = consume_replacement_field();
+                specifier.has_precision = true;
+            } else if (consume_number(precision)) {
+                specifier.precision = precision;
+                specifier.has_precision = true;
+            }
+        }
+
+        if (consume_specific('b'))
+            specifier.mode = StandardFormatter::Mode::Binary;
+        else if (consume_specific('B'))
+            specifier.mode = StandardFormatter::Mode::BinaryUppercase;
+        else if (consume_specific('d'))
+            specifier.mode = StandardFormatter::Mode::Decimal;
+        else if (consume_specific('o'))
+            specifier.mode = StandardFormatter::Mode::Octal;
+        else if (consume_specific('x'))
+            specifier.mode = StandardFormatter::Mode::Hexadecimal;
+        else if (consume_specific('X'))
+            specifier.mode = StandardFormatter::Mode::HexadecimalUppercase;
+        else if (consume_specific('c'))
+            specifier.mode = StandardFormatter::Mode::Character;
+        else if (consume_specific('s'))
+            specifier.mode = StandardFormatter::Mode::String;
+        else if (consume_specific('p'))
+            specifier.mode = StandardFormatter::Mode::Pointer;
+        else if (consume_specific('f'))
+            specifier.mode = StandardFormatter::Mode::Float;
+        else if (consume_specific('a'))
+            specifier.mode = StandardFormatter::Mode::Hexfloat;
+        else if (consume_specific('A'))
+            specifier.mode = StandardFormatter::Mode::HexfloatUppercase;
+
+        if (!is_eof())
+            compiletime_fail("Unknown format specifier");
+
+        m_position = field_end;
+        m_end = m_length;
+    }
+
+    const char* m_characters { nullptr };
+    size_t m_length { 0 };
+    size_t m_position { 0 };
+    size_t m_end { 0 };
+    size_t m_parameter_count { 0 };
+    size_t m_next_index { 0 };
+};
+
+}
+
+// A format string literal that is parsed and validated when the program is compiled. Malformed format
+// strings and references to arguments that weren't passed are compile errors, and formatting goes
+// straight to the typed Formatter for each replacement field instead of parsing the string again.
+//
+// Format strings that aren't literals are accepted as well, those are parsed at runtime like before.
 template<typename... Parameters>
-void out(FILE* file, StringView fmtstr, const Parameters&... parameters) { vout(file, fmtstr, VariadicFormatParams { parameters... }); }
+class CheckedFormatString {
+public:
+#ifdef __cpp_consteval
+    template<size_t N>
+    consteval CheckedFormatString(const char (&fmtstr)[N])
+        : m_characters(fmtstr)
+        , m_length(N - 1)
+    {
+        Detail::FormatStringCompiler compiler { m_characters, m_length, sizeof...(Parameters) };
+        auto field_count = compiler.compile(m_fields, field_capacity);
+
+        // Fields that reuse an argument may not fit, those format strings are parsed at runtime.
+        if (field_count <= field_capacity) {
+            m_field_count = field_count;
+            m_is_compiled = true;
+        }
+    }
+#endif
+
+    template<typename T>
+    CheckedFormatString(const T& fmtstr) requires(requires(const T& value) { StringView { value }; })
+    {
+        StringView view { fmtstr };
+        m_characters = view.characters_without_null_termination();
+        m_length = view.length();
+    }
+
+    StringView view() const { return { m_characters, m_length }; }
+    bool is_compiled() const { return m_is_compiled; }
+
+    TypeErasedFormatString type_erased() const
+    {
+        if (m_is_compiled)
+            return { view(), { m_fields, m_field_count } };
+        return { view() };
+    }
+
+private:
+    static constexpr size_t field_capacity = sizeof...(Parameters) ? sizeof...(Parameters) : 1;
+
+    const char* m_characters { nullptr };
+    size_t m_length { 0 };
+    bool m_is_compiled { false };
+    size_t m_field_count { 0 };
+    CompiledFormatField m_fields[field_capacity] {};
+};
+
+void vformat(StringBuilder& builder, TypeErasedFormatString fmtstr, TypeErasedFormatParams);
+void vformat(const LogStream& stream, TypeErasedFormatString fmtstr, TypeErasedFormatParams);
+
+#ifndef KERNEL
+void vout(FILE*, TypeErasedFormatString fmtstr, TypeErasedFormatParams, bool newline = false);
+
 template<typename... Parameters>
-void outln(FILE* file, StringView fmtstr, const Parameters&... parameters) { vout(file, fmtstr, VariadicFormatParams { parameters... }, true); }
+void out(FILE* file, const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { vout(file, fmtstr.type_erased(), VariadicFormatParams { parameters... }); }
 template<typename... Parameters>
-void outln(FILE* file, const char* fmtstr, const Parameters&... parameters) { vout(file, fmtstr, VariadicFormatParams { parameters... }, true); }
+void outln(FILE* file, const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { vout(file, fmtstr.type_erased(), VariadicFormatParams { parameters... }, true); }
 inline void outln(FILE* file) { fputc('\n', file); }
 
 template<typename... Parameters>
-void out(StringView fmtstr, const Parameters&... parameters) { out(stdout, fmtstr, parameters...); }
-template<typename... Parameters>
-void outln(StringView fmtstr, const Parameters&... parameters) { outln(stdout, fmtstr, parameters...); }
+void out(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { out(stdout, fmtstr, parameters...); }
 template<typename... Parameters>
-void outln(const char* fmtstr, const Parameters&... parameters) { outln(stdout, fmtstr, parameters...); }
+void outln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { outln(stdout, fmtstr, parameters...); }
 inline void outln() { outln(stdout); }
 
 template<typename... Parameters>
-void warn(StringView fmtstr, const Parameters&... parameters) { out(stderr, fmtstr, parameters...); }
-template<typename... Parameters>
-void warnln(StringView fmtstr, const Parameters&... parameters) { outln(stderr, fmtstr, parameters...); }
+void warn(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { out(stderr, fmtstr, parameters...); }
 template<typename... Parameters>
-void warnln(const char* fmtstr, const Parameters&... parameters) { outln(stderr, fmtstr, parameters...); }
+void warnln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { outln(stderr, fmtstr, parameters...); }
 inline void warnln() { outln(stderr); }
 #endif
 
-void vdbgln(StringView fmtstr, TypeErasedFormatParams);
+void vdbgln(TypeErasedFormatString fmtstr, TypeErasedFormatParams);
 
 template<typename... Parameters>
-void dbgln(StringView fmtstr, const Parameters&... parameters) { vdbgln(fmtstr, VariadicFormatParams { parameters... }); }
-template<typename... Parameters>
-void dbgln(const char* fmtstr, const Parameters&... parameters) { dbgln(StringView { fmtstr }, parameters...); }
+void dbgln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters) { vdbgln(fmtstr.type_erased(), VariadicFormatParams { parameters... }); }
 
 template<typename T, typename = void>
 struct HasFormatter : TrueType {
@@ -447,4 +781,6 @@ using AK::warnln;
 
 using AK::dbgln;
 
+using AK::CheckedFormatString;
+
 using AK::FormatIfSupported;
@@ -133,14 +133,20 @@ class WeakPtr;
 template<typename T, size_t inline_capacity = 0>
 class Vector;
 
+template<class T>
+struct IdentityType;
+
+template<typename... Parameters>
+class CheckedFormatString;
+
 template<typename... Parameters>
-void dbgln(const char* fmtstr, const Parameters&...);
+void dbgln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>&, const Parameters&...);
 
 template<typename... Parameters>
-void warnln(const char* fmtstr, const Parameters&...);
+void warnln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>&, const Parameters&...);
 
 template<typename... Parameters>
-void outln(const char* fmtstr, const Parameters&...);
+void outln(const CheckedFormatString<typename IdentityType<Parameters>::Type...>&, const Parameters&...);
 
 }
 
@@ -32,6 +32,10 @@
 #include <AK/Types.h>
 #include <AK/kmalloc.h>
 
+#if defined(__SSE2__) && !defined(KERNEL)
+#    include <AK/SIMD.h>
+#endif
+
 namespace AK {
 
 enum class HashSetResult {
@@ -39,52 +43,161 @@ enum class HashSetResult {
     ReplacedExistingEntry
 };
 
-template<typename HashTableType, typename T, typename BucketType>
+namespace Detail {
+
+// HashTable keeps one control byte per slot, next to (but separate from) the slots themselves.
+// A full slot stores the low 7 bits of its hash in the control byte, so a lookup can compare
+// a whole group of control bytes against the tag at once and only look at the slots that match.
+enum class HashTableControl : u8 {
+    Empty = 0x80,
+    Deleted = 0xfe,
+};
+
+// A set of slots within a group, with one bit (or one byte, for SWAR groups) per slot.
+template<size_t GroupWidth, size_t BitsPerSlotShift>
+class HashTableGroupMask {
+public:
+    explicit HashTableGroupMask(u64 bits)
+        : m_bits(bits)
+    {
+    }
+
+    explicit operator bool() const { return m_bits; }
+
+    size_t lowest_slot() const { return __builtin_ctzll(m_bits) >> BitsPerSlotShift; }
+    size_t trailing_empty_slots() const { return lowest_slot(); }
+    size_t leading_empty_slots() const
+    {
+        constexpr size_t unused_bits = 64 - (GroupWidth << BitsPerSlotShift);
+        return (__builtin_clzll(m_bits) - unused_bits) >> BitsPerSlotShift;
+    }
+
+    void clear_lowest_slot() { m_bits &= m_bits - 1; }
+
+private:
+    u64 m_bits { 0 };
+};
+
+#if defined(__SSE2__) && !defined(KERNEL)
+// Compares 16 control bytes at a time.
+class HashTableGroup {
+public:
+    static constexpr size_t width = 16;
+    using Mask = HashTableGroupMask<width, 0>;
+
+    ALWAYS_INLINE explicit HashTableGroup(const u8* control)
+    {
+        __builtin_memcpy(&m_control, control, width);
+    }
+
+    ALWAYS_INLINE Mask match(u8 tag) const { return Mask(move_mask(m_control == (i8)tag)); }
+    ALWAYS_INLINE Mask match_empty() const { return Mask(move_mask(m_control == (i8)HashTableControl::Empty)); }
+    ALWAYS_INLINE Mask match_empty_or_deleted() const { return Mask(move_mask(m_control)); }
+    ALWAYS_INLINE Mask match_full() const { return Mask(move_mask(m_control) ^ 0xffff); }
+
+private:
+    using CharVector = char __attribute__((vector_size(16)));
+
+    ALWAYS_INLINE static u64 move_mask(const SIMD::i8x16& vector)
+    {
+        return (u16)__builtin_ia32_pmovmskb128((CharVector)vector);
+    }
+
+    SIMD::i8x16 m_control;
+};
+#else
+// Compares 8 control bytes at a time, using plain integer arithmetic on a u64.
+// This is what the kernel (built without SSE) and the i686 userland use.
+class HashTableGroup {
+public:
+    static constexpr size_t width = 8;
+    using Mask = HashTableGroupMask<width, 3>;
+
+    ALWAYS_INLINE explicit HashTableGroup(const u8* control)
+    {
+        __builtin_memcpy(&m_control, control, width);
+    }
+
+    // May report false positives, but only in full slots, which the caller compares anyway.
+    ALWAYS_INLINE Mask match(u8 tag) const
+    {
+        auto x = m_control ^ (lsbs * tag);
+        return Mask((x - lsbs) & ~x & msbs);
+    }
+    ALWAYS_INLINE Mask match_empty() const { return Mask(m_control & (~m_control << 6) & msbs); }
+    ALWAYS_INLINE Mask match_empty_or_deleted() const { return Mask(m_control & msbs); }
+    ALWAYS_INLINE Mask match_full() const { return Mask(~m_control & msbs); }
+
+private:
+    static constexpr u64 lsbs = 0x0101010101010101ull;
+    static constexpr u64 msbs = 0x8080808080808080ull;
+
+    u64 m_control { 0 };
+};
+#endif
+
+}
+
+template<typename HashTableType, typename T>
 class HashTableIterator {
     friend HashTableType;
 
 public:
-    bool operator==(const HashTableIterator& other) const { return m_bucket == other.m_bucket; }
-    bool operator!=(const HashTableIterator& other) const { return m_bucket != other.m_bucket; }
-    T& operator*() { return *m_bucket->slot(); }
-    T* operator->() { return m_bucket->slot(); }
-    void operator++() { skip_to_next(); }
+    bool operator==(const HashTableIterator& other) const { return m_control == other.m_control; }
+    bool operator!=(const HashTableIterator& other) const { return m_control != other.m_control; }
+    T& operator*() { return *m_slot; }
+    T* operator->() { return m_slot; }
+    void operator++()
+    {
+        ++m_control;
+        ++m_slot;
+        skip_to_next();
+    }
 
 private:
+    using Group = Detail::HashTableGroup;
+
     void skip_to_next()
     {
-        if (!m_bucket)
+        // Tables are usually well filled, so check the next slot on its own first.
+        if (m_control < m_control_end && !(*m_control & 0x80))
             return;
-        do {
-            ++m_bucket;
-            if (m_bucket->used)
+        while (m_control < m_control_end) {
+            // The control bytes are followed by a copy of the first group, so this never reads out of bounds.
+            auto full = Group(m_control).match_full();
+            if (full) {
+                auto offset = full.lowest_slot();
+                if (m_control + offset >= m_control_end)
+                    break;
+                m_control += offset;
+                m_slot += offset;
                 return;
-        } while (!m_bucket->end);
-        if (m_bucket->end)
-            m_bucket = nullptr;
+            }
+            m_control += Group::width;
+            m_slot += Group::width;
+        }
+        m_slot += m_control_end - m_control;
+        m_control = m_control_end;
     }
 
-    explicit HashTableIterator(BucketType* bucket)
-        : m_bucket(bucket)
+    HashTableIterator(const u8* control, const u8* control_end, T* slot)
+        : m_control(control)
+        , m_control_end(control_end)
+        , m_slot(slot)
     {
     }
 
-    BucketType* m_bucket { nullptr };
+    const u8* m_control { nullptr };
+    const u8* m_control_end { nullptr };
+    T* m_slot { nullptr };
 };
 
 template<typename T, typename TraitsForT>
 class HashTable {
-    static constexpr size_t load_factor_in_percent = 60;
+    using Group = Detail::HashTableGroup;
+    using Control = Detail::HashTableControl;
 
-    struct Bucket {
-        bool used;
-        bool deleted;
-        bool end;
-        alignas(T) u8 storage[sizeof(T)];
-
-        T* slot() { return reinterpret_cast<T*>(storage); }
-        const T* slot() const { return reinterpret_cast<const T*>(storage); }
-    };
+    static constexpr size_t minimum_capacity = 8;
 
 public:
     HashTable() { }
@@ -92,15 +205,15 @@ public:
 
     ~HashTable()
     {
-        if (!m_buckets)
+        if (!m_control)
             return;
 
         for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                m_buckets[i].slot()->~T();
+            if (is_full(m_control[i]))
+                m_slots[i].~T();
         }
 
-        kfree(m_buckets);
+        kfree(m_control);
     }
 
     HashTable(const HashTable& other)
@@ -118,7 +231,8 @@ public:
     }
 
     HashTable(HashTable&& other) noexcept
-        : m_buckets(other.m_buckets)
+        : m_control(other.m_control)
+        , m_slots(other.m_slots)
         , m_size(other.m_size)
         , m_capacity(other.m_capacity)
         , m_deleted_count(other.m_deleted_count)
@@ -126,7 +240,8 @@ public:
         other.m_size = 0;
         other.m_capacity = 0;
         other.m_deleted_count = 0;
-        other.m_buckets = nullptr;
+        other.m_control = nullptr;
+        other.m_slots = nullptr;
     }
 
     HashTable& operator=(HashTable&& other) noexcept
@@ -137,7 +252,8 @@ public:
 
     friend void swap(HashTable& a, HashTable& b) noexcept
     {
-        swap(a.m_buckets, b.m_buckets);
+        swap(a.m_control, b.m_control);
+        swap(a.m_slots, b.m_slots);
         swap(a.m_size, b.m_size);
         swap(a.m_capacity, b.m_capacity);
         swap(a.m_deleted_count, b.m_deleted_count);
@@ -158,7 +274,9 @@ public:
     void ensure_capacity(size_t capacity)
     {
         ASSERT(capacity >= size());
-        rehash(capacity * 2);
+        auto new_capacity = capacity_for_size(capacity);
+        if (new_capacity > m_capacity)
+            rehash(new_capacity);
     }
 
     bool contains(const T& value) const
@@ -166,36 +284,32 @@ public:
         return find(value) != end();
     }
 
-    using Iterator = HashTableIterator<HashTable, T, Bucket>;
+    using Iterator = HashTableIterator<HashTable, T>;
 
     Iterator begin()
     {
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return Iterator(&m_buckets[i]);
-        }
-        return end();
+        Iterator it(m_control, m_control + m_capacity, m_slots);
+        it.skip_to_next();
+        return it;
     }
 
     Iterator end()
     {
-        return Iterator(nullptr);
+        return Iterator(m_control + m_capacity, m_control + m_capacity, m_slots + m_capacity);
     }
 
-    using ConstIterator = HashTableIterator<const HashTable, const T, const Bucket>;
+    using ConstIterator = HashTableIterator<const HashTable, const T>;
 
     ConstIterator begin() const
     {
-        for (size_t i = 0; i < m_capacity; ++i) {
-            if (m_buckets[i].used)
-                return ConstIterator(&m_buckets[i]);
-        }
-        return end();
+        ConstIterator it(m_control, m_control + m_capacity, m_slots);
+        it.skip_to_next();
+        return it;
     }
 
     ConstIterator end() const
     {
-        return ConstIterator(nullptr);
+        return ConstIterator(m_control + m_capacity, m_control + m_capacity, m_slots + m_capacity);
     }
 
     void clear()
@@ -205,18 +319,21 @@ public:
 
     HashSetResult set(T&& value)
     {
-        auto& bucket = lookup_for_writing(value);
-        if (bucket.used) {
-            (*bucket.slot()) = move(value);
+        auto hash = TraitsForT::hash(value);
+        auto index = lookup_with_hash(hash, [&value](auto& entry) { return TraitsForT::equals(entry, value); });
+        if (index != not_found) {
+            m_slots[index] = move(value);
             return HashSetResult::ReplacedExistingEntry;
         }
 
-        new (bucket.slot()) T(move(value));
-        bucket.used = true;
-        if (bucket.deleted) {
-            bucket.deleted = false;
+        if (should_grow())
+            grow();
+
+        index = find_slot_for_writing(hash);
+        if (m_control[index] == (u8)Control::Deleted)
             --m_deleted_count;
-        }
+        set_control(index, tag_for_hash(hash));
+        new (&m_slots[index]) T(move(value));
         ++m_size;
         return HashSetResult::InsertedNewEntry;
     }
@@ -229,7 +346,7 @@ public:
     template<typename Finder>
     Iterator find(unsigned hash, Finder finder)
     {
-        return Iterator(lookup_with_hash(hash, move(finder)));
+        return iterator_at(lookup_with_hash(hash, move(finder)));
     }
 
     Iterator find(const T& value)
@@ -240,7 +357,7 @@ public:
     template<typename Finder>
     ConstIterator find(unsigned hash, Finder finder) const
     {
-        return ConstIterator(lookup_with_hash(hash, move(finder)));
+        return iterator_at(lookup_with_hash(hash, move(finder)));
     }
 
     ConstIterator find(const T& value) const
@@ -260,114 +377,185 @@ public:
 
     void remove(Iterator iterator)
     {
-        ASSERT(iterator.m_bucket);
-        auto& bucket = *iterator.m_bucket;
-        ASSERT(bucket.used);
-        ASSERT(!bucket.end);
-        ASSERT(!bucket.deleted);
-        bucket.slot()->~T();
-        bucket.used = false;
-        bucket.deleted = true;
+        ASSERT(iterator.m_control >= m_control && iterator.m_control < m_control + m_capacity);
+        size_t index = iterator.m_control - m_control;
+        ASSERT(is_full(m_control[index]));
+        m_slots[index].~T();
         --m_size;
-        ++m_deleted_count;
+
+        // If no lookup could ever have probed past this slot, it can simply become empty again.
+        // Otherwise we have to leave a tombstone behind so those probe sequences stay intact.
+        if (was_never_full(index)) {
+            set_control(index, (u8)Control::Empty);
+        } else {
+            set_control(index, (u8)Control::Deleted);
+            ++m_deleted_count;
+        }
     }
 
 private:
-    void insert_during_rehash(T&& value)
+    static constexpr size_t not_found = ~(size_t)0;
+
+    static bool is_full(u8 control) { return !(control & 0x80); }
+    static size_t probe_start_for_hash(unsigned hash) { return hash >> 7; }
+    static u8 tag_for_hash(unsigned hash) { return hash & 0x7f; }
+
+    // Visits every group-sized window of the table exactly once, given a power-of-two capacity.
+    class ProbeSequence {
+    public:
+        ProbeSequence(unsigned hash, size_t capacity)
+            : m_mask(capacity - 1)
+            , m_offset(probe_start_for_hash(hash) & m_mask)
+        {
+        }
+
+        size_t offset() const { return m_offset; }
+        size_t index_for(size_t slot_in_group) const { return (m_offset + slot_in_group) & m_mask; }
+
+        void next()
+        {
+            m_stride += Group::width;
+            m_offset = (m_offset + m_stride) & m_mask;
+        }
+
+    private:
+        size_t m_mask { 0 };
+        size_t m_offset { 0 };
+        size_t m_stride { 0 };
+    };
+
+    static size_t max_load_for_capacity(size_t capacity) { return capacity - capacity / 8; }
+
+    static size_t capacity_for_size(size_t size)
     {
-        auto& bucket = lookup_for_writing(value);
-        new (bucket.slot()) T(move(value));
-        bucket.used = true;
+        size_t capacity = minimum_capacity;
+        while (max_load_for_capacity(capacity) < size)
+            capacity *= 2;
+        return capacity;
     }
 
-    void rehash(size_t new_capacity)
+    static size_t control_size_for_capacity(size_t capacity)
     {
-        new_capacity = max(new_capacity, static_cast<size_t>(4));
-
-        auto* old_buckets = m_buckets;
-        auto old_capacity = m_capacity;
-
-        m_buckets = (Bucket*)kmalloc(sizeof(Bucket) * (new_capacity + 1));
-        __builtin_memset(m_buckets, 0, sizeof(Bucket) * (new_capacity + 1));
-        m_capacity = new_capacity;
-        m_deleted_count = 0;
+        auto size = capacity + Group::width;
+        return (size + alignof(T) - 1) / alignof(T) * alignof(T);
+    }
 
-        m_buckets[m_capacity].end = true;
+    Iterator iterator_at(size_t index)
+    {
+        if (index == not_found)
+            return end();
+        return Iterator(m_control + index, m_control + m_capacity, m_slots + index);
+    }
 
-        if (!old_buckets)
-            return;
+    ConstIterator iterator_at(size_t index) const
+    {
+        if (index == not_found)
+            return end();
+        return ConstIterator(m_control + index, m_control + m_capacity, m_slots + index);
+    }
 
-        for (size_t i = 0; i < old_capacity; ++i) {
-            auto& old_bucket = old_buckets[i];
-            if (old_bucket.used) {
-                insert_during_rehash(move(*old_bucket.slot()));
-                old_bucket.slot()->~T();
-            }
-        }
+    // The first Group::width control bytes are mirrored after the last one,
+    // so that a group can be loaded starting at any slot without wrapping around.
+    void set_control(size_t index, u8 control)
+    {
+        m_control[index] = control;
+        for (size_t mirror = index + m_capacity; mirror < m_capacity + Group::width; mirror += m_capacity)
+            m_control[mirror] = control;
+    }
 
-        kfree(old_buckets);
+    bool was_never_full(size_t index) const
+    {
+        // With small tables, every group covers the whole table, and there is always an empty slot.
+        if (m_capacity <= Group::width)
+            return true;
+        auto index_before = (index - Group::width) & (m_capacity - 1);
+        auto empty_after = Group(m_control + index).match_empty();
+        auto empty_before = Group(m_control + index_before).match_empty();
+        // A group-sized window containing this slot and no empty slots would mean a probe sequence may have passed over it.
+        return empty_before && empty_after
+            && empty_after.trailing_empty_slots() + empty_before.leading_empty_slots() < Group::width;
     }
 
     template<typename Finder>
-    Bucket* lookup_with_hash(unsigned hash, Finder finder, Bucket** usable_bucket_for_writing = nullptr) const
+    size_t lookup_with_hash(unsigned hash, Finder finder) const
     {
         if (is_empty())
-            return nullptr;
-        size_t bucket_index = hash % m_capacity;
+            return not_found;
+        auto tag = tag_for_hash(hash);
+        ProbeSequence sequence(hash, m_capacity);
         for (;;) {
-            auto& bucket = m_buckets[bucket_index];
-
-            if (usable_bucket_for_writing && !*usable_bucket_for_writing && !bucket.used) {
-                *usable_bucket_for_writing = &bucket;
+            Group group(m_control + sequence.offset());
+            for (auto match = group.match(tag); match; match.clear_lowest_slot()) {
+                auto index = sequence.index_for(match.lowest_slot());
+                if (finder(m_slots[index]))
+                    return index;
             }
+            if (group.match_empty())
+                return not_found;
+            sequence.next();
+        }
+    }
 
-            if (bucket.used && finder(*bucket.slot()))
-                return &bucket;
-
-            if (!bucket.used && !bucket.deleted)
-                return nullptr;
-
-            hash = double_hash(hash);
-            bucket_index = hash % m_capacity;
+    size_t find_slot_for_writing(unsigned hash) const
+    {
+        ProbeSequence sequence(hash, m_capacity);
+        for (;;) {
+            auto usable = Group(m_control + sequence.offset()).match_empty_or_deleted();
+            if (usable)
+                return sequence.index_for(usable.lowest_slot());
+            sequence.next();
         }
     }
 
-    const Bucket* lookup_for_reading(const T& value) const
+    bool should_grow() const { return m_size + m_deleted_count + 1 > max_load_for_capacity(m_capacity); }
+
+    void grow()
     {
-        return lookup_with_hash(TraitsForT::hash(value), [&value](auto& entry) { return TraitsForT::equals(entry, value); });
+        // If most of the load is tombstones, rebuilding the table at the same size is enough to get rid of them.
+        if (m_capacity && m_deleted_count >= m_size)
+            rehash(m_capacity);
+        else
+            rehash(m_capacity * 2);
     }
 
-    Bucket& lookup_for_writing(const T& value)
+    void rehash(size_t new_capacity)
     {
-        auto hash = TraitsForT::hash(value);
-        Bucket* usable_bucket_for_writing = nullptr;
-        if (auto* bucket_for_reading = lookup_with_hash(
-                hash,
-                [&value](auto& entry) { return TraitsForT::equals(entry, value); },
-                &usable_bucket_for_writing)) {
-            return *const_cast<Bucket*>(bucket_for_reading);
-        }
+        // Probe sequences rely on the capacity being a power of two.
+        size_t capacity = minimum_capacity;
+        while (capacity < new_capacity)
+            capacity *= 2;
+        new_capacity = capacity;
+
+        auto* old_control = m_control;
+        auto* old_slots = m_slots;
+        auto old_capacity = m_capacity;
 
-        if (should_grow())
-            rehash(capacity() * 2);
-        else if (usable_bucket_for_writing)
-            return *usable_bucket_for_writing;
+        auto control_size = control_size_for_capacity(new_capacity);
+        m_control = (u8*)kmalloc(control_size + sizeof(T) * new_capacity);
+        __builtin_memset(m_control, (u8)Control::Empty, control_size);
+        m_slots = reinterpret_cast<T*>(m_control + control_size);
+        m_capacity = new_capacity;
+        m_deleted_count = 0;
 
-        size_t bucket_index = hash % m_capacity;
+        if (!old_control)
+            return;
 
-        for (;;) {
-            auto& bucket = m_buckets[bucket_index];
-            if (!bucket.used)
-                return bucket;
-            hash = double_hash(hash);
-            bucket_index = hash % m_capacity;
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!is_full(old_control[i]))
+                continue;
+            auto& old_slot = old_slots[i];
+            auto hash = TraitsForT::hash(old_slot);
+            auto index = find_slot_for_writing(hash);
+            set_control(index, tag_for_hash(hash));
+            new (&m_slots[index]) T(move(old_slot));
+            old_slot.~T();
         }
-    }
 
-    size_t used_bucket_count() const { return m_size + m_deleted_count; }
-    bool should_grow() const { return ((used_bucket_count() + 1) * 100) >= (m_capacity * load_factor_in_percent); }
+        kfree(old_control);
+    }
 
-    Bucket* m_buckets { nullptr };
+    u8* m_control { nullptr };
+    T* m_slots { nullptr };
     size_t m_size { 0 };
     size_t m_capacity { 0 };
     size_t m_deleted_count { 0 };
@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// Safe memory reclamation for lock-free data structures. A thread that is about
+// to dereference a shared pointer publishes it in a HazardPointer first; an
+// object that has been unlinked is handed to retire(), and is only deleted once
+// no hazard pointer refers to it any more. A domain has a fixed number of hazard
+// pointer slots and allocates nothing but the retired list entries, so it works
+// the same in the kernel and in userland.
+class HazardPointerDomain {
+    AK_MAKE_NONCOPYABLE(HazardPointerDomain);
+    AK_MAKE_NONMOVABLE(HazardPointerDomain);
+
+public:
+    // The number of HazardPointers that may exist at the same time.
+    static constexpr size_t max_hazard_pointers = 64;
+
+    HazardPointerDomain() { }
+
+    ~HazardPointerDomain()
+    {
+        auto* retired = m_retired.exchange(nullptr, AK::memory_order_acquire);
+        while (retired) {
+            auto* next = retired->next;
+            retired->deleter(retired->pointer);
+            delete retired;
+            retired = next;
+        }
+    }
+
+    template<typename T>
+    void retire(T* pointer)
+    {
+        retire(pointer, [](void* pointer) { delete static_cast<T*>(pointer); });
+    }
+
+    void retire(void* pointer, void (*deleter)(void*))
+    {
+        auto* retired = new Retired { pointer, deleter, nullptr };
+        push_retired(retired, retired);
+        if (m_retired_count.fetch_add(1, AK::memory_order_relaxed) + 1 >= reclaim_threshold)
+            reclaim();
+    }
+
+    // Deletes every retired object that isn't protected right now.
+    void reclaim()
+    {
+        auto* retired = m_retired.exchange(nullptr, AK::memory_order_acquire);
+        if (!retired)
+            return;
+
+        // Pairs with the store in HazardPointer::protect(): a reader either sees that its
+        // pointer was unlinked and retries, or we see its hazard here.
+        AK::atomic_thread_fence(AK::memory_order_seq_cst);
+        void* hazards[max_hazard_pointers];
+        size_t hazard_count = 0;
+        for (auto& hazard : m_hazards) {
+            if (auto* pointer = hazard.load(AK::memory_order_acquire))
+                hazards[hazard_count++] = pointer;
+        }
+
+        Retired* kept_first = nullptr;
+        Retired* kept_last = nullptr;
+        size_t freed = 0;
+        while (retired) {
+            auto* next = retired->next;
+            bool is_protected = false;
+            for (size_t i = 0; i < hazard_count && !is_protected; ++i)
+                is_protected = hazards[i] == retired->pointer;
+            if (is_protected) {
+                retired->next = kept_first;
+                kept_first = retired;
+                if (!kept_last)
+                    kept_last = retired;
+            } else {
+                retired->deleter(retired->pointer);
+                delete retired;
+                ++freed;
+            }
+            retired = next;
+        }
+
+        m_retired_count.fetch_sub(freed, AK::memory_order_relaxed);
+        if (kept_first)
+            push_retired(kept_first, kept_last);
+    }
+
+private:
+    friend class HazardPointer;
+
+    static constexpr size_t reclaim_threshold = 2 * max_hazard_pointers;
+
+    struct Retired {
+        void* pointer;
+        void (*deleter)(void*);
+        Retired* next;
+    };
+
+    void push_retired(Retired* first, Retired* last)
+    {
+        auto* head = m_retired.load(AK::memory_order_relaxed);
+        do {
+            last->next = head;
+        } while (!m_retired.compare_exchange_strong(head, first, AK::memory_order_release));
+    }
+
+    size_t acquire_slot()
+    {
+        for (size_t i = 0; i < max_hazard_pointers; ++i) {
+            bool expected = false;
+            if (m_slot_in_use[i].compare_exchange_strong(expected, true, AK::memory_order_acquire))
+                return i;
+        }
+        // More simultaneous HazardPointers than the domain has room for.
+        ASSERT_NOT_REACHED();
+    }
+
+    void release_slot(size_t slot)
+    {
+        m_hazards[slot].store(nullptr, AK::memory_order_release);
+        m_slot_in_use[slot].store(false, AK::memory_order_release);
+    }
+
+    Atomic<void*> m_hazards[max_hazard_pointers];
+    Atomic<bool> m_slot_in_use[max_hazard_pointers];
+    Atomic<Retired*> m_retired { nullptr };
+    Atomic<size_t> m_retired_count { 0 };
+};
+
+class HazardPointer {
+    AK_MAKE_NONCOPYABLE(HazardPointer);
+    AK_MAKE_NONMOVABLE(HazardPointer);
+
+public:
+    explicit HazardPointer(HazardPointerDomain& domain)
+        : m_domain(domain)
+        , m_slot(domain.acquire_slot())
+    {
+    }
+
+    ~HazardPointer()
+    {
+        m_domain.release_slot(m_slot);
+    }
+
+    // Loads `source` and keeps the object it points to from being deleted until
+    // reset() or until the next protect(). The pointer is published and then
+    // read again, so that it can't have been retired in between unnoticed.
+    template<typename T>
+    T* protect(const Atomic<T*>& source)
+    {
+        T* pointer = source.load(AK::memory_order_relaxed);
+        for (;;) {
+            m_domain.m_hazards[m_slot].store(pointer, AK::memory_order_seq_cst);
+            T* reloaded = source.load(AK::memory_order_seq_cst);
+            if (reloaded == pointer)
+                return pointer;
+            pointer = reloaded;
+        }
+    }
+
+    void reset()
+    {
+        m_domain.m_hazards[m_slot].store(nullptr, AK::memory_order_release);
+    }
+
+private:
+    HazardPointerDomain& m_domain;
+    size_t m_slot;
+};
+
+}
+
+using AK::HazardPointer;
+using AK::HazardPointerDomain;
@@ -30,6 +30,10 @@
 #include <AK/Memory.h>
 #include <ctype.h>
 
+#ifndef KERNEL
+#    include <AK/StringImplArena.h>
+#endif
+
 namespace AK {
 
 String JsonParser::consume_and_unescape_string()
@@ -170,34 +174,17 @@ Optional<JsonValue> JsonParser::parse_string()
     return JsonValue(result);
 }
 
-Optional<JsonValue> JsonParser::parse_number()
+Optional<JsonValue> JsonParser::number_from_string(const StringView& string)
 {
-    JsonValue value;
-    Vector<char, 128> number_buffer;
-    Vector<char, 128> fraction_buffer;
-
+    StringView number_string = string;
+    StringView fraction_string;
     bool is_double = false;
-    for (;;) {
-        char ch = peek();
-        if (ch == '.') {
-            is_double = true;
-            ++m_index;
-            continue;
-        }
-        if (ch == '-' || (ch >= '0' && ch <= '9')) {
-            if (is_double)
-                fraction_buffer.append(ch);
-            else
-                number_buffer.append(ch);
-            ++m_index;
-            continue;
-        }
-        break;
+    if (auto dot_index = string.find_first_of('.'); dot_index.has_value()) {
+        is_double = true;
+        number_string = string.substring_view(0, dot_index.value());
+        fraction_string = string.substring_view(dot_index.value() + 1);
     }
 
-    StringView number_string(number_buffer.data(), number_buffer.size());
-    StringView fraction_string(fraction_buffer.data(), fraction_buffer.size());
-
 #ifndef KERNEL
     if (is_double) {
         // FIXME: This logic looks shaky.
@@ -219,30 +206,38 @@ Optional<JsonValue> JsonParser::parse_number()
         fraction *= (whole < 0) ? -1 : 1;
 
         auto divider = 1;
-        for (size_t i = 0; i < fraction_buffer.size(); ++i) {
+        for (size_t i = 0; i < fraction_string.length(); ++i) {
             divider *= 10;
         }
-        value = JsonValue((double)whole + ((double)fraction / divider));
-    } else {
-#endif
-        auto to_unsigned_result = number_string.to_uint();
-        if (to_unsigned_result.has_value()) {
-            value = JsonValue(to_unsigned_result.value());
-        } else {
-            auto number = number_string.to_int<i64>();
-            if (!number.has_value())
-                return {};
-            if (number.value() <= AK::NumericLimits<i32>::max()) {
-                value = JsonValue((i32)number.value());
-            } else {
-                value = JsonValue(number.value());
-            }
-        }
-#ifndef KERNEL
+        return JsonValue((double)whole + ((double)fraction / divider));
     }
+#else
+    (void)is_double;
 #endif
 
-    return value;
+    auto to_unsigned_result = number_string.to_uint();
+    if (to_unsigned_result.has_value())
+        return JsonValue(to_unsigned_result.value());
+    auto number = number_string.to_int<i64>();
+    if (!number.has_value())
+        return {};
+    if (number.value() <= AK::NumericLimits<i32>::max())
+        return JsonValue((i32)number.value());
+    return JsonValue(number.value());
+}
+
+Optional<JsonValue> JsonParser::parse_number()
+{
+    size_t start = m_index;
+    for (;;) {
+        char ch = peek();
+        if (ch == '.' || ch == '-' || (ch >= '0' && ch <= '9')) {
+            ++m_index;
+            continue;
+        }
+        break;
+    }
+    return number_from_string(m_input.substring_view(start, m_index - start));
 }
 
 Optional<JsonValue> JsonParser::parse_true()
@@ -301,6 +296,21 @@ Optional<JsonValue> JsonParser::parse_helper()
 }
 
 Optional<JsonValue> JsonParser::parse()
+{
+#ifndef KERNEL
+    // Most of the strings in a large JSON document are keys and short values that go away together
+    // with it. Small documents don't produce enough strings to be worth a whole arena chunk, and
+    // any of their strings that are kept around would pin that chunk.
+    if (m_input.length() >= minimum_input_length_for_string_arena) {
+        StringImplArena arena;
+        StringImplArena::Scope arena_scope(arena);
+        return parse_document();
+    }
+#endif
+    return parse_document();
+}
+
+Optional<JsonValue> JsonParser::parse_document()
 {
     auto result = parse_helper();
     if (!result.has_value())
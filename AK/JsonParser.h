@@ -40,7 +40,14 @@ public:
 
     Optional<JsonValue> parse();
 
+    // Converts the text of a JSON number into a JsonValue, the same way parse() does.
+    static Optional<JsonValue> number_from_string(const StringView&);
+
 private:
+    // Documents at least this large have their strings allocated from a StringImplArena.
+    static constexpr size_t minimum_input_length_for_string_arena = 64 * KiB;
+
+    Optional<JsonValue> parse_document();
     Optional<JsonValue> parse_helper();
 
     String consume_and_unescape_string();
@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/JsonStreamParser.h>
+#include <AK/StringUtils.h>
+
+namespace AK {
+
+static bool is_json_whitespace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+JsonStreamParser::JsonStreamParser(InputStream& stream)
+    : m_stream(stream)
+{
+}
+
+bool JsonStreamParser::fill_buffer()
+{
+    if (m_buffer_position < m_buffer_size)
+        return true;
+    m_buffer_position = 0;
+    m_buffer_size = m_stream.read({ m_buffer, sizeof(m_buffer) });
+    return m_buffer_size;
+}
+
+bool JsonStreamParser::at_end()
+{
+    return !fill_buffer();
+}
+
+char JsonStreamParser::peek()
+{
+    if (!fill_buffer())
+        return 0;
+    return m_buffer[m_buffer_position];
+}
+
+bool JsonStreamParser::skip_whitespace()
+{
+    while (fill_buffer()) {
+        while (m_buffer_position < m_buffer_size) {
+            if (!is_json_whitespace(m_buffer[m_buffer_position]))
+                return true;
+            ++m_buffer_position;
+        }
+    }
+    return false;
+}
+
+bool JsonStreamParser::consume_literal(const char* literal)
+{
+    for (; *literal; ++literal) {
+        if (peek() != *literal)
+            return false;
+        ++m_buffer_position;
+    }
+    return true;
+}
+
+bool JsonStreamParser::read_string(StringView& text)
+{
+    ASSERT(peek() == '"');
+    ++m_buffer_position;
+    m_text_builder.clear();
+    bool using_builder = false;
+
+    for (;;) {
+        if (!fill_buffer())
+            return false;
+        auto* start = reinterpret_cast<const char*>(m_buffer + m_buffer_position);
+        size_t available = m_buffer_size - m_buffer_position;
+        size_t length = 0;
+        while (length < available && start[length] != '"' && start[length] != '\\')
+            ++length;
+
+        if (length == available) {
+            // The string continues past what we've read so far.
+            m_text_builder.append(start, length);
+            using_builder = true;
+            m_buffer_position = m_buffer_size;
+            continue;
+        }
+
+        m_buffer_position += length + 1;
+        if (start[length] == '"') {
+            if (!using_builder) {
+                // The common case: no escapes, and all of it is in the buffer already.
+                text = { start, length };
+                return true;
+            }
+            m_text_builder.append(start, length);
+            text = m_text_builder.string_view();
+            return true;
+        }
+
+        m_text_builder.append(start, length);
+        using_builder = true;
+        char escaped_ch = peek();
+        if (!escaped_ch)
+            return false;
+        ++m_buffer_position;
+        switch (escaped_ch) {
+        case 'n':
+            m_text_builder.append('\n');
+            break;
+        case 'r':
+            m_text_builder.append('\r');
+            break;
+        case 't':
+            m_text_builder.append('\t');
+            break;
+        case 'b':
+            m_text_builder.append('\b');
+            break;
+        case 'f':
+            m_text_builder.append('\f');
+            break;
+        case 'u': {
+            char hex[4];
+            for (auto& ch : hex) {
+                ch = peek();
+                if (!ch)
+                    return false;
+                ++m_buffer_position;
+            }
+            auto code_point = AK::StringUtils::convert_to_uint_from_hex(StringView(hex, sizeof(hex)));
+            if (code_point.has_value())
+                m_text_builder.append_code_point(code_point.value());
+            else
+                m_text_builder.append('?');
+        } break;
+        default:
+            m_text_builder.append(escaped_ch);
+            break;
+        }
+    }
+}
+
+bool JsonStreamParser::read_number(StringView& text)
+{
+    m_text_builder.clear();
+    for (;;) {
+        char ch = peek();
+        if (ch != '.' && ch != '-' && !(ch >= '0' && ch <= '9'))
+            break;
+        m_text_builder.append(ch);
+        ++m_buffer_position;
+    }
+    text = m_text_builder.string_view();
+    return !text.is_empty();
+}
+
+JsonStreamParser::Token JsonStreamParser::error()
+{
+    m_state = State::Done;
+    m_buffer_position = m_buffer_size;
+    m_nesting.clear();
+    return { TokenType::Error, {} };
+}
+
+JsonStreamParser::Token JsonStreamParser::finish_value(TokenType type, StringView text)
+{
+    m_state = m_nesting.is_empty() ? State::Done : State::ExpectingCommaOrEnd;
+    return { type, text };
+}
+
+JsonStreamParser::Token JsonStreamParser::end_container(char opening_ch)
+{
+    if (m_nesting.is_empty() || m_nesting.last() != opening_ch)
+        return error();
+    ++m_buffer_position;
+    m_nesting.take_last();
+    return finish_value(opening_ch == '{' ? TokenType::EndObject : TokenType::EndArray);
+}
+
+JsonStreamParser::Token JsonStreamParser::read_value()
+{
+    StringView text;
+    switch (peek()) {
+    case '{':
+        ++m_buffer_position;
+        m_nesting.append('{');
+        m_state = State::ExpectingKeyOrEndOfObject;
+        return { TokenType::StartObject, {} };
+    case '[':
+        ++m_buffer_position;
+        m_nesting.append('[');
+        m_state = State::ExpectingValueOrEndOfArray;
+        return { TokenType::StartArray, {} };
+    case '"':
+        if (!read_string(text))
+            return error();
+        return finish_value(TokenType::String, text);
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+        if (!read_number(text))
+            return error();
+        return finish_value(TokenType::Number, text);
+    case 't':
+        if (!consume_literal("true"))
+            return error();
+        return finish_value(TokenType::True);
+    case 'f':
+        if (!consume_literal("false"))
+            return error();
+        return finish_value(TokenType::False);
+    case 'n':
+        if (!consume_literal("null"))
+            return error();
+        return finish_value(TokenType::Null);
+    default:
+        return error();
+    }
+}
+
+JsonStreamParser::Token JsonStreamParser::read_key()
+{
+    StringView text;
+    if (peek() != '"' || !read_string(text))
+        return error();
+
+    // Looking for the ':' may need another read from the stream, which would overwrite a key
+    // that still points into the buffer.
+    while (m_buffer_position < m_buffer_size && is_json_whitespace(m_buffer[m_buffer_position]))
+        ++m_buffer_position;
+    bool text_is_in_buffer = text.characters_without_null_termination() >= reinterpret_cast<const char*>(m_buffer)
+        && text.characters_without_null_termination() < reinterpret_cast<const char*>(m_buffer + sizeof(m_buffer));
+    if (m_buffer_position == m_buffer_size && text_is_in_buffer) {
+        m_text_builder.clear();
+        m_text_builder.append(text);
+        text = m_text_builder.string_view();
+    }
+
+    if (!skip_whitespace() || peek() != ':')
+        return error();
+    ++m_buffer_position;
+    m_state = State::ExpectingValue;
+    return { TokenType::Key, text };
+}
+
+JsonStreamParser::Token JsonStreamParser::next()
+{
+    for (;;) {
+        bool has_more = skip_whitespace();
+        if (m_state == State::Done) {
+            if (has_more)
+                return error();
+            return { TokenType::EndOfDocument, {} };
+        }
+        if (!has_more)
+            return error();
+
+        switch (m_state) {
+        case State::ExpectingValue:
+            return read_value();
+        case State::ExpectingValueOrEndOfArray:
+            if (peek() == ']')
+                return end_container('[');
+            return read_value();
+        case State::ExpectingKey:
+            return read_key();
+        case State::ExpectingKeyOrEndOfObject:
+            if (peek() == '}')
+                return end_container('{');
+            return read_key();
+        case State::ExpectingCommaOrEnd:
+            switch (peek()) {
+            case '}':
+                return end_container('{');
+            case ']':
+                return end_container('[');
+            case ',':
+                ++m_buffer_position;
+                m_state = m_nesting.last() == '{' ? State::ExpectingKey : State::ExpectingValue;
+                continue;
+            default:
+                return error();
+            }
+        case State::Done:
+            ASSERT_NOT_REACHED();
+        }
+    }
+}
+
+bool JsonStreamParser::skip_value(const Token& first_token)
+{
+    if (first_token.type != TokenType::StartObject && first_token.type != TokenType::StartArray)
+        return first_token.type != TokenType::Error && first_token.type != TokenType::EndOfDocument;
+
+    auto target_depth = depth() - 1;
+    while (depth() > target_depth) {
+        auto token = next();
+        if (token.type == TokenType::Error || token.type == TokenType::EndOfDocument)
+            return false;
+    }
+    return true;
+}
+
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/JsonParser.h>
+#include <AK/Stream.h>
+#include <AK/StringBuilder.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+// JsonStreamParser reads a JSON document from an InputStream piece by piece and hands it
+// out as a sequence of tokens, without ever building a JsonValue tree. It only keeps a small
+// read buffer and the current nesting around, so it works for documents of any size.
+//
+//     JsonStreamParser parser(stream);
+//     for (;;) {
+//         auto token = parser.next();
+//         if (token.type == JsonStreamParser::TokenType::EndOfDocument)
+//             break;
+//         if (token.type == JsonStreamParser::TokenType::Error)
+//             return false;
+//         ...
+//     }
+//
+// Object members come out as a Key token followed by the tokens of their value.
+class JsonStreamParser {
+public:
+    enum class TokenType {
+        StartObject,
+        EndObject,
+        StartArray,
+        EndArray,
+        Key,
+        String,
+        Number,
+        True,
+        False,
+        Null,
+        EndOfDocument,
+        Error,
+    };
+
+    struct Token {
+        TokenType type { TokenType::Error };
+
+        // The unescaped characters of a Key or String, or the text of a Number.
+        // This is only valid until the next call to next().
+        StringView text;
+
+        Optional<JsonValue> number() const { return JsonParser::number_from_string(text); }
+    };
+
+    explicit JsonStreamParser(InputStream&);
+
+    Token next();
+
+    // Skips the rest of the value whose first token was just returned by next().
+    // This lets callers ignore the parts of a document that they're not interested in.
+    bool skip_value(const Token& first_token);
+
+    size_t depth() const { return m_nesting.size(); }
+
+private:
+    enum class State {
+        ExpectingValue,
+        ExpectingValueOrEndOfArray,
+        ExpectingKey,
+        ExpectingKeyOrEndOfObject,
+        ExpectingCommaOrEnd,
+        Done,
+    };
+
+    bool fill_buffer();
+    bool at_end();
+    char peek();
+    bool skip_whitespace();
+    bool consume_literal(const char*);
+
+    Token read_value();
+    Token read_key();
+    bool read_string(StringView&);
+    bool read_number(StringView&);
+    Token finish_value(TokenType, StringView = {});
+    Token end_container(char);
+    Token error();
+
+    InputStream& m_stream;
+    u8 m_buffer[4096];
+    size_t m_buffer_position { 0 };
+    size_t m_buffer_size { 0 };
+
+    // Used for strings that contain escapes or span multiple reads from the stream.
+    StringBuilder m_text_builder;
+
+    Vector<char, 32> m_nesting;
+    State m_state { State::ExpectingValue };
+};
+
+}
+
+using AK::JsonStreamParser;
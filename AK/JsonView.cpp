@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonParser.h>
+#include <AK/JsonView.h>
+#include <AK/StringBuilder.h>
+#include <AK/StringUtils.h>
+
+namespace AK {
+
+static bool is_json_whitespace(char ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+class JsonDocumentView::Parser {
+public:
+    Parser(const StringView& source, Vector<Node>& nodes)
+        : m_source(source)
+        , m_nodes(nodes)
+    {
+    }
+
+    bool parse()
+    {
+        if (!parse_value())
+            return false;
+        skip_whitespace();
+        return m_index == m_source.length();
+    }
+
+private:
+    char peek() const { return m_index < m_source.length() ? m_source[m_index] : 0; }
+
+    void skip_whitespace()
+    {
+        while (m_index < m_source.length() && is_json_whitespace(m_source[m_index]))
+            ++m_index;
+    }
+
+    bool consume_specific(char ch)
+    {
+        if (peek() != ch)
+            return false;
+        ++m_index;
+        return true;
+    }
+
+    bool consume_literal(const StringView& literal)
+    {
+        if (!m_source.substring_view(m_index).starts_with(literal))
+            return false;
+        m_index += literal.length();
+        return true;
+    }
+
+    u32 add_node(JsonValueView::Type type, size_t start)
+    {
+        m_nodes.append({ type, false, 0, 0, m_source.substring_view(start, 0) });
+        return m_nodes.size() - 1;
+    }
+
+    void finish_node(u32 node_index, size_t start)
+    {
+        auto& node = m_nodes[node_index];
+        node.subtree_end = m_nodes.size();
+        node.text = m_source.substring_view(start, m_index - start);
+    }
+
+    bool parse_string()
+    {
+        if (!consume_specific('"'))
+            return false;
+        size_t start = m_index;
+        bool needs_unescaping = false;
+        for (;;) {
+            if (m_index >= m_source.length())
+                return false;
+            char ch = m_source[m_index];
+            if (ch == '"')
+                break;
+            if (ch == '\\') {
+                needs_unescaping = true;
+                ++m_index;
+            }
+            ++m_index;
+        }
+        auto node_index = add_node(JsonValueView::Type::String, start);
+        finish_node(node_index, start);
+        m_nodes[node_index].needs_unescaping = needs_unescaping;
+        ++m_index;
+        return true;
+    }
+
+    bool parse_object()
+    {
+        size_t start = m_index;
+        auto node_index = add_node(JsonValueView::Type::Object, start);
+        ++m_index;
+        u32 size = 0;
+        for (;;) {
+            skip_whitespace();
+            if (peek() == '}')
+                break;
+            if (!parse_string())
+                return false;
+            skip_whitespace();
+            if (!consume_specific(':'))
+                return false;
+            if (!parse_value())
+                return false;
+            ++size;
+            skip_whitespace();
+            if (peek() == '}')
+                break;
+            if (!consume_specific(','))
+                return false;
+            skip_whitespace();
+            if (peek() == '}')
+                return false;
+        }
+        ++m_index;
+        finish_node(node_index, start);
+        m_nodes[node_index].size = size;
+        return true;
+    }
+
+    bool parse_array()
+    {
+        size_t start = m_index;
+        auto node_index = add_node(JsonValueView::Type::Array, start);
+        ++m_index;
+        u32 size = 0;
+        for (;;) {
+            skip_whitespace();
+            if (peek() == ']')
+                break;
+            if (!parse_value())
+                return false;
+            ++size;
+            skip_whitespace();
+            if (peek() == ']')
+                break;
+            if (!consume_specific(','))
+                return false;
+            skip_whitespace();
+            if (peek() == ']')
+                return false;
+        }
+        ++m_index;
+        finish_node(node_index, start);
+        m_nodes[node_index].size = size;
+        return true;
+    }
+
+    bool parse_number()
+    {
+        size_t start = m_index;
+        while (m_index < m_source.length()) {
+            char ch = m_source[m_index];
+            if (ch != '.' && ch != '-' && !(ch >= '0' && ch <= '9'))
+                break;
+            ++m_index;
+        }
+        finish_node(add_node(JsonValueView::Type::Number, start), start);
+        return true;
+    }
+
+    bool parse_literal(JsonValueView::Type type, const StringView& literal)
+    {
+        size_t start = m_index;
+        if (!consume_literal(literal))
+            return false;
+        finish_node(add_node(type, start), start);
+        return true;
+    }
+
+    bool parse_value()
+    {
+        skip_whitespace();
+        switch (peek()) {
+        case '{':
+            return parse_object();
+        case '[':
+            return parse_array();
+        case '"':
+            return parse_string();
+        case '-':
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return parse_number();
+        case 't':
+            return parse_literal(JsonValueView::Type::Bool, "true");
+        case 'f':
+            return parse_literal(JsonValueView::Type::Bool, "false");
+        case 'n':
+            return parse_literal(JsonValueView::Type::Null, "null");
+        default:
+            return false;
+        }
+    }
+
+    StringView m_source;
+    size_t m_index { 0 };
+    Vector<Node>& m_nodes;
+};
+
+Optional<JsonDocumentView> JsonDocumentView::parse(const StringView& source)
+{
+    JsonDocumentView document;
+    // Typical JSON has a node every dozen or so bytes, so this saves a few rounds of growing.
+    document.m_nodes.ensure_capacity(source.length() / 16 + 1);
+    Parser parser(source, document.m_nodes);
+    if (!parser.parse())
+        return {};
+    return document;
+}
+
+static String unescape_json_string(const StringView& raw)
+{
+    StringBuilder builder(raw.length());
+    for (size_t i = 0; i < raw.length(); ++i) {
+        char ch = raw[i];
+        if (ch != '\\' || i + 1 == raw.length()) {
+            builder.append(ch);
+            continue;
+        }
+        char escaped_ch = raw[++i];
+        switch (escaped_ch) {
+        case 'n':
+            builder.append('\n');
+            break;
+        case 'r':
+            builder.append('\r');
+            break;
+        case 't':
+            builder.append('\t');
+            break;
+        case 'b':
+            builder.append('\b');
+            break;
+        case 'f':
+            builder.append('\f');
+            break;
+        case 'u': {
+            auto code_point = AK::StringUtils::convert_to_uint_from_hex(raw.substring_view(i + 1, min<size_t>(4, raw.length() - i - 1)));
+            if (code_point.has_value())
+                builder.append_code_point(code_point.value());
+            else
+                builder.append('?');
+            i += 4;
+        } break;
+        default:
+            builder.append(escaped_ch);
+            break;
+        }
+    }
+    return builder.to_string();
+}
+
+String JsonValueView::as_string() const
+{
+    ASSERT(is_string());
+    if (string_needs_unescaping())
+        return unescape_json_string(source_text());
+    return source_text();
+}
+
+String JsonValueView::to_string() const
+{
+    if (is_string())
+        return as_string();
+    return source_text();
+}
+
+Optional<JsonValue> JsonValueView::number() const
+{
+    if (!is_number())
+        return {};
+    return JsonParser::number_from_string(source_text());
+}
+
+JsonValueView JsonValueView::at(size_t index) const
+{
+    ASSERT(is_array());
+    ASSERT(index < size());
+    u32 node_index = m_index + 1;
+    for (size_t i = 0; i < index; ++i)
+        node_index = subtree_end_of(node_index);
+    return JsonValueView(*m_document, node_index);
+}
+
+u32 JsonValueView::get_index(const StringView& key) const
+{
+    if (!is_object())
+        return 0;
+    for (u32 index = m_index + 1; index < subtree_end(); index = subtree_end_of(index + 1)) {
+        JsonValueView member_key(*m_document, index);
+        if (member_key.string_needs_unescaping() ? member_key.as_string() == key : member_key.source_text() == key)
+            return index + 1;
+    }
+    return 0;
+}
+
+JsonValueView JsonValueView::get(const StringView& key) const
+{
+    auto index = get_index(key);
+    if (!index)
+        return {};
+    return JsonValueView(*m_document, index);
+}
+
+JsonValue JsonValueView::to_json_value() const
+{
+    switch (type()) {
+    case Type::Null:
+        break;
+    case Type::Bool:
+        return JsonValue(to_bool());
+    case Type::Number:
+        return number().value_or(JsonValue());
+    case Type::String:
+        return JsonValue(as_string());
+    case Type::Array: {
+        JsonArray array;
+        for_each([&](auto& value) {
+            array.append(value.to_json_value());
+        });
+        return array;
+    }
+    case Type::Object: {
+        JsonObject object;
+        for_each_member([&](auto& key, auto& value) {
+            object.set(key, value.to_json_value());
+        });
+        return object;
+    }
+    }
+    return JsonValue();
+}
+
+}
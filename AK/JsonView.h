@@ -0,0 +1,221 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/JsonValue.h>
+#include <AK/String.h>
+#include <AK/StringView.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+class JsonDocumentView;
+
+// A read-only view of one value in a JsonDocumentView. Strings and numbers are not copied
+// out of the source text until they're asked for, and not at all by as_string_view() and
+// the to_*() number conversions. Looking up something that isn't there gives a null view,
+// much like JsonObject::get() gives a null JsonValue.
+class JsonValueView {
+public:
+    enum class Type : u8 {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    JsonValueView() { }
+
+    Type type() const;
+    bool is_null() const { return type() == Type::Null; }
+    bool is_bool() const { return type() == Type::Bool; }
+    bool is_number() const { return type() == Type::Number; }
+    bool is_string() const { return type() == Type::String; }
+    bool is_array() const { return type() == Type::Array; }
+    bool is_object() const { return type() == Type::Object; }
+
+    // The source text of this value. For strings, this is what's between the quotes, escapes and all.
+    StringView source_text() const;
+
+    // Whether the string contains escapes, in which case as_string() has to decode it.
+    bool string_needs_unescaping() const;
+
+    StringView as_string_view() const
+    {
+        ASSERT(is_string() && !string_needs_unescaping());
+        return source_text();
+    }
+    String as_string() const;
+
+    // Strings are returned as-is, anything else as its JSON text.
+    String to_string() const;
+
+    bool to_bool(bool default_value = false) const
+    {
+        if (!is_bool())
+            return default_value;
+        return source_text() == "true";
+    }
+
+    Optional<JsonValue> number() const;
+
+    template<typename T>
+    T to_number(T default_value = 0) const
+    {
+        if (!is_number())
+            return default_value;
+        auto value = number();
+        if (!value.has_value())
+            return default_value;
+        return value.value().to_number<T>(default_value);
+    }
+
+    i32 to_i32(i32 default_value = 0) const { return to_number<i32>(default_value); }
+    u32 to_u32(u32 default_value = 0) const { return to_number<u32>(default_value); }
+    i64 to_i64(i64 default_value = 0) const { return to_number<i64>(default_value); }
+    u64 to_u64(u64 default_value = 0) const { return to_number<u64>(default_value); }
+    double to_double(double default_value = 0) const { return to_number<double>(default_value); }
+
+    // The number of elements of an array, or members of an object.
+    size_t size() const;
+
+    JsonValueView at(size_t index) const;
+    JsonValueView get(const StringView& key) const;
+    bool has(const StringView& key) const { return get_index(key) != 0; }
+
+    template<typename Callback>
+    void for_each(Callback callback) const
+    {
+        ASSERT(is_array());
+        for (u32 index = m_index + 1; index < subtree_end(); index = subtree_end_of(index)) {
+            JsonValueView value(*m_document, index);
+            callback(value);
+        }
+    }
+
+    template<typename Callback>
+    void for_each_member(Callback callback) const
+    {
+        ASSERT(is_object());
+        for (u32 index = m_index + 1; index < subtree_end(); index = subtree_end_of(index + 1)) {
+            JsonValueView key(*m_document, index);
+            JsonValueView value(*m_document, index + 1);
+            if (key.string_needs_unescaping()) {
+                auto unescaped_name = key.as_string();
+                StringView name = unescaped_name;
+                callback(name, value);
+            } else {
+                StringView name = key.source_text();
+                callback(name, value);
+            }
+        }
+    }
+
+    // Builds a regular JsonValue out of this view, copying everything.
+    JsonValue to_json_value() const;
+
+private:
+    friend class JsonDocumentView;
+
+    JsonValueView(const JsonDocumentView& document, u32 index)
+        : m_document(&document)
+        , m_index(index)
+    {
+    }
+
+    u32 subtree_end() const { return subtree_end_of(m_index); }
+    u32 subtree_end_of(u32 index) const;
+    u32 get_index(const StringView& key) const;
+
+    const JsonDocumentView* m_document { nullptr };
+    u32 m_index { 0 };
+};
+
+// JsonDocumentView parses a JSON document into a flat list of nodes that point back into the
+// source text, instead of building a tree of JsonValues. The source has to stay alive and
+// unchanged for as long as the document is used, which makes this a good fit for
+// memory-mapped files and buffers that have just been read in one go.
+class JsonDocumentView {
+public:
+    static Optional<JsonDocumentView> parse(const StringView& source);
+
+    JsonValueView root() const { return JsonValueView(*this, 0); }
+
+private:
+    friend class JsonValueView;
+    class Parser;
+
+    struct Node {
+        JsonValueView::Type type { JsonValueView::Type::Null };
+        bool needs_unescaping { false };
+        u32 subtree_end { 0 };
+        u32 size { 0 };
+        StringView text;
+    };
+
+    JsonDocumentView() { }
+
+    Vector<Node> m_nodes;
+};
+
+inline JsonValueView::Type JsonValueView::type() const
+{
+    if (!m_document)
+        return Type::Null;
+    return m_document->m_nodes[m_index].type;
+}
+
+inline StringView JsonValueView::source_text() const
+{
+    if (!m_document)
+        return "null";
+    return m_document->m_nodes[m_index].text;
+}
+
+inline bool JsonValueView::string_needs_unescaping() const
+{
+    return m_document && m_document->m_nodes[m_index].needs_unescaping;
+}
+
+inline size_t JsonValueView::size() const
+{
+    if (!is_array() && !is_object())
+        return 0;
+    return m_document->m_nodes[m_index].size;
+}
+
+inline u32 JsonValueView::subtree_end_of(u32 index) const
+{
+    return m_document->m_nodes[index].subtree_end;
+}
+
+}
+
+using AK::JsonDocumentView;
+using AK::JsonValueView;
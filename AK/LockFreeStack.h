@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/HazardPointer.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+
+namespace AK {
+
+// A Treiber stack: an unbounded lock-free LIFO made of a singly linked list
+// whose head is swapped in with a CAS. Popped nodes are retired through a
+// hazard pointer domain, which makes it safe to read a node's next pointer
+// while another thread pops it, and rules out the ABA problem because a node
+// can't be freed and reused while someone still holds it.
+template<typename T>
+class LockFreeStack {
+    AK_MAKE_NONCOPYABLE(LockFreeStack);
+    AK_MAKE_NONMOVABLE(LockFreeStack);
+
+public:
+    LockFreeStack() { }
+
+    ~LockFreeStack()
+    {
+        auto* node = m_head.load(AK::memory_order_relaxed);
+        while (node) {
+            auto* next = node->next;
+            delete node;
+            node = next;
+        }
+    }
+
+    bool is_empty() const { return !m_head.load(AK::memory_order_acquire); }
+
+    void push(T&& value)
+    {
+        auto* node = new Node { move(value), nullptr };
+        auto* head = m_head.load(AK::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!m_head.compare_exchange_strong(head, node, AK::memory_order_release));
+    }
+
+    void push(const T& value)
+    {
+        push(T(value));
+    }
+
+    Optional<T> pop()
+    {
+        HazardPointer hazard(m_domain);
+        for (;;) {
+            auto* head = hazard.protect(m_head);
+            if (!head)
+                return {};
+            if (m_head.compare_exchange_strong(head, head->next, AK::memory_order_acq_rel)) {
+                hazard.reset();
+                T value = move(head->value);
+                m_domain.retire(head);
+                return value;
+            }
+        }
+    }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    Atomic<Node*> m_head { nullptr };
+    HazardPointerDomain m_domain;
+};
+
+}
+
+using AK::LockFreeStack;
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A bounded, lock-free queue for any number of producers and consumers, after
+// Dmitry Vyukov's design. Every cell carries a sequence number that says whose
+// turn it is: a producer may fill cell i when its sequence is i, and a consumer
+// may empty it when its sequence is i + 1. Claiming a position is a single CAS
+// on the enqueue or dequeue index, so neither side ever waits on a lock.
+template<typename T, size_t Capacity>
+class MPMCQueue {
+    AK_MAKE_NONCOPYABLE(MPMCQueue);
+    AK_MAKE_NONMOVABLE(MPMCQueue);
+
+    static_assert(Capacity >= 2 && !(Capacity & (Capacity - 1)), "MPMCQueue capacity must be a power of two");
+
+public:
+    MPMCQueue()
+    {
+        for (size_t i = 0; i < Capacity; ++i)
+            m_cells[i].sequence.store(i, AK::memory_order_relaxed);
+    }
+
+    ~MPMCQueue()
+    {
+        while (try_dequeue().has_value())
+            ;
+    }
+
+    size_t capacity() const { return Capacity; }
+
+    // Only a snapshot when called while other threads are using the queue.
+    size_t size() const
+    {
+        size_t enqueued = m_enqueue_position.load(AK::memory_order_acquire);
+        size_t dequeued = m_dequeue_position.load(AK::memory_order_acquire);
+        return (ssize_t)(enqueued - dequeued) > 0 ? enqueued - dequeued : 0;
+    }
+    bool is_empty() const { return size() == 0; }
+
+    // Returns false if the queue is full.
+    [[nodiscard]] bool try_enqueue(T&& value)
+    {
+        size_t position = m_enqueue_position.load(AK::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(AK::memory_order_acquire);
+            ssize_t difference = sequence - position;
+            if (difference == 0) {
+                if (m_enqueue_position.compare_exchange_strong(position, position + 1, AK::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                return false;
+            } else {
+                position = m_enqueue_position.load(AK::memory_order_relaxed);
+            }
+        }
+        new (cell->storage) T(move(value));
+        cell->sequence.store(position + 1, AK::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool try_enqueue(const T& value)
+    {
+        return try_enqueue(T(value));
+    }
+
+    Optional<T> try_dequeue()
+    {
+        size_t position = m_dequeue_position.load(AK::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[position & (Capacity - 1)];
+            size_t sequence = cell->sequence.load(AK::memory_order_acquire);
+            ssize_t difference = sequence - (position + 1);
+            if (difference == 0) {
+                if (m_dequeue_position.compare_exchange_strong(position, position + 1, AK::memory_order_relaxed))
+                    break;
+            } else if (difference < 0) {
+                return {};
+            } else {
+                position = m_dequeue_position.load(AK::memory_order_relaxed);
+            }
+        }
+        auto& slot = *reinterpret_cast<T*>(cell->storage);
+        T value = move(slot);
+        slot.~T();
+        cell->sequence.store(position + Capacity, AK::memory_order_release);
+        return value;
+    }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    struct Cell {
+        Atomic<size_t> sequence;
+        alignas(T) u8 storage[sizeof(T)];
+    };
+
+    Atomic<size_t> m_enqueue_position { 0 };
+    u8 m_enqueue_padding[cache_line_size - sizeof(Atomic<size_t>)];
+    Atomic<size_t> m_dequeue_position { 0 };
+    u8 m_dequeue_padding[cache_line_size - sizeof(Atomic<size_t>)];
+    Cell m_cells[Capacity];
+};
+
+}
+
+using AK::MPMCQueue;
@@ -28,6 +28,7 @@
 
 #include <AK/Array.h>
 #include <AK/Assertions.h>
+#include <AK/SIMDStringOps.h>
 #include <AK/Span.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -131,6 +132,12 @@ static inline const void* memmem(const void* haystack, size_t haystack_length, c
     if (haystack_length == needle_length)
         return __builtin_memcmp(haystack, needle, haystack_length) == 0 ? haystack : nullptr;
 
+#if defined(__SSE2__) && !defined(KERNEL)
+    // SSE2 is part of the baseline on x86_64, so we can use the vectorized search directly.
+    // Serenity's LibC picks between this and the code below at runtime in its own memmem().
+    return SIMD::find_substring<SIMD::u8x16>((const u8*)haystack, haystack_length, (const u8*)needle, needle_length);
+#endif
+
     if (needle_length < 32)
         return bitap_bitwise(haystack, haystack_length, needle, needle_length);
 
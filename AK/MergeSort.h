@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+
+namespace AK {
+
+namespace Detail {
+
+template<typename Collection, typename Buffer, typename LessThan>
+void merge_sort(Collection& col, size_t start, size_t end, Buffer& buffer, LessThan& less_than)
+{
+    constexpr size_t insertion_sort_threshold = 16;
+
+    if (end - start <= insertion_sort_threshold) {
+        for (size_t i = start + 1; i < end; ++i) {
+            for (size_t j = i; j > start && less_than(col[j], col[j - 1]); --j)
+                swap(col[j], col[j - 1]);
+        }
+        return;
+    }
+
+    size_t middle = start + (end - start) / 2;
+    merge_sort(col, start, middle, buffer, less_than);
+    merge_sort(col, middle, end, buffer, less_than);
+
+    // The halves are already in order, nothing to merge.
+    if (!less_than(col[middle], col[middle - 1]))
+        return;
+
+    // Move the left half out of the way and merge back into the collection.
+    // Ties are taken from the left half, which is what keeps the sort stable.
+    buffer.clear_with_capacity();
+    for (size_t i = start; i < middle; ++i)
+        buffer.unchecked_append(move(col[i]));
+
+    size_t left = 0;
+    size_t right = middle;
+    size_t out = start;
+    while (left < buffer.size() && right < end) {
+        if (less_than(col[right], buffer[left]))
+            col[out++] = move(col[right++]);
+        else
+            col[out++] = move(buffer[left++]);
+    }
+    while (left < buffer.size())
+        col[out++] = move(buffer[left++]);
+}
+
+}
+
+/* A stable merge sort: elements that compare equal keep their relative order.
+ * It needs a scratch buffer of half the collection's size, and is therefore
+ * a bit slower than intro_sort() from AK/QuickSort.h, but it is O(n log n)
+ * in all cases as well.
+ */
+template<typename Collection, typename LessThan>
+void merge_sort(Collection& collection, LessThan less_than)
+{
+    using ValueType = typename RemoveConst<typename RemoveReference<decltype(collection[0])>::Type>::Type;
+
+    size_t size = collection.size();
+    if (size <= 1)
+        return;
+
+    Vector<ValueType> buffer;
+    buffer.ensure_capacity(size / 2 + 1);
+    Detail::merge_sort(collection, 0, size, buffer, less_than);
+}
+
+template<typename Collection>
+void merge_sort(Collection& collection)
+{
+    merge_sort(collection, [](auto& a, auto& b) { return a < b; });
+}
+
+}
+
+using AK::merge_sort;
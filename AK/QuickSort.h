@@ -85,6 +85,144 @@ void dual_pivot_quick_sort(Collection& col, int start, int end, LessThan less_th
     dual_pivot_quick_sort(col, right_pointer + 1, end, less_than);
 }
 
+namespace Detail {
+
+template<typename Collection, typename LessThan>
+void insertion_sort(Collection& col, int start, int end, LessThan& less_than)
+{
+    for (int i = start + 1; i <= end; ++i) {
+        for (int j = i; j > start && less_than(col[j], col[j - 1]); --j)
+            swap(col[j], col[j - 1]);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void sift_down(Collection& col, int start, int root, int count, LessThan& less_than)
+{
+    for (;;) {
+        int child = 2 * root + 1;
+        if (child >= count)
+            return;
+        if (child + 1 < count && less_than(col[start + child], col[start + child + 1]))
+            ++child;
+        if (!less_than(col[start + root], col[start + child]))
+            return;
+        swap(col[start + root], col[start + child]);
+        root = child;
+    }
+}
+
+template<typename Collection, typename LessThan>
+void heap_sort(Collection& col, int start, int end, LessThan& less_than)
+{
+    int count = end - start + 1;
+    for (int root = count / 2 - 1; root >= 0; --root)
+        sift_down(col, start, root, count, less_than);
+    for (int last = count - 1; last > 0; --last) {
+        swap(col[start], col[start + last]);
+        sift_down(col, start, 0, last, less_than);
+    }
+}
+
+template<typename Collection, typename LessThan>
+void intro_sort(Collection& col, int start, int end, int depth_limit, LessThan& less_than)
+{
+    constexpr int insertion_sort_threshold = 16;
+
+    while (end - start >= insertion_sort_threshold) {
+        if (depth_limit-- == 0) {
+            heap_sort(col, start, end, less_than);
+            return;
+        }
+
+        // Take the pivots from the tertiles rather than from the ends, so that
+        // already sorted (or reverse sorted) input splits evenly.
+        int third = (end - start + 1) / 3;
+        swap(col[start], col[start + third]);
+        swap(col[end], col[end - third]);
+        if (less_than(col[end], col[start]))
+            swap(col[start], col[end]);
+
+        if (!less_than(col[start], col[end])) {
+            // Both pivots are equal, which would send every duplicate of the pivot
+            // to the same side. Do a three-way partition instead and drop the
+            // run of equal elements from any further work.
+            auto&& pivot = col[start];
+            int lt = start + 1;
+            int gt = end;
+            for (int i = start + 1; i <= gt;) {
+                if (less_than(col[i], pivot))
+                    swap(col[lt++], col[i++]);
+                else if (less_than(pivot, col[i]))
+                    swap(col[i], col[gt--]);
+                else
+                    ++i;
+            }
+            swap(col[start], col[lt - 1]);
+            intro_sort(col, start, lt - 2, depth_limit, less_than);
+            start = gt + 1;
+            continue;
+        }
+
+        int j = start + 1;
+        int k = start + 1;
+        int g = end - 1;
+
+        auto&& left_pivot = col[start];
+        auto&& right_pivot = col[end];
+
+        while (k <= g) {
+            if (less_than(col[k], left_pivot)) {
+                swap(col[k], col[j]);
+                j++;
+            } else if (!less_than(col[k], right_pivot)) {
+                while (!less_than(col[g], right_pivot) && k < g) {
+                    g--;
+                }
+                swap(col[k], col[g]);
+                g--;
+                if (less_than(col[k], left_pivot)) {
+                    swap(col[k], col[j]);
+                    j++;
+                }
+            }
+            k++;
+        }
+        j--;
+        g++;
+
+        swap(col[start], col[j]);
+        swap(col[end], col[g]);
+
+        intro_sort(col, start, j - 1, depth_limit, less_than);
+        intro_sort(col, j + 1, g - 1, depth_limit, less_than);
+        start = g + 1;
+    }
+
+    insertion_sort(col, start, end, less_than);
+}
+
+}
+
+/* This is an introsort: the dual pivot quick sort above, with insertion sort
+ * for short ranges and a fallback to heap sort once the recursion gets deeper
+ * than 2 * log2(n). Unlike the plain quick sorts, it is O(n log n) in the worst
+ * case, including inputs with many equal elements. It is not stable; use
+ * merge_sort() from AK/MergeSort.h if the order of equal elements matters.
+ */
+template<typename Collection, typename LessThan>
+void intro_sort(Collection& col, int start, int end, LessThan less_than)
+{
+    if (start >= end)
+        return;
+
+    int depth_limit = 0;
+    for (int size = end - start + 1; size > 1; size >>= 1)
+        depth_limit += 2;
+
+    Detail::intro_sort(col, start, end, depth_limit, less_than);
+}
+
 template<typename Iterator, typename LessThan>
 void quick_sort(Iterator start, Iterator end, LessThan less_than)
 {
@@ -120,16 +258,17 @@ void quick_sort(Iterator start, Iterator end)
 template<typename Collection, typename LessThan>
 void quick_sort(Collection& collection, LessThan less_than)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1, move(less_than));
+    intro_sort(collection, 0, collection.size() - 1, move(less_than));
 }
 
 template<typename Collection>
 void quick_sort(Collection& collection)
 {
-    dual_pivot_quick_sort(collection, 0, collection.size() - 1,
+    intro_sort(collection, 0, collection.size() - 1,
         [](auto& a, auto& b) { return a < b; });
 }
 
 }
 
+using AK::intro_sort;
 using AK::quick_sort;
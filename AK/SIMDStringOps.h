@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Platform.h>
+#include <AK/SIMD.h>
+#include <AK/Types.h>
+
+// Byte-wise memory and string search kernels, written in terms of the generic vector types
+// from AK/SIMD.h so that they can be instantiated for any vector width.
+//
+// Everything here is ALWAYS_INLINE on purpose: the kernels are meant to be inlined into a
+// function compiled for a particular instruction set (e.g. with [[gnu::target("avx2")]]),
+// which is what decides the instructions that the vector operations turn into.
+// Vectors are never passed by value between functions for the same reason.
+//
+// copy() and fill() are plain loops, which GCC may turn back into calls to memcpy() and
+// memset(). Code that uses them to implement those functions has to be built with
+// -fno-tree-loop-distribute-patterns.
+
+namespace AK::SIMD {
+
+template<size_t vector_size>
+struct WordsOfVector;
+
+template<>
+struct WordsOfVector<16> {
+    using Type = u32x4;
+};
+
+template<>
+struct WordsOfVector<32> {
+    using Type = u32x8;
+};
+
+template<typename VectorType>
+ALWAYS_INLINE void splat(VectorType& vector, u8 value)
+{
+    for (size_t i = 0; i < sizeof(VectorType); ++i)
+        vector[i] = value;
+}
+
+template<typename VectorType>
+ALWAYS_INLINE void load(VectorType& vector, const void* data)
+{
+    __builtin_memcpy(&vector, data, sizeof(VectorType));
+}
+
+template<typename VectorType>
+ALWAYS_INLINE void store(void* data, const VectorType& vector)
+{
+    __builtin_memcpy(data, &vector, sizeof(VectorType));
+}
+
+// `mask` is the result of a lane-wise comparison, so each byte is either 0x00 or 0xff.
+template<typename MaskType>
+ALWAYS_INLINE bool any_lane_set(const MaskType& mask)
+{
+    auto words = (typename WordsOfVector<sizeof(MaskType)>::Type)mask;
+    u32 combined = 0;
+    for (size_t i = 0; i < sizeof(MaskType) / sizeof(u32); ++i)
+        combined |= words[i];
+    return combined;
+}
+
+template<typename MaskType>
+ALWAYS_INLINE size_t first_set_lane(const MaskType& mask)
+{
+    auto words = (typename WordsOfVector<sizeof(MaskType)>::Type)mask;
+    for (size_t i = 0; i < sizeof(MaskType) / sizeof(u32); ++i) {
+        if (words[i])
+            return i * sizeof(u32) + count_trailing_zeroes_32(words[i]) / 8;
+    }
+    return sizeof(MaskType);
+}
+
+// The loops below handle this many vectors per iteration, and only check once whether any of them
+// had a match, since figuring that out is the expensive part without a "move mask" instruction.
+static constexpr size_t vectors_per_iteration = 4;
+
+template<typename VectorType>
+ALWAYS_INLINE const u8* find_byte(const u8* data, size_t length, u8 needle)
+{
+    VectorType needles;
+    splat(needles, needle);
+
+    constexpr size_t bytes_per_iteration = sizeof(VectorType) * vectors_per_iteration;
+    size_t offset = 0;
+    for (; offset + bytes_per_iteration <= length; offset += bytes_per_iteration) {
+        VectorType chunk0, chunk1, chunk2, chunk3;
+        load(chunk0, data + offset);
+        load(chunk1, data + offset + sizeof(VectorType));
+        load(chunk2, data + offset + sizeof(VectorType) * 2);
+        load(chunk3, data + offset + sizeof(VectorType) * 3);
+        auto any_matches = (chunk0 == needles) | (chunk1 == needles) | (chunk2 == needles) | (chunk3 == needles);
+        if (any_lane_set(any_matches))
+            break;
+    }
+    for (; offset + sizeof(VectorType) <= length; offset += sizeof(VectorType)) {
+        VectorType chunk;
+        load(chunk, data + offset);
+        auto matches = chunk == needles;
+        if (any_lane_set(matches))
+            return data + offset + first_set_lane(matches);
+    }
+    for (; offset < length; ++offset) {
+        if (data[offset] == needle)
+            return data + offset;
+    }
+    return nullptr;
+}
+
+// The string kernels below only ever read whole aligned vectors once they're past the
+// first few bytes, so they may look at bytes after the terminator, but never beyond the
+// page that contains it.
+
+template<typename VectorType>
+ALWAYS_INLINE size_t string_length(const char* string)
+{
+    auto* characters = (const u8*)string;
+    for (; (FlatPtr)characters % sizeof(VectorType); ++characters) {
+        if (!*characters)
+            return characters - (const u8*)string;
+    }
+
+    VectorType zeroes {};
+    constexpr size_t bytes_per_iteration = sizeof(VectorType) * vectors_per_iteration;
+    for (;; characters += sizeof(VectorType)) {
+        if ((FlatPtr)characters % bytes_per_iteration == 0) {
+            VectorType chunk0, chunk1, chunk2, chunk3;
+            load(chunk0, characters);
+            load(chunk1, characters + sizeof(VectorType));
+            load(chunk2, characters + sizeof(VectorType) * 2);
+            load(chunk3, characters + sizeof(VectorType) * 3);
+            auto any_matches = (chunk0 == zeroes) | (chunk1 == zeroes) | (chunk2 == zeroes) | (chunk3 == zeroes);
+            if (!any_lane_set(any_matches)) {
+                characters += bytes_per_iteration - sizeof(VectorType);
+                continue;
+            }
+        }
+        VectorType chunk;
+        load(chunk, characters);
+        auto matches = chunk == zeroes;
+        if (any_lane_set(matches))
+            return characters + first_set_lane(matches) - (const u8*)string;
+    }
+}
+
+// Returns a pointer to the first occurrence of `needle`, or to the terminator if there is none.
+template<typename VectorType>
+ALWAYS_INLINE const char* find_byte_or_terminator(const char* string, u8 needle)
+{
+    auto* characters = (const u8*)string;
+    for (; (FlatPtr)characters % sizeof(VectorType); ++characters) {
+        if (*characters == needle || !*characters)
+            return (const char*)characters;
+    }
+
+    VectorType needles;
+    splat(needles, needle);
+    VectorType zeroes {};
+    constexpr size_t bytes_per_iteration = sizeof(VectorType) * vectors_per_iteration;
+    for (;; characters += sizeof(VectorType)) {
+        if ((FlatPtr)characters % bytes_per_iteration == 0) {
+            VectorType chunk0, chunk1, chunk2, chunk3;
+            load(chunk0, characters);
+            load(chunk1, characters + sizeof(VectorType));
+            load(chunk2, characters + sizeof(VectorType) * 2);
+            load(chunk3, characters + sizeof(VectorType) * 3);
+            auto any_matches = (chunk0 == needles) | (chunk0 == zeroes) | (chunk1 == needles) | (chunk1 == zeroes)
+                | (chunk2 == needles) | (chunk2 == zeroes) | (chunk3 == needles) | (chunk3 == zeroes);
+            if (!any_lane_set(any_matches)) {
+                characters += bytes_per_iteration - sizeof(VectorType);
+                continue;
+            }
+        }
+        VectorType chunk;
+        load(chunk, characters);
+        auto matches = (chunk == needles) | (chunk == zeroes);
+        if (any_lane_set(matches))
+            return (const char*)characters + first_set_lane(matches);
+    }
+}
+
+template<typename VectorType>
+ALWAYS_INLINE int compare(const u8* a, const u8* b, size_t length)
+{
+    constexpr size_t bytes_per_iteration = sizeof(VectorType) * vectors_per_iteration;
+    size_t offset = 0;
+    for (; offset + bytes_per_iteration <= length; offset += bytes_per_iteration) {
+        VectorType a0, a1, a2, a3, b0, b1, b2, b3;
+        load(a0, a + offset);
+        load(a1, a + offset + sizeof(VectorType));
+        load(a2, a + offset + sizeof(VectorType) * 2);
+        load(a3, a + offset + sizeof(VectorType) * 3);
+        load(b0, b + offset);
+        load(b1, b + offset + sizeof(VectorType));
+        load(b2, b + offset + sizeof(VectorType) * 2);
+        load(b3, b + offset + sizeof(VectorType) * 3);
+        auto any_mismatches = (a0 != b0) | (a1 != b1) | (a2 != b2) | (a3 != b3);
+        if (any_lane_set(any_mismatches))
+            break;
+    }
+    for (; offset + sizeof(VectorType) <= length; offset += sizeof(VectorType)) {
+        VectorType chunk_a;
+        VectorType chunk_b;
+        load(chunk_a, a + offset);
+        load(chunk_b, b + offset);
+        auto mismatches = chunk_a != chunk_b;
+        if (any_lane_set(mismatches)) {
+            offset += first_set_lane(mismatches);
+            return a[offset] < b[offset] ? -1 : 1;
+        }
+    }
+    for (; offset < length; ++offset) {
+        if (a[offset] != b[offset])
+            return a[offset] < b[offset] ? -1 : 1;
+    }
+    return 0;
+}
+
+// Copies front to back, loading a few vectors before storing them, so this is also safe for
+// overlapping buffers as long as `destination` comes before `source`.
+template<typename VectorType>
+ALWAYS_INLINE void copy(u8* destination, const u8* source, size_t length)
+{
+    constexpr size_t bytes_per_iteration = sizeof(VectorType) * vectors_per_iteration;
+    size_t offset = 0;
+    for (; offset + bytes_per_iteration <= length; offset += bytes_per_iteration) {
+        VectorType chunk0, chunk1, chunk2, chunk3;
+        load(chunk0, source + offset);
+        load(chunk1, source + offset + sizeof(VectorType));
+        load(chunk2, source + offset + sizeof(VectorType) * 2);
+        load(chunk3, source + offset + sizeof(VectorType) * 3);
+        store(destination + offset, chunk0);
+        store(destination + offset + sizeof(VectorType), chunk1);
+        store(destination + offset + sizeof(VectorType) * 2, chunk2);
+        store(destination + offset + sizeof(VectorType) * 3, chunk3);
+    }
+    for (; offset + sizeof(VectorType) <= length; offset += sizeof(VectorType)) {
+        VectorType chunk;
+        load(chunk, source + offset);
+        store(destination + offset, chunk);
+    }
+    for (; offset < length; ++offset)
+        destination[offset] = source[offset];
+}
+
+template<typename VectorType>
+ALWAYS_INLINE void fill(u8* destination, u8 value, size_t length)
+{
+    VectorType values;
+    splat(values, value);
+
+    size_t offset = 0;
+    for (; offset + sizeof(VectorType) <= length; offset += sizeof(VectorType))
+        store(destination + offset, values);
+    for (; offset < length; ++offset)
+        destination[offset] = value;
+}
+
+// Looks for positions where both the first and the last byte of the needle match, and only
+// compares the bytes in between for those.
+template<typename VectorType>
+ALWAYS_INLINE const u8* find_substring(const u8* haystack, size_t haystack_length, const u8* needle, size_t needle_length)
+{
+    if (needle_length == 0)
+        return haystack;
+    if (haystack_length < needle_length)
+        return nullptr;
+    if (needle_length == 1)
+        return find_byte<VectorType>(haystack, haystack_length, needle[0]);
+
+    VectorType firsts;
+    VectorType lasts;
+    splat(firsts, needle[0]);
+    splat(lasts, needle[needle_length - 1]);
+
+    auto matches_at = [&](size_t offset) {
+        return !__builtin_memcmp(haystack + offset + 1, needle + 1, needle_length - 2);
+    };
+
+    size_t last_offset = haystack_length - needle_length;
+    size_t offset = 0;
+    for (; offset + sizeof(VectorType) <= last_offset + 1; offset += sizeof(VectorType)) {
+        VectorType chunk_of_firsts;
+        VectorType chunk_of_lasts;
+        load(chunk_of_firsts, haystack + offset);
+        load(chunk_of_lasts, haystack + offset + needle_length - 1);
+        auto candidates = (chunk_of_firsts == firsts) & (chunk_of_lasts == lasts);
+        if (!any_lane_set(candidates))
+            continue;
+        for (size_t i = 0; i < sizeof(VectorType); ++i) {
+            if (candidates[i] && matches_at(offset + i))
+                return haystack + offset + i;
+        }
+    }
+    for (; offset <= last_offset; ++offset) {
+        if (haystack[offset] == needle[0] && haystack[offset + needle_length - 1] == needle[needle_length - 1] && matches_at(offset))
+            return haystack + offset;
+    }
+    return nullptr;
+}
+
+}
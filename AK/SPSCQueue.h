@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Optional.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// A bounded, lock-free queue for exactly one producer thread and one consumer
+// thread. The head and tail indices live on separate cache lines, and each side
+// keeps a cached copy of the other side's index so that it only has to touch the
+// shared line when the queue looks full (or empty).
+template<typename T, size_t Capacity>
+class SPSCQueue {
+    AK_MAKE_NONCOPYABLE(SPSCQueue);
+    AK_MAKE_NONMOVABLE(SPSCQueue);
+
+    static_assert(Capacity && !(Capacity & (Capacity - 1)), "SPSCQueue capacity must be a power of two");
+
+public:
+    SPSCQueue() { }
+
+    ~SPSCQueue()
+    {
+        size_t head = m_head.load(AK::memory_order_relaxed);
+        size_t tail = m_tail.load(AK::memory_order_relaxed);
+        for (; head != tail; ++head)
+            slot(head).~T();
+    }
+
+    size_t capacity() const { return Capacity; }
+
+    // Only a snapshot when called while the other side is running.
+    size_t size() const { return m_tail.load(AK::memory_order_acquire) - m_head.load(AK::memory_order_acquire); }
+    bool is_empty() const { return size() == 0; }
+
+    // Must only be called by the producer. Returns false if the queue is full.
+    [[nodiscard]] bool try_enqueue(T&& value)
+    {
+        size_t tail = m_tail.load(AK::memory_order_relaxed);
+        if (tail - m_producer_cached_head == Capacity) {
+            m_producer_cached_head = m_head.load(AK::memory_order_acquire);
+            if (tail - m_producer_cached_head == Capacity)
+                return false;
+        }
+        new (&slot(tail)) T(move(value));
+        m_tail.store(tail + 1, AK::memory_order_release);
+        return true;
+    }
+
+    [[nodiscard]] bool try_enqueue(const T& value)
+    {
+        return try_enqueue(T(value));
+    }
+
+    // Must only be called by the consumer.
+    Optional<T> try_dequeue()
+    {
+        size_t head = m_head.load(AK::memory_order_relaxed);
+        if (head == m_consumer_cached_tail) {
+            m_consumer_cached_tail = m_tail.load(AK::memory_order_acquire);
+            if (head == m_consumer_cached_tail)
+                return {};
+        }
+        T value = move(slot(head));
+        slot(head).~T();
+        m_head.store(head + 1, AK::memory_order_release);
+        return value;
+    }
+
+private:
+    static constexpr size_t cache_line_size = 64;
+
+    T& slot(size_t index) { return reinterpret_cast<T*>(m_storage)[index & (Capacity - 1)]; }
+
+    // Written by the consumer.
+    Atomic<size_t> m_head { 0 };
+    size_t m_consumer_cached_tail { 0 };
+    u8 m_consumer_padding[cache_line_size - sizeof(Atomic<size_t>) - sizeof(size_t)];
+
+    // Written by the producer.
+    Atomic<size_t> m_tail { 0 };
+    size_t m_producer_cached_head { 0 };
+    u8 m_producer_padding[cache_line_size - sizeof(Atomic<size_t>) - sizeof(size_t)];
+
+    alignas(T) u8 m_storage[sizeof(T) * Capacity];
+};
+
+}
+
+using AK::SPSCQueue;
@@ -105,6 +105,12 @@ struct EnableIf<true, T> {
     using Type = T;
 };
 
+// Used to keep a template parameter out of template argument deduction.
+template<class T>
+struct IdentityType {
+    using Type = T;
+};
+
 template<class T>
 struct AddConst {
     using Type = const T;
@@ -481,6 +487,12 @@ constexpr bool is_trivially_copyable()
     return __is_trivially_copyable(T);
 }
 
+template<typename T>
+constexpr bool is_trivially_destructible()
+{
+    return __has_trivial_destructor(T);
+}
+
 template<typename T>
 struct __IsIntegral : FalseType {
 };
@@ -583,10 +595,12 @@ using AK::declval;
 using AK::DependentFalse;
 using AK::exchange;
 using AK::forward;
+using AK::IdentityType;
 using AK::IndexSequence;
 using AK::IntegerSequence;
 using AK::is_trivial;
 using AK::is_trivially_copyable;
+using AK::is_trivially_destructible;
 using AK::IsArithmetic;
 using AK::IsBaseOf;
 using AK::IsClass;
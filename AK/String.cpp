@@ -462,7 +462,7 @@ InputStream& operator>>(InputStream& stream, String& string)
     }
 }
 
-String String::vformatted(StringView fmtstr, TypeErasedFormatParams params)
+String String::vformatted(TypeErasedFormatString fmtstr, TypeErasedFormatParams params)
 {
     StringBuilder builder;
     vformat(builder, fmtstr, params);
@@ -246,12 +246,12 @@ public:
 
     static String format(const char*, ...);
 
-    static String vformatted(StringView fmtstr, TypeErasedFormatParams);
+    static String vformatted(TypeErasedFormatString fmtstr, TypeErasedFormatParams);
 
     template<typename... Parameters>
-    static String formatted(StringView fmtstr, const Parameters&... parameters)
+    static String formatted(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters)
     {
-        return vformatted(fmtstr, VariadicFormatParams { parameters... });
+        return vformatted(fmtstr.type_erased(), VariadicFormatParams { parameters... });
     }
 
     template<typename T>
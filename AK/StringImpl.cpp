@@ -24,6 +24,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Atomic.h>
 #include <AK/FlyString.h>
 #include <AK/HashTable.h>
 #include <AK/Memory.h>
@@ -31,6 +32,10 @@
 #include <AK/StringImpl.h>
 #include <AK/kmalloc.h>
 
+#ifndef KERNEL
+#    include <AK/StringImplArena.h>
+#endif
+
 //#define DEBUG_STRINGIMPL
 
 #ifdef DEBUG_STRINGIMPL
@@ -50,6 +55,11 @@ void dump_all_stringimpls()
 
 namespace AK {
 
+static inline size_t allocation_size_for_stringimpl(size_t length)
+{
+    return sizeof(StringImpl) + (sizeof(char) * length) + sizeof(char);
+}
+
 static StringImpl* s_the_empty_stringimpl = nullptr;
 
 StringImpl& StringImpl::the_empty_stringimpl()
@@ -61,6 +71,31 @@ StringImpl& StringImpl::the_empty_stringimpl()
     return *s_the_empty_stringimpl;
 }
 
+// One-character strings are common enough (think tokenizers and splitting on separators)
+// that we keep a shared, never-destroyed StringImpl around for each of them.
+static StringImpl* s_single_character_stringimpls[256];
+
+StringImpl& StringImpl::the_single_character_stringimpl(char ch)
+{
+    auto*& slot = s_single_character_stringimpls[(u8)ch];
+    if (auto* impl = AK::atomic_load(&slot, AK::memory_order_acquire))
+        return *impl;
+
+    void* memory = kmalloc(allocation_size_for_stringimpl(1));
+    auto* new_impl = new (memory) StringImpl(ConstructWithInlineBuffer, 1);
+    new_impl->m_inline_buffer[0] = ch;
+    new_impl->m_inline_buffer[1] = '\0';
+
+    StringImpl* expected = nullptr;
+    if (AK::atomic_compare_exchange_strong(&slot, expected, new_impl, AK::memory_order_acq_rel))
+        return *new_impl;
+
+    // Another thread got there first.
+    new_impl->deref_base();
+    new_impl->destroy();
+    return *expected;
+}
+
 StringImpl::StringImpl(ConstructWithInlineBufferTag, size_t length)
     : m_length(length)
 {
@@ -82,17 +117,37 @@ StringImpl::~StringImpl()
 #endif
 }
 
-static inline size_t allocation_size_for_stringimpl(size_t length)
+void StringImpl::destroy() const
 {
-    return sizeof(StringImpl) + (sizeof(char) * length) + sizeof(char);
+    auto* self = const_cast<StringImpl*>(this);
+    bool arena_allocated = m_arena_allocated;
+    self->~StringImpl();
+#ifndef KERNEL
+    if (arena_allocated) {
+        StringImplArena::deallocate(self);
+        return;
+    }
+#else
+    ASSERT(!arena_allocated);
+#endif
+    kfree(self);
 }
 
 NonnullRefPtr<StringImpl> StringImpl::create_uninitialized(size_t length, char*& buffer)
 {
     ASSERT(length);
-    void* slot = kmalloc(allocation_size_for_stringimpl(length));
+    auto allocation_size = allocation_size_for_stringimpl(length);
+    void* slot = nullptr;
+#ifndef KERNEL
+    if (auto* arena = StringImplArena::current())
+        slot = arena->allocate(allocation_size);
+#endif
+    bool arena_allocated = slot;
+    if (!slot)
+        slot = kmalloc(allocation_size);
     ASSERT(slot);
     auto new_stringimpl = adopt(*new (slot) StringImpl(ConstructWithInlineBuffer, length));
+    new_stringimpl->m_arena_allocated = arena_allocated;
     buffer = const_cast<char*>(new_stringimpl->characters());
     buffer[length] = '\0';
     return new_stringimpl;
@@ -116,6 +171,9 @@ RefPtr<StringImpl> StringImpl::create(const char* cstring, size_t length, Should
     if (!length)
         return the_empty_stringimpl();
 
+    if (length == 1)
+        return the_single_character_stringimpl(cstring[0]);
+
     char* buffer;
     auto new_stringimpl = create_uninitialized(length, buffer);
     memcpy(buffer, cstring, length * sizeof(char));
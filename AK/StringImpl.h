@@ -40,7 +40,7 @@ enum ShouldChomp {
     Chomp
 };
 
-class StringImpl : public RefCounted<StringImpl> {
+class StringImpl : public RefCountedBase {
 public:
     static NonnullRefPtr<StringImpl> create_uninitialized(size_t length, char*& buffer);
     static RefPtr<StringImpl> create(const char* cstring, ShouldChomp = NoChomp);
@@ -49,9 +49,14 @@ public:
     NonnullRefPtr<StringImpl> to_lowercase() const;
     NonnullRefPtr<StringImpl> to_uppercase() const;
 
-    void operator delete(void* ptr)
+    // StringImpls may live in a StringImplArena instead of their own heap allocation,
+    // so they do their own cleanup instead of relying on RefCounted's operator delete.
+    ALWAYS_INLINE bool unref() const
     {
-        kfree(ptr);
+        if (deref_base())
+            return false;
+        destroy();
+        return true;
     }
 
     static StringImpl& the_empty_stringimpl();
@@ -107,12 +112,16 @@ private:
     };
     StringImpl(ConstructWithInlineBufferTag, size_t length);
 
+    static StringImpl& the_single_character_stringimpl(char);
+
     void compute_hash() const;
+    void destroy() const;
 
     size_t m_length { 0 };
     mutable unsigned m_hash { 0 };
     mutable bool m_has_hash { false };
     mutable bool m_fly { false };
+    bool m_arena_allocated { false };
     char m_inline_buffer[0];
 };
 
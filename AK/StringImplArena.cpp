@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2019-2020, Sergey Bugaev <bugaevc@serenityos.org>
+ * Copyright (c) 2020, the SerenityOS developers.
  * All rights reserved.
  *
  * Redistribution and use in source and binary forms, with or without
@@ -24,51 +24,41 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#include <AK/Queue.h>
-#include <LibThread/BackgroundAction.h>
-#include <LibThread/Lock.h>
-#include <LibThread/Thread.h>
+#include <AK/Assertions.h>
+#include <AK/StringImplArena.h>
 
-static LibThread::Lockable<Queue<Function<void()>>>* s_all_actions;
-static LibThread::Thread* s_background_thread;
+namespace AK {
 
-static int background_thread_func()
-{
-    while (true) {
-        Function<void()> work_item;
-        {
-            LOCKER(s_all_actions->lock());
+#ifdef NO_TLS
+static StringImplArena* s_current_arena;
+#else
+static __thread StringImplArena* s_current_arena;
+#endif
 
-            if (!s_all_actions->resource().is_empty())
-                work_item = s_all_actions->resource().dequeue();
-        }
-        if (work_item)
-            work_item();
-        else
-            sleep(1);
-    }
+StringImplArena::StringImplArena(size_t chunk_size)
+    : m_arena(chunk_size)
+{
+}
 
-    ASSERT_NOT_REACHED();
+StringImplArena::~StringImplArena()
+{
+    ASSERT(s_current_arena != this);
 }
 
-static void init()
+StringImplArena::Scope::Scope(StringImplArena& arena)
+    : m_previous_arena(s_current_arena)
 {
-    s_all_actions = new LibThread::Lockable<Queue<Function<void()>>>();
-    s_background_thread = &LibThread::Thread::construct(background_thread_func).leak_ref();
-    s_background_thread->set_name("Background thread");
-    s_background_thread->start();
+    s_current_arena = &arena;
 }
 
-LibThread::Lockable<Queue<Function<void()>>>& LibThread::BackgroundActionBase::all_actions()
+StringImplArena::Scope::~Scope()
 {
-    if (s_all_actions == nullptr)
-        init();
-    return *s_all_actions;
+    s_current_arena = m_previous_arena;
 }
 
-LibThread::Thread& LibThread::BackgroundActionBase::background_thread()
+StringImplArena* StringImplArena::current()
 {
-    if (s_background_thread == nullptr)
-        init();
-    return *s_background_thread;
+    return s_current_arena;
+}
+
 }
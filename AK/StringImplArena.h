@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Arena.h>
+#include <AK/Noncopyable.h>
+#include <AK/Types.h>
+
+namespace AK {
+
+// StringImplArena hands out memory for the StringImpls created on the current thread while
+// one of its Scopes is alive. Parsers that churn out lots of small strings can put a Scope
+// around a single parse, so those strings are carved out of a few large chunks instead of
+// each getting their own heap allocation.
+//
+// Strings made in an arena are ordinary Strings and may outlive both the Scope and the arena.
+// They are counted allocations in an AK::Arena, so every chunk is only freed once the arena is
+// gone and the last of the strings in it is too. Keep in mind that this means a single
+// long-lived string keeps its whole chunk around.
+class StringImplArena {
+    AK_MAKE_NONCOPYABLE(StringImplArena);
+    AK_MAKE_NONMOVABLE(StringImplArena);
+
+public:
+    static constexpr size_t default_chunk_size = 16 * KiB;
+
+    explicit StringImplArena(size_t chunk_size = default_chunk_size);
+    ~StringImplArena();
+
+    class Scope {
+        AK_MAKE_NONCOPYABLE(Scope);
+        AK_MAKE_NONMOVABLE(Scope);
+
+    public:
+        explicit Scope(StringImplArena&);
+        ~Scope();
+
+    private:
+        StringImplArena* m_previous_arena { nullptr };
+    };
+
+    static StringImplArena* current();
+
+    // Returns nullptr for allocations that are too large to be worth putting into a chunk.
+    void* allocate(size_t size) { return m_arena.allocate_counted(size); }
+    static void deallocate(void* ptr) { Arena::deallocate_counted(ptr); }
+
+    size_t allocated_chunk_count() const { return m_arena.allocated_chunk_count(); }
+
+private:
+    Arena m_arena;
+};
+
+}
+
+using AK::StringImplArena;
@@ -268,10 +268,10 @@ bool StringView::operator==(const String& string) const
 
 Optional<size_t> StringView::find_first_of(char c) const
 {
-    for (size_t pos = 0; pos < m_length; ++pos) {
-        if (m_characters[pos] == c)
-            return pos;
-    }
+    if (is_empty())
+        return {};
+    if (auto* pos = (const char*)memchr(m_characters, c, m_length))
+        return pos - m_characters;
     return {};
 }
 
@@ -287,6 +287,17 @@ Optional<size_t> StringView::find_first_of(const StringView& view) const
     return {};
 }
 
+Optional<size_t> StringView::find(const StringView& needle) const
+{
+    if (needle.length() > m_length)
+        return {};
+    if (needle.is_empty())
+        return 0;
+    if (auto* pos = (const char*)memmem(m_characters, m_length, needle.characters_without_null_termination(), needle.length()))
+        return pos - m_characters;
+    return {};
+}
+
 Optional<size_t> StringView::find_last_of(char c) const
 {
     for (size_t pos = m_length; --pos > 0;) {
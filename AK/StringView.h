@@ -97,6 +97,8 @@ public:
     Optional<size_t> find_first_of(char) const;
     Optional<size_t> find_first_of(const StringView&) const;
 
+    Optional<size_t> find(const StringView&) const;
+
     Optional<size_t> find_last_of(char) const;
     Optional<size_t> find_last_of(const StringView&) const;
 
@@ -30,35 +30,34 @@
 
 namespace AK {
 
-template<typename... Parameters>
-void warnln(const char* fmtstr, const Parameters&...);
+// The assertion macros are used by headers that are parsed before the formatting code
+// is available, so they report failures through this instead of calling warnln() directly.
+inline void report_assertion_failure(const char* file, int line, const char* message);
 
 }
 
-using AK::warnln;
-
-#define ASSERT(x)                                                                                    \
-    do {                                                                                             \
-        if (!(x))                                                                                    \
-            ::AK::warnln("\033[31;1mFAIL\033[0m: {}:{}: ASSERT({}) failed", __FILE__, __LINE__, #x); \
+#define ASSERT(x)                                                                        \
+    do {                                                                                 \
+        if (!(x))                                                                        \
+            ::AK::report_assertion_failure(__FILE__, __LINE__, "ASSERT(" #x ") failed"); \
     } while (false)
 
-#define RELEASE_ASSERT(x)                                                                                    \
-    do {                                                                                                     \
-        if (!(x))                                                                                            \
-            ::AK::warnln("\033[31;1mFAIL\033[0m: {}:{}: RELEASE_ASSERT({}) failed", __FILE__, __LINE__, #x); \
+#define RELEASE_ASSERT(x)                                                                        \
+    do {                                                                                         \
+        if (!(x))                                                                                \
+            ::AK::report_assertion_failure(__FILE__, __LINE__, "RELEASE_ASSERT(" #x ") failed"); \
     } while (false)
 
-#define ASSERT_NOT_REACHED()                                                                           \
-    do {                                                                                               \
-        ::AK::warnln("\033[31;1mFAIL\033[0m: {}:{}: ASSERT_NOT_REACHED() called", __FILE__, __LINE__); \
-        ::abort();                                                                                     \
+#define ASSERT_NOT_REACHED()                                                               \
+    do {                                                                                   \
+        ::AK::report_assertion_failure(__FILE__, __LINE__, "ASSERT_NOT_REACHED() called"); \
+        ::abort();                                                                         \
     } while (false)
 
-#define TODO()                                                                                   \
-    do {                                                                                         \
-        ::AK::warnln(stderr, "\033[31;1mFAIL\033[0m: {}:{}: TODO() called", __FILE__, __LINE__); \
-        ::abort();                                                                               \
+#define TODO()                                                               \
+    do {                                                                     \
+        ::AK::report_assertion_failure(__FILE__, __LINE__, "TODO() called"); \
+        ::abort();                                                           \
     } while (false)
 
 #include <stdlib.h>
@@ -74,6 +73,11 @@ using AK::warnln;
 
 namespace AK {
 
+inline void report_assertion_failure(const char* file, int line, const char* message)
+{
+    warnln("\033[31;1mFAIL\033[0m: {}:{}: {}", file, line, message);
+}
+
 class TestElapsedTimer {
 public:
     TestElapsedTimer() { restart(); }
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Arena.h>
+#include <AK/NonnullRefPtr.h>
+#include <AK/OwnPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+
+TEST_CASE(allocate_is_aligned)
+{
+    Arena arena(256);
+    for (size_t alignment = 1; alignment <= 64; alignment *= 2) {
+        auto* slot = arena.allocate(3, alignment);
+        EXPECT_EQ((FlatPtr)slot % alignment, 0u);
+    }
+}
+
+TEST_CASE(allocate_large)
+{
+    Arena arena(256);
+    auto* small = (u8*)arena.allocate(8);
+    auto* large = (u8*)arena.allocate(1000);
+    __builtin_memset(large, 0xaa, 1000);
+    EXPECT_EQ(arena.allocated_chunk_count(), 2u);
+
+    // Large allocations don't use up the current chunk.
+    auto* next = (u8*)arena.allocate(8);
+    EXPECT_EQ(next, small + 8);
+    EXPECT_EQ(arena.allocated_chunk_count(), 2u);
+}
+
+static int s_destroyed_in_order = 0;
+static int s_destroyed_out_of_order = 0;
+
+struct Destroyed {
+    explicit Destroyed(int index)
+        : index(index)
+    {
+    }
+    ~Destroyed()
+    {
+        if (index == s_destroyed_in_order - 1 || s_destroyed_in_order == 0)
+            s_destroyed_in_order = index;
+        else
+            ++s_destroyed_out_of_order;
+    }
+    int index;
+};
+
+struct Trivial {
+    int x;
+    int y;
+};
+
+TEST_CASE(make_runs_destructors_in_reverse)
+{
+    {
+        Arena arena(128);
+        for (int i = 1; i <= 100; ++i) {
+            auto& object = arena.make<Destroyed>(i);
+            EXPECT_EQ(object.index, i);
+        }
+        auto& trivial = arena.make<Trivial>(Trivial { 1, 2 });
+        EXPECT_EQ(trivial.y, 2);
+        EXPECT_EQ(s_destroyed_in_order, 0);
+    }
+    EXPECT_EQ(s_destroyed_in_order, 1);
+    EXPECT_EQ(s_destroyed_out_of_order, 0);
+}
+
+static int s_alive = 0;
+
+struct Node
+    : public RefCounted<Node>
+    , public ArenaAllocated {
+    explicit Node(RefPtr<Node> next)
+        : next(move(next))
+    {
+        ++s_alive;
+    }
+    ~Node() { --s_alive; }
+    RefPtr<Node> next;
+};
+
+TEST_CASE(arena_allocated_outlives_arena)
+{
+    RefPtr<Node> list;
+    {
+        Arena arena(1024);
+        Arena::Scope scope(arena);
+        for (int i = 0; i < 100; ++i)
+            list = adopt(*new Node(move(list)));
+        EXPECT(arena.allocated_chunk_count() > 1);
+    }
+    EXPECT_EQ(Arena::current(), nullptr);
+    EXPECT_EQ(s_alive, 100);
+
+    // Nodes made without an arena live on the heap, and can be mixed with the others.
+    list = adopt(*new Node(move(list)));
+    EXPECT_EQ(s_alive, 101);
+    list = nullptr;
+    EXPECT_EQ(s_alive, 0);
+}
+
+struct Leaf : public ArenaAllocated {
+    Leaf() { ++s_alive; }
+    ~Leaf() { --s_alive; }
+};
+
+TEST_CASE(arena_allocated_with_own_ptr)
+{
+    OwnPtr<Leaf> leaf;
+    {
+        Arena arena;
+        Arena::Scope scope(arena);
+        leaf = make<Leaf>();
+    }
+    EXPECT_EQ(s_alive, 1);
+    leaf = nullptr;
+    EXPECT_EQ(s_alive, 0);
+}
+
+TEST_CASE(scopes_nest)
+{
+    Arena outer;
+    Arena inner;
+    {
+        Arena::Scope outer_scope(outer);
+        {
+            Arena::Scope inner_scope(inner);
+            EXPECT_EQ(Arena::current(), &inner);
+        }
+        EXPECT_EQ(Arena::current(), &outer);
+    }
+    EXPECT_EQ(Arena::current(), nullptr);
+}
+
+TEST_MAIN(Arena)
@@ -274,4 +274,32 @@ TEST_CASE(format_nullptr)
     EXPECT_EQ(String::formatted("{}", nullptr), String::formatted("{:p}", static_cast<FlatPtr>(0)));
 }
 
+TEST_CASE(compiled_format_strings)
+{
+    EXPECT(AK::CheckedFormatString<int> { "{:*^8}" }.is_compiled());
+    EXPECT(AK::CheckedFormatString<> { "{{}}" }.is_compiled());
+    EXPECT(!AK::CheckedFormatString<int> { StringView { "{:*^8}" } }.is_compiled());
+
+    // There is room for one field per argument, reusing arguments beyond that is parsed at runtime.
+    EXPECT((AK::CheckedFormatString<int, int> { "{1}{0}" }.is_compiled()));
+    EXPECT(!AK::CheckedFormatString<int> { "{0}{0}" }.is_compiled());
+    EXPECT_EQ(String::formatted("{0}{0}", 7), "77");
+}
+
+TEST_CASE(compiled_and_runtime_format_strings_agree)
+{
+#define EXPECT_SAME_FORMAT(fmtstr, ...) \
+    EXPECT_EQ(String::formatted(fmtstr, __VA_ARGS__), String::formatted(StringView { fmtstr }, __VA_ARGS__))
+
+    EXPECT_SAME_FORMAT("{{{:04}/{}/{0:8}/{1}}}", 42u, "foo");
+    EXPECT_SAME_FORMAT("{:*^ 8}|{:#06x}|{:+d}", 13, -64, 5);
+    EXPECT_SAME_FORMAT("{:*>{1}}|{2:.{3}}", 13, 10, "abcdef", 3);
+    EXPECT_SAME_FORMAT("{:.{}}|{}", "abcdef", 3, 4);
+    EXPECT_SAME_FORMAT("{:{2}}|{:p}", -5, 8, 16);
+    EXPECT_SAME_FORMAT("{:x>5.1}|{:08b}|{:c}", 1.12, 5, 'x');
+    EXPECT_SAME_FORMAT("}}{:>6}{{", true);
+
+#undef EXPECT_SAME_FORMAT
+}
+
 TEST_MAIN(Format)
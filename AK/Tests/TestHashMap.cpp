@@ -193,4 +193,63 @@ TEST_CASE(basic_contains)
     EXPECT_EQ(map.contains(1), false);
 }
 
+TEST_CASE(remove_while_iterating)
+{
+    HashMap<int, int> map;
+    for (int i = 0; i < 1000; ++i)
+        map.set(i, i * 10);
+
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        if (it->key % 2)
+            map.remove(it);
+    }
+    EXPECT_EQ(map.size(), 500u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(map.contains(i), !(i % 2));
+}
+
+struct CollidingTraits : public GenericTraits<int> {
+    // Only a handful of distinct hashes, so that removals have to leave tombstones behind.
+    static unsigned hash(int value) { return value % 5; }
+};
+
+TEST_CASE(removal_and_reinsertion_with_collisions)
+{
+    HashMap<int, int, CollidingTraits> map;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(map.set(i, i + round), AK::HashSetResult::InsertedNewEntry);
+        EXPECT_EQ(map.size(), 100u);
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(map.get(i).value(), i + round);
+        for (int i = 0; i < 100; i += 2)
+            EXPECT_EQ(map.remove(i), true);
+        EXPECT_EQ(map.size(), 50u);
+        for (int i = 0; i < 100; ++i)
+            EXPECT_EQ(map.contains(i), i % 2 == 1);
+        for (int i = 1; i < 100; i += 2)
+            EXPECT_EQ(map.remove(i), true);
+        EXPECT_EQ(map.is_empty(), true);
+        EXPECT(map.capacity() <= 256u);
+    }
+}
+
+TEST_CASE(copy_and_move)
+{
+    HashMap<String, int> map;
+    for (int i = 0; i < 100; ++i)
+        map.set(String::number(i), i);
+
+    auto copy = map;
+    EXPECT_EQ(copy.size(), 100u);
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(copy.get(String::number(i)).value(), i);
+
+    auto moved = move(map);
+    EXPECT_EQ(map.is_empty(), true);
+    EXPECT_EQ(map.begin() == map.end(), true);
+    EXPECT_EQ(moved.size(), 100u);
+    EXPECT_EQ(moved.contains("42"), true);
+}
+
 TEST_MAIN(HashMap)
@@ -29,7 +29,10 @@
 #include <AK/HashMap.h>
 #include <AK/JsonArray.h>
 #include <AK/JsonObject.h>
+#include <AK/JsonStreamParser.h>
 #include <AK/JsonValue.h>
+#include <AK/JsonView.h>
+#include <AK/MemoryStream.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
 
@@ -143,4 +146,199 @@ TEST_CASE(json_duplicate_keys)
     EXPECT_EQ(json.to_string(), "{\"test\":\"baz\"}");
 }
 
+TEST_CASE(json_large_document)
+{
+    // Large enough for the parser to put its strings into an arena.
+    StringBuilder builder;
+    builder.append('[');
+    for (size_t i = 0; i < 10000; ++i) {
+        if (i)
+            builder.append(',');
+        builder.appendf("{\"key\":\"value %zu\"}", i);
+    }
+    builder.append(']');
+    EXPECT(builder.length() >= 64 * KiB);
+
+    String kept_value;
+    {
+        auto json = JsonValue::from_string(builder.to_string()).value();
+        EXPECT_EQ(json.as_array().size(), 10000);
+        EXPECT_EQ(json.as_array().at(1234).as_object().get("key").as_string(), "value 1234");
+        kept_value = json.as_array().at(9999).as_object().get("key").as_string();
+    }
+    EXPECT_EQ(kept_value, "value 9999");
+}
+
+// Hands out one byte at a time, so that every token straddles a read.
+class TrickleStream final : public InputStream {
+public:
+    explicit TrickleStream(const StringView& string)
+        : m_bytes(string.bytes())
+    {
+    }
+
+    size_t read(Bytes bytes) override
+    {
+        if (bytes.is_empty() || m_offset == m_bytes.size())
+            return 0;
+        bytes[0] = m_bytes[m_offset++];
+        return 1;
+    }
+    bool unreliable_eof() const override { return m_offset == m_bytes.size(); }
+    bool read_or_error(Bytes) override { ASSERT_NOT_REACHED(); }
+    bool discard_or_error(size_t) override { ASSERT_NOT_REACHED(); }
+
+private:
+    ReadonlyBytes m_bytes;
+    size_t m_offset { 0 };
+};
+
+static String describe_tokens(InputStream& stream)
+{
+    JsonStreamParser parser(stream);
+    StringBuilder builder;
+    for (;;) {
+        auto token = parser.next();
+        switch (token.type) {
+        case JsonStreamParser::TokenType::StartObject:
+            builder.append('{');
+            break;
+        case JsonStreamParser::TokenType::EndObject:
+            builder.append('}');
+            break;
+        case JsonStreamParser::TokenType::StartArray:
+            builder.append('[');
+            break;
+        case JsonStreamParser::TokenType::EndArray:
+            builder.append(']');
+            break;
+        case JsonStreamParser::TokenType::Key:
+            builder.appendff("K({})", token.text);
+            break;
+        case JsonStreamParser::TokenType::String:
+            builder.appendff("S({})", token.text);
+            break;
+        case JsonStreamParser::TokenType::Number:
+            builder.appendff("N({})", token.number().value().to_i32());
+            break;
+        case JsonStreamParser::TokenType::True:
+            builder.append("T");
+            break;
+        case JsonStreamParser::TokenType::False:
+            builder.append("F");
+            break;
+        case JsonStreamParser::TokenType::Null:
+            builder.append("0");
+            break;
+        case JsonStreamParser::TokenType::EndOfDocument:
+            return builder.to_string();
+        case JsonStreamParser::TokenType::Error:
+            builder.append("!");
+            return builder.to_string();
+        }
+    }
+}
+
+static const char* s_sample_document = R"({ "name": "Serenity\nOS", "pid": 42, "load": -1.5, "tags": [ "a", "bé", true, false, null ], "empty": {}, "nested": [[], [1]] })";
+static const char* s_sample_tokens = "{K(name)S(Serenity\nOS)K(pid)N(42)K(load)N(-1)K(tags)[S(a)S(bé)TF0]K(empty){}K(nested)[[][N(1)]]}";
+
+TEST_CASE(json_stream_parser)
+{
+    StringView document = s_sample_document;
+    InputMemoryStream memory_stream { document.bytes() };
+    EXPECT_EQ(describe_tokens(memory_stream), s_sample_tokens);
+    TrickleStream trickle_stream { document };
+    EXPECT_EQ(describe_tokens(trickle_stream), s_sample_tokens);
+}
+
+TEST_CASE(json_stream_parser_errors)
+{
+    auto tokens_for = [](const StringView& document) {
+        InputMemoryStream stream { document.bytes() };
+        return describe_tokens(stream);
+    };
+    EXPECT_EQ(tokens_for("[1, 2,]"), "[N(1)N(2)!");
+    EXPECT_EQ(tokens_for("{\"a\": 1]"), "{K(a)N(1)!");
+    EXPECT_EQ(tokens_for("[\"unterminated"), "[!");
+    EXPECT_EQ(tokens_for("1 2"), "N(1)!");
+    EXPECT_EQ(tokens_for("{\"a\" 1}"), "{!");
+    EXPECT_EQ(tokens_for(""), "!");
+}
+
+// JsonStreamParser reads the stream in chunks of this many bytes.
+static constexpr size_t stream_parser_buffer_size = 4096;
+
+TEST_CASE(json_stream_parser_key_at_buffer_boundary)
+{
+    // The closing quote of the key is the last byte of the first chunk, and the ':' is in the next.
+    String key = String::repeated('k', stream_parser_buffer_size - 3);
+    String document = String::formatted("{{\"{}\"   : 1}}", key);
+    EXPECT_EQ(document.index_of(":").value(), stream_parser_buffer_size + 3);
+
+    InputMemoryStream stream { document.bytes() };
+    EXPECT_EQ(describe_tokens(stream), String::formatted("{{K({})N(1)}}", key));
+}
+
+TEST_CASE(json_stream_parser_escape_across_buffer_boundary)
+{
+    // The hex digits of the \u escape start with the last byte of the first chunk.
+    String padding = String::repeated('a', stream_parser_buffer_size - 5);
+    String document = String::formatted("[\"{}\\u00e9b\"]", padding);
+    EXPECT_EQ(document.index_of("\\").value(), stream_parser_buffer_size - 3);
+
+    InputMemoryStream stream { document.bytes() };
+    EXPECT_EQ(describe_tokens(stream), String::formatted("[S({}éb)]", padding));
+}
+
+TEST_CASE(json_stream_parser_skip_value)
+{
+    StringView document = R"([{ "skip": [1, {"x": [2]}], "keep": 3 }])";
+    InputMemoryStream stream { document.bytes() };
+    JsonStreamParser parser(stream);
+    EXPECT_EQ(parser.next().type, JsonStreamParser::TokenType::StartArray);
+    EXPECT_EQ(parser.next().type, JsonStreamParser::TokenType::StartObject);
+    EXPECT_EQ(parser.next().text, "skip");
+    EXPECT(parser.skip_value(parser.next()));
+    EXPECT_EQ(parser.next().text, "keep");
+    EXPECT_EQ(parser.next().number().value().to_i32(), 3);
+    EXPECT_EQ(parser.next().type, JsonStreamParser::TokenType::EndObject);
+}
+
+TEST_CASE(json_document_view)
+{
+    auto document = JsonDocumentView::parse(s_sample_document);
+    EXPECT(document.has_value());
+    auto root = document.value().root();
+    EXPECT(root.is_object());
+    EXPECT_EQ(root.size(), 6u);
+    EXPECT(root.get("name").string_needs_unescaping());
+    EXPECT_EQ(root.get("name").as_string(), "Serenity\nOS");
+    EXPECT_EQ(root.get("pid").to_u32(), 42u);
+    EXPECT_EQ(root.get("load").to_double(), -1.5);
+    EXPECT(root.get("missing").is_null());
+    EXPECT_EQ(root.get("missing").to_u32(7), 7u);
+    EXPECT_EQ(root.has("empty"), true);
+    EXPECT_EQ(root.get("empty").size(), 0u);
+
+    auto tags = root.get("tags");
+    EXPECT_EQ(tags.size(), 5u);
+    EXPECT_EQ(tags.at(0).as_string_view(), "a");
+    EXPECT_EQ(tags.at(1).as_string(), "bé");
+    EXPECT_EQ(tags.at(2).to_bool(), true);
+    EXPECT_EQ(tags.at(3).to_bool(true), false);
+    EXPECT(tags.at(4).is_null());
+    EXPECT_EQ(root.get("nested").to_string(), "[[], [1]]");
+
+    // Views point straight into the source text.
+    StringView source = s_sample_document;
+    auto pid_text = root.get("pid").source_text();
+    EXPECT(pid_text.characters_without_null_termination() > source.characters_without_null_termination());
+    EXPECT(pid_text.characters_without_null_termination() < source.characters_without_null_termination() + source.length());
+
+    EXPECT_EQ(root.to_json_value().to_string(), JsonValue::from_string(s_sample_document).value().to_string());
+
+    EXPECT(!JsonDocumentView::parse("[1, 2,]").has_value());
+    EXPECT(!JsonDocumentView::parse("{\"a\": }").has_value());
+}
+
 TEST_MAIN(JSON)
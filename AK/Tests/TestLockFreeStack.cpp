@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Atomic.h>
+#include <AK/LockFreeStack.h>
+#include <pthread.h>
+
+TEST_CASE(push_and_pop)
+{
+    LockFreeStack<int> stack;
+    EXPECT(stack.is_empty());
+    EXPECT(!stack.pop().has_value());
+
+    for (int i = 0; i < 10; ++i)
+        stack.push(i);
+    EXPECT(!stack.is_empty());
+    for (int i = 9; i >= 0; --i)
+        EXPECT_EQ(stack.pop().value(), i);
+    EXPECT(stack.is_empty());
+}
+
+static Atomic<int> s_alive { 0 };
+
+struct Tracked {
+    Tracked() { ++s_alive; }
+    Tracked(const Tracked&) { ++s_alive; }
+    Tracked(Tracked&&) { ++s_alive; }
+    ~Tracked() { --s_alive; }
+};
+
+TEST_CASE(frees_everything)
+{
+    {
+        LockFreeStack<Tracked> stack;
+        for (int i = 0; i < 1000; ++i)
+            stack.push(Tracked());
+        for (int i = 0; i < 600; ++i)
+            [[maybe_unused]] auto value = stack.pop();
+    }
+    EXPECT_EQ(s_alive.load(), 0);
+}
+
+TEST_CASE(hazard_pointer_protects_retired_object)
+{
+    static Atomic<int> s_deleted { 0 };
+    struct Object {
+        ~Object() { ++s_deleted; }
+    };
+
+    HazardPointerDomain domain;
+    auto* object = new Object;
+    Atomic<Object*> shared { object };
+    {
+        HazardPointer hazard(domain);
+        EXPECT_EQ(hazard.protect(shared), object);
+
+        shared.store(nullptr);
+        domain.retire(object);
+        domain.reclaim();
+        EXPECT_EQ(s_deleted.load(), 0);
+    }
+    domain.reclaim();
+    EXPECT_EQ(s_deleted.load(), 1);
+}
+
+static constexpr int thread_count = 8;
+static constexpr int operations_per_thread = 20'000;
+static LockFreeStack<int> s_stress_stack;
+static Atomic<i64> s_pushed_sum { 0 };
+static Atomic<i64> s_popped_sum { 0 };
+
+static void* stress_thread(void* argument)
+{
+    int thread = (int)(FlatPtr)argument;
+    for (int i = 0; i < operations_per_thread; ++i) {
+        int value = thread * operations_per_thread + i;
+        s_stress_stack.push(value);
+        s_pushed_sum += value;
+        if (i % 2) {
+            if (auto popped = s_stress_stack.pop(); popped.has_value())
+                s_popped_sum += popped.value();
+        }
+    }
+    return nullptr;
+}
+
+TEST_CASE(stress_concurrent_push_and_pop)
+{
+    pthread_t threads[thread_count];
+    for (int i = 0; i < thread_count; ++i)
+        pthread_create(&threads[i], nullptr, stress_thread, (void*)(FlatPtr)i);
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+
+    while (!s_stress_stack.is_empty())
+        s_popped_sum += s_stress_stack.pop().value();
+    EXPECT_EQ(s_popped_sum.load(), s_pushed_sum.load());
+}
+
+TEST_MAIN(LockFreeStack)
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Atomic.h>
+#include <AK/MPMCQueue.h>
+#include <AK/String.h>
+#include <pthread.h>
+#include <sched.h>
+
+TEST_CASE(enqueue_and_dequeue)
+{
+    MPMCQueue<int, 4> queue;
+    EXPECT(queue.is_empty());
+    EXPECT(!queue.try_dequeue().has_value());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT(queue.try_enqueue(i));
+    EXPECT(!queue.try_enqueue(4));
+    EXPECT_EQ(queue.size(), 4u);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(queue.try_dequeue().value(), i);
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(wraps_around_with_non_trivial_type)
+{
+    MPMCQueue<String, 8> queue;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 5; ++i)
+            EXPECT(queue.try_enqueue(String::number(round * 5 + i)));
+        for (int i = 0; i < 5; ++i)
+            EXPECT_EQ(queue.try_dequeue().value(), String::number(round * 5 + i));
+    }
+    EXPECT(queue.try_enqueue("left behind"));
+}
+
+static constexpr u32 producer_count = 4;
+static constexpr u32 consumer_count = 4;
+static constexpr u32 items_per_producer = 50'000;
+static MPMCQueue<u32, 1024> s_stress_queue;
+static Atomic<u32> s_consumed { 0 };
+static Atomic<u64> s_consumed_sum { 0 };
+static Atomic<bool> s_out_of_order { false };
+
+static void* stress_producer(void* argument)
+{
+    u32 producer = (u32)(FlatPtr)argument;
+    for (u32 i = 0; i < items_per_producer;) {
+        if (s_stress_queue.try_enqueue(producer * items_per_producer + i))
+            ++i;
+        else
+            sched_yield();
+    }
+    return nullptr;
+}
+
+static void* stress_consumer(void*)
+{
+    // Items from any one producer must come out in the order they went in.
+    u32 last_seen[producer_count];
+    bool seen_any[producer_count] = {};
+    while (s_consumed.load() < producer_count * items_per_producer) {
+        auto value = s_stress_queue.try_dequeue();
+        if (!value.has_value()) {
+            sched_yield();
+            continue;
+        }
+        u32 producer = value.value() / items_per_producer;
+        if (seen_any[producer] && value.value() <= last_seen[producer])
+            s_out_of_order = true;
+        seen_any[producer] = true;
+        last_seen[producer] = value.value();
+        s_consumed_sum.fetch_add(value.value());
+        ++s_consumed;
+    }
+    return nullptr;
+}
+
+TEST_CASE(stress_many_producers_many_consumers)
+{
+    pthread_t threads[producer_count + consumer_count];
+    for (u32 i = 0; i < consumer_count; ++i)
+        pthread_create(&threads[i], nullptr, stress_consumer, nullptr);
+    for (u32 i = 0; i < producer_count; ++i)
+        pthread_create(&threads[consumer_count + i], nullptr, stress_producer, (void*)(FlatPtr)i);
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+
+    u64 item_count = producer_count * items_per_producer;
+    EXPECT_EQ(s_consumed.load(), item_count);
+    EXPECT_EQ(s_consumed_sum.load(), item_count * (item_count - 1) / 2);
+    EXPECT(!s_out_of_order.load());
+    EXPECT(s_stress_queue.is_empty());
+}
+
+TEST_MAIN(MPMCQueue)
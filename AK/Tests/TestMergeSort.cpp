@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/MergeSort.h>
+#include <AK/Noncopyable.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+
+struct Item {
+    int key;
+    int order;
+};
+
+static u32 next_random(u32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+TEST_CASE(sorts)
+{
+    u32 state = 0xcafe;
+    for (size_t size : { 0, 1, 2, 16, 17, 33, 1000, 12345 }) {
+        Vector<int> values;
+        for (size_t i = 0; i < size; ++i)
+            values.append(next_random(state) % 10000);
+
+        merge_sort(values);
+
+        EXPECT_EQ(values.size(), size);
+        for (size_t i = 1; i < values.size(); ++i)
+            EXPECT(values[i - 1] <= values[i]);
+    }
+}
+
+TEST_CASE(is_stable)
+{
+    u32 state = 0xbeef;
+    Vector<Item> items;
+    for (int i = 0; i < 5000; ++i)
+        items.append({ (int)(next_random(state) % 20), i });
+
+    merge_sort(items, [](auto& a, auto& b) { return a.key < b.key; });
+
+    for (size_t i = 1; i < items.size(); ++i) {
+        EXPECT(items[i - 1].key <= items[i].key);
+        if (items[i - 1].key == items[i].key)
+            EXPECT(items[i - 1].order < items[i].order);
+    }
+}
+
+TEST_CASE(sorts_strings)
+{
+    Vector<String> strings { "pear", "apple", "fig", "banana", "apple", "cherry" };
+    merge_sort(strings);
+
+    Vector<String> expected { "apple", "apple", "banana", "cherry", "fig", "pear" };
+    EXPECT_EQ(strings.size(), expected.size());
+    for (size_t i = 0; i < strings.size(); ++i)
+        EXPECT_EQ(strings[i], expected[i]);
+}
+
+TEST_CASE(sorts_without_copy)
+{
+    struct NoCopy {
+        AK_MAKE_NONCOPYABLE(NoCopy);
+
+    public:
+        explicit NoCopy(int v)
+            : value(v)
+        {
+        }
+        NoCopy(NoCopy&&) = default;
+
+        NoCopy& operator=(NoCopy&&) = default;
+
+        int value { 0 };
+    };
+
+    Vector<NoCopy> values;
+    for (int i = 0; i < 100; ++i)
+        values.append(NoCopy((100 - i) % 32));
+
+    merge_sort(values, [](auto& a, auto& b) { return a.value < b.value; });
+
+    for (size_t i = 1; i < values.size(); ++i)
+        EXPECT(values[i - 1].value <= values[i].value);
+}
+
+TEST_MAIN(MergeSort)
@@ -30,6 +30,34 @@
 #include <AK/Noncopyable.h>
 #include <AK/QuickSort.h>
 #include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+
+static u32 next_random(u32& state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static bool is_sorted(const Vector<int>& values)
+{
+    for (size_t i = 1; i < values.size(); ++i) {
+        if (values[i] < values[i - 1])
+            return false;
+    }
+    return true;
+}
+
+static size_t sort_and_count_comparisons(Vector<int>& values)
+{
+    size_t comparisons = 0;
+    intro_sort(values, 0, values.size() - 1, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+    return comparisons;
+}
 
 TEST_CASE(sorts_without_copy)
 {
@@ -55,4 +83,69 @@ TEST_CASE(sorts_without_copy)
         EXPECT(array[i].value <= array[i + 1].value);
 }
 
+TEST_CASE(intro_sort_random)
+{
+    u32 state = 0x12345678;
+    for (size_t size : { 0, 1, 2, 3, 15, 16, 17, 100, 1000, 10000 }) {
+        Vector<int> values;
+        i64 sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            values.append(next_random(state) % 1000);
+            sum += values.last();
+        }
+
+        intro_sort(values, 0, values.size() - 1, [](int a, int b) { return a < b; });
+
+        EXPECT_EQ(values.size(), size);
+        EXPECT(is_sorted(values));
+        for (auto value : values)
+            sum -= value;
+        EXPECT_EQ(sum, 0);
+    }
+}
+
+TEST_CASE(intro_sort_is_n_log_n_on_hostile_inputs)
+{
+    constexpr int size = 100000;
+    // 2 * n * log2(n) is a generous bound for a well-behaved sort, and far
+    // below the ~n^2 / 2 comparisons a degenerate quick sort would need.
+    constexpr size_t max_comparisons = 2 * size * 17;
+
+    Vector<int> all_equal;
+    Vector<int> sorted;
+    Vector<int> reversed;
+    Vector<int> organ_pipe;
+    Vector<int> two_values;
+    for (int i = 0; i < size; ++i) {
+        all_equal.append(42);
+        sorted.append(i);
+        reversed.append(size - i);
+        organ_pipe.append(i < size / 2 ? i : size - i);
+        two_values.append(i % 2);
+    }
+
+    for (auto* values : { &all_equal, &sorted, &reversed, &organ_pipe, &two_values }) {
+        EXPECT(sort_and_count_comparisons(*values) < max_comparisons);
+        EXPECT(is_sorted(*values));
+    }
+}
+
+TEST_CASE(quick_sort_uses_intro_sort)
+{
+    Vector<int> values;
+    for (int i = 0; i < 50000; ++i)
+        values.append(7);
+    values.append(3);
+
+    size_t comparisons = 0;
+    quick_sort(values, [&](int a, int b) {
+        ++comparisons;
+        return a < b;
+    });
+
+    EXPECT_EQ(values.first(), 3);
+    EXPECT(is_sorted(values));
+    EXPECT(comparisons < 50000u * 32);
+}
+
 TEST_MAIN(QuickSort)
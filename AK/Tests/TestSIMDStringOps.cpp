@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/SIMDStringOps.h>
+#include <AK/Vector.h>
+
+using AK::SIMD::u8x16;
+using AK::SIMD::u8x32;
+
+// Every size and alignment up to a few vectors, so that all the head and tail paths get exercised.
+static constexpr size_t max_test_length = 100;
+
+template<typename VectorType>
+static void test_find_byte()
+{
+    Vector<u8> buffer;
+    buffer.resize(max_test_length + 32);
+    for (size_t start = 0; start < 32; ++start) {
+        for (size_t length = 0; length < max_test_length; ++length) {
+            for (auto& byte : buffer)
+                byte = 'a';
+            auto* data = buffer.data() + start;
+            EXPECT_EQ(AK::SIMD::find_byte<VectorType>(data, length, 'b'), nullptr);
+            if (!length)
+                continue;
+            data[length - 1] = 'b';
+            data[length / 2] = 'b';
+            EXPECT_EQ(AK::SIMD::find_byte<VectorType>(data, length, 'b'), data + length / 2);
+            // Bytes right after the end must not be found.
+            data[length / 2] = 'a';
+            data[length - 1] = 'a';
+            data[length] = 'b';
+            EXPECT_EQ(AK::SIMD::find_byte<VectorType>(data, length, 'b'), nullptr);
+        }
+    }
+}
+
+TEST_CASE(find_byte)
+{
+    test_find_byte<u8x16>();
+    test_find_byte<u8x32>();
+}
+
+template<typename VectorType>
+static void test_strings()
+{
+    Vector<char> buffer;
+    buffer.resize(max_test_length + 32);
+    for (size_t start = 0; start < 32; ++start) {
+        for (size_t length = 0; length < max_test_length; ++length) {
+            for (auto& character : buffer)
+                character = 'a';
+            auto* string = buffer.data() + start;
+            string[length] = 0;
+            EXPECT_EQ(AK::SIMD::string_length<VectorType>(string), length);
+            EXPECT_EQ(AK::SIMD::find_byte_or_terminator<VectorType>(string, 'b'), string + length);
+            EXPECT_EQ(AK::SIMD::find_byte_or_terminator<VectorType>(string, 0), string + length);
+            if (!length)
+                continue;
+            string[length - 1] = 'b';
+            EXPECT_EQ(AK::SIMD::find_byte_or_terminator<VectorType>(string, 'b'), string + length - 1);
+        }
+    }
+}
+
+TEST_CASE(string_length_and_find)
+{
+    test_strings<u8x16>();
+    test_strings<u8x32>();
+}
+
+template<typename VectorType>
+static void test_compare_copy_fill()
+{
+    Vector<u8> a;
+    Vector<u8> b;
+    a.resize(max_test_length);
+    b.resize(max_test_length);
+    for (size_t length = 0; length < max_test_length; ++length) {
+        AK::SIMD::fill<VectorType>(a.data(), 'x', max_test_length);
+        AK::SIMD::fill<VectorType>(b.data(), 'y', max_test_length);
+        AK::SIMD::copy<VectorType>(b.data(), a.data(), length);
+        EXPECT_EQ(AK::SIMD::compare<VectorType>(a.data(), b.data(), length), 0);
+        if (length < max_test_length)
+            EXPECT_EQ(b[length], 'y');
+        for (size_t i = 0; i < length; ++i) {
+            b[i] = 'w';
+            EXPECT_EQ(AK::SIMD::compare<VectorType>(a.data(), b.data(), length), 1);
+            b[i] = 'z';
+            EXPECT_EQ(AK::SIMD::compare<VectorType>(a.data(), b.data(), length), -1);
+            b[i] = 'x';
+        }
+    }
+}
+
+TEST_CASE(compare_copy_fill)
+{
+    test_compare_copy_fill<u8x16>();
+    test_compare_copy_fill<u8x32>();
+}
+
+template<typename VectorType>
+static void test_find_substring()
+{
+    const u8 needle[] = { 'a', 'b', 'a', 'c' };
+    Vector<u8> haystack;
+    haystack.resize(max_test_length);
+    for (size_t length = 0; length < max_test_length; ++length) {
+        for (size_t i = 0; i < length; ++i)
+            haystack[i] = "ab"[i % 2];
+        EXPECT_EQ(AK::SIMD::find_substring<VectorType>(haystack.data(), length, needle, sizeof(needle)), nullptr);
+        EXPECT_EQ(AK::SIMD::find_substring<VectorType>(haystack.data(), length, needle, 0), haystack.data());
+        if (length < sizeof(needle))
+            continue;
+        for (size_t offset = 0; offset + sizeof(needle) <= length; ++offset) {
+            __builtin_memcpy(haystack.data() + offset, needle, sizeof(needle));
+            EXPECT_EQ(AK::SIMD::find_substring<VectorType>(haystack.data(), length, needle, sizeof(needle)), haystack.data() + offset);
+            EXPECT_EQ(AK::SIMD::find_substring<VectorType>(haystack.data(), length, needle + 3, 1), haystack.data() + offset + 3);
+            for (size_t i = offset; i < offset + sizeof(needle); ++i)
+                haystack[i] = "ab"[i % 2];
+        }
+    }
+}
+
+TEST_CASE(find_substring)
+{
+    test_find_substring<u8x16>();
+    test_find_substring<u8x32>();
+}
+
+TEST_MAIN(SIMDStringOps)
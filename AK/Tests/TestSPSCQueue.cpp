@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/NonnullRefPtr.h>
+#include <AK/RefCounted.h>
+#include <AK/SPSCQueue.h>
+#include <pthread.h>
+#include <sched.h>
+
+TEST_CASE(enqueue_and_dequeue)
+{
+    SPSCQueue<int, 4> queue;
+    EXPECT(queue.is_empty());
+    EXPECT(!queue.try_dequeue().has_value());
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT(queue.try_enqueue(i));
+    EXPECT(!queue.try_enqueue(4));
+    EXPECT_EQ(queue.size(), 4u);
+
+    for (int i = 0; i < 4; ++i)
+        EXPECT_EQ(queue.try_dequeue().value(), i);
+    EXPECT(queue.is_empty());
+}
+
+TEST_CASE(wraps_around)
+{
+    SPSCQueue<int, 8> queue;
+    for (int round = 0; round < 100; ++round) {
+        for (int i = 0; i < 5; ++i)
+            EXPECT(queue.try_enqueue(round * 5 + i));
+        for (int i = 0; i < 5; ++i)
+            EXPECT_EQ(queue.try_dequeue().value(), round * 5 + i);
+    }
+}
+
+struct Counted : public RefCounted<Counted> {
+    static int s_alive;
+    Counted() { ++s_alive; }
+    ~Counted() { --s_alive; }
+};
+int Counted::s_alive = 0;
+
+TEST_CASE(destroys_remaining_elements)
+{
+    {
+        SPSCQueue<NonnullRefPtr<Counted>, 8> queue;
+        for (int i = 0; i < 6; ++i)
+            EXPECT(queue.try_enqueue(adopt(*new Counted)));
+        EXPECT(queue.try_dequeue().has_value());
+        EXPECT_EQ(Counted::s_alive, 5);
+    }
+    EXPECT_EQ(Counted::s_alive, 0);
+}
+
+static constexpr u32 stress_item_count = 200'000;
+static SPSCQueue<u32, 256> s_stress_queue;
+
+static void* stress_producer(void*)
+{
+    for (u32 i = 0; i < stress_item_count;) {
+        if (s_stress_queue.try_enqueue(i))
+            ++i;
+        else
+            sched_yield();
+    }
+    return nullptr;
+}
+
+TEST_CASE(stress_one_producer_one_consumer)
+{
+    pthread_t producer;
+    pthread_create(&producer, nullptr, stress_producer, nullptr);
+
+    u32 expected = 0;
+    bool in_order = true;
+    while (expected < stress_item_count) {
+        auto value = s_stress_queue.try_dequeue();
+        if (!value.has_value()) {
+            sched_yield();
+            continue;
+        }
+        in_order &= value.value() == expected;
+        ++expected;
+    }
+    pthread_join(producer, nullptr);
+
+    EXPECT(in_order);
+    EXPECT(s_stress_queue.is_empty());
+}
+
+TEST_MAIN(SPSCQueue)
@@ -29,6 +29,7 @@
 #include <AK/FlyString.h>
 #include <AK/String.h>
 #include <AK/StringBuilder.h>
+#include <AK/StringImplArena.h>
 #include <cstring>
 
 TEST_CASE(construct_empty)
@@ -256,4 +257,36 @@ TEST_CASE(sprintf)
     EXPECT_EQ(String(buf2), String("-12"));
 }
 
+TEST_CASE(single_character_strings_are_shared)
+{
+    String a = "x";
+    String b = String::formatted("{}", 'x');
+    EXPECT_EQ(a.impl(), b.impl());
+    EXPECT_EQ(b, "x");
+    EXPECT_EQ(String("xy").substring(1).impl(), String("y").impl());
+}
+
+TEST_CASE(arena_allocated_strings)
+{
+    Vector<String> strings;
+    {
+        StringImplArena arena;
+        {
+            StringImplArena::Scope scope(arena);
+            for (int i = 0; i < 100; ++i)
+                strings.append(String::formatted("string number {}", i));
+        }
+        EXPECT_EQ(arena.allocated_chunk_count(), 1u);
+        EXPECT_EQ(StringImplArena::current(), nullptr);
+
+        strings.append(String::formatted("made outside the arena"));
+        EXPECT_EQ(arena.allocated_chunk_count(), 1u);
+    }
+
+    // The strings outlive the arena, and get cleaned up as usual when they go away.
+    for (int i = 0; i < 100; ++i)
+        EXPECT_EQ(strings[i], String::formatted("string number {}", i));
+    strings.clear();
+}
+
 TEST_MAIN(String)
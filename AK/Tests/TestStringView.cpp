@@ -136,6 +136,24 @@ TEST_CASE(find_first_of)
     EXPECT_EQ(test_string_view.find_first_of("defg").has_value(), false);
 }
 
+TEST_CASE(find)
+{
+    String test_string = "aabbcc_xy_ccbbaa_xyz";
+    StringView test_string_view = test_string.view();
+
+    EXPECT_EQ(test_string_view.find("bb").value(), 2U);
+    EXPECT_EQ(test_string_view.find("xyz").value(), 17U);
+    EXPECT_EQ(test_string_view.find("aa_xyz").value(), 14U);
+    EXPECT_EQ(test_string_view.find("").value(), 0U);
+    EXPECT_EQ(test_string_view.find("xyzw").has_value(), false);
+    EXPECT_EQ(test_string_view.find("aabbcc_xy_ccbbaa_xyz_").has_value(), false);
+
+    String long_string = String::formatted("{}needle{}", String::repeated('a', 200), String::repeated('a', 200));
+    EXPECT_EQ(long_string.view().find("needle").value(), 200U);
+    EXPECT_EQ(long_string.view().find("aneedlea").value(), 199U);
+    EXPECT_EQ(long_string.view().find("needles").has_value(), false);
+}
+
 TEST_CASE(find_last_of)
 {
     String test_string = "aabbcc_xy_ccbbaa";
@@ -46,8 +46,11 @@ namespace Spreadsheet {
 static JS::VM& global_vm()
 {
     static RefPtr<JS::VM> vm;
-    if (!vm)
+    if (!vm) {
         vm = JS::VM::create();
+        // Spreadsheet pledges "thread", so large sheets can be marked with all processors.
+        vm->heap().set_marking_thread_count(0);
+    }
     return *vm;
 }
 
@@ -46,6 +46,8 @@ struct Message {
     bool is_synchronous { false };
     Vector<Parameter> inputs;
     Vector<Parameter> outputs;
+    Vector<String> coalesce_keys;
+    bool is_coalescible { false };
 
     String response_name() const
     {
@@ -137,9 +139,36 @@ int main(int argc, char** argv)
         }
     };
 
+    auto parse_message_attributes = [&](Message& message) {
+        if (!lexer.consume_specific('['))
+            return;
+        consume_whitespace();
+        auto attribute = lexer.consume_until([](char ch) { return isspace(ch) || ch == '(' || ch == ']'; });
+        if (attribute != "Coalesce") {
+            warnln("Unknown message attribute '{}' at index {}", attribute, lexer.tell());
+            exit(1);
+        }
+        message.is_coalescible = true;
+        consume_whitespace();
+        if (lexer.consume_specific('(')) {
+            for (;;) {
+                consume_whitespace();
+                if (lexer.consume_specific(')'))
+                    break;
+                message.coalesce_keys.append(lexer.consume_until([](char ch) { return isspace(ch) || ch == ',' || ch == ')'; }));
+                consume_whitespace();
+                lexer.consume_specific(',');
+            }
+            consume_whitespace();
+        }
+        assert_specific(']');
+        consume_whitespace();
+    };
+
     auto parse_message = [&] {
         Message message;
         consume_whitespace();
+        parse_message_attributes(message);
         message.name = lexer.consume_until([](char ch) { return isspace(ch) || ch == '('; });
         consume_whitespace();
         assert_specific('(');
@@ -166,6 +195,20 @@ int main(int argc, char** argv)
 
         consume_whitespace();
 
+        if (message.is_coalescible) {
+            // A synchronous request can't be dropped, since someone is waiting for its response.
+            if (message.is_synchronous) {
+                warnln("Synchronous message '{}' can't be coalesced", message.name);
+                exit(1);
+            }
+            for (auto& key : message.coalesce_keys) {
+                if (!message.inputs.first_matching([&](auto& parameter) { return parameter.name == key; }).has_value()) {
+                    warnln("Message '{}' is coalesced by unknown parameter '{}'", message.name, key);
+                    exit(1);
+                }
+            }
+        }
+
         endpoints.last().messages.append(move(message));
     };
 
@@ -293,7 +336,7 @@ enum class MessageID : i32 {
             return builder.to_string();
         };
 
-        auto do_message = [&](const String& name, const Vector<Parameter>& parameters, const String& response_type = {}) {
+        auto do_message = [&](const String& name, const Vector<Parameter>& parameters, const String& response_type = {}, const Message* coalescible_message = nullptr) {
             auto message_generator = endpoint_generator.fork();
             message_generator.set("message.name", name);
             message_generator.set("message.response_type", response_type);
@@ -386,6 +429,50 @@ public:
     }
 )~~~");
 
+            if (coalescible_message) {
+                message_generator.append(R"~~~(
+    virtual bool is_coalescible() const override { return true; }
+
+    virtual bool try_coalesce_into(IPC::Message& other) const override
+    {
+        if (other.endpoint_magic() != @endpoint.magic@ || other.message_id() != (int)MessageID::@message.name@)
+            return false;
+)~~~");
+                auto is_merged_parameter = [&](auto& parameter) {
+                    return parameter.type.starts_with("Vector<") && !coalescible_message->coalesce_keys.contains_slow(parameter.name);
+                };
+                bool has_merged_parameters = false;
+                for (auto& parameter : parameters)
+                    has_merged_parameters |= is_merged_parameter(parameter);
+                if (!coalescible_message->coalesce_keys.is_empty() || has_merged_parameters) {
+                    message_generator.append(R"~~~(
+        auto& later = static_cast<@message.name@&>(other);
+)~~~");
+                }
+                for (auto& key : coalescible_message->coalesce_keys) {
+                    auto key_generator = message_generator.fork();
+                    key_generator.set("key.name", key);
+                    key_generator.append(R"~~~(
+        if (!(later.m_@key.name@ == m_@key.name@))
+            return false;
+)~~~");
+                }
+                // The later message's values win, except that lists (such as dirty rects) are merged.
+                for (auto& parameter : parameters) {
+                    if (!is_merged_parameter(parameter))
+                        continue;
+                    auto parameter_generator = message_generator.fork();
+                    parameter_generator.set("parameter.name", parameter.name);
+                    parameter_generator.append(R"~~~(
+        later.m_@parameter.name@.prepend(m_@parameter.name@.data(), m_@parameter.name@.size());
+)~~~");
+                }
+                message_generator.append(R"~~~(
+        return true;
+    }
+)~~~");
+            }
+
             for (auto& parameter : parameters) {
                 auto parameter_generator = message_generator.fork();
                 parameter_generator.set("parameter.type", parameter.type);
@@ -418,7 +505,7 @@ private:
                 response_name = message.response_name();
                 do_message(response_name, message.outputs);
             }
-            do_message(message.name, message.inputs, response_name);
+            do_message(message.name, message.inputs, response_name, message.is_coalescible ? &message : nullptr);
         }
 
         endpoint_generator.append(R"~~~(
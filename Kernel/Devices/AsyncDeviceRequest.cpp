@@ -26,6 +26,7 @@
 
 #include <Kernel/Devices/AsyncDeviceRequest.h>
 #include <Kernel/Devices/Device.h>
+#include <Kernel/Tracing.h>
 
 namespace Kernel {
 
@@ -33,6 +34,8 @@ AsyncDeviceRequest::AsyncDeviceRequest(Device& device)
     : m_device(device)
     , m_process(*Process::current())
 {
+    if (Tracing::is_enabled())
+        m_start_ns = Tracing::now_ns();
 }
 
 AsyncDeviceRequest::~AsyncDeviceRequest()
@@ -161,6 +164,9 @@ void AsyncDeviceRequest::complete(RequestResult result)
         ASSERT(m_result == Started);
         m_result = result;
     }
+    // Sub-requests are accounted for as part of the request they belong to.
+    if (m_start_ns && !m_parent_request)
+        Tracing::record(Tracing::Tracepoint::DeviceRequest, Tracing::now_ns() - m_start_ns);
     if (Processor::current().in_irq()) {
         ref(); // Make sure we don't get freed
         Processor::deferred_call_queue([this]() {
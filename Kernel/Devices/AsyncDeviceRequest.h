@@ -169,6 +169,7 @@ private:
     WaitQueue m_queue;
     NonnullRefPtr<Process> m_process;
     void* m_private { nullptr };
+    u64 m_start_ns { 0 };
     mutable SpinLock<u8> m_lock;
 };
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Kernel/API/ProfileSampleRecord.h>
+#include <Kernel/Devices/ProfilingDevice.h>
+#include <Kernel/FileSystem/FileDescription.h>
+#include <Kernel/Profiling.h>
+
+namespace Kernel {
+
+struct ProfilingDeviceData : public FileDescriptionData {
+    Vector<Profiling::SampleCursor> cursors;
+    u32 next_cpu { 0 };
+};
+
+ProfilingDevice::ProfilingDevice()
+    : CharacterDevice(1, 12)
+{
+}
+
+ProfilingDevice::~ProfilingDevice()
+{
+}
+
+KResultOr<size_t> ProfilingDevice::read(FileDescription& description, size_t, UserOrKernelBuffer& buffer, size_t size)
+{
+    if (!description.data()) {
+        auto data = make<ProfilingDeviceData>();
+        data->cursors.resize(Processor::count());
+        description.data() = move(data);
+    }
+    auto& data = static_cast<ProfilingDeviceData&>(*description.data());
+
+    size_t nwritten = 0;
+    bool did_fault = false;
+    bool is_full = false;
+    // Take turns on where to start, so a busy CPU can't starve the others when reading in small chunks.
+    auto cpu_count = data.cursors.size();
+    for (size_t i = 0; i < cpu_count && !is_full && !did_fault; ++i) {
+        u32 cpu = (data.next_cpu + i) % cpu_count;
+        auto& cursor = data.cursors[cpu];
+        Profiling::read_samples(cpu, cursor, [&](auto& sample) {
+            ProfileSampleRecord record;
+            record.timestamp = sample.timestamp;
+            record.pid = sample.pid.value();
+            record.tid = sample.tid.value();
+            record.cpu = cpu;
+            while (record.frame_count < Profiling::max_stack_frame_count && sample.frames[record.frame_count])
+                ++record.frame_count;
+            size_t frames_size = record.frame_count * sizeof(u32);
+            if (nwritten + sizeof(record) + frames_size > size) {
+                is_full = true;
+                return false;
+            }
+            record.lost_count = cursor.lost_count;
+            if (!buffer.write(&record, nwritten, sizeof(record)) || !buffer.write(sample.frames, nwritten + sizeof(record), frames_size)) {
+                did_fault = true;
+                return false;
+            }
+            cursor.lost_count = 0;
+            nwritten += sizeof(record) + frames_size;
+            return true;
+        });
+    }
+    data.next_cpu = (data.next_cpu + 1) % cpu_count;
+
+    if (did_fault)
+        return KResult(-EFAULT);
+    // Don't pretend we're at the end of the stream just because a single record didn't fit.
+    if (nwritten == 0 && is_full)
+        return KResult(-EINVAL);
+    return nwritten;
+}
+
+}
@@ -382,6 +382,8 @@ String DevFSDeviceInode::determine_name() const
                 return "zero";
             case 7:
                 return "full";
+            case 12:
+                return "profile";
             default:
                 ASSERT_NOT_REACHED();
             }
@@ -56,6 +56,7 @@
 #include <Kernel/Scheduler.h>
 #include <Kernel/StdLib.h>
 #include <Kernel/TTY/TTY.h>
+#include <Kernel/Tracing.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <LibC/errno_numbers.h>
@@ -97,6 +98,7 @@ enum ProcFileType {
     FI_Root_cmdline,
     FI_Root_modules,
     FI_Root_profile,
+    FI_Root_trace,
     FI_Root_self, // symlink
     FI_Root_sys,  // directory
     FI_Root_net,  // directory
@@ -470,9 +472,14 @@ static bool procfs$profile(InodeIdentifier, KBufferBuilder& builder)
 
     auto array = object.add_array("events");
     bool mask_kernel_addresses = !Process::current()->is_superuser();
+    auto pid = Profiling::pid();
     Profiling::for_each_sample([&](auto& sample) {
+        // When profiling the whole system, the buffers also contain samples from everyone else.
+        if (pid != -1 && sample.pid != pid && !Profiling::is_system_wide())
+            return;
         auto object = array.add_object();
         object.add("type", "sample");
+        object.add("pid", sample.pid.value());
         object.add("tid", sample.tid.value());
         object.add("timestamp", sample.timestamp);
         auto frames_array = object.add_array("stack");
@@ -491,6 +498,46 @@ static bool procfs$profile(InodeIdentifier, KBufferBuilder& builder)
     return true;
 }
 
+static void add_latency_histogram(JsonObjectSerializer<KBufferBuilder>& object, const Tracing::LatencyHistogram& histogram)
+{
+    object.add("count", histogram.count());
+    auto buckets_array = object.add_array("buckets");
+    for (size_t i = 0; i < Tracing::LatencyHistogram::bucket_count; ++i) {
+        auto count = histogram.bucket(i);
+        if (!count)
+            continue;
+        auto bucket_object = buckets_array.add_object();
+        bucket_object.add("min_ns", Tracing::LatencyHistogram::bucket_lower_bound(i));
+        bucket_object.add("count", count);
+    }
+}
+
+static bool procfs$trace(InodeIdentifier, KBufferBuilder& builder)
+{
+    JsonObjectSerializer object(builder);
+    object.add("enabled", Tracing::is_enabled());
+    {
+        auto tracepoints_object = object.add_object("tracepoints");
+        for (size_t i = 0; i < (size_t)Tracing::Tracepoint::__Count; ++i) {
+            auto tracepoint = (Tracing::Tracepoint)i;
+            auto tracepoint_object = tracepoints_object.add_object(Tracing::to_string(tracepoint));
+            add_latency_histogram(tracepoint_object, Tracing::histogram(tracepoint));
+        }
+    }
+    {
+        auto syscalls_object = object.add_object("syscalls");
+        for (u32 function = 0; function < Syscall::Function::__Count; ++function) {
+            auto& histogram = Tracing::syscall_histogram(function);
+            if (!histogram.count())
+                continue;
+            auto syscall_object = syscalls_object.add_object(Syscall::to_string((Syscall::Function)function));
+            add_latency_histogram(syscall_object, histogram);
+        }
+    }
+    object.finish();
+    return true;
+}
+
 static bool procfs$net_adapters(InodeIdentifier, KBufferBuilder& builder)
 {
     JsonArraySerializer array { builder };
@@ -1753,6 +1800,7 @@ ProcFS::ProcFS()
     m_entries[FI_Root_cmdline] = { "cmdline", FI_Root_cmdline, true, procfs$cmdline };
     m_entries[FI_Root_modules] = { "modules", FI_Root_modules, true, procfs$modules };
     m_entries[FI_Root_profile] = { "profile", FI_Root_profile, false, procfs$profile };
+    m_entries[FI_Root_trace] = { "trace", FI_Root_trace, true, procfs$trace };
     m_entries[FI_Root_sys] = { "sys", FI_Root_sys, true };
     m_entries[FI_Root_net] = { "net", FI_Root_net, false };
 
@@ -51,7 +51,7 @@ public:
     void append_bytes(ReadonlyBytes);
 
     template<typename... Parameters>
-    void appendff(StringView fmtstr, const Parameters&... parameters)
+    void appendff(const CheckedFormatString<typename IdentityType<Parameters>::Type...>& fmtstr, const Parameters&... parameters)
     {
         // FIXME: This is really not the way to go about it, but vformat expects a
         //        StringBuilder. Why does this class exist anyways?
@@ -24,27 +24,39 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/Atomic.h>
 #include <AK/Demangle.h>
-#include <AK/Singleton.h>
 #include <AK/StringBuilder.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/ProcFS.h>
 #include <Kernel/KBuffer.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Process.h>
 #include <Kernel/Profiling.h>
+#include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
 namespace Profiling {
 
-static size_t s_slot_count;
-static AK::Singleton<KBuffer, []() -> KBuffer* {
-    auto buffer = KBuffer::try_create_with_size(8 * MiB, Region::Access::Read | Region::Access::Write, "Profiling Buffer", AllocationStrategy::AllocateNow);
-    s_slot_count = buffer->size() / sizeof(Sample);
-    return buffer.leak_ptr();
-}>
-    s_profiling_buffer;
-static size_t s_next_slot_index;
+static constexpr size_t buffer_size_per_cpu = 4 * MiB;
+
+struct CPUSampleBuffer {
+    OwnPtr<KBuffer> buffer;
+    u32 capacity { 0 };
+    // Only ever written by the CPU owning this buffer, from its timer interrupt.
+    Atomic<u32> head { 0 };
+    unsigned ticks_until_sample { 1 };
+    // The serial of the first sample that for_each_sample() will consider.
+    Atomic<u32> first_serial { 0 };
+
+    Sample& slot(u32 serial) { return ((Sample*)buffer->data())[serial % capacity]; }
+};
+
+static Atomic<CPUSampleBuffer*> s_buffers;
+static u32 s_cpu_count;
+static Atomic<unsigned> s_sample_interval { 1 };
+static Atomic<bool> s_system_wide { false };
 static ProcessID s_pid { -1 };
 
 String& executable_path()
@@ -60,6 +72,98 @@ ProcessID pid()
     return s_pid;
 }
 
+static bool ensure_buffers()
+{
+    if (s_buffers.load(AK::MemoryOrder::memory_order_acquire))
+        return true;
+
+    // NOTE: Callers are serialized by g_processes_lock, so we can't race with ourselves here.
+    //       All processors are up by the time anyone can ask for a profile.
+    auto cpu_count = Processor::count();
+    auto* buffers = new CPUSampleBuffer[cpu_count];
+    for (u32 cpu = 0; cpu < cpu_count; ++cpu) {
+        auto& buffer = buffers[cpu];
+        buffer.buffer = KBuffer::try_create_with_size(buffer_size_per_cpu, Region::Access::Read | Region::Access::Write, "Profiling Buffer", AllocationStrategy::AllocateNow);
+        if (!buffer.buffer) {
+            delete[] buffers;
+            return false;
+        }
+        buffer.capacity = buffer.buffer->size() / sizeof(Sample);
+    }
+    s_cpu_count = cpu_count;
+    s_buffers.store(buffers, AK::MemoryOrder::memory_order_release);
+    return true;
+}
+
+static void reset_buffers()
+{
+    auto* buffers = s_buffers.load(AK::MemoryOrder::memory_order_acquire);
+    for (u32 cpu = 0; cpu < s_cpu_count; ++cpu)
+        buffers[cpu].first_serial.store(buffers[cpu].head.load(AK::MemoryOrder::memory_order_acquire), AK::MemoryOrder::memory_order_release);
+}
+
+void initialize()
+{
+    static Lockable<String>* sample_interval_helper;
+
+    if (sample_interval_helper == nullptr) {
+        sample_interval_helper = new Lockable<String>(String::number(sample_interval()));
+        ProcFS::add_sys_string("profiling_sample_interval", *sample_interval_helper, [] {
+            auto& helper = *sample_interval_helper;
+            LOCKER(helper.lock());
+            auto ticks = helper.resource().trim_whitespace().to_uint();
+            if (ticks.has_value() && ticks.value() > 0)
+                set_sample_interval(ticks.value());
+            helper.resource() = String::number(sample_interval());
+        });
+    }
+}
+
+unsigned sample_interval()
+{
+    return s_sample_interval.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void set_sample_interval(unsigned ticks)
+{
+    ASSERT(ticks > 0);
+    s_sample_interval.store(ticks, AK::MemoryOrder::memory_order_relaxed);
+}
+
+bool is_sampling(const Process& process)
+{
+    return process.is_profiling() || s_system_wide.load(AK::MemoryOrder::memory_order_relaxed);
+}
+
+void sample_current_thread(const RegisterState& regs)
+{
+    ASSERT_INTERRUPTS_DISABLED();
+    auto* buffers = s_buffers.load(AK::MemoryOrder::memory_order_acquire);
+    if (!buffers)
+        return;
+    auto& processor = Processor::current();
+    auto& buffer = buffers[processor.id()];
+    if (--buffer.ticks_until_sample > 0)
+        return;
+    buffer.ticks_until_sample = sample_interval();
+
+    auto* current_thread = processor.current_thread();
+    SmapDisabler disabler;
+    auto backtrace = current_thread->raw_backtrace(regs.ebp, regs.eip);
+
+    auto serial = buffer.head.load(AK::MemoryOrder::memory_order_relaxed);
+    auto& sample = buffer.slot(serial);
+    sample.pid = current_thread->process().pid();
+    sample.tid = current_thread->tid();
+    sample.timestamp = TimeManagement::the().uptime_ms();
+    size_t frame_count = min(backtrace.size(), max_stack_frame_count);
+    for (size_t i = 0; i < frame_count; ++i)
+        sample.frames[i] = backtrace[i];
+    for (size_t i = frame_count; i < max_stack_frame_count; ++i)
+        sample.frames[i] = 0;
+    buffer.head.store(serial + 1, AK::MemoryOrder::memory_order_release);
+}
+
 void start(Process& process)
 {
     if (process.executable())
@@ -68,40 +172,131 @@ void start(Process& process)
         executable_path() = {};
     s_pid = process.pid();
 
-    s_profiling_buffer.ensure_instance();
+    if (!ensure_buffers())
+        return;
+    reset_buffers();
+}
 
-    s_next_slot_index = 0;
+void start_system_wide()
+{
+    if (!ensure_buffers())
+        return;
+    s_system_wide.store(true, AK::MemoryOrder::memory_order_relaxed);
 }
 
-static Sample& sample_slot(size_t index)
+void stop()
 {
-    return ((Sample*)s_profiling_buffer->data())[index];
+    // NOTE: The samples stay around, so that the profile can still be read.
 }
 
-Sample& next_sample_slot()
+void stop_system_wide()
 {
-    auto& slot = sample_slot(s_next_slot_index++);
-    if (s_next_slot_index >= s_slot_count)
-        s_next_slot_index = 0;
-    return slot;
+    s_system_wide.store(false, AK::MemoryOrder::memory_order_relaxed);
 }
 
-void stop()
+bool is_system_wide()
 {
-    // FIXME: This probably shouldn't be empty.
+    return s_system_wide.load(AK::MemoryOrder::memory_order_relaxed);
 }
 
 void did_exec(const String& new_executable_path)
 {
     executable_path() = new_executable_path;
-    s_next_slot_index = 0;
+    if (s_buffers.load(AK::MemoryOrder::memory_order_acquire))
+        reset_buffers();
+}
+
+// Copies the sample with the given serial out of the ring, unless the owning CPU
+// has overwritten it (or might be in the middle of doing so).
+static bool try_copy_sample(CPUSampleBuffer& buffer, u32 serial, Sample& sample)
+{
+    if (buffer.head.load(AK::MemoryOrder::memory_order_acquire) - serial > buffer.capacity)
+        return false;
+    sample = buffer.slot(serial);
+    __atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+    return buffer.head.load(AK::MemoryOrder::memory_order_relaxed) - serial < buffer.capacity;
+}
+
+static u32 oldest_readable_serial(CPUSampleBuffer& buffer, u32 serial)
+{
+    auto head = buffer.head.load(AK::MemoryOrder::memory_order_acquire);
+    if (head - serial > buffer.capacity)
+        return head - buffer.capacity;
+    return serial;
+}
+
+void read_samples(u32 cpu, SampleCursor& cursor, Function<bool(const Sample&)> callback)
+{
+    auto* buffers = s_buffers.load(AK::MemoryOrder::memory_order_acquire);
+    if (!buffers || cpu >= s_cpu_count)
+        return;
+    auto& buffer = buffers[cpu];
+    if (!cursor.is_initialized) {
+        cursor.next_serial = oldest_readable_serial(buffer, 0);
+        cursor.is_initialized = true;
+    }
+
+    Sample sample;
+    while (cursor.next_serial != buffer.head.load(AK::MemoryOrder::memory_order_acquire)) {
+        if (!try_copy_sample(buffer, cursor.next_serial, sample)) {
+            auto oldest_serial = oldest_readable_serial(buffer, cursor.next_serial);
+            // Skip ahead a bit further than necessary, since the writer keeps going while we catch up.
+            oldest_serial += min(buffer.capacity / 8, buffer.head.load(AK::MemoryOrder::memory_order_acquire) - oldest_serial);
+            cursor.lost_count += oldest_serial - cursor.next_serial;
+            cursor.next_serial = oldest_serial;
+            continue;
+        }
+        if (!callback(sample))
+            break;
+        ++cursor.next_serial;
+    }
 }
 
 void for_each_sample(Function<void(Sample&)> callback)
 {
-    for (size_t i = 0; i < s_next_slot_index; ++i) {
-        auto& sample = sample_slot(i);
-        callback(sample);
+    auto* buffers = s_buffers.load(AK::MemoryOrder::memory_order_acquire);
+    if (!buffers)
+        return;
+
+    // Merge the per-CPU buffers, so that the samples come out in timestamp order.
+    Vector<u32, 16> next_serials;
+    Vector<u32, 16> end_serials;
+    for (u32 cpu = 0; cpu < s_cpu_count; ++cpu) {
+        auto& buffer = buffers[cpu];
+        end_serials.append(buffer.head.load(AK::MemoryOrder::memory_order_acquire));
+        auto first_serial = buffer.first_serial.load(AK::MemoryOrder::memory_order_acquire);
+        if (end_serials[cpu] - first_serial > buffer.capacity)
+            first_serial = end_serials[cpu] - buffer.capacity;
+        next_serials.append(first_serial);
+    }
+
+    Vector<Sample> next_samples;
+    next_samples.resize(s_cpu_count);
+    auto fetch_next_sample = [&](u32 cpu) {
+        while (next_serials[cpu] != end_serials[cpu]) {
+            if (try_copy_sample(buffers[cpu], next_serials[cpu], next_samples[cpu]))
+                return;
+            // Overwritten while we weren't looking, so it's no longer the oldest sample.
+            ++next_serials[cpu];
+        }
+    };
+    for (u32 cpu = 0; cpu < s_cpu_count; ++cpu)
+        fetch_next_sample(cpu);
+
+    for (;;) {
+        Optional<u32> oldest_cpu;
+        for (u32 cpu = 0; cpu < s_cpu_count; ++cpu) {
+            if (next_serials[cpu] == end_serials[cpu])
+                continue;
+            if (!oldest_cpu.has_value() || next_samples[cpu].timestamp < next_samples[oldest_cpu.value()].timestamp)
+                oldest_cpu = cpu;
+        }
+        if (!oldest_cpu.has_value())
+            break;
+        auto cpu = oldest_cpu.value();
+        callback(next_samples[cpu]);
+        ++next_serials[cpu];
+        fetch_next_sample(cpu);
     }
 }
 
@@ -33,6 +33,7 @@
 namespace Kernel {
 
 class Process;
+struct RegisterState;
 
 namespace Profiling {
 
@@ -45,15 +46,40 @@ struct Sample {
     u32 frames[max_stack_frame_count];
 };
 
+// Each CPU records its samples into its own ring buffer, overwriting the oldest
+// samples once it's full. Samples are numbered per CPU by a serial that only grows,
+// which lets readers resume where they left off without ever blocking the writer.
+struct SampleCursor {
+    u32 next_serial { 0 };
+    // How many samples were overwritten before the reader got to them.
+    u32 lost_count { 0 };
+    bool is_initialized { false };
+};
+
 extern ProcessID pid();
 extern String& executable_path();
 
-Sample& next_sample_slot();
+void initialize();
+bool is_sampling(const Process&);
+void sample_current_thread(const RegisterState&);
+
+unsigned sample_interval();
+void set_sample_interval(unsigned ticks);
+
 void start(Process&);
+void start_system_wide();
 void stop();
+void stop_system_wide();
+bool is_system_wide();
 void did_exec(const String& new_executable_path);
+
+// Calls back with the samples still in the buffers since profiling was last (re)started, oldest first.
 void for_each_sample(Function<void(Sample&)>);
 
+// Calls back with samples recorded on the given CPU since the cursor was last advanced.
+// The callback returns false to stop early, leaving the cursor at the sample it rejected.
+void read_samples(u32 cpu, SampleCursor&, Function<bool(const Sample&)>);
+
 }
 
 }
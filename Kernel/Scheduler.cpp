@@ -34,6 +34,7 @@
 #include <Kernel/Scheduler.h>
 #include <Kernel/Time/TimeManagement.h>
 #include <Kernel/TimerQueue.h>
+#include <Kernel/Tracing.h>
 
 //#define LOG_EVERY_CONTEXT_SWITCH
 //#define SCHEDULER_DEBUG
@@ -192,7 +193,7 @@ bool Scheduler::pick_next()
     scheduler_data.m_pending_beneficiary = nullptr;
     scheduler_data.m_pending_donate_reason = nullptr;
 
-    quick_sort(sorted_runnables, [](auto& a, auto& b) { return a->effective_priority() >= b->effective_priority(); });
+    quick_sort(sorted_runnables, [](auto& a, auto& b) { return a->effective_priority() > b->effective_priority(); });
 
     for (auto* thread : sorted_runnables) {
         if (thread->process().exec_tid() && thread->process().exec_tid() != thread->tid())
@@ -340,6 +341,8 @@ bool Scheduler::context_switch(Thread* thread)
         proc.init_context(*thread, false);
         thread->set_initialized(true);
     }
+    if (thread->runnable_since_ns() && Tracing::is_enabled())
+        Tracing::record(Tracing::Tracepoint::RunQueueDelay, Tracing::now_ns() - thread->runnable_since_ns());
     thread->set_state(Thread::Running);
 
     // Mark it as active because we are using this thread. This is similar
@@ -473,20 +476,12 @@ void Scheduler::timer_tick(const RegisterState& regs)
     if (!current_thread)
         return;
 
+    if (Profiling::is_sampling(current_thread->process()))
+        Profiling::sample_current_thread(regs);
+
     bool is_bsp = Processor::current().id() == 0;
     if (!is_bsp)
         return; // TODO: This prevents scheduling on other CPUs!
-    if (current_thread->process().is_profiling()) {
-        SmapDisabler disabler;
-        auto backtrace = current_thread->raw_backtrace(regs.ebp, regs.eip);
-        auto& sample = Profiling::next_sample_slot();
-        sample.pid = current_thread->process().pid();
-        sample.tid = current_thread->tid();
-        sample.timestamp = TimeManagement::the().uptime_ms();
-        for (size_t i = 0; i < min(backtrace.size(), Profiling::max_stack_frame_count); ++i) {
-            sample.frames[i] = backtrace[i];
-        }
-    }
 
     if (current_thread->tick((regs.cs & 3) == 0))
         return;
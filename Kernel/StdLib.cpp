@@ -215,6 +215,16 @@ int memcmp(const void* v1, const void* v2, size_t n)
     return 0;
 }
 
+void* memchr(const void* ptr, int c, size_t size)
+{
+    auto* bytes = (const u8*)ptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (bytes[i] == (u8)c)
+            return const_cast<u8*>(bytes + i);
+    }
+    return nullptr;
+}
+
 int strncmp(const char* s1, const char* s2, size_t n)
 {
     if (!n)
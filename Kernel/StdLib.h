@@ -51,6 +51,7 @@ size_t strlen(const char*);
 size_t strnlen(const char*, size_t);
 void* memset(void*, int, size_t);
 int memcmp(const void*, const void*, size_t);
+void* memchr(const void*, int, size_t);
 void* memmove(void* dest, const void* src, size_t n);
 const void* memmem(const void* haystack, size_t, const void* needle, size_t);
 
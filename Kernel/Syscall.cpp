@@ -29,6 +29,7 @@
 #include <Kernel/Process.h>
 #include <Kernel/Random.h>
 #include <Kernel/ThreadTracer.h>
+#include <Kernel/Tracing.h>
 #include <Kernel/VM/MemoryManager.h>
 
 namespace Kernel {
@@ -193,7 +194,10 @@ void syscall_handler(TrapFrame* trap)
     u32 arg1 = regs.edx;
     u32 arg2 = regs.ecx;
     u32 arg3 = regs.ebx;
+    u64 start_ns = Tracing::is_enabled() ? Tracing::now_ns() : 0;
     regs.eax = Syscall::handle(regs, function, arg1, arg2, arg3);
+    if (start_ns)
+        Tracing::record_syscall(function, Tracing::now_ns() - start_ns);
 
     process.big_lock().unlock();
 
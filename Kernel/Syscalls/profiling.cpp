@@ -34,6 +34,12 @@ int Process::sys$profiling_enable(pid_t pid)
 {
     REQUIRE_NO_PROMISES;
     ScopedSpinLock lock(g_processes_lock);
+    if (pid == -1) {
+        if (!is_superuser())
+            return -EPERM;
+        Profiling::start_system_wide();
+        return 0;
+    }
     auto process = Process::from_pid(pid);
     if (!process)
         return -ESRCH;
@@ -49,6 +55,12 @@ int Process::sys$profiling_enable(pid_t pid)
 int Process::sys$profiling_disable(pid_t pid)
 {
     ScopedSpinLock lock(g_processes_lock);
+    if (pid == -1) {
+        if (!is_superuser())
+            return -EPERM;
+        Profiling::stop_system_wide();
+        return 0;
+    }
     auto process = Process::from_pid(pid);
     if (!process)
         return -ESRCH;
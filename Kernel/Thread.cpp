@@ -37,6 +37,7 @@
 #include <Kernel/Thread.h>
 #include <Kernel/ThreadTracer.h>
 #include <Kernel/TimerQueue.h>
+#include <Kernel/Tracing.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/PageDirectory.h>
 #include <Kernel/VM/ProcessPagingScope.h>
@@ -903,6 +904,8 @@ void Thread::set_state(State new_state, u8 stop_signal)
         }
 
         m_state = new_state;
+        if (new_state == Runnable)
+            m_runnable_since_ns = Tracing::is_enabled() ? Tracing::now_ns() : 0;
 #ifdef THREAD_DEBUG
         dbg() << "Set Thread " << *this << " state to " << state_string();
 #endif
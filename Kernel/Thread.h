@@ -1032,6 +1032,9 @@ public:
     u32 ticks_in_user() const { return m_ticks_in_user; }
     u32 ticks_in_kernel() const { return m_ticks_in_kernel; }
 
+    // When tracing, the time at which this thread last became runnable.
+    u64 runnable_since_ns() const { return m_runnable_since_ns; }
+
     RecursiveSpinLock& get_lock() const { return m_lock; }
 
 #ifdef LOCK_DEBUG
@@ -1159,6 +1162,7 @@ private:
     u32 m_times_scheduled { 0 };
     u32 m_ticks_in_user { 0 };
     u32 m_ticks_in_kernel { 0 };
+    u64 m_runnable_since_ns { 0 };
     u32 m_pending_signals { 0 };
     u32 m_signal_mask { 0 };
     u32 m_kernel_stack_base { 0 };
@@ -119,34 +119,98 @@ TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 
 void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
 {
-    u64 timer_expiration = timer->m_expires;
-
     ASSERT(!timer->is_queued());
 
     auto& queue = queue_for_timer(*timer);
-    if (queue.list.is_empty()) {
-        queue.list.append(&timer.leak_ref());
-        queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        queue.list.for_each([&](Timer& t) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
-                return IterationDecision::Break;
-            }
-            return IterationDecision::Continue;
-        });
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.head() == following_timer;
-            queue.list.insert_before(following_timer, &timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(&timer.leak_ref());
+    if (queue.timer_count == 0) {
+        // Nothing is queued, so the wheel may have fallen arbitrarily far
+        // behind. Just move it to the current time instead of turning it.
+        queue.current_tick = now_tick(queue);
+    }
+
+    if (timer->m_id != 0)
+        m_timers_by_id.set(timer->m_id, timer.ptr());
+    timer->set_queued(true);
+    queue.timer_count++;
+    insert_into_wheel(queue, timer.leak_ref());
+}
+
+u64 TimerQueue::now_tick(const Queue& queue) const
+{
+    return time_to_ns(TimeManagement::the().current_time(queue.clock_id).value()) >> wheel_tick_shift;
+}
+
+void TimerQueue::insert_into_wheel(Queue& queue, Timer& timer)
+{
+    ASSERT(g_timerqueue_lock.is_locked());
+    ASSERT(!timer.m_slot);
+
+    // Timers that are already due go into the current slot, so that the
+    // next call to fire() picks them up.
+    u64 tick = max(timer.m_expires >> wheel_tick_shift, queue.current_tick);
+    u64 delta = tick - queue.current_tick;
+
+    size_t level = 0;
+    while (level < wheel_level_count - 1 && delta >= (1ull << (wheel_slot_bits * (level + 1))))
+        ++level;
+
+    // Timers beyond the range of the wheel are parked in the furthest slot
+    // of the last level, and placed again whenever that slot is cascaded.
+    u64 wheel_range = 1ull << (wheel_slot_bits * wheel_level_count);
+    if (delta >= wheel_range)
+        tick = queue.current_tick + wheel_range - 1;
+
+    auto& slot = queue.slots[level][(tick >> (wheel_slot_bits * level)) & wheel_slot_mask];
+    slot.append(&timer);
+    timer.m_slot = &slot;
+}
+
+void TimerQueue::remove_from_wheel(Timer& timer)
+{
+    ASSERT(g_timerqueue_lock.is_locked());
+    ASSERT(timer.m_slot);
+    timer.m_slot->remove(&timer);
+    timer.m_slot = nullptr;
+}
+
+void TimerQueue::advance_wheel(Queue& queue)
+{
+    ASSERT(g_timerqueue_lock.is_locked());
+
+    ++queue.current_tick;
+
+    // Whenever a level completes a revolution, the next slot of the level
+    // above it is due and its timers are redistributed further down.
+    for (size_t level = 1; level < wheel_level_count; ++level) {
+        if (queue.current_tick & ((1ull << (wheel_slot_bits * level)) - 1))
+            break;
+        auto& slot = queue.slots[level][(queue.current_tick >> (wheel_slot_bits * level)) & wheel_slot_mask];
+        InlineLinkedList<Timer> timers;
+        timers.append(slot);
+        while (auto* timer = timers.remove_head()) {
+            timer->m_slot = nullptr;
+            insert_into_wheel(queue, *timer);
         }
     }
 }
 
+void TimerQueue::reset_wheel(Queue& queue, u64 tick)
+{
+    ASSERT(g_timerqueue_lock.is_locked());
+
+    InlineLinkedList<Timer> timers;
+    for (auto& level : queue.slots) {
+        for (auto& slot : level)
+            timers.append(slot);
+    }
+
+    queue.current_tick = tick;
+    while (auto* timer = timers.remove_head()) {
+        timer->m_slot = nullptr;
+        insert_into_wheel(queue, *timer);
+    }
+}
+
 TimerId TimerQueue::add_timer(clockid_t clock_id, timeval& deadline, Function<void()>&& callback)
 {
     auto expires = TimeManagement::the().current_time(clock_id).value();
@@ -156,30 +220,9 @@ TimerId TimerQueue::add_timer(clockid_t clock_id, timeval& deadline, Function<vo
 
 bool TimerQueue::cancel_timer(TimerId id)
 {
-    Timer* found_timer = nullptr;
-    Queue* timer_queue = nullptr;
-
     ScopedSpinLock lock(g_timerqueue_lock);
-    if (m_timer_queue_monotonic.list.for_each([&](Timer& timer) {
-            if (timer.m_id == id) {
-                found_timer = &timer;
-                timer_queue = &m_timer_queue_monotonic;
-                return IterationDecision::Break;
-            }
-            return IterationDecision::Continue;
-        })
-        != IterationDecision::Break) {
-        m_timer_queue_realtime.list.for_each([&](Timer& timer) {
-            if (timer.m_id == id) {
-                found_timer = &timer;
-                timer_queue = &m_timer_queue_realtime;
-                return IterationDecision::Break;
-            }
-            return IterationDecision::Continue;
-        });
-    }
-
-    if (!found_timer) {
+    auto it = m_timers_by_id.find(id);
+    if (it == m_timers_by_id.end()) {
         // The timer may be executing right now, if it is then it should
         // be in m_timers_executing. If it is then release the lock
         // briefly to allow it to finish by removing itself
@@ -202,9 +245,8 @@ bool TimerQueue::cancel_timer(TimerId id)
         return false;
     }
 
-    ASSERT(found_timer);
-    ASSERT(timer_queue);
-    remove_timer_locked(*timer_queue, *found_timer);
+    auto& timer = *it->value;
+    remove_timer_locked(queue_for_timer(timer), timer);
     return true;
 }
 
@@ -212,7 +254,7 @@ bool TimerQueue::cancel_timer(Timer& timer)
 {
     auto& timer_queue = queue_for_timer(timer);
     ScopedSpinLock lock(g_timerqueue_lock);
-    if (!timer_queue.list.contains_slow(&timer)) {
+    if (!timer.is_queued()) {
         // The timer may be executing right now, if it is then it should
         // be in m_timers_executing. If it is then release the lock
         // briefly to allow it to finish by removing itself
@@ -238,15 +280,15 @@ bool TimerQueue::cancel_timer(Timer& timer)
 
 void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
 {
-    bool was_next_timer = (queue.list.head() == &timer);
-    queue.list.remove(&timer);
+    remove_from_wheel(timer);
+    if (timer.m_id != 0)
+        m_timers_by_id.remove(timer.m_id);
     timer.set_queued(false);
+    queue.timer_count--;
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
@@ -258,48 +300,67 @@ void TimerQueue::fire()
     ScopedSpinLock lock(g_timerqueue_lock);
 
     auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.head();
-        ASSERT(timer);
-        ASSERT(queue.next_timer_due == timer->m_expires);
-
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(timer);
-            timer->set_queued(false);
-
-            m_timers_executing.append(timer);
-
-            update_next_timer_due(queue);
+        auto target_tick = now_tick(queue);
+
+        // If we fell behind by more than a full revolution of the first
+        // level (or the clock was set), placing every timer again is
+        // cheaper than turning the wheel one tick at a time.
+        if (target_tick > queue.current_tick + wheel_slot_count)
+            reset_wheel(queue, target_tick);
+
+        for (;;) {
+            auto& slot = queue.slots[0][queue.current_tick & wheel_slot_mask];
+            InlineLinkedList<Timer> not_due;
+
+            while (auto* timer = slot.head()) {
+                remove_from_wheel(*timer);
+                if (timer->now(true) <= timer->m_expires) {
+                    not_due.append(timer);
+                    timer->m_slot = &not_due;
+                    continue;
+                }
+
+                if (timer->m_id != 0)
+                    m_timers_by_id.remove(timer->m_id);
+                timer->set_queued(false);
+                queue.timer_count--;
+
+                m_timers_executing.append(timer);
+
+                lock.unlock();
+
+                // Defer executing the timer outside of the irq handler
+                Processor::current().deferred_call_queue([this, timer]() {
+                    timer->m_callback();
+                    ScopedSpinLock lock(g_timerqueue_lock);
+                    m_timers_executing.remove(timer);
+                    // Drop the reference we added when queueing the timer
+                    timer->unref();
+                });
+
+                lock.lock();
+            }
 
-            lock.unlock();
+            bool caught_up = queue.current_tick >= target_tick;
+            if (!caught_up)
+                advance_wheel(queue);
 
-            // Defer executing the timer outside of the irq handler
-            Processor::current().deferred_call_queue([this, timer]() {
-                timer->m_callback();
-                ScopedSpinLock lock(g_timerqueue_lock);
-                m_timers_executing.remove(timer);
-                // Drop the reference we added when queueing the timer
-                timer->unref();
-            });
+            // Timers that expire later within the current tick (or whose
+            // own clock lags behind the wheel) are simply placed again.
+            while (auto* timer = not_due.remove_head()) {
+                timer->m_slot = nullptr;
+                insert_into_wheel(queue, *timer);
+            }
 
-            lock.lock();
-            timer = queue.list.head();
+            if (caught_up)
+                break;
         }
     };
 
-    if (!m_timer_queue_monotonic.list.is_empty())
+    if (m_timer_queue_monotonic.timer_count)
         fire_timers(m_timer_queue_monotonic);
-    if (!m_timer_queue_realtime.list.is_empty())
+    if (m_timer_queue_realtime.timer_count)
         fire_timers(m_timer_queue_realtime);
 }
 
-void TimerQueue::update_next_timer_due(Queue& queue)
-{
-    ASSERT(g_timerqueue_lock.is_locked());
-
-    if (auto* next_timer = queue.list.head())
-        queue.next_timer_due = next_timer->m_expires;
-    else
-        queue.next_timer_due = 0;
-}
-
 }
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <AK/Function.h>
+#include <AK/HashMap.h>
 #include <AK/InlineLinkedList.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/OwnPtr.h>
@@ -64,6 +65,7 @@ private:
     Function<void()> m_callback;
     Timer* m_next { nullptr };
     Timer* m_prev { nullptr };
+    InlineLinkedList<Timer>* m_slot { nullptr };
     Atomic<bool, AK::MemoryOrder::memory_order_relaxed> m_queued { false };
 
     bool operator<(const Timer& rhs) const
@@ -102,14 +104,39 @@ public:
     void fire();
 
 private:
+    // Timers are kept in a hierarchical timing wheel per clock, which makes
+    // adding and cancelling a timer O(1) regardless of how many are queued.
+    // Level 0 has one slot per tick, and each slot on a higher level spans a
+    // full revolution of the level below it. As the wheel turns, timers are
+    // cascaded down one level at a time until they reach the level 0 slot
+    // of the tick they expire in.
+    static constexpr size_t wheel_level_count = 5;
+    static constexpr size_t wheel_slot_bits = 6;
+    static constexpr size_t wheel_slot_count = 1 << wheel_slot_bits;
+    static constexpr u64 wheel_slot_mask = wheel_slot_count - 1;
+    // One tick of the wheel is 2^20 ns (~1ms), about the timer interrupt rate.
+    static constexpr u64 wheel_tick_shift = 20;
+
     struct Queue {
-        InlineLinkedList<Timer> list;
-        u64 next_timer_due { 0 };
+        explicit Queue(clockid_t clock_id)
+            : clock_id(clock_id)
+        {
+        }
+
+        clockid_t clock_id;
+        u64 current_tick { 0 };
+        size_t timer_count { 0 };
+        InlineLinkedList<Timer> slots[wheel_level_count][wheel_slot_count];
     };
     void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
     void add_timer_locked(NonnullRefPtr<Timer>);
 
+    u64 now_tick(const Queue&) const;
+    void insert_into_wheel(Queue&, Timer&);
+    void remove_from_wheel(Timer&);
+    void advance_wheel(Queue&);
+    void reset_wheel(Queue&, u64 tick);
+
     Queue& queue_for_timer(Timer& timer)
     {
         switch (timer.m_clock_id) {
@@ -127,8 +154,9 @@ private:
 
     u64 m_timer_id_count { 0 };
     u64 m_ticks_per_second { 0 };
-    Queue m_timer_queue_monotonic;
-    Queue m_timer_queue_realtime;
+    Queue m_timer_queue_monotonic { CLOCK_MONOTONIC_COARSE };
+    Queue m_timer_queue_realtime { CLOCK_REALTIME_COARSE };
+    HashMap<TimerId, Timer*> m_timers_by_id;
     InlineLinkedList<Timer> m_timers_executing;
 };
 
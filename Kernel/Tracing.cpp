@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <Kernel/API/Syscall.h>
+#include <Kernel/FileSystem/ProcFS.h>
+#include <Kernel/Lock.h>
+#include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracing.h>
+
+namespace Kernel {
+
+namespace Tracing {
+
+bool g_enabled;
+
+static LatencyHistogram s_histograms[(size_t)Tracepoint::__Count];
+static LatencyHistogram s_syscall_histograms[Syscall::Function::__Count];
+
+u64 LatencyHistogram::count() const
+{
+    u64 count = 0;
+    for (size_t i = 0; i < bucket_count; ++i)
+        count += bucket(i);
+    return count;
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto& counter : m_buckets)
+        counter.store(0, AK::MemoryOrder::memory_order_relaxed);
+}
+
+void initialize()
+{
+    static Lockable<bool>* enabled_helper;
+
+    if (enabled_helper == nullptr) {
+        enabled_helper = new Lockable<bool>();
+        ProcFS::add_sys_bool("trace", *enabled_helper, [] {
+            bool enable = enabled_helper->resource();
+            if (enable && !g_enabled) {
+                // Start from a clean slate every time tracing is turned on.
+                for (auto& histogram : s_histograms)
+                    histogram.reset();
+                for (auto& histogram : s_syscall_histograms)
+                    histogram.reset();
+            }
+            g_enabled = enable;
+        });
+    }
+}
+
+u64 now_ns()
+{
+    auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    return (u64)now.tv_sec * 1'000'000'000ull + now.tv_nsec;
+}
+
+void record(Tracepoint tracepoint, u64 latency_ns)
+{
+    ASSERT(tracepoint < Tracepoint::__Count);
+    s_histograms[(size_t)tracepoint].record(latency_ns);
+}
+
+void record_syscall(u32 function, u64 latency_ns)
+{
+    record(Tracepoint::Syscall, latency_ns);
+    if (function < Syscall::Function::__Count)
+        s_syscall_histograms[function].record(latency_ns);
+}
+
+const LatencyHistogram& histogram(Tracepoint tracepoint)
+{
+    ASSERT(tracepoint < Tracepoint::__Count);
+    return s_histograms[(size_t)tracepoint];
+}
+
+const LatencyHistogram& syscall_histogram(u32 function)
+{
+    ASSERT(function < Syscall::Function::__Count);
+    return s_syscall_histograms[function];
+}
+
+}
+
+}
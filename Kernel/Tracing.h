@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Types.h>
+
+namespace Kernel {
+
+namespace Tracing {
+
+#define ENUMERATE_TRACEPOINTS                                  \
+    __ENUMERATE_TRACEPOINT(Syscall, "syscall")                 \
+    __ENUMERATE_TRACEPOINT(PageFault, "page_fault")            \
+    __ENUMERATE_TRACEPOINT(DeviceRequest, "device_request")    \
+    __ENUMERATE_TRACEPOINT(RunQueueDelay, "run_queue_delay")
+
+enum class Tracepoint {
+#undef __ENUMERATE_TRACEPOINT
+#define __ENUMERATE_TRACEPOINT(name, string) name,
+    ENUMERATE_TRACEPOINTS
+#undef __ENUMERATE_TRACEPOINT
+        __Count
+};
+
+constexpr const char* to_string(Tracepoint tracepoint)
+{
+    switch (tracepoint) {
+#define __ENUMERATE_TRACEPOINT(name, string) \
+    case Tracepoint::name:                   \
+        return string;
+        ENUMERATE_TRACEPOINTS
+#undef __ENUMERATE_TRACEPOINT
+    default:
+        return "Unknown";
+    }
+}
+
+class LatencyHistogram {
+public:
+    // Bucket N counts latencies of [2^N, 2^(N+1)) nanoseconds, except for the first one,
+    // which also counts zero, and the last one, which counts everything longer.
+    static constexpr size_t bucket_count = 40;
+
+    static constexpr u64 bucket_lower_bound(size_t index) { return index == 0 ? 0 : 1ull << index; }
+
+    void record(u64 nanoseconds)
+    {
+        size_t index = nanoseconds ? 63 - __builtin_clzll(nanoseconds) : 0;
+        m_buckets[min(index, bucket_count - 1)].fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+    }
+
+    u32 bucket(size_t index) const { return m_buckets[index].load(AK::MemoryOrder::memory_order_relaxed); }
+    u64 count() const;
+    void reset();
+
+private:
+    Atomic<u32> m_buckets[bucket_count];
+};
+
+// Every tracepoint checks this first, so that they cost no more than a
+// (correctly predicted) branch while tracing is off.
+extern bool g_enabled;
+
+ALWAYS_INLINE bool is_enabled()
+{
+    return __builtin_expect(g_enabled, false);
+}
+
+void initialize();
+u64 now_ns();
+
+void record(Tracepoint, u64 latency_ns);
+void record_syscall(u32 function, u64 latency_ns);
+
+const LatencyHistogram& histogram(Tracepoint);
+const LatencyHistogram& syscall_histogram(u32 function);
+
+// Records how long it takes until it goes out of scope.
+class ScopedTracepoint {
+public:
+    explicit ScopedTracepoint(Tracepoint tracepoint)
+        : m_tracepoint(tracepoint)
+    {
+        if (is_enabled())
+            m_start_ns = now_ns();
+    }
+
+    ~ScopedTracepoint()
+    {
+        if (m_start_ns)
+            record(m_tracepoint, now_ns() - m_start_ns);
+    }
+
+private:
+    Tracepoint m_tracepoint;
+    u64 m_start_ns { 0 };
+};
+
+}
+
+}
@@ -29,6 +29,7 @@
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/Process.h>
 #include <Kernel/Thread.h>
+#include <Kernel/Tracing.h>
 #include <Kernel/VM/AnonymousVMObject.h>
 #include <Kernel/VM/MemoryManager.h>
 #include <Kernel/VM/PageDirectory.h>
@@ -433,6 +434,7 @@ void Region::remap()
 
 PageFaultResponse Region::handle_fault(const PageFault& fault)
 {
+    Tracing::ScopedTracepoint tracepoint(Tracing::Tracepoint::PageFault);
     ScopedSpinLock lock(s_mm_lock);
     auto page_index_in_region = page_index_from_address(fault.vaddr());
     if (fault.type() == PageFault::Type::PageNotPresent) {
@@ -36,6 +36,7 @@
 #include <Kernel/Devices/I8042Controller.h>
 #include <Kernel/Devices/MBVGADevice.h>
 #include <Kernel/Devices/NullDevice.h>
+#include <Kernel/Devices/ProfilingDevice.h>
 #include <Kernel/Devices/RandomDevice.h>
 #include <Kernel/Devices/SB16.h>
 #include <Kernel/Devices/SerialDevice.h>
@@ -58,6 +59,7 @@
 #include <Kernel/PCI/Access.h>
 #include <Kernel/PCI/Initializer.h>
 #include <Kernel/Process.h>
+#include <Kernel/Profiling.h>
 #include <Kernel/RTC.h>
 #include <Kernel/Random.h>
 #include <Kernel/Scheduler.h>
@@ -67,6 +69,7 @@
 #include <Kernel/Tasks/FinalizerTask.h>
 #include <Kernel/Tasks/SyncTask.h>
 #include <Kernel/Time/TimeManagement.h>
+#include <Kernel/Tracing.h>
 #include <Kernel/VM/MemoryManager.h>
 
 // Defined in the linker script
@@ -258,6 +261,9 @@ void init_stage2(void*)
     new ZeroDevice;
     new FullDevice;
     new RandomDevice;
+    new ProfilingDevice;
+    Profiling::initialize();
+    Tracing::initialize();
     PTYMultiplexer::initialize();
     new SB16;
     VMWareBackdoor::the(); // don't wait until first mouse packet
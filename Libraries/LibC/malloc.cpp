@@ -38,8 +38,6 @@
 #include <sys/internals.h>
 #include <sys/mman.h>
 
-// FIXME: Thread safety.
-
 //#define MALLOC_DEBUG
 #define RECYCLE_BIG_ALLOCATIONS
 
@@ -94,6 +92,10 @@ struct MallocStats {
     size_t number_of_freed_full_blocks;
     size_t number_of_keeps;
     size_t number_of_frees;
+
+    size_t number_of_thread_cache_hits;
+    size_t number_of_thread_cache_misses;
+    size_t number_of_thread_cache_flushes;
 };
 static MallocStats g_malloc_stats = {};
 
@@ -129,6 +131,44 @@ static inline BigAllocator (&big_allocators())[1]
     return reinterpret_cast<BigAllocator(&)[1]>(g_big_allocators_storage);
 }
 
+// Each thread keeps a few free chunks of the smaller size classes to itself, so that
+// most calls to malloc() and free() don't have to take the malloc lock. Chunks move
+// between the thread caches and the global blocks in batches. Chunks freed by another
+// thread than the one that allocated them simply end up in the freeing thread's cache,
+// and make their way back to the global blocks from there.
+constexpr size_t largest_thread_cached_chunk_size = 4088;
+
+struct ThreadCacheBin {
+    FreelistEntry* freelist { nullptr };
+    size_t count { 0 };
+};
+
+struct ThreadCache {
+    ThreadCacheBin bins[num_size_classes];
+
+    // Counted here and folded into g_malloc_stats whenever we take the malloc lock anyway.
+    size_t number_of_malloc_calls { 0 };
+    size_t number_of_free_calls { 0 };
+    size_t number_of_hits { 0 };
+    size_t number_of_misses { 0 };
+
+    // Set when the thread exits, after which everything goes straight to the global blocks.
+    bool is_disabled { false };
+};
+
+#ifdef NO_TLS
+static ThreadCache t_thread_cache;
+#else
+static __thread ThreadCache t_thread_cache;
+#endif
+
+// How many chunks move between a thread cache and the global blocks at once.
+// A thread cache holds up to twice this many chunks of each size class.
+static constexpr size_t thread_cache_batch_size(size_t chunk_size)
+{
+    return clamp<size_t>(2048 / chunk_size, 1, 32);
+}
+
 static Allocator* allocator_for_size(size_t size, size_t& good_size)
 {
     for (size_t i = 0; size_classes[i]; ++i) {
@@ -150,6 +190,15 @@ static BigAllocator* big_allocator_for_size(size_t size)
 }
 #endif
 
+static void fold_thread_cache_stats()
+{
+    auto& cache = t_thread_cache;
+    g_malloc_stats.number_of_malloc_calls += exchange(cache.number_of_malloc_calls, 0);
+    g_malloc_stats.number_of_free_calls += exchange(cache.number_of_free_calls, 0);
+    g_malloc_stats.number_of_thread_cache_hits += exchange(cache.number_of_hits, 0);
+    g_malloc_stats.number_of_thread_cache_misses += exchange(cache.number_of_misses, 0);
+}
+
 extern "C" {
 
 static void* os_alloc(size_t size, const char* name)
@@ -165,65 +214,18 @@ static void os_free(void* ptr, size_t size)
     assert(rc == 0);
 }
 
-static void* malloc_impl(size_t size)
+static void* allocate_chunk(Allocator& allocator, size_t good_size)
 {
-    LOCKER(malloc_lock());
-
-    if (s_log_malloc)
-        dbgprintf("LibC: malloc(%zu)\n", size);
-
-    if (!size)
-        return nullptr;
-
-    g_malloc_stats.number_of_malloc_calls++;
-
-    size_t good_size;
-    auto* allocator = allocator_for_size(size, good_size);
-
-    if (!allocator) {
-        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
-#ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(real_size)) {
-            if (!allocator->blocks.is_empty()) {
-                g_malloc_stats.number_of_big_allocator_hits++;
-                auto* block = allocator->blocks.take_last();
-                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
-                bool this_block_was_purged = rc == 1;
-                if (rc < 0) {
-                    perror("madvise");
-                    ASSERT_NOT_REACHED();
-                }
-                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
-                    perror("mprotect");
-                    ASSERT_NOT_REACHED();
-                }
-                if (this_block_was_purged) {
-                    g_malloc_stats.number_of_big_allocator_purge_hits++;
-                    new (block) BigAllocationBlock(real_size);
-                }
-
-                ue_notify_malloc(&block->m_slot[0], size);
-                return &block->m_slot[0];
-            }
-        }
-#endif
-        g_malloc_stats.number_of_big_allocs++;
-        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
-        new (block) BigAllocationBlock(real_size);
-        ue_notify_malloc(&block->m_slot[0], size);
-        return &block->m_slot[0];
-    }
-
     ChunkedBlock* block = nullptr;
 
-    for (block = allocator->usable_blocks.head(); block; block = block->next()) {
+    for (block = allocator.usable_blocks.head(); block; block = block->next()) {
         if (block->free_chunks())
             break;
     }
 
-    if (!block && allocator->empty_block_count) {
+    if (!block && allocator.empty_block_count) {
         g_malloc_stats.number_of_empty_block_hits++;
-        block = allocator->empty_blocks[--allocator->empty_block_count];
+        block = allocator.empty_blocks[--allocator.empty_block_count];
         int rc = madvise(block, ChunkedBlock::block_size, MADV_SET_NONVOLATILE);
         bool this_block_was_purged = rc == 1;
         if (rc < 0) {
@@ -239,7 +241,7 @@ static void* malloc_impl(size_t size)
             g_malloc_stats.number_of_empty_block_purge_hits++;
             new (block) ChunkedBlock(good_size);
         }
-        allocator->usable_blocks.append(block);
+        allocator.usable_blocks.append(block);
     }
 
     if (!block) {
@@ -248,8 +250,8 @@ static void* malloc_impl(size_t size)
         snprintf(buffer, sizeof(buffer), "malloc: ChunkedBlock(%zu)", good_size);
         block = (ChunkedBlock*)os_alloc(ChunkedBlock::block_size, buffer);
         new (block) ChunkedBlock(good_size);
-        allocator->usable_blocks.append(block);
-        ++allocator->block_count;
+        allocator.usable_blocks.append(block);
+        ++allocator.block_count;
     }
 
     --block->m_free_chunks;
@@ -261,69 +263,111 @@ static void* malloc_impl(size_t size)
 #ifdef MALLOC_DEBUG
         dbgprintf("Block %p is now full in size class %zu\n", block, good_size);
 #endif
-        allocator->usable_blocks.remove(block);
-        allocator->full_blocks.append(block);
+        allocator.usable_blocks.remove(block);
+        allocator.full_blocks.append(block);
     }
 #ifdef MALLOC_DEBUG
     dbgprintf("LibC: allocated %p (chunk in block %p, size %zu)\n", ptr, block, block->bytes_per_chunk());
 #endif
-
-    if (s_scrub_malloc)
-        memset(ptr, MALLOC_SCRUB_BYTE, block->m_size);
-
-    ue_notify_malloc(ptr, size);
     return ptr;
 }
 
-static void free_impl(void* ptr)
+static void refill_thread_cache_bin(ThreadCacheBin& bin, Allocator& allocator, size_t good_size)
 {
-    ScopedValueRollback rollback(errno);
+    ASSERT(!bin.count);
+    for (size_t i = 0; i < thread_cache_batch_size(good_size); ++i) {
+        auto* entry = (FreelistEntry*)allocate_chunk(allocator, good_size);
+        entry->next = bin.freelist;
+        bin.freelist = entry;
+        ++bin.count;
+    }
+}
 
-    if (!ptr)
-        return;
+static void* malloc_impl(size_t size)
+{
+    if (s_log_malloc)
+        dbgprintf("LibC: malloc(%zu)\n", size);
 
-    g_malloc_stats.number_of_free_calls++;
+    if (!size)
+        return nullptr;
 
-    LOCKER(malloc_lock());
+    size_t good_size;
+    auto* allocator = allocator_for_size(size, good_size);
 
-    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
-    size_t magic = *(size_t*)block_base;
+    auto& cache = t_thread_cache;
+    if (allocator && good_size <= largest_thread_cached_chunk_size && !cache.is_disabled) {
+        ++cache.number_of_malloc_calls;
+        auto& bin = cache.bins[allocator - allocators()];
+        if (bin.count) {
+            ++cache.number_of_hits;
+        } else {
+            ++cache.number_of_misses;
+            LOCKER(malloc_lock());
+            fold_thread_cache_stats();
+            refill_thread_cache_bin(bin, *allocator, good_size);
+        }
+        void* ptr = bin.freelist;
+        bin.freelist = bin.freelist->next;
+        --bin.count;
 
-    if (magic == MAGIC_BIGALLOC_HEADER) {
-        auto* block = (BigAllocationBlock*)block_base;
+        if (s_scrub_malloc)
+            memset(ptr, MALLOC_SCRUB_BYTE, good_size);
+        ue_notify_malloc(ptr, size);
+        return ptr;
+    }
+
+    LOCKER(malloc_lock());
+    fold_thread_cache_stats();
+    g_malloc_stats.number_of_malloc_calls++;
+
+    if (!allocator) {
+        size_t real_size = round_up_to_power_of_two(sizeof(BigAllocationBlock) + size, ChunkedBlock::block_size);
 #ifdef RECYCLE_BIG_ALLOCATIONS
-        if (auto* allocator = big_allocator_for_size(block->m_size)) {
-            if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
-                g_malloc_stats.number_of_big_allocator_keeps++;
-                allocator->blocks.append(block);
-                size_t this_block_size = block->m_size;
-                if (mprotect(block, this_block_size, PROT_NONE) < 0) {
-                    perror("mprotect");
+        if (auto* allocator = big_allocator_for_size(real_size)) {
+            if (!allocator->blocks.is_empty()) {
+                g_malloc_stats.number_of_big_allocator_hits++;
+                auto* block = allocator->blocks.take_last();
+                int rc = madvise(block, real_size, MADV_SET_NONVOLATILE);
+                bool this_block_was_purged = rc == 1;
+                if (rc < 0) {
+                    perror("madvise");
                     ASSERT_NOT_REACHED();
                 }
-                if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
-                    perror("madvise");
+                if (mprotect(block, real_size, PROT_READ | PROT_WRITE) < 0) {
+                    perror("mprotect");
                     ASSERT_NOT_REACHED();
                 }
-                return;
+                if (this_block_was_purged) {
+                    g_malloc_stats.number_of_big_allocator_purge_hits++;
+                    new (block) BigAllocationBlock(real_size);
+                }
+
+                ue_notify_malloc(&block->m_slot[0], size);
+                return &block->m_slot[0];
             }
         }
 #endif
-        g_malloc_stats.number_of_big_allocator_frees++;
-        os_free(block, block->m_size);
-        return;
+        g_malloc_stats.number_of_big_allocs++;
+        auto* block = (BigAllocationBlock*)os_alloc(real_size, "malloc: BigAllocationBlock");
+        new (block) BigAllocationBlock(real_size);
+        ue_notify_malloc(&block->m_slot[0], size);
+        return &block->m_slot[0];
     }
 
-    assert(magic == MAGIC_PAGE_HEADER);
-    auto* block = (ChunkedBlock*)block_base;
+    void* ptr = allocate_chunk(*allocator, good_size);
+    if (s_scrub_malloc)
+        memset(ptr, MALLOC_SCRUB_BYTE, good_size);
 
+    ue_notify_malloc(ptr, size);
+    return ptr;
+}
+
+static void free_chunk(ChunkedBlock* block, void* ptr)
+{
 #ifdef MALLOC_DEBUG
     dbgprintf("LibC: freeing %p in allocator %p (size=%zu, used=%zu)\n", ptr, block, block->bytes_per_chunk(), block->used_chunks());
 #endif
 
-    if (s_scrub_free)
-        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
-
     auto* entry = (FreelistEntry*)ptr;
     entry->next = block->m_freelist;
     block->m_freelist = entry;
@@ -365,6 +409,87 @@ static void free_impl(void* ptr)
     }
 }
 
+static void flush_thread_cache_bin(ThreadCacheBin& bin, size_t count)
+{
+    g_malloc_stats.number_of_thread_cache_flushes++;
+    for (size_t i = 0; i < count && bin.count; ++i) {
+        auto* entry = bin.freelist;
+        bin.freelist = entry->next;
+        --bin.count;
+        free_chunk((ChunkedBlock*)((FlatPtr)entry & ChunkedBlock::block_mask), entry);
+    }
+}
+
+static void free_impl(void* ptr)
+{
+    ScopedValueRollback rollback(errno);
+
+    if (!ptr)
+        return;
+
+    void* block_base = (void*)((FlatPtr)ptr & ChunkedBlock::ChunkedBlock::block_mask);
+    size_t magic = *(size_t*)block_base;
+
+    if (magic == MAGIC_BIGALLOC_HEADER) {
+        LOCKER(malloc_lock());
+        fold_thread_cache_stats();
+        g_malloc_stats.number_of_free_calls++;
+
+        auto* block = (BigAllocationBlock*)block_base;
+#ifdef RECYCLE_BIG_ALLOCATIONS
+        if (auto* allocator = big_allocator_for_size(block->m_size)) {
+            if (allocator->blocks.size() < number_of_big_blocks_to_keep_around_per_size_class) {
+                g_malloc_stats.number_of_big_allocator_keeps++;
+                allocator->blocks.append(block);
+                size_t this_block_size = block->m_size;
+                if (mprotect(block, this_block_size, PROT_NONE) < 0) {
+                    perror("mprotect");
+                    ASSERT_NOT_REACHED();
+                }
+                if (madvise(block, this_block_size, MADV_SET_VOLATILE) != 0) {
+                    perror("madvise");
+                    ASSERT_NOT_REACHED();
+                }
+                return;
+            }
+        }
+#endif
+        g_malloc_stats.number_of_big_allocator_frees++;
+        os_free(block, block->m_size);
+        return;
+    }
+
+    assert(magic == MAGIC_PAGE_HEADER);
+    auto* block = (ChunkedBlock*)block_base;
+
+    if (s_scrub_free)
+        memset(ptr, FREE_SCRUB_BYTE, block->bytes_per_chunk());
+
+    auto& cache = t_thread_cache;
+    if (block->m_size <= largest_thread_cached_chunk_size && !cache.is_disabled) {
+        ++cache.number_of_free_calls;
+        size_t good_size;
+        auto* allocator = allocator_for_size(block->m_size, good_size);
+        auto& bin = cache.bins[allocator - allocators()];
+        auto* entry = (FreelistEntry*)ptr;
+        entry->next = bin.freelist;
+        bin.freelist = entry;
+        ++bin.count;
+        auto batch_size = thread_cache_batch_size(good_size);
+        if (bin.count > 2 * batch_size) {
+            LOCKER(malloc_lock());
+            fold_thread_cache_stats();
+            flush_thread_cache_bin(bin, batch_size);
+        }
+        return;
+    }
+
+    LOCKER(malloc_lock());
+    fold_thread_cache_stats();
+    g_malloc_stats.number_of_free_calls++;
+    free_chunk(block, ptr);
+}
+
 [[gnu::flatten]] void* malloc(size_t size)
 {
     void* ptr = malloc_impl(size);
@@ -447,8 +572,22 @@ void __malloc_init()
     new (&big_allocators()[0])(BigAllocator);
 }
 
+void __malloc_release_thread_cache()
+{
+    LOCKER(malloc_lock());
+    auto& cache = t_thread_cache;
+    fold_thread_cache_stats();
+    for (auto& bin : cache.bins)
+        flush_thread_cache_bin(bin, bin.count);
+    cache.is_disabled = true;
+}
+
 void serenity_dump_malloc_stats()
 {
+    {
+        LOCKER(malloc_lock());
+        fold_thread_cache_stats();
+    }
     dbg() << "# malloc() calls: " << g_malloc_stats.number_of_malloc_calls;
     dbg();
     dbg() << "big alloc hits: " << g_malloc_stats.number_of_big_allocator_hits;
@@ -468,5 +607,9 @@ void serenity_dump_malloc_stats()
     dbg() << "full block frees: " << g_malloc_stats.number_of_freed_full_blocks;
     dbg() << "number of keeps: " << g_malloc_stats.number_of_keeps;
     dbg() << "number of frees: " << g_malloc_stats.number_of_frees;
+    dbg();
+    dbg() << "thread cache hits: " << g_malloc_stats.number_of_thread_cache_hits;
+    dbg() << "thread cache misses: " << g_malloc_stats.number_of_thread_cache_misses;
+    dbg() << "thread cache flushes: " << g_malloc_stats.number_of_thread_cache_flushes;
 }
 }
@@ -26,6 +26,7 @@
 
 #include <AK/MemMem.h>
 #include <AK/Platform.h>
+#include <AK/SIMDStringOps.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Types.h>
 #include <assert.h>
@@ -35,9 +36,233 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/internals.h>
+
+static size_t strlen_scalar(const char* str)
+{
+    size_t len = 0;
+    while (*(str++))
+        ++len;
+    return len;
+}
+
+static int memcmp_scalar(const void* v1, const void* v2, size_t n)
+{
+    auto* s1 = (const uint8_t*)v1;
+    auto* s2 = (const uint8_t*)v2;
+    while (n-- > 0) {
+        if (*s1++ != *s2++)
+            return s1[-1] < s2[-1] ? -1 : 1;
+    }
+    return 0;
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+static void* memcpy_scalar(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    void* original_dest = dest_ptr;
+    asm volatile(
+        "rep movsb"
+        : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
+    return original_dest;
+}
+
+static void* memset_scalar(void* dest_ptr, int c, size_t n)
+{
+    void* original_dest = dest_ptr;
+    asm volatile(
+        "rep stosb\n"
+        : "=D"(dest_ptr), "=c"(n)
+        : "0"(dest_ptr), "1"(n), "a"(c)
+        : "memory");
+    return original_dest;
+}
+#else
+static void* memcpy_scalar(void* dest_ptr, const void* src_ptr, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    auto* src = (const u8*)src_ptr;
+    for (size_t i = 0; i < n; ++i)
+        dest[i] = src[i];
+    return dest_ptr;
+}
+
+static void* memset_scalar(void* dest_ptr, int c, size_t n)
+{
+    auto* dest = (u8*)dest_ptr;
+    for (size_t i = 0; i < n; ++i)
+        dest[i] = (u8)c;
+    return dest_ptr;
+}
+#endif
+
+static char* strchr_scalar(const char* str, int c)
+{
+    char ch = c;
+    for (;; ++str) {
+        if (*str == ch)
+            return const_cast<char*>(str);
+        if (!*str)
+            return nullptr;
+    }
+}
+
+static char* strchrnul_scalar(const char* str, int c)
+{
+    char ch = c;
+    for (;; ++str) {
+        if (*str == ch || !*str)
+            return const_cast<char*>(str);
+    }
+}
+
+static void* memchr_scalar(const void* ptr, int c, size_t size)
+{
+    char ch = c;
+    auto* cptr = (const char*)ptr;
+    for (size_t i = 0; i < size; ++i) {
+        if (cptr[i] == ch)
+            return const_cast<char*>(cptr + i);
+    }
+    return nullptr;
+}
+
+static const void* memmem_scalar(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
+{
+    return AK::memmem(haystack, haystack_length, needle, needle_length);
+}
+
+#if ARCH(I386) || ARCH(X86_64)
+// For big copies and fills, "rep movsb" and "rep stosb" beat the vector loops on any CPU that
+// has fast string operations. (See the string-ops-benchmark in Meta/Lagom/Benchmarks.)
+static constexpr size_t vectorized_copy_and_fill_limit = 2 * KiB;
+
+// Instantiates the AK::SIMD kernels for one vector width, compiled for the given target.
+#    define DEFINE_VECTORIZED_STRING_FUNCTIONS(suffix, target_name, VectorType)                                                  \
+        [[gnu::target(target_name)]] static size_t strlen_##suffix(const char* str)                                              \
+        {                                                                                                                        \
+            return AK::SIMD::string_length<VectorType>(str);                                                                     \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static int memcmp_##suffix(const void* v1, const void* v2, size_t n)                        \
+        {                                                                                                                        \
+            return AK::SIMD::compare<VectorType>((const u8*)v1, (const u8*)v2, n);                                               \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static void* memcpy_##suffix(void* dest_ptr, const void* src_ptr, size_t n)                 \
+        {                                                                                                                        \
+            if (n >= vectorized_copy_and_fill_limit)                                                                             \
+                return memcpy_scalar(dest_ptr, src_ptr, n);                                                                      \
+            AK::SIMD::copy<VectorType>((u8*)dest_ptr, (const u8*)src_ptr, n);                                                    \
+            return dest_ptr;                                                                                                     \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static void* memset_##suffix(void* dest_ptr, int c, size_t n)                               \
+        {                                                                                                                        \
+            if (n >= vectorized_copy_and_fill_limit)                                                                             \
+                return memset_scalar(dest_ptr, c, n);                                                                            \
+            AK::SIMD::fill<VectorType>((u8*)dest_ptr, (u8)c, n);                                                                 \
+            return dest_ptr;                                                                                                     \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static char* strchr_##suffix(const char* str, int c)                                        \
+        {                                                                                                                        \
+            auto* result = AK::SIMD::find_byte_or_terminator<VectorType>(str, (u8)c);                                            \
+            return *result == (char)c ? const_cast<char*>(result) : nullptr;                                                     \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static char* strchrnul_##suffix(const char* str, int c)                                     \
+        {                                                                                                                        \
+            return const_cast<char*>(AK::SIMD::find_byte_or_terminator<VectorType>(str, (u8)c));                                 \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static void* memchr_##suffix(const void* ptr, int c, size_t size)                           \
+        {                                                                                                                        \
+            return const_cast<u8*>(AK::SIMD::find_byte<VectorType>((const u8*)ptr, size, (u8)c));                                \
+        }                                                                                                                        \
+        [[gnu::target(target_name)]] static const void* memmem_##suffix(const void* haystack, size_t haystack_length,            \
+            const void* needle, size_t needle_length)                                                                            \
+        {                                                                                                                        \
+            return AK::SIMD::find_substring<VectorType>((const u8*)haystack, haystack_length, (const u8*)needle, needle_length); \
+        }
+
+DEFINE_VECTORIZED_STRING_FUNCTIONS(sse2, "sse2", AK::SIMD::u8x16)
+DEFINE_VECTORIZED_STRING_FUNCTIONS(avx2, "avx2", AK::SIMD::u8x32)
+#endif
+
+// The functions below start out as the plain versions, and get swapped for vectorized ones
+// in __string_init() if the CPU (and kernel) support them. The dynamic loader never calls
+// __string_init(), so it sticks with the plain versions.
+static size_t (*s_strlen)(const char*) = strlen_scalar;
+static int (*s_memcmp)(const void*, const void*, size_t) = memcmp_scalar;
+static void* (*s_memcpy)(void*, const void*, size_t) = memcpy_scalar;
+static void* (*s_memset)(void*, int, size_t) = memset_scalar;
+static char* (*s_strchr)(const char*, int) = strchr_scalar;
+static char* (*s_strchrnul)(const char*, int) = strchrnul_scalar;
+static void* (*s_memchr)(const void*, int, size_t) = memchr_scalar;
+static const void* (*s_memmem)(const void*, size_t, const void*, size_t) = memmem_scalar;
+
+#define USE_STRING_FUNCTIONS(suffix)      \
+    do {                                  \
+        s_strlen = strlen_##suffix;       \
+        s_memcmp = memcmp_##suffix;       \
+        s_memcpy = memcpy_##suffix;       \
+        s_memset = memset_##suffix;       \
+        s_strchr = strchr_##suffix;       \
+        s_strchrnul = strchrnul_##suffix; \
+        s_memchr = memchr_##suffix;       \
+        s_memmem = memmem_##suffix;       \
+    } while (0)
+
+#if ARCH(I386) || ARCH(X86_64)
+static void cpuid(u32 function, u32 subfunction, u32& eax, u32& ebx, u32& ecx, u32& edx)
+{
+    asm volatile("cpuid"
+                 : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                 : "a"(function), "c"(subfunction));
+}
+
+static bool cpu_supports_avx2(u32 max_function, u32 function_1_ecx)
+{
+    constexpr u32 osxsave_bit = 1 << 27;
+    constexpr u32 avx_bit = 1 << 28;
+    if (max_function < 7 || !(function_1_ecx & osxsave_bit) || !(function_1_ecx & avx_bit))
+        return false;
+
+    // The CPU having AVX2 isn't enough, the kernel also has to save and restore
+    // the YMM registers. It tells us that it does by enabling them in XCR0.
+    u32 xcr0_low;
+    u32 xcr0_high;
+    asm volatile("xgetbv"
+                 : "=a"(xcr0_low), "=d"(xcr0_high)
+                 : "c"(0));
+    constexpr u32 sse_and_avx_state = 0x6;
+    if ((xcr0_low & sse_and_avx_state) != sse_and_avx_state)
+        return false;
+
+    u32 eax, ebx, ecx, edx;
+    cpuid(7, 0, eax, ebx, ecx, edx);
+    constexpr u32 avx2_bit = 1 << 5;
+    return ebx & avx2_bit;
+}
+#endif
 
 extern "C" {
 
+void __string_init()
+{
+#if ARCH(I386) || ARCH(X86_64)
+    u32 max_function, ebx, ecx, edx;
+    cpuid(0, 0, max_function, ebx, ecx, edx);
+    if (max_function < 1)
+        return;
+
+    u32 eax;
+    cpuid(1, 0, eax, ebx, ecx, edx);
+    if (cpu_supports_avx2(max_function, ecx)) {
+        USE_STRING_FUNCTIONS(avx2);
+        return;
+    }
+    constexpr u32 sse2_bit = 1 << 26;
+    if (edx & sse2_bit)
+        USE_STRING_FUNCTIONS(sse2);
+#endif
+}
+
 void bzero(void* dest, size_t n)
 {
     memset(dest, 0, n);
@@ -76,10 +301,7 @@ size_t strcspn(const char* s, const char* reject)
 
 size_t strlen(const char* str)
 {
-    size_t len = 0;
-    while (*(str++))
-        ++len;
-    return len;
+    return s_strlen(str);
 }
 
 size_t strnlen(const char* str, size_t maxlen)
@@ -131,53 +353,18 @@ int strncmp(const char* s1, const char* s2, size_t n)
 
 int memcmp(const void* v1, const void* v2, size_t n)
 {
-    auto* s1 = (const uint8_t*)v1;
-    auto* s2 = (const uint8_t*)v2;
-    while (n-- > 0) {
-        if (*s1++ != *s2++)
-            return s1[-1] < s2[-1] ? -1 : 1;
-    }
-    return 0;
+    return s_memcmp(v1, v2, n);
 }
 
-#if ARCH(I386)
-void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
-{
-    void* original_dest = dest_ptr;
-    asm volatile(
-        "rep movsb"
-        : "+D"(dest_ptr), "+S"(src_ptr), "+c"(n)::"memory");
-    return original_dest;
-}
-
-void* memset(void* dest_ptr, int c, size_t n)
-{
-    void* original_dest = dest_ptr;
-    asm volatile(
-        "rep stosb\n"
-        : "=D"(dest_ptr), "=c"(n)
-        : "0"(dest_ptr), "1"(n), "a"(c)
-        : "memory");
-    return original_dest;
-}
-#else
 void* memcpy(void* dest_ptr, const void* src_ptr, size_t n)
 {
-    auto* dest = (u8*)dest_ptr;
-    auto* src = (const u8*)src_ptr;
-    for (size_t i = 0; i < n; ++i)
-        dest[i] = src[i];
-    return dest_ptr;
+    return s_memcpy(dest_ptr, src_ptr, n);
 }
 
 void* memset(void* dest_ptr, int c, size_t n)
 {
-    auto* dest = (u8*)dest_ptr;
-    for (size_t i = 0; i < n; ++i)
-        dest[i] = (u8)c;
-    return dest_ptr;
+    return s_memset(dest_ptr, c, n);
 }
-#endif
 
 void* memmove(void* dest, const void* src, size_t n)
 {
@@ -193,7 +380,7 @@ void* memmove(void* dest, const void* src, size_t n)
 
 const void* memmem(const void* haystack, size_t haystack_length, const void* needle, size_t needle_length)
 {
-    return AK::memmem(haystack, haystack_length, needle, needle_length);
+    return s_memmem(haystack, haystack_length, needle, needle_length);
 }
 
 char* strcpy(char* dest, const char* src)
@@ -229,33 +416,17 @@ size_t strlcpy(char* dest, const char* src, size_t n)
 
 char* strchr(const char* str, int c)
 {
-    char ch = c;
-    for (;; ++str) {
-        if (*str == ch)
-            return const_cast<char*>(str);
-        if (!*str)
-            return nullptr;
-    }
+    return s_strchr(str, c);
 }
 
 char* strchrnul(const char* str, int c)
 {
-    char ch = c;
-    for (;; ++str) {
-        if (*str == ch || !*str)
-            return const_cast<char*>(str);
-    }
+    return s_strchrnul(str, c);
 }
 
 void* memchr(const void* ptr, int c, size_t size)
 {
-    char ch = c;
-    auto* cptr = (const char*)ptr;
-    for (size_t i = 0; i < size; ++i) {
-        if (cptr[i] == ch)
-            return const_cast<char*>(cptr + i);
-    }
-    return nullptr;
+    return s_memchr(ptr, c, size);
 }
 
 char* strrchr(const char* str, int ch)
@@ -34,6 +34,8 @@ typedef void (*AtExitFunction)(void*);
 
 extern void __libc_init();
 extern void __malloc_init();
+extern void __string_init();
+extern void __malloc_release_thread_cache();
 extern void __stdio_init();
 extern void _init();
 extern bool __environ_is_malloced;
@@ -25,9 +25,7 @@
  */
 
 #include <AK/ByteBuffer.h>
-#include <AK/JsonArray.h>
-#include <AK/JsonObject.h>
-#include <AK/JsonValue.h>
+#include <AK/JsonView.h>
 #include <LibCore/File.h>
 #include <LibCore/ProcessStatisticsReader.h>
 #include <pwd.h>
@@ -54,12 +52,13 @@ Optional<HashMap<pid_t, Core::ProcessStatistics>> ProcessStatisticsReader::get_a
 
     HashMap<pid_t, Core::ProcessStatistics> map;
 
+    // This gets called every second or so by things like SystemMonitor, so look at
+    // the JSON in place instead of building a JsonValue tree only to throw it away.
     auto file_contents = proc_all_file->read_all();
-    auto json = JsonValue::from_string(file_contents);
-    if (!json.has_value())
+    auto json = JsonDocumentView::parse(file_contents);
+    if (!json.has_value() || !json.value().root().is_array())
         return {};
-    json.value().as_array().for_each([&](auto& value) {
-        const JsonObject& process_object = value.as_object();
+    json.value().root().for_each([&](auto& process_object) {
         Core::ProcessStatistics process;
 
         // kernel data first
@@ -84,10 +83,9 @@ Optional<HashMap<pid_t, Core::ProcessStatistics>> ProcessStatisticsReader::get_a
         process.amount_purgeable_volatile = process_object.get("amount_purgeable_volatile").to_u32();
         process.amount_purgeable_nonvolatile = process_object.get("amount_purgeable_nonvolatile").to_u32();
 
-        auto& thread_array = process_object.get_ptr("threads")->as_array();
+        auto thread_array = process_object.get("threads");
         process.threads.ensure_capacity(thread_array.size());
-        thread_array.for_each([&](auto& value) {
-            auto& thread_object = value.as_object();
+        thread_array.for_each([&](auto& thread_object) {
             Core::ThreadStatistics thread;
             thread.tid = thread_object.get("tid").to_u32();
             thread.times_scheduled = thread_object.get("times_scheduled").to_u32();
@@ -70,6 +70,7 @@ void WindowServerConnection::handshake()
     set_my_client_id(response->client_id());
     set_system_theme_from_shbuf_id(response->system_theme_buffer_id());
     Desktop::the().did_receive_screen_rect({}, response->screen_rect());
+    offer_message_ring();
 }
 
 void WindowServerConnection::handle(const Messages::WindowClient::UpdateSystemTheme& message)
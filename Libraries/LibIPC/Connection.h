@@ -35,12 +35,16 @@
 #include <LibCore/SyscallUtils.h>
 #include <LibCore/Timer.h>
 #include <LibIPC/Message.h>
+#include <LibIPC/MessageRing.h>
+#include <fcntl.h>
+#include <sched.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace IPC {
@@ -60,6 +64,13 @@ public:
         };
     }
 
+    virtual ~Connection() override
+    {
+        // Don't drop messages that were still waiting for the deferred flush.
+        if (m_socket->is_open())
+            write_pending_outgoing_messages();
+    }
+
     pid_t peer_pid() const { return m_peer_pid; }
 
     template<typename MessageType>
@@ -76,9 +87,6 @@ public:
             return;
 
         auto buffer = message.encode();
-        // Prepend the message size.
-        uint32_t message_size = buffer.data.size();
-        buffer.data.prepend(reinterpret_cast<const u8*>(&message_size), sizeof(message_size));
 
 #ifdef __serenity__
         for (int fd : buffer.fds) {
@@ -93,31 +101,35 @@ public:
             warnln("fd passing is not supported on this platform, sorry :(");
 #endif
 
-        size_t total_nwritten = 0;
-        while (total_nwritten < buffer.data.size()) {
-            auto nwritten = write(m_socket->fd(), buffer.data.data() + total_nwritten, buffer.data.size() - total_nwritten);
-            if (nwritten < 0) {
-                switch (errno) {
-                case EPIPE:
-                    dbg() << *this << "::post_message: Disconnected from peer";
-                    shutdown();
-                    return;
-                case EAGAIN:
-                    dbg() << *this << "::post_message: Peer buffer overflowed";
-                    shutdown();
-                    return;
-                default:
-                    perror("Connection::post_message write");
-                    shutdown();
-                    return;
-                }
-            }
-            total_nwritten += nwritten;
+        if (m_outgoing_ring_active) {
+            if (!post_message_to_ring(buffer.data.span()))
+                return;
+        } else {
+            m_pending_outgoing_messages.append({ static_cast<uint32_t>(buffer.data.size()), move(buffer.data) });
+        }
+
+        // Everything posted during this turn of the event loop goes out in one go.
+        if (!m_flush_scheduled) {
+            m_flush_scheduled = true;
+            deferred_invoke([this](auto&) {
+                flush_outgoing_messages();
+            });
         }
 
         m_responsiveness_timer->start();
     }
 
+    void flush_outgoing_messages()
+    {
+        m_flush_scheduled = false;
+        if (!m_socket->is_open())
+            return;
+        if (!write_pending_outgoing_messages())
+            return;
+        if (m_outgoing_ring_active && m_outgoing_ring->take_consumer_idle())
+            send_control_frame(ControlFrame::Doorbell);
+    }
+
     template<typename RequestType, typename... Args>
     OwnPtr<typename RequestType::ResponseType> send_sync(Args&&... args)
     {
@@ -143,9 +155,25 @@ protected:
     Core::LocalSocket& socket() { return *m_socket; }
     void set_peer_pid(pid_t pid) { m_peer_pid = pid; }
 
+    // Offers the peer to send our messages through a shared memory ring instead of the
+    // socket. The socket is then only used for passing fds, and for waking up the peer
+    // when it's idle. This needs to know the correct peer pid, so call it after the handshake.
+    void offer_message_ring()
+    {
+        if (m_outgoing_ring)
+            return;
+        m_outgoing_ring = MessageRing::create(m_peer_pid);
+        if (!m_outgoing_ring)
+            return;
+        send_control_frame(ControlFrame::OfferRing, m_outgoing_ring->shbuf_id());
+    }
+
     template<typename MessageType, typename Endpoint>
     OwnPtr<MessageType> wait_for_specific_endpoint_message()
     {
+        // The peer can't respond to messages we haven't sent yet.
+        flush_outgoing_messages();
+
         for (;;) {
             // Double check we don't already have the event waiting for us.
             // Otherwise we might end up blocked for a while for no reason.
@@ -159,6 +187,11 @@ protected:
 
             if (!m_socket->is_open())
                 break;
+            if (m_incoming_ring_active && !m_incoming_ring->is_empty()) {
+                if (!drain_messages_from_peer())
+                    break;
+                continue;
+            }
             fd_set rfds;
             FD_ZERO(&rfds);
             FD_SET(m_socket->fd(), &rfds);
@@ -202,27 +235,25 @@ protected:
             bytes.append(buffer, nread);
         }
 
-        if (!bytes.is_empty()) {
-            m_responsiveness_timer->stop();
-            did_become_responsive();
-        }
-
         size_t index = 0;
         uint32_t message_size = 0;
         for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
             message_size = *reinterpret_cast<uint32_t*>(bytes.data() + index);
+            if (message_size & control_frame_flag) {
+                if (bytes.size() - index < control_frame_size)
+                    break;
+                auto argument = *reinterpret_cast<uint32_t*>(bytes.data() + index + sizeof(uint32_t));
+                if (!handle_control_frame(static_cast<ControlFrame>(message_size & ~control_frame_flag), argument))
+                    return false;
+                message_size = control_frame_size;
+                continue;
+            }
             if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
             auto remaining_bytes = ReadonlyBytes { bytes.data() + index, bytes.size() - index };
-            if (auto message = LocalEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else if (auto message = PeerEndpoint::decode_message(remaining_bytes, m_socket->fd())) {
-                m_unprocessed_messages.append(message.release_nonnull());
-            } else {
-                dbgln("Failed to parse a message");
+            if (!decode_message(remaining_bytes))
                 break;
-            }
         }
 
         if (index < bytes.size()) {
@@ -238,6 +269,16 @@ protected:
             m_unprocessed_bytes = remaining_bytes;
         }
 
+        // Messages in the ring were all sent after the ones that came through the socket.
+        bool received_from_ring = false;
+        if (m_incoming_ring_active && !drain_message_ring(received_from_ring))
+            return false;
+
+        if (!bytes.is_empty() || received_from_ring) {
+            m_responsiveness_timer->stop();
+            did_become_responsive();
+        }
+
         if (!m_unprocessed_messages.is_empty()) {
             deferred_invoke([this](auto&) {
                 handle_messages();
@@ -246,9 +287,85 @@ protected:
         return true;
     }
 
+    bool decode_message(ReadonlyBytes bytes)
+    {
+        if (auto message = LocalEndpoint::decode_message(bytes, m_socket->fd())) {
+            m_unprocessed_messages.append(message.release_nonnull());
+        } else if (auto message = PeerEndpoint::decode_message(bytes, m_socket->fd())) {
+            m_unprocessed_messages.append(message.release_nonnull());
+        } else {
+            dbgln("Failed to parse a message");
+            return false;
+        }
+        return true;
+    }
+
+    bool drain_message_ring(bool& received_any)
+    {
+        for (;;) {
+            ByteBuffer bytes;
+            auto result = m_incoming_ring->dequeue(bytes);
+            if (result == MessageRing::DequeueResult::Message) {
+                received_any = true;
+                if (!decode_message(bytes))
+                    return false;
+                continue;
+            }
+            if (result == MessageRing::DequeueResult::Corrupted) {
+                dbg() << *this << "::drain_message_ring: Peer corrupted the message ring";
+                shutdown();
+                return false;
+            }
+            // Let the peer know that it needs to wake us up for the next message, then make
+            // sure that it didn't sneak one in before seeing that.
+            m_incoming_ring->set_consumer_idle(true);
+            if (m_incoming_ring->is_empty())
+                return true;
+            m_incoming_ring->set_consumer_idle(false);
+        }
+    }
+
+    static void coalesce_messages(NonnullOwnPtrVector<Message>& messages)
+    {
+        // Walk backwards, so that each coalescible message is merged into the latest
+        // message superseding it, which is the one left in the queue.
+        Vector<size_t, 32> coalescible_indices;
+        Vector<bool> superseded;
+        for (size_t i = messages.size(); i-- > 0;) {
+            auto& message = messages[i];
+            if (!message.is_coalescible())
+                continue;
+            bool was_coalesced = false;
+            for (auto later_index : coalescible_indices) {
+                if (message.try_coalesce_into(messages[later_index])) {
+                    was_coalesced = true;
+                    break;
+                }
+            }
+            if (!was_coalesced) {
+                coalescible_indices.append(i);
+                continue;
+            }
+            if (superseded.is_empty())
+                superseded.resize(messages.size());
+            superseded[i] = true;
+        }
+
+        if (superseded.is_empty())
+            return;
+
+        NonnullOwnPtrVector<Message> remaining_messages;
+        for (size_t i = 0; i < messages.size(); ++i) {
+            if (!superseded[i])
+                remaining_messages.append(move(messages.ptr_at(i)));
+        }
+        messages = move(remaining_messages);
+    }
+
     void handle_messages()
     {
         auto messages = move(m_unprocessed_messages);
+        coalesce_messages(messages);
         for (auto& message : messages) {
             if (message.endpoint_magic() == LocalEndpoint::static_magic())
                 if (auto response = m_local_endpoint.handle(message))
@@ -256,6 +373,142 @@ protected:
         }
     }
 
+private:
+    // Control frames are exchanged between the two Connections themselves and never reach
+    // the endpoints. They are told apart from messages by the high bit of the size word.
+    enum class ControlFrame : uint32_t {
+        OfferRing = 1,
+        AcceptRing,
+        RejectRing,
+        SwitchToRing,
+        Doorbell,
+    };
+    static constexpr uint32_t control_frame_flag = 0x80000000;
+    static constexpr size_t control_frame_size = 2 * sizeof(uint32_t);
+
+    bool write_to_socket(Vector<iovec, 2>& iovecs)
+    {
+        // Don't hand the kernel unreasonably many iovecs at a time.
+        static constexpr size_t max_iovecs_per_write = 256;
+
+        size_t index = 0;
+        while (index < iovecs.size()) {
+            auto nwritten = writev(m_socket->fd(), iovecs.data() + index, min(iovecs.size() - index, max_iovecs_per_write));
+            if (nwritten < 0) {
+                switch (errno) {
+                case EPIPE:
+                    dbg() << *this << "::post_message: Disconnected from peer";
+                    shutdown();
+                    return false;
+                case EAGAIN:
+                    dbg() << *this << "::post_message: Peer buffer overflowed";
+                    shutdown();
+                    return false;
+                default:
+                    perror("Connection::post_message writev");
+                    shutdown();
+                    return false;
+                }
+            }
+            // Skip past what was written, which may have ended in the middle of an iovec.
+            while (nwritten > 0) {
+                auto& iov = iovecs[index];
+                if (static_cast<size_t>(nwritten) < iov.iov_len) {
+                    iov.iov_base = static_cast<u8*>(iov.iov_base) + nwritten;
+                    iov.iov_len -= nwritten;
+                    break;
+                }
+                nwritten -= iov.iov_len;
+                ++index;
+            }
+        }
+        return true;
+    }
+
+    bool write_pending_outgoing_messages()
+    {
+        if (m_pending_outgoing_messages.is_empty())
+            return true;
+        auto messages = move(m_pending_outgoing_messages);
+        Vector<iovec, 2> iovecs;
+        iovecs.ensure_capacity(messages.size() * 2);
+        for (auto& message : messages) {
+            iovecs.unchecked_append({ &message.size, sizeof(message.size) });
+            iovecs.unchecked_append({ message.data.data(), message.data.size() });
+        }
+        return write_to_socket(iovecs);
+    }
+
+    bool send_control_frame(ControlFrame frame, uint32_t argument = 0)
+    {
+        // Control frames take effect in order with the messages we've posted so far.
+        if (!write_pending_outgoing_messages())
+            return false;
+        uint32_t words[] = { control_frame_flag | static_cast<uint32_t>(frame), argument };
+        Vector<iovec, 2> iovecs;
+        iovecs.append({ words, sizeof(words) });
+        return write_to_socket(iovecs);
+    }
+
+    bool post_message_to_ring(ReadonlyBytes bytes)
+    {
+        while (!m_outgoing_ring->try_enqueue(bytes)) {
+            // Like with a full socket buffer, a non-blocking connection gives up on the peer.
+            if (fcntl(m_socket->fd(), F_GETFL) & O_NONBLOCK) {
+                dbg() << *this << "::post_message: Peer ring overflowed";
+                shutdown();
+                return false;
+            }
+            // Otherwise make sure the peer is draining the ring, and wait for it to do so.
+            // The socket fills up with doorbells if the peer takes its time, which blocks us.
+            if (!send_control_frame(ControlFrame::Doorbell))
+                return false;
+            sched_yield();
+        }
+        return true;
+    }
+
+    bool handle_control_frame(ControlFrame frame, uint32_t argument)
+    {
+        switch (frame) {
+        case ControlFrame::OfferRing:
+            if (m_incoming_ring)
+                break;
+            m_incoming_ring = MessageRing::create_from_shbuf_id(argument);
+            if (!m_incoming_ring)
+                return send_control_frame(ControlFrame::RejectRing);
+            if (!send_control_frame(ControlFrame::AcceptRing))
+                return false;
+            // Return the favor, so messages flow through shared memory both ways.
+            offer_message_ring();
+            return true;
+        case ControlFrame::AcceptRing:
+            if (!m_outgoing_ring || m_outgoing_ring_active)
+                break;
+            // Everything we've sent so far went through the socket. Tell the peer where to
+            // pick up, and only use the ring from here on out.
+            if (!send_control_frame(ControlFrame::SwitchToRing))
+                return false;
+            m_outgoing_ring_active = true;
+            return true;
+        case ControlFrame::RejectRing:
+            if (!m_outgoing_ring || m_outgoing_ring_active)
+                break;
+            m_outgoing_ring = nullptr;
+            return true;
+        case ControlFrame::SwitchToRing:
+            if (!m_incoming_ring || m_incoming_ring_active)
+                break;
+            m_incoming_ring_active = true;
+            return true;
+        case ControlFrame::Doorbell:
+            return true;
+        }
+        dbg() << *this << "::handle_control_frame: Unexpected control frame " << static_cast<uint32_t>(frame);
+        shutdown();
+        return false;
+    }
+
 protected:
     void initialize_peer_info()
     {
@@ -276,6 +529,18 @@ protected:
     NonnullOwnPtrVector<Message> m_unprocessed_messages;
     ByteBuffer m_unprocessed_bytes;
     pid_t m_peer_pid { -1 };
+
+    struct OutgoingMessage {
+        uint32_t size;
+        Vector<u8, 1024> data;
+    };
+    Vector<OutgoingMessage> m_pending_outgoing_messages;
+    bool m_flush_scheduled { false };
+
+    RefPtr<MessageRing> m_outgoing_ring;
+    RefPtr<MessageRing> m_incoming_ring;
+    bool m_outgoing_ring_active { false };
+    bool m_incoming_ring_active { false };
 };
 
 }
@@ -45,6 +45,12 @@ public:
     virtual const char* message_name() const = 0;
     virtual MessageBuffer encode() const = 0;
 
+    // Messages declared with the [Coalesce(...)] attribute are superseded by a later message
+    // of the same type with equal key parameters. Connection merges such messages into the
+    // later one (and drops this one) before dispatching them.
+    virtual bool is_coalescible() const { return false; }
+    virtual bool try_coalesce_into(Message&) const { return false; }
+
     Function<void()> on_destruction;
 
 protected:
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/StdLibExtras.h>
+#include <LibIPC/MessageRing.h>
+#include <string.h>
+
+namespace IPC {
+
+// Every record in the ring starts with a tag word: the size of the message that follows,
+// possibly flagged as an out-of-line message, or the padding tag that says the rest of
+// the ring is unused and the next record starts over at the beginning.
+static constexpr u32 out_of_line_flag = 0x80000000;
+static constexpr u32 padding_tag = 0xffffffff;
+
+struct OutOfLineMessage {
+    i32 shbuf_id;
+    u32 size;
+};
+
+static u32 record_size(size_t message_size)
+{
+    return round_up_to_power_of_two(sizeof(u32) + message_size, sizeof(u32));
+}
+
+static bool is_power_of_two(size_t value)
+{
+    return value && !(value & (value - 1));
+}
+
+RefPtr<MessageRing> MessageRing::create(pid_t peer_pid, size_t capacity)
+{
+    ASSERT(is_power_of_two(capacity));
+    auto buffer = SharedBuffer::create_with_size(sizeof(Header) + capacity);
+    if (!buffer)
+        return nullptr;
+    if (!buffer->share_with(peer_pid))
+        return nullptr;
+    auto ring = adopt(*new MessageRing(buffer.release_nonnull(), capacity, peer_pid));
+    new (&ring->header()) Header;
+    ring->header().capacity = capacity;
+    return ring;
+}
+
+RefPtr<MessageRing> MessageRing::create_from_shbuf_id(int shbuf_id)
+{
+    auto buffer = SharedBuffer::create_from_shbuf_id(shbuf_id);
+    if (!buffer)
+        return nullptr;
+    if (static_cast<size_t>(buffer->size()) < sizeof(Header))
+        return nullptr;
+    auto capacity = reinterpret_cast<const Header*>(buffer->data<u8>())->capacity;
+    if (!is_power_of_two(capacity) || capacity > buffer->size() - sizeof(Header))
+        return nullptr;
+    return adopt(*new MessageRing(buffer.release_nonnull(), capacity, -1));
+}
+
+MessageRing::MessageRing(NonnullRefPtr<SharedBuffer> buffer, size_t capacity, pid_t peer_pid)
+    : m_buffer(move(buffer))
+    , m_capacity(capacity)
+    , m_peer_pid(peer_pid)
+{
+}
+
+bool MessageRing::try_enqueue(ReadonlyBytes bytes)
+{
+    // Out-of-line messages stay alive until the consumer has moved past them.
+    u32 tail = header().tail.load(AK::MemoryOrder::memory_order_acquire);
+    m_pending_out_of_line_messages.remove_all_matching([&](auto& message) {
+        return tail - message.position <= m_head - message.position;
+    });
+
+    if (bytes.size() > max_inline_message_size)
+        return try_enqueue_out_of_line(bytes);
+    return try_enqueue_record(bytes.size(), bytes);
+}
+
+bool MessageRing::try_enqueue_record(u32 tag, ReadonlyBytes bytes)
+{
+    u32 size = record_size(bytes.size());
+    u32 tail = header().tail.load(AK::MemoryOrder::memory_order_acquire);
+    u32 available = m_capacity - (m_head - tail);
+    u32 offset = m_head & (m_capacity - 1);
+    u32 contiguous = m_capacity - offset;
+
+    u32 needed = size > contiguous ? size + contiguous : size;
+    if (needed > available)
+        return false;
+
+    if (size > contiguous) {
+        memcpy(ring_data() + offset, &padding_tag, sizeof(u32));
+        m_head += contiguous;
+        offset = 0;
+    }
+
+    memcpy(ring_data() + offset, &tag, sizeof(u32));
+    memcpy(ring_data() + offset + sizeof(u32), bytes.data(), bytes.size());
+    m_head += size;
+    header().head.store(m_head);
+    return true;
+}
+
+bool MessageRing::try_enqueue_out_of_line(ReadonlyBytes bytes)
+{
+    if (record_size(sizeof(OutOfLineMessage)) * 2 > m_capacity - (m_head - header().tail.load(AK::MemoryOrder::memory_order_acquire)))
+        return false;
+
+    auto buffer = SharedBuffer::create_with_size(bytes.size());
+    if (!buffer)
+        return false;
+    memcpy(buffer->data<u8>(), bytes.data(), bytes.size());
+    if (!buffer->share_with(m_peer_pid))
+        return false;
+    buffer->seal();
+
+    OutOfLineMessage message { buffer->shbuf_id(), static_cast<u32>(bytes.size()) };
+    if (!try_enqueue_record(sizeof(message) | out_of_line_flag, { &message, sizeof(message) }))
+        return false;
+    m_pending_out_of_line_messages.append({ m_head, buffer.release_nonnull() });
+    return true;
+}
+
+bool MessageRing::take_consumer_idle()
+{
+    return header().consumer_idle.exchange(0) != 0;
+}
+
+bool MessageRing::is_empty() const
+{
+    return header().head.load() == m_tail;
+}
+
+void MessageRing::set_consumer_idle(bool idle)
+{
+    header().consumer_idle.store(idle);
+}
+
+MessageRing::DequeueResult MessageRing::dequeue(ByteBuffer& message)
+{
+    for (;;) {
+        u32 head = header().head.load(AK::MemoryOrder::memory_order_acquire);
+        u32 used = head - m_tail;
+        if (used == 0)
+            return DequeueResult::Empty;
+        if (used > m_capacity || used % sizeof(u32))
+            return DequeueResult::Corrupted;
+
+        u32 offset = m_tail & (m_capacity - 1);
+        u32 contiguous = min(m_capacity - offset, used);
+        u32 tag;
+        memcpy(&tag, ring_data() + offset, sizeof(u32));
+
+        if (tag == padding_tag) {
+            if (m_capacity - offset > used)
+                return DequeueResult::Corrupted;
+            m_tail += m_capacity - offset;
+            header().tail.store(m_tail, AK::MemoryOrder::memory_order_release);
+            continue;
+        }
+
+        u32 size = tag & ~out_of_line_flag;
+        if (size > m_capacity || record_size(size) > contiguous)
+            return DequeueResult::Corrupted;
+
+        if (!(tag & out_of_line_flag)) {
+            message = ByteBuffer::copy(ring_data() + offset + sizeof(u32), size);
+            m_tail += record_size(size);
+            header().tail.store(m_tail, AK::MemoryOrder::memory_order_release);
+            return DequeueResult::Message;
+        }
+
+        OutOfLineMessage out_of_line;
+        if (size != sizeof(out_of_line))
+            return DequeueResult::Corrupted;
+        memcpy(&out_of_line, ring_data() + offset + sizeof(u32), sizeof(out_of_line));
+
+        // The producer lets go of the buffer once we move past its record, so hold on to it first.
+        auto buffer = SharedBuffer::create_from_shbuf_id(out_of_line.shbuf_id);
+        if (!buffer || out_of_line.size > static_cast<u32>(buffer->size()))
+            return DequeueResult::Corrupted;
+        m_tail += record_size(size);
+        header().tail.store(m_tail, AK::MemoryOrder::memory_order_release);
+        message = ByteBuffer::copy(buffer->data<u8>(), out_of_line.size);
+        return DequeueResult::Message;
+    }
+}
+
+}
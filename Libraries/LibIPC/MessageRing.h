@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/ByteBuffer.h>
+#include <AK/RefCounted.h>
+#include <AK/SharedBuffer.h>
+#include <AK/Span.h>
+#include <AK/Vector.h>
+
+namespace IPC {
+
+// A single-producer, single-consumer ring of messages in a shared buffer.
+// The sending side of a connection creates the ring and shares it with the
+// receiving peer, so that messages don't have to be copied through the kernel.
+// Messages too large for the ring are passed out of line in their own shbuf.
+class MessageRing : public RefCounted<MessageRing> {
+public:
+    static constexpr size_t default_capacity = 64 * KiB;
+    static constexpr size_t max_inline_message_size = 4 * KiB;
+
+    static RefPtr<MessageRing> create(pid_t peer_pid, size_t capacity = default_capacity);
+    static RefPtr<MessageRing> create_from_shbuf_id(int shbuf_id);
+
+    int shbuf_id() const { return m_buffer->shbuf_id(); }
+
+    // Producer side. Returns false if the ring doesn't have room for the message right now.
+    bool try_enqueue(ReadonlyBytes);
+
+    // Producer side. Clears the consumer's idle flag and returns whether it was set,
+    // in which case the consumer is (about to go) to sleep and has to be woken up.
+    bool take_consumer_idle();
+
+    enum class DequeueResult {
+        Message,
+        Empty,
+        Corrupted,
+    };
+
+    // Consumer side. The ring is written by another process, so everything read from it
+    // is validated, and a misbehaving peer results in DequeueResult::Corrupted.
+    DequeueResult dequeue(ByteBuffer&);
+    bool is_empty() const;
+    void set_consumer_idle(bool);
+
+private:
+    struct Header {
+        Atomic<u32> head;
+        Atomic<u32> tail;
+        Atomic<u32> consumer_idle;
+        u32 capacity;
+    };
+
+    struct PendingOutOfLineMessage {
+        u32 position;
+        NonnullRefPtr<SharedBuffer> buffer;
+    };
+
+    MessageRing(NonnullRefPtr<SharedBuffer>, size_t capacity, pid_t peer_pid);
+
+    Header& header() { return *reinterpret_cast<Header*>(m_buffer->data<u8>()); }
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_buffer->data<u8>()); }
+    u8* ring_data() { return m_buffer->data<u8>() + sizeof(Header); }
+
+    bool try_enqueue_record(u32 tag, ReadonlyBytes);
+    bool try_enqueue_out_of_line(ReadonlyBytes);
+
+    NonnullRefPtr<SharedBuffer> m_buffer;
+    u32 m_capacity { 0 };
+    pid_t m_peer_pid { -1 };
+
+    // Our own copies of the cursors, since the shared ones can't be trusted.
+    u32 m_head { 0 };
+    u32 m_tail { 0 };
+
+    Vector<PendingOutOfLineMessage> m_pending_out_of_line_messages;
+};
+
+}
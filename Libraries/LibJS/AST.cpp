@@ -32,7 +32,10 @@
 #include <AK/TemporaryChange.h>
 #include <LibCrypto/BigInt/SignedBigInteger.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Generator.h>
 #include <LibJS/Interpreter.h>
+#include <LibJS/Parser.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/BigInt.h>
@@ -71,13 +74,13 @@ static void update_function_name(Value value, const FlyString& name, HashTable<J
     }
 }
 
-static void update_function_name(Value value, const FlyString& name)
+void update_function_name(Value value, const FlyString& name)
 {
     HashTable<JS::Cell*> visited;
     update_function_name(value, name, visited);
 }
 
-static String get_function_name(GlobalObject& global_object, Value value)
+String get_function_name(GlobalObject& global_object, Value value)
 {
     if (value.is_symbol())
         return String::formatted("[{}]", value.as_symbol().description());
@@ -86,6 +89,25 @@ static String get_function_name(GlobalObject& global_object, Value value)
     return value.to_string(global_object);
 }
 
+ScopeNode::ScopeNode(SourceRange source_range)
+    : Statement(move(source_range))
+{
+}
+
+ScopeNode::~ScopeNode()
+{
+}
+
+const Bytecode::Executable& ScopeNode::bytecode_executable(VM& vm) const
+{
+    if (!m_bytecode_executable) {
+        m_bytecode_executable = Bytecode::Generator::generate(*this);
+        if (vm.should_dump_bytecode())
+            m_bytecode_executable->dump();
+    }
+    return *m_bytecode_executable;
+}
+
 Value ScopeNode::execute(Interpreter& interpreter, GlobalObject& global_object) const
 {
     interpreter.enter_node(*this);
@@ -110,6 +132,21 @@ Value FunctionDeclaration::execute(Interpreter& interpreter, GlobalObject&) cons
     return js_undefined();
 }
 
+const FunctionDeclaration* LazyFunctionBody::function() const
+{
+    if (!m_was_parsed) {
+        m_function = Parser::parse_lazy_function(*this, m_syntax_error);
+        m_was_parsed = true;
+    }
+    return m_function.ptr();
+}
+
+Value LazyFunctionBody::execute(Interpreter&, GlobalObject&) const
+{
+    // NOTE: ScriptFunction replaces the lazy body with the parsed one before running it.
+    ASSERT_NOT_REACHED();
+}
+
 Value FunctionExpression::execute(Interpreter& interpreter, GlobalObject& global_object) const
 {
     interpreter.enter_node(*this);
@@ -159,12 +196,29 @@ CallExpression::ThisAndCallee CallExpression::compute_this_and_callee(Interprete
         auto property_name = member_expression.computed_property_name(interpreter, global_object);
         if (!property_name.is_valid())
             return {};
-        auto callee = lookup_target.to_object(global_object)->get(property_name).value_or(js_undefined());
+        auto callee = member_expression.get_property(*lookup_target.to_object(global_object), property_name).value_or(js_undefined());
         return { this_value, callee };
     }
     return { &global_object, m_callee->execute(interpreter, global_object) };
 }
 
+void CallExpression::throw_type_error_for_callee(Interpreter& interpreter, GlobalObject& global_object, Value callee) const
+{
+    auto& vm = interpreter.vm();
+    auto call_type = is<NewExpression>(*this) ? "constructor" : "function";
+    if (is<Identifier>(*m_callee) || is<MemberExpression>(*m_callee)) {
+        String expression_string;
+        if (is<Identifier>(*m_callee)) {
+            expression_string = static_cast<const Identifier&>(*m_callee).string();
+        } else {
+            expression_string = static_cast<const MemberExpression&>(*m_callee).to_string_approximation();
+        }
+        vm.throw_exception<TypeError>(global_object, ErrorType::IsNotAEvaluatedFrom, callee.to_string_without_side_effects(), call_type, expression_string);
+    } else {
+        vm.throw_exception<TypeError>(global_object, ErrorType::IsNotA, callee.to_string_without_side_effects(), call_type);
+    }
+}
+
 Value CallExpression::execute(Interpreter& interpreter, GlobalObject& global_object) const
 {
     interpreter.enter_node(*this);
@@ -179,19 +233,7 @@ Value CallExpression::execute(Interpreter& interpreter, GlobalObject& global_obj
 
     if (!callee.is_function()
         || (is<NewExpression>(*this) && (is<NativeFunction>(callee.as_object()) && !static_cast<NativeFunction&>(callee.as_object()).has_constructor()))) {
-        String error_message;
-        auto call_type = is<NewExpression>(*this) ? "constructor" : "function";
-        if (is<Identifier>(*m_callee) || is<MemberExpression>(*m_callee)) {
-            String expression_string;
-            if (is<Identifier>(*m_callee)) {
-                expression_string = static_cast<const Identifier&>(*m_callee).string();
-            } else {
-                expression_string = static_cast<const MemberExpression&>(*m_callee).to_string_approximation();
-            }
-            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotAEvaluatedFrom, callee.to_string_without_side_effects(), call_type, expression_string);
-        } else {
-            vm.throw_exception<TypeError>(global_object, ErrorType::IsNotA, callee.to_string_without_side_effects(), call_type);
-        }
+        throw_type_error_for_callee(interpreter, global_object, callee);
         return {};
     }
 
@@ -444,9 +486,8 @@ Value ForStatement::execute(Interpreter& interpreter, GlobalObject& global_objec
     return last_value;
 }
 
-static FlyString variable_from_for_declaration(Interpreter& interpreter, GlobalObject& global_object, const ASTNode& node, RefPtr<BlockStatement> wrapper)
+static const Identifier& variable_from_for_declaration(Interpreter& interpreter, GlobalObject& global_object, const ASTNode& node, RefPtr<BlockStatement> wrapper)
 {
-    FlyString variable_name;
     if (is<VariableDeclaration>(node)) {
         auto& variable_declaration = static_cast<const VariableDeclaration&>(node);
         ASSERT(!variable_declaration.declarations().is_empty());
@@ -455,13 +496,18 @@ static FlyString variable_from_for_declaration(Interpreter& interpreter, GlobalO
             interpreter.enter_scope(*wrapper, ScopeType::Block, global_object);
         }
         variable_declaration.execute(interpreter, global_object);
-        variable_name = variable_declaration.declarations().first().id().string();
-    } else if (is<Identifier>(node)) {
-        variable_name = static_cast<const Identifier&>(node).string();
-    } else {
-        ASSERT_NOT_REACHED();
+        return variable_declaration.declarations().first().id();
     }
-    return variable_name;
+    ASSERT(is<Identifier>(node));
+    return static_cast<const Identifier&>(node);
+}
+
+static void set_for_in_of_variable(Interpreter& interpreter, GlobalObject& global_object, const Identifier& variable, Value value)
+{
+    if (variable.has_frame_slot())
+        interpreter.vm().frame_slot(variable.frame_slot()) = value;
+    else
+        interpreter.vm().set_variable(variable.string(), value, global_object);
 }
 
 Value ForInStatement::execute(Interpreter& interpreter, GlobalObject& global_object) const
@@ -474,7 +520,7 @@ Value ForInStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
         ASSERT_NOT_REACHED();
     }
     RefPtr<BlockStatement> wrapper;
-    auto variable_name = variable_from_for_declaration(interpreter, global_object, m_lhs, wrapper);
+    auto& variable = variable_from_for_declaration(interpreter, global_object, m_lhs, wrapper);
     auto wrapper_cleanup = ScopeGuard([&] {
         if (wrapper)
             interpreter.exit_scope(*wrapper);
@@ -487,7 +533,7 @@ Value ForInStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
     while (object) {
         auto property_names = object->get_own_properties(*object, Object::PropertyKind::Key, true);
         for (auto& property_name : property_names.as_object().indexed_properties()) {
-            interpreter.vm().set_variable(variable_name, property_name.value_and_attributes(object).value, global_object);
+            set_for_in_of_variable(interpreter, global_object, variable, property_name.value_and_attributes(object).value);
             if (interpreter.exception())
                 return {};
             last_value = interpreter.execute_statement(global_object, *m_body);
@@ -521,7 +567,7 @@ Value ForOfStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
         ASSERT_NOT_REACHED();
     }
     RefPtr<BlockStatement> wrapper;
-    auto variable_name = variable_from_for_declaration(interpreter, global_object, m_lhs, wrapper);
+    auto& variable = variable_from_for_declaration(interpreter, global_object, m_lhs, wrapper);
     auto wrapper_cleanup = ScopeGuard([&] {
         if (wrapper)
             interpreter.exit_scope(*wrapper);
@@ -532,7 +578,7 @@ Value ForOfStatement::execute(Interpreter& interpreter, GlobalObject& global_obj
         return {};
 
     get_iterator_values(global_object, rhs_result, [&](Value value) {
-        interpreter.vm().set_variable(variable_name, value, global_object);
+        set_for_in_of_variable(interpreter, global_object, variable, value);
         last_value = interpreter.execute_statement(global_object, *m_body);
         if (interpreter.exception())
             return IterationDecision::Break;
@@ -663,6 +709,8 @@ Reference Expression::to_reference(Interpreter&, GlobalObject&) const
 
 Reference Identifier::to_reference(Interpreter& interpreter, GlobalObject&) const
 {
+    if (has_frame_slot())
+        return { Reference::FrameSlot, string(), frame_slot(), is_const_frame_slot() };
     return interpreter.vm().get_reference(string());
 }
 
@@ -689,6 +737,8 @@ Value UnaryExpression::execute(Interpreter& interpreter, GlobalObject& global_ob
             return {};
         if (reference.is_unresolvable())
             return Value(true);
+        if (reference.is_frame_slot())
+            return Value(false);
         // FIXME: Support deleting locals
         ASSERT(!reference.is_local_variable());
         if (reference.is_global_variable())
@@ -706,7 +756,9 @@ Value UnaryExpression::execute(Interpreter& interpreter, GlobalObject& global_ob
             return {};
         }
         // FIXME: standard recommends checking with is_unresolvable but it ALWAYS return false here
-        if (reference.is_local_variable() || reference.is_global_variable()) {
+        if (reference.is_frame_slot()) {
+            lhs_result = reference.get(global_object);
+        } else if (reference.is_local_variable() || reference.is_global_variable()) {
             auto name = reference.name();
             lhs_result = interpreter.vm().get_variable(name.to_string(), global_object).value_or(js_undefined());
             if (interpreter.exception())
@@ -1184,6 +1236,17 @@ void FunctionNode::dump(int indent, const char* class_name) const
     body().dump(indent + 2);
 }
 
+void LazyFunctionBody::dump(int indent) const
+{
+    if (auto* function = this->function()) {
+        function->body().dump(indent);
+        return;
+    }
+    ASTNode::dump(indent);
+    print_indent(indent + 1);
+    outln("SyntaxError: {}", m_syntax_error);
+}
+
 void FunctionDeclaration::dump(int indent) const
 {
     FunctionNode::dump(indent, class_name());
@@ -1290,6 +1353,9 @@ Value Identifier::execute(Interpreter& interpreter, GlobalObject& global_object)
     interpreter.enter_node(*this);
     ScopeGuard exit_node { [&] { interpreter.exit_node(*this); } };
 
+    if (has_frame_slot())
+        return interpreter.vm().frame_slot(frame_slot());
+
     auto value = interpreter.vm().get_variable(string(), global_object);
     if (value.is_empty()) {
         interpreter.vm().throw_exception<ReferenceError>(global_object, ErrorType::UnknownIdentifier, string());
@@ -1301,7 +1367,10 @@ Value Identifier::execute(Interpreter& interpreter, GlobalObject& global_object)
 void Identifier::dump(int indent) const
 {
     print_indent(indent);
-    outln("Identifier \"{}\"", m_string);
+    if (has_frame_slot())
+        outln("Identifier \"{}\" (frame slot {})", m_string, frame_slot());
+    else
+        outln("Identifier \"{}\"", m_string);
 }
 
 void SpreadExpression::dump(int indent) const
@@ -1442,7 +1511,10 @@ Value AssignmentExpression::execute(Interpreter& interpreter, GlobalObject& glob
         return {};
     }
     update_function_name(rhs_result, get_function_name(global_object, reference.name().to_value(interpreter.vm())));
-    reference.put(global_object, rhs_result);
+    if (is<MemberExpression>(*m_lhs) && !static_cast<const MemberExpression&>(*m_lhs).is_computed() && reference.base().is_object())
+        m_property_cache.put(reference.base().as_object(), reference.name(), rhs_result);
+    else
+        reference.put(global_object, rhs_result);
 
     if (interpreter.exception())
         return {};
@@ -1583,9 +1655,12 @@ Value VariableDeclaration::execute(Interpreter& interpreter, GlobalObject& globa
             auto initalizer_result = init->execute(interpreter, global_object);
             if (interpreter.exception())
                 return {};
-            auto variable_name = declarator.id().string();
-            update_function_name(initalizer_result, variable_name);
-            interpreter.vm().set_variable(variable_name, initalizer_result, global_object, true);
+            auto& id = declarator.id();
+            update_function_name(initalizer_result, id.string());
+            if (id.has_frame_slot())
+                interpreter.vm().frame_slot(id.frame_slot()) = initalizer_result;
+            else
+                interpreter.vm().set_variable(id.string(), initalizer_result, global_object, true);
         }
     }
     return js_undefined();
@@ -1779,7 +1854,14 @@ Value MemberExpression::execute(Interpreter& interpreter, GlobalObject& global_o
     auto property_name = computed_property_name(interpreter, global_object);
     if (!property_name.is_valid())
         return {};
-    return object_result->get(property_name).value_or(js_undefined());
+    return get_property(*object_result, property_name).value_or(js_undefined());
+}
+
+Value MemberExpression::get_property(Object& object, const PropertyName& property_name) const
+{
+    if (is_computed())
+        return object.get(property_name);
+    return m_property_cache.get(object, property_name);
 }
 
 void MetaProperty::dump(int indent) const
@@ -1914,19 +1996,19 @@ Value TemplateLiteral::execute(Interpreter& interpreter, GlobalObject& global_ob
     interpreter.enter_node(*this);
     ScopeGuard exit_node { [&] { interpreter.exit_node(*this); } };
 
-    StringBuilder string_builder;
+    auto* result = &interpreter.vm().empty_string();
 
     for (auto& expression : m_expressions) {
         auto expr = expression.execute(interpreter, global_object);
         if (interpreter.exception())
             return {};
-        auto string = expr.to_string(global_object);
+        auto* string = expr.to_primitive_string(global_object);
         if (interpreter.exception())
             return {};
-        string_builder.append(string);
+        result = js_string_concatenation(interpreter.heap(), *result, *string);
     }
 
-    return js_string(interpreter.heap(), string_builder.build());
+    return result;
 }
 
 void TaggedTemplateLiteral::dump(int indent) const
@@ -27,13 +27,17 @@
 
 #pragma once
 
+#include <AK/Arena.h>
 #include <AK/FlyString.h>
 #include <AK/HashMap.h>
 #include <AK/NonnullRefPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
 #include <AK/Vector.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Runtime/PropertyCache.h>
 #include <LibJS/Runtime/PropertyName.h>
 #include <LibJS/Runtime/Value.h>
 #include <LibJS/SourceRange.h>
@@ -50,7 +54,10 @@ create_ast_node(SourceRange range, Args&&... args)
     return adopt(*new T(range, forward<Args>(args)...));
 }
 
-class ASTNode : public RefCounted<ASTNode> {
+// While a Parser is running, AST nodes are allocated from its Arena.
+class ASTNode
+    : public RefCounted<ASTNode>
+    , public ArenaAllocated {
 public:
     virtual ~ASTNode() { }
     virtual const char* class_name() const = 0;
@@ -146,16 +153,24 @@ public:
     const NonnullRefPtrVector<VariableDeclaration>& variables() const { return m_variables; }
     const NonnullRefPtrVector<FunctionDeclaration>& functions() const { return m_functions; }
 
+    // Only set on programs and function bodies, which own the CallFrame
+    // that slotted bindings declared anywhere inside of them live in.
+    size_t frame_slot_count() const { return m_frame_slot_count; }
+    void set_frame_slot_count(size_t count) { m_frame_slot_count = count; }
+
+    // Compiled on first use, and kept for as long as the node is alive.
+    const Bytecode::Executable& bytecode_executable(VM&) const;
+
 protected:
-    ScopeNode(SourceRange source_range)
-        : Statement(move(source_range))
-    {
-    }
+    ScopeNode(SourceRange source_range);
+    ~ScopeNode();
 
 private:
     NonnullRefPtrVector<Statement> m_children;
     NonnullRefPtrVector<VariableDeclaration> m_variables;
     NonnullRefPtrVector<FunctionDeclaration> m_functions;
+    size_t m_frame_slot_count { 0 };
+    mutable OwnPtr<Bytecode::Executable> m_bytecode_executable;
 };
 
 class Program final : public ScopeNode {
@@ -187,6 +202,51 @@ private:
     virtual const char* class_name() const override { return "BlockStatement"; }
 };
 
+// The body of a function declaration that the Parser has skipped over, see
+// Parser::enable_lazy_function_bodies(). The whole function is parsed again from its source the
+// first time it is needed.
+class LazyFunctionBody final : public Statement {
+public:
+    // The parts of the parser's state that parsing the function depends on.
+    struct ParserContext {
+        bool strict_mode { false };
+        bool in_break_context { false };
+        bool in_continue_context { false };
+    };
+
+    LazyFunctionBody(SourceRange source_range, String source, size_t function_offset, Position function_start, ParserContext parser_context)
+        : Statement(move(source_range))
+        , m_source(move(source))
+        , m_function_offset(function_offset)
+        , m_function_start(function_start)
+        , m_parser_context(parser_context)
+    {
+    }
+
+    const String& source() const { return m_source; }
+    size_t function_offset() const { return m_function_offset; }
+    const Position& function_start() const { return m_function_start; }
+    const ParserContext& parser_context() const { return m_parser_context; }
+
+    // Returns null if the function has syntax errors after all, see syntax_error().
+    const FunctionDeclaration* function() const;
+    const String& syntax_error() const { return m_syntax_error; }
+
+    virtual Value execute(Interpreter&, GlobalObject&) const override;
+    virtual void dump(int indent) const override;
+
+private:
+    virtual const char* class_name() const override { return "LazyFunctionBody"; }
+
+    String m_source;
+    size_t m_function_offset { 0 };
+    Position m_function_start;
+    ParserContext m_parser_context;
+    mutable bool m_was_parsed { false };
+    mutable RefPtr<FunctionDeclaration> m_function;
+    mutable String m_syntax_error;
+};
+
 class Expression : public ASTNode {
 public:
     Expression(SourceRange source_range)
@@ -220,6 +280,7 @@ public:
         FlyString name;
         RefPtr<Expression> default_value;
         bool is_rest { false };
+        Optional<size_t> frame_slot {};
     };
 
     const FlyString& name() const { return m_name; }
@@ -227,6 +288,7 @@ public:
     const Vector<Parameter>& parameters() const { return m_parameters; };
     i32 function_length() const { return m_function_length; }
     bool is_strict_mode() const { return m_is_strict_mode; }
+    const NonnullRefPtrVector<VariableDeclaration>& variables() const { return m_variables; }
 
 protected:
     FunctionNode(const FlyString& name, NonnullRefPtr<Statement> body, Vector<Parameter> parameters, i32 function_length, NonnullRefPtrVector<VariableDeclaration> variables, bool is_strict_mode)
@@ -241,8 +303,6 @@ protected:
 
     void dump(int indent, const char* class_name) const;
 
-    const NonnullRefPtrVector<VariableDeclaration>& variables() const { return m_variables; }
-
 private:
     FlyString m_name;
     NonnullRefPtr<Statement> m_body;
@@ -284,6 +344,8 @@ public:
     {
     }
 
+    bool is_arrow_function() const { return m_is_arrow_function; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -527,6 +589,10 @@ public:
     {
     }
 
+    BinaryOp op() const { return m_op; }
+    const Expression& lhs() const { return *m_lhs; }
+    const Expression& rhs() const { return *m_rhs; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -554,6 +620,10 @@ public:
     {
     }
 
+    LogicalOp op() const { return m_op; }
+    const Expression& lhs() const { return *m_lhs; }
+    const Expression& rhs() const { return *m_rhs; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -584,6 +654,9 @@ public:
     {
     }
 
+    UnaryOp op() const { return m_op; }
+    const Expression& lhs() const { return *m_lhs; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -602,6 +675,8 @@ public:
     {
     }
 
+    const NonnullRefPtrVector<Expression>& expressions() const { return m_expressions; }
+
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
 
@@ -627,6 +702,8 @@ public:
     {
     }
 
+    bool value() const { return m_value; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -644,6 +721,8 @@ public:
     {
     }
 
+    double value() const { return m_value; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -661,6 +740,8 @@ public:
     {
     }
 
+    const String& value() const { return m_value; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -738,6 +819,18 @@ public:
 
     const FlyString& string() const { return m_string; }
 
+    // Set by the parser if this refers to a binding that is never accessed from a
+    // nested function or from inside a `with` statement. Such bindings live in a
+    // slot of the current CallFrame rather than in a LexicalEnvironment.
+    bool has_frame_slot() const { return m_frame_slot.has_value(); }
+    size_t frame_slot() const { return m_frame_slot.value(); }
+    bool is_const_frame_slot() const { return m_is_const_frame_slot; }
+    void set_frame_slot(size_t slot, bool is_const)
+    {
+        m_frame_slot = slot;
+        m_is_const_frame_slot = is_const;
+    }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
     virtual Reference to_reference(Interpreter&, GlobalObject&) const override;
@@ -746,6 +839,8 @@ private:
     virtual const char* class_name() const override { return "Identifier"; }
 
     FlyString m_string;
+    Optional<size_t> m_frame_slot;
+    bool m_is_const_frame_slot { false };
 };
 
 class ClassMethod final : public ASTNode {
@@ -766,6 +861,7 @@ public:
     }
 
     const Expression& key() const { return *m_key; }
+    const FunctionExpression& function() const { return *m_function; }
     Kind kind() const { return m_kind; }
     bool is_static() const { return m_is_static; }
 
@@ -807,6 +903,9 @@ public:
     }
 
     StringView name() const { return m_name; }
+    const FunctionExpression* constructor() const { return m_constructor; }
+    const Expression* super_class() const { return m_super_class; }
+    const NonnullRefPtrVector<ClassMethod>& methods() const { return m_methods; }
 
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
@@ -828,6 +927,8 @@ public:
     {
     }
 
+    const ClassExpression& class_expression() const { return *m_class_expression; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -844,6 +945,8 @@ public:
     {
     }
 
+    const Expression& target() const { return *m_target; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -880,6 +983,11 @@ public:
     {
     }
 
+    const Expression& callee() const { return *m_callee; }
+    const Vector<Argument>& arguments() const { return m_arguments; }
+
+    void throw_type_error_for_callee(Interpreter&, GlobalObject&, Value callee) const;
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -936,6 +1044,10 @@ public:
     {
     }
 
+    AssignmentOp op() const { return m_op; }
+    const Expression& lhs() const { return *m_lhs; }
+    const Expression& rhs() const { return *m_rhs; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -945,6 +1057,7 @@ private:
     AssignmentOp m_op;
     NonnullRefPtr<Expression> m_lhs;
     NonnullRefPtr<Expression> m_rhs;
+    mutable PropertyCache m_property_cache;
 };
 
 enum class UpdateOp {
@@ -962,6 +1075,10 @@ public:
     {
     }
 
+    UpdateOp op() const { return m_op; }
+    const Expression& argument() const { return *m_argument; }
+    bool is_prefixed() const { return m_prefixed; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -1055,6 +1172,8 @@ public:
         return *m_value;
     }
 
+    // Spread properties don't have a value.
+    const Expression* value_or_null() const { return m_value; }
     Type type() const { return m_property_type; }
     bool is_method() const { return m_is_method; }
 
@@ -1078,6 +1197,8 @@ public:
     {
     }
 
+    const NonnullRefPtrVector<ObjectProperty>& properties() const { return m_properties; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -1143,6 +1264,9 @@ public:
     {
     }
 
+    const Expression& tag() const { return *m_tag; }
+    const TemplateLiteral& template_literal() const { return *m_template_literal; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -1173,6 +1297,9 @@ public:
 
     PropertyName computed_property_name(Interpreter&, GlobalObject&) const;
 
+    // Gets the property from the object this expression evaluated to, going through its inline cache unless the name is computed.
+    Value get_property(Object&, const PropertyName&) const;
+
     String to_string_approximation() const;
 
 private:
@@ -1181,6 +1308,7 @@ private:
     NonnullRefPtr<Expression> m_object;
     NonnullRefPtr<Expression> m_property;
     bool m_computed { false };
+    mutable PropertyCache m_property_cache;
 };
 
 class MetaProperty final : public Expression {
@@ -1196,6 +1324,8 @@ public:
     {
     }
 
+    Type type() const { return m_type; }
+
     virtual Value execute(Interpreter&, GlobalObject&) const override;
     virtual void dump(int indent) const override;
 
@@ -1215,6 +1345,10 @@ public:
     {
     }
 
+    const Expression& test() const { return *m_test; }
+    const Expression& consequent() const { return *m_consequent; }
+    const Expression& alternate() const { return *m_alternate; }
+
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
 
@@ -1323,6 +1457,9 @@ public:
     {
     }
 
+    const Expression& discriminant() const { return *m_discriminant; }
+    const NonnullRefPtrVector<SwitchCase>& cases() const { return m_cases; }
+
     virtual void dump(int indent) const override;
     virtual Value execute(Interpreter&, GlobalObject&) const override;
 
@@ -1382,4 +1519,7 @@ private:
     virtual const char* class_name() const override { return "DebuggerStatement"; }
 };
 
+void update_function_name(Value, const FlyString& name);
+String get_function_name(GlobalObject&, Value);
+
 }
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Format.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Runtime/VM.h>
+
+namespace JS::Bytecode {
+
+String Executable::instruction_to_string(const Instruction& instruction) const
+{
+    auto a = instruction.a;
+    auto b = instruction.b;
+    auto c = instruction.c;
+
+    switch (instruction.opcode) {
+    case Opcode::LoadConstant:
+        return String::formatted("r{}, {}", a, constant(b).is_empty() ? "<empty>" : constant(b).to_string_without_side_effects());
+    case Opcode::LoadString:
+        return String::formatted("r{}, \"{}\"", a, string(b));
+    case Opcode::LoadGlobalObject:
+    case Opcode::LoadThis:
+    case Opcode::Throw:
+    case Opcode::Return:
+    case Opcode::SetLastValue:
+        return String::formatted("r{}", a);
+    case Opcode::NewArray:
+        return String::formatted("r{}, [r{}; {}]", a, b, c);
+    case Opcode::GetVariable:
+    case Opcode::SetVariable:
+    case Opcode::DeclareVariable:
+        return String::formatted("r{}, {}", a, identifier(b));
+    case Opcode::GetFrameSlot:
+        return String::formatted("r{}, slot{}", a, b);
+    case Opcode::SetFrameSlot:
+        return String::formatted("r{}, slot{} ({}{})", a, b, identifier(c), instruction.d ? ", const" : "");
+    case Opcode::GetById:
+        return String::formatted("r{}, r{}.{}", a, b, identifier(c));
+    case Opcode::GetByValue:
+        return String::formatted("r{}, r{}[r{}]", a, b, c);
+    case Opcode::PutById:
+        return String::formatted("r{}.{}, r{}", a, identifier(b), c);
+    case Opcode::PutByValue:
+        return String::formatted("r{}[r{}], r{}", a, b, c);
+    case Opcode::Jump:
+        return String::formatted("@{}", a);
+    case Opcode::JumpIfTrue:
+    case Opcode::JumpIfFalse:
+    case Opcode::JumpIfNotNullish:
+        return String::formatted("r{}, @{}", a, b);
+    case Opcode::Call:
+        return String::formatted("r{}, r{}, this=r{}, [r{}; {}]", a, b, b + 1, b + 2, c);
+    case Opcode::New:
+        return String::formatted("r{}, r{}, [r{}; {}]", a, b, b + 2, c);
+    case Opcode::EnterScope:
+        return String::formatted("{} ({})", node(a).class_name(), b == static_cast<u32>(ScopeType::Function) ? "function" : "block");
+    case Opcode::ExitScope:
+        return {};
+    case Opcode::EvaluateNode:
+    case Opcode::EvaluateStatement:
+        return String::formatted("r{}, {}", a, node(b).class_name());
+#define __JS_ENUMERATE_BYTECODE_OP(name, abstract_operation) \
+    case Opcode::name:
+        JS_ENUMERATE_BYTECODE_BINARY_OPS
+        return String::formatted("r{}, r{}, r{}", a, b, c);
+        JS_ENUMERATE_BYTECODE_UNARY_OPS
+    case Opcode::Move:
+    case Opcode::ToObject:
+    case Opcode::ToPropertyKey:
+        return String::formatted("r{}, r{}", a, b);
+#undef __JS_ENUMERATE_BYTECODE_OP
+    }
+    ASSERT_NOT_REACHED();
+}
+
+void Executable::dump() const
+{
+    outln("Bytecode for {} ({} registers):", m_root.class_name(), m_register_count);
+    for (size_t i = 0; i < m_instructions.size(); ++i) {
+        auto& instruction = m_instructions[i];
+        outln("[{:4}] {:18} {}", i, opcode_name(instruction.opcode), instruction_to_string(instruction));
+    }
+}
+
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Instruction.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/PropertyCache.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS::Bytecode {
+
+// A break or continue executed by the AST interpreter, inside a statement the
+// generator left to it, is resumed at the first matching target of the
+// statement's unwind handler.
+struct UnwindTarget {
+    FlyString label;
+    bool is_loop { false };
+    u32 break_target { 0 };
+    u32 continue_target { 0 };
+    u32 scope_depth { 0 };
+};
+
+class Executable {
+public:
+    const ScopeNode& root() const { return m_root; }
+    const Vector<Instruction>& instructions() const { return m_instructions; }
+    size_t register_count() const { return m_register_count; }
+
+    Value constant(u32 index) const { return m_constants[index]; }
+    const String& string(u32 index) const { return m_strings[index]; }
+    const FlyString& identifier(u32 index) const { return m_identifiers[index]; }
+    const ASTNode& node(u32 index) const { return *m_nodes[index]; }
+    const Vector<UnwindTarget>& unwind_handler(u32 index) const { return m_unwind_handlers[index]; }
+    PropertyCache& property_cache(u32 index) const { return m_property_caches[index]; }
+
+    void dump() const;
+
+private:
+    friend class Generator;
+
+    explicit Executable(const ScopeNode& root)
+        : m_root(root)
+    {
+    }
+
+    String instruction_to_string(const Instruction&) const;
+
+    const ScopeNode& m_root;
+    Vector<Instruction> m_instructions;
+    size_t m_register_count { 0 };
+
+    // Constants are never cells, strings are created when they are loaded.
+    // This keeps the Executable invisible to the garbage collector.
+    Vector<Value> m_constants;
+    Vector<String> m_strings;
+    Vector<FlyString> m_identifiers;
+    Vector<const ASTNode*> m_nodes;
+    Vector<Vector<UnwindTarget>> m_unwind_handlers;
+
+    // These are filled in as the executable runs.
+    mutable Vector<PropertyCache> m_property_caches;
+
+    // Scopes the generator had to make up, like the one holding the let and
+    // const declarations of a for loop's init clause.
+    NonnullRefPtrVector<ScopeNode> m_synthesized_scopes;
+};
+
+}
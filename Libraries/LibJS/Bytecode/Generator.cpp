@@ -0,0 +1,811 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Generator.h>
+#include <LibJS/Runtime/VM.h>
+
+namespace JS::Bytecode {
+
+NonnullOwnPtr<Executable> Generator::generate(const ScopeNode& root)
+{
+    auto executable = adopt_own(*new Executable(root));
+    Generator generator(*executable);
+
+    // A Program leaves the value of its last statement behind for the REPL,
+    // so every top-level statement gets to write its completion value.
+    bool is_program = is<Program>(root);
+    auto scope_type = is_program ? ScopeType::Block : ScopeType::Function;
+    generator.emit(Opcode::EnterScope, generator.add_node(root), static_cast<u32>(scope_type));
+    generator.m_scope_depth = 1;
+
+    Optional<Register> completion;
+    if (is_program) {
+        completion = generator.allocate_register();
+        if (root.children().is_empty()) {
+            generator.emit_load_constant(*completion, js_undefined());
+            generator.emit(Opcode::SetLastValue, *completion);
+        }
+    }
+
+    for (auto& child : root.children()) {
+        generator.generate_statement(child, completion);
+        if (is_program)
+            generator.emit(Opcode::SetLastValue, *completion);
+    }
+
+    auto result = generator.allocate_register();
+    generator.emit_load_constant(result, js_undefined());
+    generator.emit(Opcode::Return, result);
+
+    generator.resolve_labels();
+    return executable;
+}
+
+Generator::Generator(Executable& executable)
+    : m_executable(executable)
+{
+}
+
+Generator::Register Generator::allocate_register()
+{
+    auto reg = m_next_register++;
+    if (m_next_register > m_executable.m_register_count)
+        m_executable.m_register_count = m_next_register;
+    return reg;
+}
+
+Generator::Label Generator::make_label()
+{
+    m_label_positions.append(Optional<u32> {});
+    return m_label_positions.size() - 1;
+}
+
+void Generator::bind(Label label)
+{
+    ASSERT(!m_label_positions[label].has_value());
+    m_label_positions[label] = m_executable.m_instructions.size();
+}
+
+void Generator::emit(Opcode opcode, u32 a, u32 b, u32 c, u32 d)
+{
+    m_executable.m_instructions.append({ opcode, a, b, c, d });
+}
+
+void Generator::emit_load_constant(Register dst, Value value)
+{
+    ASSERT(!value.is_cell());
+    m_executable.m_constants.append(value);
+    emit(Opcode::LoadConstant, dst, m_executable.m_constants.size() - 1);
+}
+
+void Generator::emit_exit_scopes(u32 target_depth)
+{
+    for (auto depth = m_scope_depth; depth > target_depth; --depth)
+        emit(Opcode::ExitScope);
+}
+
+u32 Generator::add_identifier(const FlyString& identifier)
+{
+    if (auto it = m_identifier_indices.find(identifier); it != m_identifier_indices.end())
+        return it->value;
+    u32 index = m_executable.m_identifiers.size();
+    m_executable.m_identifiers.append(identifier);
+    m_identifier_indices.set(identifier, index);
+    return index;
+}
+
+void Generator::emit_get_variable(Register dst, const Identifier& identifier)
+{
+    if (identifier.has_frame_slot())
+        emit(Opcode::GetFrameSlot, dst, identifier.frame_slot());
+    else
+        emit(Opcode::GetVariable, dst, add_identifier(identifier.string()));
+}
+
+void Generator::emit_set_variable(Register value, const Identifier& identifier, bool is_declaration)
+{
+    auto name = add_identifier(identifier.string());
+    if (identifier.has_frame_slot())
+        emit(Opcode::SetFrameSlot, value, identifier.frame_slot(), name, !is_declaration && identifier.is_const_frame_slot());
+    else
+        emit(is_declaration ? Opcode::DeclareVariable : Opcode::SetVariable, value, name);
+}
+
+u32 Generator::add_node(const ASTNode& node)
+{
+    m_executable.m_nodes.append(&node);
+    return m_executable.m_nodes.size() - 1;
+}
+
+u32 Generator::add_property_cache()
+{
+    m_executable.m_property_caches.append(PropertyCache {});
+    return m_executable.m_property_caches.size() - 1;
+}
+
+void Generator::resolve_labels()
+{
+    auto position = [&](Label label) -> u32 { return m_label_positions[label].value(); };
+
+    for (auto& instruction : m_executable.m_instructions) {
+        switch (instruction.opcode) {
+        case Opcode::Jump:
+            instruction.a = position(instruction.a);
+            break;
+        case Opcode::JumpIfTrue:
+        case Opcode::JumpIfFalse:
+        case Opcode::JumpIfNotNullish:
+            instruction.b = position(instruction.b);
+            break;
+        default:
+            break;
+        }
+    }
+
+    for (auto& handler : m_executable.m_unwind_handlers) {
+        for (auto& target : handler) {
+            target.break_target = position(target.break_target);
+            if (target.is_loop)
+                target.continue_target = position(target.continue_target);
+        }
+    }
+}
+
+void Generator::generate_statement(const Statement& statement, Optional<Register> completion)
+{
+    // Registers only live for the duration of a statement.
+    auto first_free_register = m_next_register;
+
+    if (is<ExpressionStatement>(statement)) {
+        auto dst = completion.has_value() ? *completion : allocate_register();
+        generate_expression(static_cast<const ExpressionStatement&>(statement).expression(), dst);
+    } else if (is<BlockStatement>(statement)) {
+        generate_block(static_cast<const BlockStatement&>(statement), completion);
+    } else if (is<EmptyStatement>(statement) || is<FunctionDeclaration>(statement)) {
+        if (completion.has_value())
+            emit_load_constant(*completion, js_undefined());
+    } else if (is<VariableDeclaration>(statement)) {
+        generate_variable_declaration(static_cast<const VariableDeclaration&>(statement));
+        if (completion.has_value())
+            emit_load_constant(*completion, js_undefined());
+    } else if (is<IfStatement>(statement)) {
+        generate_if(static_cast<const IfStatement&>(statement), completion);
+    } else if (is<WhileStatement>(statement)) {
+        generate_while(static_cast<const WhileStatement&>(statement), completion);
+    } else if (is<DoWhileStatement>(statement)) {
+        generate_do_while(static_cast<const DoWhileStatement&>(statement), completion);
+    } else if (is<ForStatement>(statement)) {
+        generate_for(static_cast<const ForStatement&>(statement), completion);
+    } else if (is<ReturnStatement>(statement)) {
+        auto* argument = static_cast<const ReturnStatement&>(statement).argument();
+        auto value = allocate_register();
+        if (argument)
+            generate_expression(*argument, value);
+        else
+            emit_load_constant(value, js_undefined());
+        emit(Opcode::Return, value);
+    } else if (is<ThrowStatement>(statement)) {
+        auto value = allocate_register();
+        generate_expression(static_cast<const ThrowStatement&>(statement).argument(), value);
+        emit(Opcode::Throw, value);
+    } else if (is<BreakStatement>(statement)) {
+        if (!generate_break_or_continue(static_cast<const BreakStatement&>(statement).target_label(), false, completion))
+            generate_evaluate_statement(statement, completion);
+    } else if (is<ContinueStatement>(statement)) {
+        if (!generate_break_or_continue(static_cast<const ContinueStatement&>(statement).target_label(), true, completion))
+            generate_evaluate_statement(statement, completion);
+    } else {
+        generate_evaluate_statement(statement, completion);
+    }
+
+    m_next_register = first_free_register;
+}
+
+void Generator::generate_block(const BlockStatement& block, Optional<Register> completion)
+{
+    // Blocks without declarations don't need a scope of their own.
+    bool needs_scope = !block.variables().is_empty() || !block.functions().is_empty();
+    if (needs_scope) {
+        emit(Opcode::EnterScope, add_node(block), static_cast<u32>(ScopeType::Block));
+        ++m_scope_depth;
+    }
+
+    if (completion.has_value())
+        emit_load_constant(*completion, js_undefined());
+
+    Optional<Label> end;
+    if (!block.label().is_null()) {
+        end = make_label();
+        m_breakable_scopes.append({ block.label(), false, *end, 0, m_scope_depth });
+    }
+
+    for (auto& child : block.children())
+        generate_statement(child, {});
+
+    if (end.has_value()) {
+        m_breakable_scopes.take_last();
+        bind(*end);
+    }
+
+    if (needs_scope) {
+        emit(Opcode::ExitScope);
+        --m_scope_depth;
+    }
+}
+
+void Generator::generate_if(const IfStatement& if_statement, Optional<Register> completion)
+{
+    auto predicate = allocate_register();
+    generate_expression(if_statement.predicate(), predicate);
+
+    auto end = make_label();
+    if (!if_statement.alternate() && !completion.has_value()) {
+        emit(Opcode::JumpIfFalse, predicate, end);
+        generate_statement(if_statement.consequent(), {});
+        bind(end);
+        return;
+    }
+
+    auto alternate = make_label();
+    emit(Opcode::JumpIfFalse, predicate, alternate);
+    generate_statement(if_statement.consequent(), completion);
+    emit(Opcode::Jump, end);
+    bind(alternate);
+    if (if_statement.alternate())
+        generate_statement(*if_statement.alternate(), completion);
+    else
+        emit_load_constant(*completion, js_undefined());
+    bind(end);
+}
+
+void Generator::generate_while(const WhileStatement& while_statement, Optional<Register> completion)
+{
+    if (completion.has_value())
+        emit_load_constant(*completion, js_undefined());
+
+    auto test = make_label();
+    auto end = make_label();
+    bind(test);
+    auto test_result = allocate_register();
+    generate_expression(while_statement.test(), test_result);
+    emit(Opcode::JumpIfFalse, test_result, end);
+
+    m_breakable_scopes.append({ while_statement.label(), true, end, test, m_scope_depth });
+    generate_statement(while_statement.body(), completion);
+    m_breakable_scopes.take_last();
+
+    emit(Opcode::Jump, test);
+    bind(end);
+}
+
+void Generator::generate_do_while(const DoWhileStatement& do_while_statement, Optional<Register> completion)
+{
+    if (completion.has_value())
+        emit_load_constant(*completion, js_undefined());
+
+    auto body = make_label();
+    auto test = make_label();
+    auto end = make_label();
+    bind(body);
+    m_breakable_scopes.append({ do_while_statement.label(), true, end, test, m_scope_depth });
+    generate_statement(do_while_statement.body(), completion);
+    m_breakable_scopes.take_last();
+
+    bind(test);
+    auto test_result = allocate_register();
+    generate_expression(do_while_statement.test(), test_result);
+    emit(Opcode::JumpIfTrue, test_result, body);
+    bind(end);
+}
+
+void Generator::generate_for(const ForStatement& for_statement, Optional<Register> completion)
+{
+    // Like ForStatement::execute(), give let and const declarations in the
+    // init clause a block scope around the whole loop.
+    auto* init = for_statement.init();
+    bool needs_scope = init && is<VariableDeclaration>(*init) && static_cast<const VariableDeclaration&>(*init).declaration_kind() != DeclarationKind::Var;
+    if (needs_scope) {
+        auto wrapper = create_ast_node<BlockStatement>(for_statement.source_range());
+        NonnullRefPtrVector<VariableDeclaration> declarations;
+        declarations.append(static_cast<const VariableDeclaration&>(*init));
+        wrapper->add_variables(declarations);
+        emit(Opcode::EnterScope, add_node(*wrapper), static_cast<u32>(ScopeType::Block));
+        ++m_scope_depth;
+        m_executable.m_synthesized_scopes.append(move(wrapper));
+    }
+
+    if (completion.has_value())
+        emit_load_constant(*completion, js_undefined());
+
+    if (init) {
+        if (is<VariableDeclaration>(*init))
+            generate_variable_declaration(static_cast<const VariableDeclaration&>(*init));
+        else if (is<Expression>(*init))
+            generate_expression(static_cast<const Expression&>(*init), allocate_register());
+        else
+            emit(Opcode::EvaluateNode, allocate_register(), add_node(*init));
+    }
+
+    auto test = make_label();
+    auto update = make_label();
+    auto end = make_label();
+    bind(test);
+    if (for_statement.test()) {
+        auto test_result = allocate_register();
+        generate_expression(*for_statement.test(), test_result);
+        emit(Opcode::JumpIfFalse, test_result, end);
+    }
+
+    m_breakable_scopes.append({ for_statement.label(), true, end, update, m_scope_depth });
+    generate_statement(for_statement.body(), completion);
+    m_breakable_scopes.take_last();
+
+    bind(update);
+    if (for_statement.update())
+        generate_expression(*for_statement.update(), allocate_register());
+    emit(Opcode::Jump, test);
+    bind(end);
+
+    if (needs_scope) {
+        emit(Opcode::ExitScope);
+        --m_scope_depth;
+    }
+}
+
+void Generator::generate_variable_declaration(const VariableDeclaration& declaration)
+{
+    for (auto& declarator : declaration.declarations()) {
+        auto* init = declarator.init();
+        if (!init)
+            continue;
+        auto value = allocate_register();
+        generate_expression(*init, value);
+        emit_set_variable(value, declarator.id(), true);
+    }
+}
+
+bool Generator::generate_break_or_continue(const FlyString& target_label, bool is_continue, Optional<Register> completion)
+{
+    // This resolves targets the same way the AST interpreter's loops and
+    // labelled blocks catch an unwind, so an unlabelled break leaves the
+    // innermost labelled block even when that is inside a loop.
+    for (ssize_t i = m_breakable_scopes.size() - 1; i >= 0; --i) {
+        auto& scope = m_breakable_scopes[i];
+        if (is_continue && !scope.is_loop)
+            continue;
+        if (!target_label.is_null() && target_label != scope.label)
+            continue;
+        if (completion.has_value())
+            emit_load_constant(*completion, js_undefined());
+        emit_exit_scopes(scope.scope_depth);
+        emit(Opcode::Jump, is_continue ? scope.continue_target : scope.break_target);
+        return true;
+    }
+    return false;
+}
+
+void Generator::generate_evaluate_statement(const Statement& statement, Optional<Register> completion)
+{
+    Vector<UnwindTarget> handler;
+    for (ssize_t i = m_breakable_scopes.size() - 1; i >= 0; --i) {
+        auto& scope = m_breakable_scopes[i];
+        handler.append({ scope.label, scope.is_loop, scope.break_target, scope.continue_target, scope.scope_depth });
+    }
+    m_executable.m_unwind_handlers.append(move(handler));
+
+    auto dst = completion.has_value() ? *completion : allocate_register();
+    emit(Opcode::EvaluateStatement, dst, add_node(statement), m_executable.m_unwind_handlers.size() - 1);
+}
+
+static Opcode opcode_for_binary_op(BinaryOp op)
+{
+    switch (op) {
+    case BinaryOp::Addition:
+        return Opcode::Add;
+    case BinaryOp::Subtraction:
+        return Opcode::Sub;
+    case BinaryOp::Multiplication:
+        return Opcode::Mul;
+    case BinaryOp::Division:
+        return Opcode::Div;
+    case BinaryOp::Modulo:
+        return Opcode::Mod;
+    case BinaryOp::Exponentiation:
+        return Opcode::Exp;
+    case BinaryOp::TypedEquals:
+        return Opcode::TypedEquals;
+    case BinaryOp::TypedInequals:
+        return Opcode::TypedInequals;
+    case BinaryOp::AbstractEquals:
+        return Opcode::AbstractEquals;
+    case BinaryOp::AbstractInequals:
+        return Opcode::AbstractInequals;
+    case BinaryOp::GreaterThan:
+        return Opcode::GreaterThan;
+    case BinaryOp::GreaterThanEquals:
+        return Opcode::GreaterThanEquals;
+    case BinaryOp::LessThan:
+        return Opcode::LessThan;
+    case BinaryOp::LessThanEquals:
+        return Opcode::LessThanEquals;
+    case BinaryOp::BitwiseAnd:
+        return Opcode::BitwiseAnd;
+    case BinaryOp::BitwiseOr:
+        return Opcode::BitwiseOr;
+    case BinaryOp::BitwiseXor:
+        return Opcode::BitwiseXor;
+    case BinaryOp::LeftShift:
+        return Opcode::LeftShift;
+    case BinaryOp::RightShift:
+        return Opcode::RightShift;
+    case BinaryOp::UnsignedRightShift:
+        return Opcode::UnsignedRightShift;
+    case BinaryOp::In:
+        return Opcode::In;
+    case BinaryOp::InstanceOf:
+        return Opcode::InstanceOf;
+    }
+    ASSERT_NOT_REACHED();
+}
+
+static Optional<Opcode> opcode_for_compound_assignment(AssignmentOp op)
+{
+    switch (op) {
+    case AssignmentOp::AdditionAssignment:
+        return Opcode::Add;
+    case AssignmentOp::SubtractionAssignment:
+        return Opcode::Sub;
+    case AssignmentOp::MultiplicationAssignment:
+        return Opcode::Mul;
+    case AssignmentOp::DivisionAssignment:
+        return Opcode::Div;
+    case AssignmentOp::ModuloAssignment:
+        return Opcode::Mod;
+    case AssignmentOp::ExponentiationAssignment:
+        return Opcode::Exp;
+    case AssignmentOp::BitwiseAndAssignment:
+        return Opcode::BitwiseAnd;
+    case AssignmentOp::BitwiseOrAssignment:
+        return Opcode::BitwiseOr;
+    case AssignmentOp::BitwiseXorAssignment:
+        return Opcode::BitwiseXor;
+    case AssignmentOp::LeftShiftAssignment:
+        return Opcode::LeftShift;
+    case AssignmentOp::RightShiftAssignment:
+        return Opcode::RightShift;
+    case AssignmentOp::UnsignedRightShiftAssignment:
+        return Opcode::UnsignedRightShift;
+    default:
+        return {};
+    }
+}
+
+void Generator::generate_expression(const Expression& expression, Register dst)
+{
+    if (is<NumericLiteral>(expression)) {
+        emit_load_constant(dst, Value(static_cast<const NumericLiteral&>(expression).value()));
+        return;
+    }
+    if (is<BooleanLiteral>(expression)) {
+        emit_load_constant(dst, Value(static_cast<const BooleanLiteral&>(expression).value()));
+        return;
+    }
+    if (is<NullLiteral>(expression)) {
+        emit_load_constant(dst, js_null());
+        return;
+    }
+    if (is<StringLiteral>(expression)) {
+        m_executable.m_strings.append(static_cast<const StringLiteral&>(expression).value());
+        emit(Opcode::LoadString, dst, m_executable.m_strings.size() - 1);
+        return;
+    }
+    if (is<Identifier>(expression)) {
+        emit_get_variable(dst, static_cast<const Identifier&>(expression));
+        return;
+    }
+    if (is<ThisExpression>(expression)) {
+        emit(Opcode::LoadThis, dst);
+        return;
+    }
+    if (is<BinaryExpression>(expression)) {
+        auto& binary_expression = static_cast<const BinaryExpression&>(expression);
+        auto rhs = allocate_register();
+        generate_expression(binary_expression.lhs(), dst);
+        generate_expression(binary_expression.rhs(), rhs);
+        emit(opcode_for_binary_op(binary_expression.op()), dst, dst, rhs);
+        return;
+    }
+    if (is<LogicalExpression>(expression)) {
+        auto& logical_expression = static_cast<const LogicalExpression&>(expression);
+        auto end = make_label();
+        generate_expression(logical_expression.lhs(), dst);
+        switch (logical_expression.op()) {
+        case LogicalOp::And:
+            emit(Opcode::JumpIfFalse, dst, end);
+            break;
+        case LogicalOp::Or:
+            emit(Opcode::JumpIfTrue, dst, end);
+            break;
+        case LogicalOp::NullishCoalescing:
+            emit(Opcode::JumpIfNotNullish, dst, end);
+            break;
+        }
+        generate_expression(logical_expression.rhs(), dst);
+        bind(end);
+        return;
+    }
+    if (is<ConditionalExpression>(expression)) {
+        auto& conditional_expression = static_cast<const ConditionalExpression&>(expression);
+        auto alternate = make_label();
+        auto end = make_label();
+        auto test_result = allocate_register();
+        generate_expression(conditional_expression.test(), test_result);
+        emit(Opcode::JumpIfFalse, test_result, alternate);
+        generate_expression(conditional_expression.consequent(), dst);
+        emit(Opcode::Jump, end);
+        bind(alternate);
+        generate_expression(conditional_expression.alternate(), dst);
+        bind(end);
+        return;
+    }
+    if (is<SequenceExpression>(expression)) {
+        for (auto& subexpression : static_cast<const SequenceExpression&>(expression).expressions())
+            generate_expression(subexpression, dst);
+        return;
+    }
+    if (is<UnaryExpression>(expression)) {
+        auto& unary_expression = static_cast<const UnaryExpression&>(expression);
+        Optional<Opcode> opcode;
+        switch (unary_expression.op()) {
+        case UnaryOp::Not:
+            opcode = Opcode::Not;
+            break;
+        case UnaryOp::BitwiseNot:
+            opcode = Opcode::BitwiseNot;
+            break;
+        case UnaryOp::Plus:
+            opcode = Opcode::UnaryPlus;
+            break;
+        case UnaryOp::Minus:
+            opcode = Opcode::UnaryMinus;
+            break;
+        case UnaryOp::Void:
+            generate_expression(unary_expression.lhs(), dst);
+            emit_load_constant(dst, js_undefined());
+            return;
+        case UnaryOp::Typeof:
+        case UnaryOp::Delete:
+            break;
+        }
+        if (opcode.has_value()) {
+            generate_expression(unary_expression.lhs(), dst);
+            emit(*opcode, dst, dst);
+            return;
+        }
+    }
+    if (is<MemberExpression>(expression) && generate_member_expression(static_cast<const MemberExpression&>(expression), dst))
+        return;
+    if (is<AssignmentExpression>(expression) && generate_assignment(static_cast<const AssignmentExpression&>(expression), dst))
+        return;
+    if (is<UpdateExpression>(expression) && generate_update(static_cast<const UpdateExpression&>(expression), dst))
+        return;
+    if (is<CallExpression>(expression) && generate_call(static_cast<const CallExpression&>(expression), dst))
+        return;
+    if (is<ArrayExpression>(expression) && generate_array(static_cast<const ArrayExpression&>(expression), dst))
+        return;
+
+    emit(Opcode::EvaluateNode, dst, add_node(expression));
+}
+
+bool Generator::generate_member_expression(const MemberExpression& member_expression, Register dst)
+{
+    if (is<SuperExpression>(member_expression.object()))
+        return false;
+    if (!member_expression.is_computed() && !is<Identifier>(member_expression.property()))
+        return false;
+
+    generate_expression(member_expression.object(), dst);
+    if (!member_expression.is_computed()) {
+        auto& name = static_cast<const Identifier&>(member_expression.property()).string();
+        emit(Opcode::GetById, dst, dst, add_identifier(name), add_property_cache());
+        return true;
+    }
+
+    // The base is converted to an object before the key is evaluated.
+    auto key = allocate_register();
+    emit(Opcode::ToObject, dst, dst);
+    generate_expression(member_expression.property(), key);
+    emit(Opcode::GetByValue, dst, dst, key);
+    return true;
+}
+
+bool Generator::generate_assignment(const AssignmentExpression& assignment_expression, Register dst)
+{
+    auto op = assignment_expression.op();
+    auto& lhs = assignment_expression.lhs();
+
+    if (is<Identifier>(lhs)) {
+        auto& identifier = static_cast<const Identifier&>(lhs);
+        if (op == AssignmentOp::Assignment) {
+            generate_expression(assignment_expression.rhs(), dst);
+            emit_set_variable(dst, identifier);
+            return true;
+        }
+
+        emit_get_variable(dst, identifier);
+        if (auto opcode = opcode_for_compound_assignment(op); opcode.has_value()) {
+            auto rhs = allocate_register();
+            generate_expression(assignment_expression.rhs(), rhs);
+            emit(*opcode, dst, dst, rhs);
+            emit_set_variable(dst, identifier);
+            return true;
+        }
+
+        auto end = make_label();
+        switch (op) {
+        case AssignmentOp::AndAssignment:
+            emit(Opcode::JumpIfFalse, dst, end);
+            break;
+        case AssignmentOp::OrAssignment:
+            emit(Opcode::JumpIfTrue, dst, end);
+            break;
+        case AssignmentOp::NullishAssignment:
+            emit(Opcode::JumpIfNotNullish, dst, end);
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+        }
+        generate_expression(assignment_expression.rhs(), dst);
+        emit_set_variable(dst, identifier);
+        bind(end);
+        return true;
+    }
+
+    // Compound assignments to members evaluate their base and key twice in
+    // the AST interpreter; leave those to it rather than changing behavior.
+    if (op != AssignmentOp::Assignment || !is<MemberExpression>(lhs))
+        return false;
+    auto& member_expression = static_cast<const MemberExpression&>(lhs);
+    if (is<SuperExpression>(member_expression.object()))
+        return false;
+    if (!member_expression.is_computed() && !is<Identifier>(member_expression.property()))
+        return false;
+
+    auto object = allocate_register();
+    generate_expression(member_expression.object(), object);
+    if (!member_expression.is_computed()) {
+        generate_expression(assignment_expression.rhs(), dst);
+        auto& name = static_cast<const Identifier&>(member_expression.property()).string();
+        emit(Opcode::PutById, object, add_identifier(name), dst, add_property_cache());
+        return true;
+    }
+
+    auto key = allocate_register();
+    generate_expression(member_expression.property(), key);
+    emit(Opcode::ToPropertyKey, key, key);
+    generate_expression(assignment_expression.rhs(), dst);
+    emit(Opcode::PutByValue, object, key, dst);
+    return true;
+}
+
+bool Generator::generate_update(const UpdateExpression& update_expression, Register dst)
+{
+    if (!is<Identifier>(update_expression.argument()))
+        return false;
+
+    auto& identifier = static_cast<const Identifier&>(update_expression.argument());
+    auto opcode = update_expression.op() == UpdateOp::Increment ? Opcode::Increment : Opcode::Decrement;
+    emit_get_variable(dst, identifier);
+    emit(Opcode::ToNumeric, dst, dst);
+    if (update_expression.is_prefixed()) {
+        emit(opcode, dst, dst);
+        emit_set_variable(dst, identifier);
+    } else {
+        auto new_value = allocate_register();
+        emit(opcode, new_value, dst);
+        emit_set_variable(new_value, identifier);
+    }
+    return true;
+}
+
+bool Generator::generate_call(const CallExpression& call_expression, Register dst)
+{
+    auto& callee = call_expression.callee();
+    if (is<SuperExpression>(callee))
+        return false;
+    for (auto& argument : call_expression.arguments()) {
+        if (argument.is_spread)
+            return false;
+    }
+
+    bool is_new = is<NewExpression>(call_expression);
+    bool is_method_call = !is_new && is<MemberExpression>(callee);
+    if (is_method_call) {
+        auto& member_expression = static_cast<const MemberExpression&>(callee);
+        if (is<SuperExpression>(member_expression.object()))
+            return false;
+        if (!member_expression.is_computed() && !is<Identifier>(member_expression.property()))
+            return false;
+    }
+
+    // The callee, |this| and the arguments have to be in consecutive registers.
+    auto first = allocate_register();
+    auto this_value = allocate_register();
+    auto argument_count = call_expression.arguments().size();
+    for (size_t i = 0; i < argument_count; ++i)
+        allocate_register();
+
+    if (is_method_call) {
+        auto& member_expression = static_cast<const MemberExpression&>(callee);
+        generate_expression(member_expression.object(), this_value);
+        emit(Opcode::ToObject, this_value, this_value);
+        if (member_expression.is_computed()) {
+            auto key = allocate_register();
+            generate_expression(member_expression.property(), key);
+            emit(Opcode::GetByValue, first, this_value, key);
+        } else {
+            auto& name = static_cast<const Identifier&>(member_expression.property()).string();
+            emit(Opcode::GetById, first, this_value, add_identifier(name), add_property_cache());
+        }
+    } else {
+        generate_expression(callee, first);
+        if (!is_new)
+            emit(Opcode::LoadGlobalObject, this_value);
+    }
+
+    for (size_t i = 0; i < argument_count; ++i)
+        generate_expression(call_expression.arguments()[i].value, this_value + 1 + i);
+
+    emit(is_new ? Opcode::New : Opcode::Call, dst, first, argument_count, add_node(call_expression));
+    return true;
+}
+
+bool Generator::generate_array(const ArrayExpression& array_expression, Register dst)
+{
+    auto& elements = array_expression.elements();
+    for (auto& element : elements) {
+        if (element && is<SpreadExpression>(*element))
+            return false;
+    }
+
+    auto first = m_next_register;
+    for (size_t i = 0; i < elements.size(); ++i)
+        allocate_register();
+
+    // Holes are appended as empty values, just like ArrayExpression::execute() does.
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (elements[i])
+            generate_expression(*elements[i], first + i);
+        else
+            emit_load_constant(first + i, {});
+    }
+
+    emit(Opcode::NewArray, dst, first, elements.size());
+    return true;
+}
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/FlyString.h>
+#include <AK/HashMap.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/Vector.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Forward.h>
+
+namespace JS::Bytecode {
+
+// Translates the body of a Program or function into register-based bytecode.
+// Whatever the generator doesn't know how to translate is evaluated by the
+// AST interpreter through EvaluateNode and EvaluateStatement instructions.
+class Generator {
+public:
+    static NonnullOwnPtr<Executable> generate(const ScopeNode&);
+
+private:
+    using Register = u32;
+    using Label = u32;
+
+    struct BreakableScope {
+        FlyString label;
+        bool is_loop { false };
+        Label break_target { 0 };
+        Label continue_target { 0 };
+        u32 scope_depth { 0 };
+    };
+
+    explicit Generator(Executable&);
+
+    Register allocate_register();
+    Label make_label();
+    void bind(Label);
+    void emit(Opcode, u32 a = 0, u32 b = 0, u32 c = 0, u32 d = 0);
+    void emit_load_constant(Register, Value);
+    void emit_exit_scopes(u32 target_depth);
+    u32 add_identifier(const FlyString&);
+    void emit_get_variable(Register dst, const Identifier&);
+    void emit_set_variable(Register value, const Identifier&, bool is_declaration = false);
+    u32 add_node(const ASTNode&);
+    u32 add_property_cache();
+    void resolve_labels();
+
+    void generate_statement(const Statement&, Optional<Register> completion);
+    void generate_block(const BlockStatement&, Optional<Register> completion);
+    void generate_if(const IfStatement&, Optional<Register> completion);
+    void generate_while(const WhileStatement&, Optional<Register> completion);
+    void generate_do_while(const DoWhileStatement&, Optional<Register> completion);
+    void generate_for(const ForStatement&, Optional<Register> completion);
+    void generate_variable_declaration(const VariableDeclaration&);
+    bool generate_break_or_continue(const FlyString& target_label, bool is_continue, Optional<Register> completion);
+    void generate_evaluate_statement(const Statement&, Optional<Register> completion);
+
+    void generate_expression(const Expression&, Register dst);
+    bool generate_member_expression(const MemberExpression&, Register dst);
+    bool generate_assignment(const AssignmentExpression&, Register dst);
+    bool generate_update(const UpdateExpression&, Register dst);
+    bool generate_call(const CallExpression&, Register dst);
+    bool generate_array(const ArrayExpression&, Register dst);
+
+    Executable& m_executable;
+    Register m_next_register { 0 };
+    u32 m_scope_depth { 0 };
+    Vector<BreakableScope> m_breakable_scopes;
+    Vector<Optional<u32>> m_label_positions;
+    // Where each identifier is in the executable's identifier table.
+    HashMap<FlyString, u32> m_identifier_indices;
+};
+
+}
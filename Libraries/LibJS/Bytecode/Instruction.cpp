@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Assertions.h>
+#include <LibJS/Bytecode/Instruction.h>
+
+namespace JS::Bytecode {
+
+const char* opcode_name(Opcode opcode)
+{
+    switch (opcode) {
+    case Opcode::LoadConstant:
+        return "LoadConstant";
+    case Opcode::LoadString:
+        return "LoadString";
+    case Opcode::LoadGlobalObject:
+        return "LoadGlobalObject";
+    case Opcode::LoadThis:
+        return "LoadThis";
+    case Opcode::Move:
+        return "Move";
+    case Opcode::NewArray:
+        return "NewArray";
+    case Opcode::GetVariable:
+        return "GetVariable";
+    case Opcode::SetVariable:
+        return "SetVariable";
+    case Opcode::DeclareVariable:
+        return "DeclareVariable";
+    case Opcode::GetFrameSlot:
+        return "GetFrameSlot";
+    case Opcode::SetFrameSlot:
+        return "SetFrameSlot";
+    case Opcode::GetById:
+        return "GetById";
+    case Opcode::GetByValue:
+        return "GetByValue";
+    case Opcode::PutById:
+        return "PutById";
+    case Opcode::PutByValue:
+        return "PutByValue";
+    case Opcode::ToObject:
+        return "ToObject";
+    case Opcode::ToPropertyKey:
+        return "ToPropertyKey";
+    case Opcode::Jump:
+        return "Jump";
+    case Opcode::JumpIfTrue:
+        return "JumpIfTrue";
+    case Opcode::JumpIfFalse:
+        return "JumpIfFalse";
+    case Opcode::JumpIfNotNullish:
+        return "JumpIfNotNullish";
+    case Opcode::Call:
+        return "Call";
+    case Opcode::New:
+        return "New";
+    case Opcode::Throw:
+        return "Throw";
+    case Opcode::Return:
+        return "Return";
+    case Opcode::EnterScope:
+        return "EnterScope";
+    case Opcode::ExitScope:
+        return "ExitScope";
+    case Opcode::SetLastValue:
+        return "SetLastValue";
+    case Opcode::EvaluateNode:
+        return "EvaluateNode";
+    case Opcode::EvaluateStatement:
+        return "EvaluateStatement";
+#define __JS_ENUMERATE_BYTECODE_OP(name, abstract_operation) \
+    case Opcode::name:                                       \
+        return #name;
+        JS_ENUMERATE_BYTECODE_BINARY_OPS
+        JS_ENUMERATE_BYTECODE_UNARY_OPS
+#undef __JS_ENUMERATE_BYTECODE_OP
+    }
+    ASSERT_NOT_REACHED();
+}
+
+}
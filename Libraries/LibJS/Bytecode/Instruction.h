@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+
+namespace JS::Bytecode {
+
+// Binary and unary operations map one-to-one onto the abstract operations
+// the AST interpreter uses, so they are enumerated together with them.
+#define JS_ENUMERATE_BYTECODE_BINARY_OPS                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Add, add)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Sub, sub)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Mul, mul)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Div, div)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Mod, mod)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(Exp, exp)                                  \
+    __JS_ENUMERATE_BYTECODE_OP(TypedEquals, typed_equals)                 \
+    __JS_ENUMERATE_BYTECODE_OP(TypedInequals, typed_inequals)             \
+    __JS_ENUMERATE_BYTECODE_OP(AbstractEquals, abstract_equals)           \
+    __JS_ENUMERATE_BYTECODE_OP(AbstractInequals, abstract_inequals)       \
+    __JS_ENUMERATE_BYTECODE_OP(GreaterThan, greater_than)                 \
+    __JS_ENUMERATE_BYTECODE_OP(GreaterThanEquals, greater_than_equals)    \
+    __JS_ENUMERATE_BYTECODE_OP(LessThan, less_than)                       \
+    __JS_ENUMERATE_BYTECODE_OP(LessThanEquals, less_than_equals)          \
+    __JS_ENUMERATE_BYTECODE_OP(BitwiseAnd, bitwise_and)                   \
+    __JS_ENUMERATE_BYTECODE_OP(BitwiseOr, bitwise_or)                     \
+    __JS_ENUMERATE_BYTECODE_OP(BitwiseXor, bitwise_xor)                   \
+    __JS_ENUMERATE_BYTECODE_OP(LeftShift, left_shift)                     \
+    __JS_ENUMERATE_BYTECODE_OP(RightShift, right_shift)                   \
+    __JS_ENUMERATE_BYTECODE_OP(UnsignedRightShift, unsigned_right_shift) \
+    __JS_ENUMERATE_BYTECODE_OP(In, in)                                    \
+    __JS_ENUMERATE_BYTECODE_OP(InstanceOf, instance_of)
+
+#define JS_ENUMERATE_BYTECODE_UNARY_OPS                   \
+    __JS_ENUMERATE_BYTECODE_OP(Not, logical_not)          \
+    __JS_ENUMERATE_BYTECODE_OP(BitwiseNot, bitwise_not)   \
+    __JS_ENUMERATE_BYTECODE_OP(UnaryPlus, unary_plus)     \
+    __JS_ENUMERATE_BYTECODE_OP(UnaryMinus, unary_minus)   \
+    __JS_ENUMERATE_BYTECODE_OP(ToNumeric, to_numeric)     \
+    __JS_ENUMERATE_BYTECODE_OP(Increment, increment)      \
+    __JS_ENUMERATE_BYTECODE_OP(Decrement, decrement)
+
+// The operands a, b, c and d of each instruction are listed below in that
+// order. They are register indices unless noted otherwise. "constant",
+// "string", "identifier", "node", "handler" and "property cache" operands
+// index into the corresponding table of the Executable, "target" is an
+// instruction index.
+enum class Opcode : u8 {
+    LoadConstant,      // dst, constant
+    LoadString,        // dst, string
+    LoadGlobalObject,  // dst
+    LoadThis,          // dst
+    Move,              // dst, src
+    NewArray,          // dst, first element, element count
+    GetVariable,       // dst, identifier
+    SetVariable,       // value, identifier
+    DeclareVariable,   // value, identifier
+    GetFrameSlot,      // dst, slot
+    SetFrameSlot,      // value, slot, identifier, is assignment to const
+    GetById,           // dst, object, identifier, property cache
+    GetByValue,        // dst, object, key
+    PutById,           // object, identifier, value, property cache
+    PutByValue,        // object, key, value
+    ToObject,          // dst, src
+    ToPropertyKey,     // dst, src
+    Jump,              // target
+    JumpIfTrue,        // condition, target
+    JumpIfFalse,       // condition, target
+    JumpIfNotNullish,  // condition, target
+    Call,              // dst, first (callee, this, arguments...), argument count, node
+    New,               // dst, first (callee, unused, arguments...), argument count, node
+    Throw,             // value
+    Return,            // value
+    EnterScope,        // node, scope type
+    ExitScope,         //
+    SetLastValue,      // value
+    EvaluateNode,      // dst, node
+    EvaluateStatement, // dst, node, handler
+#define __JS_ENUMERATE_BYTECODE_OP(name, abstract_operation) name,
+    JS_ENUMERATE_BYTECODE_BINARY_OPS // dst, lhs, rhs
+    JS_ENUMERATE_BYTECODE_UNARY_OPS  // dst, src
+#undef __JS_ENUMERATE_BYTECODE_OP
+};
+
+struct Instruction {
+    Opcode opcode;
+    u32 a { 0 };
+    u32 b { 0 };
+    u32 c { 0 };
+    u32 d { 0 };
+};
+
+const char* opcode_name(Opcode);
+
+}
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibCrypto/BigInt/SignedBigInteger.h>
+#include <LibJS/AST.h>
+#include <LibJS/Bytecode/Executable.h>
+#include <LibJS/Bytecode/Interpreter.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Runtime/Array.h>
+#include <LibJS/Runtime/BigInt.h>
+#include <LibJS/Runtime/Error.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/MarkedValueList.h>
+#include <LibJS/Runtime/NativeFunction.h>
+#include <LibJS/Runtime/Reference.h>
+
+namespace JS::Bytecode {
+
+static Value typed_equals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(strict_eq(lhs, rhs));
+}
+
+static Value typed_inequals(GlobalObject&, Value lhs, Value rhs)
+{
+    return Value(!strict_eq(lhs, rhs));
+}
+
+static Value abstract_equals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(abstract_eq(global_object, lhs, rhs));
+}
+
+static Value abstract_inequals(GlobalObject& global_object, Value lhs, Value rhs)
+{
+    return Value(!abstract_eq(global_object, lhs, rhs));
+}
+
+static Value logical_not(GlobalObject&, Value value)
+{
+    return Value(!value.to_boolean());
+}
+
+static Value to_numeric(GlobalObject& global_object, Value value)
+{
+    return value.to_numeric(global_object);
+}
+
+// These expect a value that went through ToNumeric already.
+static Value increment(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() + 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().plus(Crypto::SignedBigInteger { 1 }));
+}
+
+static Value decrement(GlobalObject& global_object, Value value)
+{
+    if (value.is_number())
+        return Value(value.as_double() - 1);
+    return js_bigint(global_object.heap(), value.as_bigint().big_integer().minus(Crypto::SignedBigInteger { 1 }));
+}
+
+Interpreter::Interpreter(JS::Interpreter& interpreter)
+    : m_interpreter(interpreter)
+{
+}
+
+Value Interpreter::run(GlobalObject& global_object, const Executable& executable)
+{
+    auto& vm = m_interpreter.vm();
+
+    m_interpreter.enter_node(executable.root());
+    ScopeGuard exit_node { [&] { m_interpreter.exit_node(executable.root()); } };
+
+    MarkedValueList registers(vm.heap());
+    registers.resize(executable.register_count());
+
+    Vector<const ScopeNode*, 8> scopes;
+    auto exit_scopes_until = [&](size_t depth) {
+        while (scopes.size() > depth)
+            m_interpreter.exit_scope(*scopes.take_last());
+    };
+
+    auto& instructions = executable.instructions();
+    size_t ip = 0;
+    for (;;) {
+        auto& instruction = instructions[ip++];
+        auto a = instruction.a;
+        auto b = instruction.b;
+        auto c = instruction.c;
+
+        switch (instruction.opcode) {
+        case Opcode::LoadConstant:
+            registers[a] = executable.constant(b);
+            break;
+        case Opcode::LoadString:
+            registers[a] = js_string(vm, executable.string(b));
+            break;
+        case Opcode::LoadGlobalObject:
+            registers[a] = &global_object;
+            break;
+        case Opcode::LoadThis:
+            registers[a] = vm.resolve_this_binding(global_object);
+            break;
+        case Opcode::Move:
+            registers[a] = registers[b];
+            break;
+        case Opcode::NewArray: {
+            auto* array = Array::create(global_object);
+            for (size_t i = 0; i < c; ++i)
+                array->indexed_properties().append(registers[b + i]);
+            registers[a] = array;
+            break;
+        }
+        case Opcode::GetVariable: {
+            auto& name = executable.identifier(b);
+            auto value = vm.get_variable(name, global_object);
+            if (vm.exception())
+                break;
+            if (value.is_empty()) {
+                vm.throw_exception<ReferenceError>(global_object, ErrorType::UnknownIdentifier, name);
+                break;
+            }
+            registers[a] = value;
+            break;
+        }
+        case Opcode::SetVariable: {
+            auto& name = executable.identifier(b);
+            update_function_name(registers[a], name);
+            vm.get_reference(name).put(global_object, registers[a]);
+            break;
+        }
+        case Opcode::DeclareVariable: {
+            auto& name = executable.identifier(b);
+            update_function_name(registers[a], name);
+            vm.set_variable(name, registers[a], global_object, true);
+            break;
+        }
+        case Opcode::GetFrameSlot:
+            registers[a] = vm.frame_slot(b);
+            break;
+        case Opcode::SetFrameSlot:
+            if (instruction.d) {
+                vm.throw_exception<TypeError>(global_object, ErrorType::InvalidAssignToConst);
+                break;
+            }
+            update_function_name(registers[a], executable.identifier(c));
+            vm.frame_slot(b) = registers[a];
+            break;
+        case Opcode::GetById: {
+            auto* object = registers[b].to_object(global_object);
+            if (!object)
+                break;
+            registers[a] = executable.property_cache(instruction.d).get(*object, executable.identifier(c)).value_or(js_undefined());
+            break;
+        }
+        case Opcode::GetByValue: {
+            auto* object = registers[b].to_object(global_object);
+            if (!object)
+                break;
+            auto property_name = PropertyName::from_value(global_object, registers[c]);
+            if (!property_name.is_valid())
+                break;
+            registers[a] = object->get(property_name).value_or(js_undefined());
+            break;
+        }
+        case Opcode::PutById: {
+            auto& name = executable.identifier(b);
+            update_function_name(registers[c], name);
+            if (registers[a].is_object())
+                executable.property_cache(instruction.d).put(registers[a].as_object(), name, registers[c]);
+            else
+                Reference(registers[a], name).put(global_object, registers[c]);
+            break;
+        }
+        case Opcode::PutByValue: {
+            auto property_name = PropertyName::from_value(global_object, registers[b]);
+            if (!property_name.is_valid())
+                break;
+            update_function_name(registers[c], get_function_name(global_object, registers[b]));
+            Reference(registers[a], property_name).put(global_object, registers[c]);
+            break;
+        }
+        case Opcode::ToObject: {
+            auto* object = registers[b].to_object(global_object);
+            if (!object)
+                break;
+            registers[a] = object;
+            break;
+        }
+        case Opcode::ToPropertyKey: {
+            auto property_name = PropertyName::from_value(global_object, registers[b]);
+            if (!property_name.is_valid())
+                break;
+            registers[a] = property_name.to_value(vm);
+            break;
+        }
+        case Opcode::Jump:
+            ip = a;
+            break;
+        case Opcode::JumpIfTrue:
+            if (registers[a].to_boolean())
+                ip = b;
+            break;
+        case Opcode::JumpIfFalse:
+            if (!registers[a].to_boolean())
+                ip = b;
+            break;
+        case Opcode::JumpIfNotNullish:
+            if (!registers[a].is_nullish())
+                ip = b;
+            break;
+        case Opcode::Call:
+        case Opcode::New: {
+            bool is_new = instruction.opcode == Opcode::New;
+            auto callee = registers[b];
+            if (!callee.is_function()
+                || (is_new && is<NativeFunction>(callee.as_object()) && !static_cast<NativeFunction&>(callee.as_object()).has_constructor())) {
+                auto& call_expression = static_cast<const CallExpression&>(executable.node(instruction.d));
+                call_expression.throw_type_error_for_callee(m_interpreter, global_object, callee);
+                break;
+            }
+
+            auto& function = callee.as_function();
+            MarkedValueList arguments(vm.heap());
+            arguments.ensure_capacity(c);
+            for (size_t i = 0; i < c; ++i)
+                arguments.append(registers[b + 2 + i]);
+
+            if (is_new)
+                registers[a] = vm.construct(function, function, move(arguments), global_object);
+            else
+                registers[a] = vm.call(function, registers[b + 1], move(arguments));
+            break;
+        }
+        case Opcode::Throw:
+            vm.throw_exception(global_object, registers[a]);
+            break;
+        case Opcode::Return: {
+            auto value = registers[a];
+            exit_scopes_until(0);
+            return value;
+        }
+        case Opcode::EnterScope: {
+            auto& scope_node = static_cast<const ScopeNode&>(executable.node(a));
+            m_interpreter.enter_scope(scope_node, static_cast<ScopeType>(b), global_object);
+            if (vm.exception())
+                break;
+            scopes.append(&scope_node);
+            break;
+        }
+        case Opcode::ExitScope:
+            m_interpreter.exit_scope(*scopes.take_last());
+            break;
+        case Opcode::SetLastValue:
+            vm.set_last_value(Badge<Interpreter> {}, registers[a]);
+            break;
+        case Opcode::EvaluateNode:
+            registers[a] = executable.node(b).execute(m_interpreter, global_object);
+            break;
+        case Opcode::EvaluateStatement: {
+            auto value = executable.node(b).execute(m_interpreter, global_object);
+            if (vm.exception())
+                break;
+            registers[a] = value;
+            if (!vm.should_unwind())
+                break;
+
+            // The statement was interrupted by a return, break or continue,
+            // which we have to carry on with like the AST interpreter would.
+            if (vm.unwind_until() == ScopeType::Function) {
+                vm.stop_unwind();
+                exit_scopes_until(0);
+                return value;
+            }
+            bool found_target = false;
+            for (auto& target : executable.unwind_handler(c)) {
+                if (target.is_loop && vm.should_unwind_until(ScopeType::Continuable, target.label)) {
+                    ip = target.continue_target;
+                } else if (vm.should_unwind_until(ScopeType::Breakable, target.label)) {
+                    ip = target.break_target;
+                } else {
+                    continue;
+                }
+                vm.stop_unwind();
+                exit_scopes_until(target.scope_depth);
+                found_target = true;
+                break;
+            }
+            if (!found_target) {
+                exit_scopes_until(0);
+                return js_undefined();
+            }
+            break;
+        }
+#define __JS_ENUMERATE_BYTECODE_OP(name, abstract_operation)                 \
+    case Opcode::name:                                                       \
+        registers[a] = abstract_operation(global_object, registers[b], registers[c]); \
+        break;
+            JS_ENUMERATE_BYTECODE_BINARY_OPS
+#undef __JS_ENUMERATE_BYTECODE_OP
+#define __JS_ENUMERATE_BYTECODE_OP(name, abstract_operation)  \
+    case Opcode::name:                                        \
+        registers[a] = abstract_operation(global_object, registers[b]); \
+        break;
+            JS_ENUMERATE_BYTECODE_UNARY_OPS
+#undef __JS_ENUMERATE_BYTECODE_OP
+        }
+
+        if (vm.exception()) {
+            exit_scopes_until(0);
+            return js_undefined();
+        }
+    }
+}
+
+}
@@ -136,13 +136,19 @@ class HeapBlock;
 class Interpreter;
 class LexicalEnvironment;
 class MarkedValueList;
+class NativeFunction;
 class NativeProperty;
 class PrimitiveString;
+class Program;
+class PropertyCache;
+class PropertyName;
 class Reference;
 class ScopeNode;
 class ScopeObject;
+class ScriptFunction;
 class Shape;
 class Statement;
+class StringOrSymbol;
 class Symbol;
 class Token;
 class Uint8ClampedArray;
@@ -169,4 +175,10 @@ JS_ENUMERATE_TYPED_ARRAYS
 template<class T>
 class Handle;
 
+namespace Bytecode {
+class Executable;
+class Generator;
+class Interpreter;
+}
+
 }
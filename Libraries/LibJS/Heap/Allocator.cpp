@@ -26,6 +26,7 @@
 
 #include <AK/Badge.h>
 #include <LibJS/Heap/Allocator.h>
+#include <LibJS/Heap/Heap.h>
 #include <LibJS/Heap/HeapBlock.h>
 
 namespace JS {
@@ -41,6 +42,11 @@ Allocator::~Allocator()
 
 Cell* Allocator::allocate_cell(Heap& heap)
 {
+    // Dead cells in a block that hasn't been swept yet are indistinguishable from newly
+    // allocated ones, so sweep the block before handing out any of its cells.
+    while (!m_usable_blocks.is_empty() && m_usable_blocks.last()->needs_sweep())
+        heap.sweep_block({}, *m_usable_blocks.last());
+
     if (m_usable_blocks.is_empty()) {
         auto block = HeapBlock::create_with_cell_size(heap, m_cell_size);
         m_usable_blocks.append(*block.leak_ptr());
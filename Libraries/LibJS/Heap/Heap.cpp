@@ -25,7 +25,10 @@
  */
 
 #include <AK/Badge.h>
+#include <AK/HashMap.h>
 #include <AK/HashTable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/RefCounted.h>
 #include <AK/StackInfo.h>
 #include <AK/TemporaryChange.h>
 #include <LibCore/ElapsedTimer.h>
@@ -35,12 +38,22 @@
 #include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Object.h>
+#include <LibThread/ThreadPool.h>
+#include <LibThread/WorkStealingDeque.h>
+#include <sched.h>
 #include <setjmp.h>
+#include <unistd.h>
 
 //#define HEAP_DEBUG
 
 namespace JS {
 
+// Below this heap size, handing the mark stack to other threads costs more than it saves.
+static constexpr size_t parallel_marking_min_heap_size = 16 * MiB;
+
+// Marking threads take this many cells out of a slice's budget at a time.
+static constexpr size_t parallel_marking_budget_chunk = 256;
+
 Heap::Heap(VM& vm)
     : m_vm(vm)
 {
@@ -70,17 +83,27 @@ ALWAYS_INLINE Allocator& Heap::allocator_for_size(size_t cell_size)
 
 Cell* Heap::allocate_cell(size_t size)
 {
-    if (should_collect_on_every_allocation()) {
-        collect_garbage();
-    } else if (m_allocations_since_last_gc > m_max_allocations_between_gc) {
+    // Sweep one block per allocation, which finishes the sweep long before the next collection.
+    if (!m_blocks_to_sweep.is_empty())
+        sweep_block(*m_blocks_to_sweep.first());
+
+    // While marking incrementally, do a small marking step every so often instead.
+    auto allocations_between_gc = m_is_marking ? m_max_allocations_between_gc / 10 : m_max_allocations_between_gc;
+    if (should_collect_on_every_allocation() || m_allocations_since_last_gc > allocations_between_gc) {
         m_allocations_since_last_gc = 0;
-        collect_garbage();
+        // Only start a full collection once the old generation has about doubled since the last one.
+        if (m_is_marking || m_cells_promoted_since_last_full_collection > max(m_live_cells_after_last_full_collection, m_max_allocations_between_gc))
+            collect_garbage(CollectionType::CollectIncrementally);
+        else
+            collect_garbage(CollectionType::CollectYoungGarbage);
     } else {
         ++m_allocations_since_last_gc;
     }
 
     auto& allocator = allocator_for_size(size);
-    return allocator.allocate_cell(*this);
+    auto* cell = allocator.allocate_cell(*this);
+    m_young_cells.append(cell);
+    return cell;
 }
 
 void Heap::collect_garbage(CollectionType collection_type, bool print_report)
@@ -88,18 +111,61 @@ void Heap::collect_garbage(CollectionType collection_type, bool print_report)
     ASSERT(!m_collecting_garbage);
     TemporaryChange change(m_collecting_garbage, true);
 
-    Core::ElapsedTimer collection_measurement_timer;
+    Core::ElapsedTimer collection_measurement_timer(true);
     collection_measurement_timer.start();
-    if (collection_type == CollectionType::CollectGarbage) {
-        if (m_gc_deferrals) {
-            m_should_gc_when_deferral_ends = true;
-            return;
-        }
+
+    if (collection_type == CollectionType::CollectEverything) {
+        if (m_is_marking)
+            abandon_marking();
+        finish_sweeping();
+        start_sweeping();
+        finish_sweeping();
+        return;
+    }
+
+    if (m_gc_deferrals) {
+        if (!m_should_gc_when_deferral_ends || collection_type == CollectionType::CollectGarbage)
+            m_collection_type_when_deferral_ends = collection_type;
+        m_should_gc_when_deferral_ends = true;
+        return;
+    }
+
+    finish_sweeping();
+
+    switch (collection_type) {
+    case CollectionType::CollectYoungGarbage: {
+        ASSERT(!m_is_marking);
         HashTable<Cell*> roots;
         gather_roots(roots);
-        mark_live_cells(roots);
+        mark_live_young_cells(roots);
+        sweep_dead_young_cells(print_report, collection_measurement_timer);
+        return;
+    }
+    case CollectionType::CollectIncrementally:
+        if (!m_is_marking)
+            start_marking();
+        if (mark_incrementally(m_max_allocations_between_gc)) {
+            finish_marking();
+            start_sweeping();
+        }
+        record_pause(m_incremental_step_statistics, collection_measurement_timer.elapsed());
+        return;
+    case CollectionType::CollectGarbage: {
+        if (!m_is_marking)
+            start_marking();
+        mark_incrementally(NumericLimits<size_t>::max());
+        finish_marking();
+        start_sweeping();
+        finish_sweeping();
+        int time_spent = collection_measurement_timer.elapsed();
+        record_pause(m_full_collection_statistics, time_spent);
+        if (print_report)
+            print_collection_report(collection_type, time_spent, m_sweep_statistics.live_cells, m_sweep_statistics.live_cell_bytes, m_sweep_statistics.collected_cells, m_sweep_statistics.collected_cell_bytes, m_sweep_statistics.freed_blocks);
+        return;
+    }
+    default:
+        ASSERT_NOT_REACHED();
     }
-    sweep_dead_cells(print_report, collection_measurement_timer);
 }
 
 void Heap::gather_roots(HashTable<Cell*>& roots)
@@ -137,17 +203,24 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
     HashTable<FlatPtr> possible_pointers;
 
+    auto add_possible_pointer = [&](FlatPtr data) {
+        possible_pointers.set(data);
+        // Values hold their cell pointers NaN-boxed.
+        if (auto cell_pointer = Value::cell_pointer_from_bits(data))
+            possible_pointers.set(cell_pointer);
+    };
+
     const FlatPtr* raw_jmp_buf = reinterpret_cast<const FlatPtr*>(buf);
 
     for (size_t i = 0; i < ((size_t)sizeof(buf)) / sizeof(FlatPtr); i += sizeof(FlatPtr))
-        possible_pointers.set(raw_jmp_buf[i]);
+        add_possible_pointer(raw_jmp_buf[i]);
 
     FlatPtr stack_reference = reinterpret_cast<FlatPtr>(&dummy);
     auto& stack_info = m_vm.stack_info();
 
     for (FlatPtr stack_address = stack_reference; stack_address < stack_info.top(); stack_address += sizeof(FlatPtr)) {
         auto data = *reinterpret_cast<FlatPtr*>(stack_address);
-        possible_pointers.set(data);
+        add_possible_pointer(data);
     }
 
     HashTable<HeapBlock*> all_live_heap_blocks;
@@ -182,109 +255,490 @@ __attribute__((no_sanitize("address"))) void Heap::gather_conservative_roots(Has
 
 class MarkingVisitor final : public Cell::Visitor {
 public:
-    MarkingVisitor() { }
+    explicit MarkingVisitor(Vector<Cell*>& mark_stack, bool only_young_cells = false)
+        : m_mark_stack(mark_stack)
+        , m_only_young_cells(only_young_cells)
+    {
+    }
 
     virtual void visit_impl(Cell* cell)
     {
         if (cell->is_marked())
             return;
+        // Old cells are assumed to be live during young collections, and their
+        // edges to young cells are found through the dirty blocks instead.
+        if (m_only_young_cells && cell->is_old())
+            return;
 #ifdef HEAP_DEBUG
         dbgln("  ! {}", cell);
 #endif
         cell->set_marked(true);
-        cell->visit_edges(*this);
+        m_mark_stack.append(cell);
+    }
+
+    // Returns false if it ran out of budget before the mark stack was empty.
+    bool drain(size_t cell_budget = NumericLimits<size_t>::max())
+    {
+        for (; cell_budget && !m_mark_stack.is_empty(); --cell_budget)
+            m_mark_stack.take_last()->visit_edges(*this);
+        return m_mark_stack.is_empty();
+    }
+
+private:
+    Vector<Cell*>& m_mark_stack;
+    bool m_only_young_cells { false };
+};
+
+class ParallelMarkingVisitor final : public Cell::Visitor {
+public:
+    explicit ParallelMarkingVisitor(LibThread::WorkStealingDeque<Cell*>& deque)
+        : m_deque(deque)
+    {
+    }
+
+    virtual void visit_impl(Cell* cell)
+    {
+        if (cell->is_marked() || !cell->try_mark())
+            return;
+        m_deque.push(cell);
+    }
+
+private:
+    LibThread::WorkStealingDeque<Cell*>& m_deque;
+};
+
+// The state shared by the threads that drain the mark stack together. Each of them marks out of a
+// deque of its own, and steals from the others when that runs dry. Workers that only get to start
+// once marking has stopped leave again without touching anything, as they may run arbitrarily late.
+class ParallelMarking : public RefCounted<ParallelMarking> {
+public:
+    ParallelMarking(size_t thread_count, size_t cell_budget)
+        : m_cell_budget(cell_budget)
+    {
+        for (size_t i = 0; i < thread_count; ++i)
+            m_deques.append(make<LibThread::WorkStealingDeque<Cell*>>());
+    }
+
+    size_t thread_count() const { return m_deques.size(); }
+
+    // Only the thread that takes part as `index` may push onto that deque.
+    LibThread::WorkStealingDeque<Cell*>& deque(size_t index) { return m_deques[index]; }
+
+    void take_part(size_t index)
+    {
+        ++m_threads_taking_part;
+        if (!m_is_stopped) {
+            ++m_busy_thread_count;
+            mark(index);
+        }
+        --m_threads_taking_part;
     }
+
+    // Makes sure nothing starts marking anymore, and waits for everything that did to be done.
+    void stop()
+    {
+        m_is_stopped = true;
+        while (m_threads_taking_part.load())
+            sched_yield();
+    }
+
+private:
+    void mark(size_t index)
+    {
+        auto& deque = m_deques[index];
+        ParallelMarkingVisitor visitor(deque);
+        size_t cell_budget = 0;
+        while (auto cell = find_cell(index)) {
+            if (!cell_budget && !(cell_budget = take_cell_budget())) {
+                // The cell stays marked, so it has to be left for the next slice.
+                deque.push(cell);
+                --m_busy_thread_count;
+                return;
+            }
+            --cell_budget;
+            cell->visit_edges(visitor);
+        }
+    }
+
+    // Returns null once marking has stopped, which it does when no thread has cells left to mark.
+    Cell* find_cell(size_t index)
+    {
+        if (auto cell = m_deques[index].pop(); cell.has_value())
+            return cell.value();
+        for (;;) {
+            if (auto* cell = steal(index))
+                return cell;
+            // Only busy threads push cells, and they only stop being busy once their own deque is empty.
+            // So if nothing is left to steal and no thread is busy, every cell has been marked.
+            --m_busy_thread_count;
+            while (!has_cells_to_steal()) {
+                if (m_is_stopped)
+                    return nullptr;
+                if (!m_busy_thread_count.load()) {
+                    m_is_stopped = true;
+                    return nullptr;
+                }
+                sched_yield();
+            }
+            ++m_busy_thread_count;
+        }
+    }
+
+    Cell* steal(size_t index)
+    {
+        for (size_t i = 1; i < m_deques.size(); ++i) {
+            if (auto cell = m_deques[(index + i) % m_deques.size()].steal(); cell.has_value())
+                return cell.value();
+        }
+        return nullptr;
+    }
+
+    bool has_cells_to_steal() const
+    {
+        for (auto& deque : m_deques) {
+            if (!deque.is_empty())
+                return true;
+        }
+        return false;
+    }
+
+    size_t take_cell_budget()
+    {
+        auto cell_budget = m_cell_budget.load();
+        size_t taken;
+        do {
+            if (!cell_budget || m_is_stopped) {
+                m_is_stopped = true;
+                return 0;
+            }
+            taken = min(cell_budget, parallel_marking_budget_chunk);
+        } while (!m_cell_budget.compare_exchange_strong(cell_budget, cell_budget - taken));
+        return taken;
+    }
+
+    NonnullOwnPtrVector<LibThread::WorkStealingDeque<Cell*>> m_deques;
+    Atomic<size_t> m_cell_budget;
+    Atomic<size_t> m_busy_thread_count { 0 };
+    Atomic<size_t> m_threads_taking_part { 0 };
+    Atomic<bool> m_is_stopped { false };
 };
 
-void Heap::mark_live_cells(const HashTable<Cell*>& roots)
+void Heap::mark_live_young_cells(const HashTable<Cell*>& roots)
 {
 #ifdef HEAP_DEBUG
-    dbgln("mark_live_cells:");
+    dbgln("mark_live_young_cells:");
 #endif
-    MarkingVisitor visitor;
+    Vector<Cell*> mark_stack;
+    MarkingVisitor visitor(mark_stack, true);
     for (auto* root : roots)
         visitor.visit(root);
+
+    for (auto* cell : m_old_cells_without_write_barriers)
+        cell->visit_edges(visitor);
+
+    for_each_block([&](auto& block) {
+        if (!block.is_dirty())
+            return IterationDecision::Continue;
+        block.set_dirty(false);
+        block.for_each_cell([&](Cell* cell) {
+            if (cell->is_live() && cell->is_old() && cell->has_write_barriers())
+                cell->visit_edges(visitor);
+        });
+        return IterationDecision::Continue;
+    });
+
+    visitor.drain();
 }
 
-void Heap::sweep_dead_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
+void Heap::start_marking()
 {
 #ifdef HEAP_DEBUG
-    dbgln("sweep_dead_cells:");
+    dbgln("start_marking:");
 #endif
-    Vector<HeapBlock*, 32> empty_blocks;
-    Vector<HeapBlock*, 32> full_blocks_that_became_usable;
+    ASSERT(!m_is_marking);
+    ASSERT(m_mark_stack.is_empty());
+    m_is_marking = true;
 
-    size_t collected_cells = 0;
-    size_t live_cells = 0;
-    size_t collected_cell_bytes = 0;
-    size_t live_cell_bytes = 0;
+    size_t heap_size = 0;
+    for_each_block([&](auto&) {
+        heap_size += HeapBlock::block_size;
+        return IterationDecision::Continue;
+    });
+    m_is_marking_in_parallel = m_marking_thread_count > 1 && heap_size >= parallel_marking_min_heap_size;
 
-    for_each_block([&](auto& block) {
-        bool block_has_live_cells = false;
-        bool block_was_full = block.is_full();
-        block.for_each_cell([&](Cell* cell) {
-            if (cell->is_live()) {
-                if (!cell->is_marked()) {
+    HashTable<Cell*> roots;
+    gather_roots(roots);
+    MarkingVisitor visitor(m_mark_stack);
+    for (auto* root : roots)
+        visitor.visit(root);
+}
+
+bool Heap::mark_incrementally(size_t cell_budget)
+{
+    ASSERT(m_is_marking);
+    return drain_mark_stack(cell_budget);
+}
+
+// Returns false if it ran out of budget before the mark stack was empty.
+bool Heap::drain_mark_stack(size_t cell_budget)
+{
+    if (m_is_marking_in_parallel && m_mark_stack.size() > 1)
+        return drain_mark_stack_in_parallel(cell_budget);
+    MarkingVisitor visitor(m_mark_stack);
+    return visitor.drain(cell_budget);
+}
+
+bool Heap::drain_mark_stack_in_parallel(size_t cell_budget)
+{
+    if (!m_marking_thread_pool)
+        m_marking_thread_pool = make<LibThread::ThreadPool>(m_marking_thread_count - 1, "MarkingThread");
+
+    auto marking = adopt(*new ParallelMarking(m_marking_thread_count, cell_budget));
+    for (auto* cell : m_mark_stack)
+        marking->deque(0).push(cell);
+    m_mark_stack.clear_with_capacity();
+
+    for (size_t i = 1; i < marking->thread_count(); ++i) {
+        // Workers may only get to run once this has returned, so they keep the state alive themselves.
+        marking->ref();
+        m_marking_thread_pool->submit([marking = marking.ptr(), i] {
+            marking->take_part(i);
+            marking->unref();
+        });
+    }
+    marking->take_part(0);
+    marking->stop();
+
+    // Whatever is left when the budget runs out goes back on the mark stack for the next slice.
+    for (size_t i = 0; i < marking->thread_count(); ++i) {
+        auto& deque = marking->deque(i);
+        while (!deque.is_empty())
+            m_mark_stack.append(deque.steal().value());
+    }
+    return m_mark_stack.is_empty();
+}
+
+void Heap::finish_marking()
+{
 #ifdef HEAP_DEBUG
-                    dbgln("  ~ {}", cell);
+    dbgln("finish_marking:");
 #endif
-                    block.deallocate(cell);
-                    ++collected_cells;
-                    collected_cell_bytes += block.cell_size();
-                } else {
-                    cell->set_marked(false);
-                    block_has_live_cells = true;
-                    ++live_cells;
-                    live_cell_bytes += block.cell_size();
-                }
-            }
+    ASSERT(m_is_marking);
+    MarkingVisitor visitor(m_mark_stack);
+
+    // The roots may have changed since marking started, and cells without write barriers
+    // may have been given edges to unmarked cells after they were marked.
+    HashTable<Cell*> roots;
+    gather_roots(roots);
+    for (auto* root : roots)
+        visitor.visit(root);
+    for (auto* cell : m_old_cells_without_write_barriers) {
+        if (cell->is_marked())
+            cell->visit_edges(visitor);
+    }
+    for (auto* cell : m_young_cells) {
+        if (cell->is_marked() && !cell->has_write_barriers())
+            cell->visit_edges(visitor);
+    }
+    for (auto* cell : m_cells_written_while_marking)
+        cell->visit_edges(visitor);
+    m_cells_written_while_marking.clear();
+    drain_mark_stack();
+    m_is_marking = false;
+
+    // Everything that's still marked survives the sweep, so the generations can be updated now.
+    m_old_cells_without_write_barriers.remove_all_matching([](auto* cell) { return !cell->is_marked(); });
+    for (auto* cell : m_young_cells) {
+        if (cell->is_marked())
+            promote(*cell);
+    }
+    m_young_cells.clear_with_capacity();
+    m_cells_promoted_since_last_full_collection = 0;
+}
+
+void Heap::abandon_marking()
+{
+    ASSERT(m_is_marking);
+    m_mark_stack.clear();
+    m_cells_written_while_marking.clear();
+    m_is_marking = false;
+    for_each_block([&](auto& block) {
+        block.for_each_cell([&](Cell* cell) {
+            cell->set_marked(false);
         });
-        if (!block_has_live_cells)
-            empty_blocks.append(&block);
-        else if (block_was_full != block.is_full())
-            full_blocks_that_became_usable.append(&block);
         return IterationDecision::Continue;
     });
+}
+
+void Heap::set_marking_thread_count(size_t thread_count)
+{
+    if (thread_count == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processors > 0 ? processors : 1;
+    }
+    // The workers are started again with the new count when they're next needed.
+    if (thread_count != m_marking_thread_count)
+        m_marking_thread_pool = nullptr;
+    m_marking_thread_count = thread_count;
+}
 
-    for (auto* block : empty_blocks) {
+void Heap::promote(Cell& cell)
+{
+    cell.set_old(true);
+    if (!cell.has_write_barriers())
+        m_old_cells_without_write_barriers.append(&cell);
+}
+
+void Heap::start_sweeping()
+{
+    ASSERT(!m_is_marking);
+    ASSERT(m_blocks_to_sweep.is_empty());
+    m_sweep_statistics = {};
+    for_each_block([&](auto& block) {
+        // All edges from old cells now point to cells that survive this collection.
+        block.set_dirty(false);
+        m_blocks_to_sweep.append(block);
+        return IterationDecision::Continue;
+    });
+}
+
+void Heap::finish_sweeping()
+{
+    while (!m_blocks_to_sweep.is_empty())
+        sweep_block(*m_blocks_to_sweep.first());
+}
+
+void Heap::sweep_block(HeapBlock& block)
+{
+    ASSERT(block.needs_sweep());
+    m_blocks_to_sweep.remove(block);
+
+    bool block_has_live_cells = false;
+    bool block_was_full = block.is_full();
+    block.for_each_cell([&](Cell* cell) {
+        if (!cell->is_live())
+            return;
+        if (!cell->is_marked()) {
 #ifdef HEAP_DEBUG
-        dbgln(" - HeapBlock empty @ {}: cell_size={}", block, block->cell_size());
+            dbgln("  ~ {}", cell);
 #endif
-        allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
-    }
+            block.deallocate(cell);
+            ++m_sweep_statistics.collected_cells;
+            m_sweep_statistics.collected_cell_bytes += block.cell_size();
+        } else {
+            cell->set_marked(false);
+            block_has_live_cells = true;
+            ++m_sweep_statistics.live_cells;
+            m_sweep_statistics.live_cell_bytes += block.cell_size();
+        }
+    });
 
-    for (auto* block : full_blocks_that_became_usable) {
+    if (!block_has_live_cells) {
+#ifdef HEAP_DEBUG
+        dbgln(" - HeapBlock empty @ {}: cell_size={}", &block, block.cell_size());
+#endif
+        ++m_sweep_statistics.freed_blocks;
+        allocator_for_size(block.cell_size()).block_did_become_empty({}, block);
+    } else if (block_was_full != block.is_full()) {
 #ifdef HEAP_DEBUG
-        dbgln(" - HeapBlock usable again @ {}: cell_size={}", block, block->cell_size());
+        dbgln(" - HeapBlock usable again @ {}: cell_size={}", &block, block.cell_size());
 #endif
-        allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+        allocator_for_size(block.cell_size()).block_did_become_usable({}, block);
     }
 
+    if (m_blocks_to_sweep.is_empty())
+        m_live_cells_after_last_full_collection = m_sweep_statistics.live_cells;
+}
+
+void Heap::record_pause(CollectionStatistics& statistics, int time_spent)
+{
+    statistics.count++;
+    statistics.total_ms += time_spent;
+    statistics.longest_ms = max(statistics.longest_ms, time_spent);
+}
+
+void Heap::sweep_dead_young_cells(bool print_report, const Core::ElapsedTimer& measurement_timer)
+{
 #ifdef HEAP_DEBUG
-    for_each_block([&](auto& block) {
-        dbgln(" > Live HeapBlock @ {}: cell_size={}", &block, block.cell_size());
-        return IterationDecision::Continue;
-    });
+    dbgln("sweep_dead_young_cells:");
 #endif
+    // Maps each block we collected cells from to whether it was full before.
+    HashMap<HeapBlock*, bool> blocks_with_collected_cells;
 
-    int time_spent = measurement_timer.elapsed();
+    size_t collected_cells = 0;
+    size_t promoted_cells = 0;
+    size_t collected_cell_bytes = 0;
+    size_t promoted_cell_bytes = 0;
+
+    for (auto* cell : m_young_cells) {
+        ASSERT(cell->is_live());
+        ASSERT(!cell->is_old());
+        auto* block = HeapBlock::from_cell(cell);
+        if (cell->is_marked()) {
+            cell->set_marked(false);
+            promote(*cell);
+            ++promoted_cells;
+            promoted_cell_bytes += block->cell_size();
+            continue;
+        }
+#ifdef HEAP_DEBUG
+        dbgln("  ~ {}", cell);
+#endif
+        if (!blocks_with_collected_cells.contains(block))
+            blocks_with_collected_cells.set(block, block->is_full());
+        block->deallocate(cell);
+        ++collected_cells;
+        collected_cell_bytes += block->cell_size();
+    }
+    m_young_cells.clear_with_capacity();
+    m_cells_promoted_since_last_full_collection += promoted_cells;
 
-    if (print_report) {
-        size_t live_block_count = 0;
-        for_each_block([&](auto&) {
-            ++live_block_count;
-            return IterationDecision::Continue;
+    size_t freed_blocks = 0;
+    for (auto& it : blocks_with_collected_cells) {
+        auto* block = it.key;
+        bool block_has_live_cells = false;
+        block->for_each_cell([&](Cell* cell) {
+            if (cell->is_live())
+                block_has_live_cells = true;
         });
+        if (!block_has_live_cells) {
+            allocator_for_size(block->cell_size()).block_did_become_empty({}, *block);
+            ++freed_blocks;
+        } else if (it.value) {
+            allocator_for_size(block->cell_size()).block_did_become_usable({}, *block);
+        }
+    }
+
+    int time_spent = measurement_timer.elapsed();
+    record_pause(m_young_collection_statistics, time_spent);
+
+    if (print_report)
+        print_collection_report(CollectionType::CollectYoungGarbage, time_spent, promoted_cells, promoted_cell_bytes, collected_cells, collected_cell_bytes, freed_blocks);
+}
 
-        dbgln("Garbage collection report");
-        dbgln("=============================================");
-        dbgln("     Time spent: {} ms", time_spent);
+void Heap::print_collection_report(CollectionType collection_type, int time_spent, size_t live_cells, size_t live_cell_bytes, size_t collected_cells, size_t collected_cell_bytes, size_t freed_blocks)
+{
+    size_t live_block_count = 0;
+    for_each_block([&](auto&) {
+        ++live_block_count;
+        return IterationDecision::Continue;
+    });
+
+    bool is_young_collection = collection_type == CollectionType::CollectYoungGarbage;
+    dbgln("Garbage collection report ({})", is_young_collection ? "young generation" : "full heap");
+    dbgln("=============================================");
+    dbgln("     Time spent: {} ms", time_spent);
+    if (is_young_collection)
+        dbgln(" Promoted cells: {} ({} bytes)", live_cells, live_cell_bytes);
+    else
         dbgln("     Live cells: {} ({} bytes)", live_cells, live_cell_bytes);
-        dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
-        dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
-        dbgln("   Freed blocks: {} ({} bytes)", empty_blocks.size(), empty_blocks.size() * HeapBlock::block_size);
-        dbgln("=============================================");
-    }
+    dbgln("Collected cells: {} ({} bytes)", collected_cells, collected_cell_bytes);
+    dbgln("    Live blocks: {} ({} bytes)", live_block_count, live_block_count * HeapBlock::block_size);
+    dbgln("   Freed blocks: {} ({} bytes)", freed_blocks, freed_blocks * HeapBlock::block_size);
+    dbgln("   Young pauses: {} ({} ms total, {} ms longest)", m_young_collection_statistics.count, m_young_collection_statistics.total_ms, m_young_collection_statistics.longest_ms);
+    dbgln("    Full pauses: {} ({} ms total, {} ms longest)", m_full_collection_statistics.count, m_full_collection_statistics.total_ms, m_full_collection_statistics.longest_ms);
+    dbgln("   Incr. pauses: {} ({} ms total, {} ms longest)", m_incremental_step_statistics.count, m_incremental_step_statistics.total_ms, m_incremental_step_statistics.longest_ms);
+    dbgln("=============================================");
 }
 
 void Heap::did_create_handle(Badge<HandleImpl>, HandleImpl& impl)
@@ -316,14 +770,27 @@ void Heap::defer_gc(Badge<DeferGC>)
     ++m_gc_deferrals;
 }
 
+void Heap::did_write_to_marked_cell(Badge<Cell>, Cell& cell)
+{
+    // The cell has to be scanned again, so that whatever it points to now gets marked too.
+    // This is left to finish_marking(), since the same (possibly large) cell tends to be written to over and over.
+    if (m_is_marking)
+        m_cells_written_while_marking.set(&cell);
+}
+
 void Heap::undefer_gc(Badge<DeferGC>)
+{
+    end_deferral();
+}
+
+void Heap::end_deferral()
 {
     ASSERT(m_gc_deferrals > 0);
     --m_gc_deferrals;
 
     if (!m_gc_deferrals) {
         if (m_should_gc_when_deferral_ends)
-            collect_garbage();
+            collect_garbage(m_collection_type_when_deferral_ends);
         m_should_gc_when_deferral_ends = false;
     }
 }
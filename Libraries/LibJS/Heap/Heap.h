@@ -27,8 +27,11 @@
 #pragma once
 
 #include <AK/HashTable.h>
+#include <AK/IntrusiveList.h>
 #include <AK/Noncopyable.h>
 #include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/OwnPtr.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
@@ -38,6 +41,10 @@
 #include <LibJS/Runtime/Cell.h>
 #include <LibJS/Runtime/Object.h>
 
+namespace LibThread {
+class ThreadPool;
+}
+
 namespace JS {
 
 class Heap {
@@ -48,31 +55,49 @@ public:
     explicit Heap(VM&);
     ~Heap();
 
+    // Only these exact types call Cell::write_barrier() whenever they gain an edge after construction.
+    // Every other cell gets all of its edges rescanned by each young collection once it's old.
+    template<typename T>
+    static constexpr bool has_write_barriers = IsSame<T, Object>::value || IsSame<T, Array>::value
+        || IsSame<T, ScriptFunction>::value || IsSame<T, NativeFunction>::value || IsSame<T, LexicalEnvironment>::value
+        || IsSame<T, Shape>::value || IsSame<T, Accessor>::value || IsSame<T, NativeProperty>::value
+        || IsSame<T, PrimitiveString>::value || IsSame<T, Symbol>::value || IsSame<T, BigInt>::value;
+
     template<typename T, typename... Args>
     T* allocate_without_global_object(Args&&... args)
     {
         auto* memory = allocate_cell(sizeof(T));
+        // Constructors don't call write barriers, so the cell must not be promoted before it's done.
+        ++m_gc_deferrals;
         new (memory) T(forward<Args>(args)...);
-        return static_cast<T*>(memory);
+        auto* cell = static_cast<T*>(memory);
+        cell->set_has_write_barriers(has_write_barriers<T>);
+        end_deferral();
+        return cell;
     }
 
     template<typename T, typename... Args>
     T* allocate(GlobalObject& global_object, Args&&... args)
     {
         auto* memory = allocate_cell(sizeof(T));
+        ++m_gc_deferrals;
         new (memory) T(forward<Args>(args)...);
         auto* cell = static_cast<T*>(memory);
+        cell->set_has_write_barriers(has_write_barriers<T>);
         constexpr bool is_object = IsBaseOf<Object, T>::value;
         if constexpr (is_object)
             static_cast<Object*>(cell)->disable_transitions();
         cell->initialize(global_object);
         if constexpr (is_object)
             static_cast<Object*>(cell)->enable_transitions();
+        end_deferral();
         return cell;
     }
 
     enum class CollectionType {
         CollectGarbage,
+        CollectYoungGarbage,
+        CollectIncrementally,
         CollectEverything,
     };
 
@@ -83,6 +108,12 @@ public:
     bool should_collect_on_every_allocation() const { return m_should_collect_on_every_allocation; }
     void set_should_collect_on_every_allocation(bool b) { m_should_collect_on_every_allocation = b; }
 
+    // Full collections of large heaps mark with this many threads: the one collecting, and workers that
+    // are started the first time they're needed. 0 means one per online processor. Processes that may
+    // not start threads (see pledge()) have to stay at the default of 1.
+    size_t marking_thread_count() const { return m_marking_thread_count; }
+    void set_marking_thread_count(size_t);
+
     void did_create_handle(Badge<HandleImpl>, HandleImpl&);
     void did_destroy_handle(Badge<HandleImpl>, HandleImpl&);
 
@@ -92,13 +123,37 @@ public:
     void defer_gc(Badge<DeferGC>);
     void undefer_gc(Badge<DeferGC>);
 
+    void did_write_to_marked_cell(Badge<Cell>, Cell&);
+    void sweep_block(Badge<Allocator>, HeapBlock& block) { sweep_block(block); }
+
 private:
+    struct CollectionStatistics {
+        size_t count { 0 };
+        int total_ms { 0 };
+        int longest_ms { 0 };
+    };
+
     Cell* allocate_cell(size_t);
+    void end_deferral();
 
     void gather_roots(HashTable<Cell*>&);
     void gather_conservative_roots(HashTable<Cell*>&);
-    void mark_live_cells(const HashTable<Cell*>& live_cells);
-    void sweep_dead_cells(bool print_report, const Core::ElapsedTimer&);
+    void mark_live_young_cells(const HashTable<Cell*>& roots);
+    void sweep_dead_young_cells(bool print_report, const Core::ElapsedTimer&);
+    void promote(Cell&);
+
+    void start_marking();
+    bool mark_incrementally(size_t cell_budget);
+    bool drain_mark_stack(size_t cell_budget = NumericLimits<size_t>::max());
+    bool drain_mark_stack_in_parallel(size_t cell_budget);
+    void finish_marking();
+    void abandon_marking();
+    void start_sweeping();
+    void finish_sweeping();
+    void sweep_block(HeapBlock&);
+
+    void record_pause(CollectionStatistics&, int time_spent);
+    void print_collection_report(CollectionType, int time_spent, size_t live_cells, size_t live_cell_bytes, size_t collected_cells, size_t collected_cell_bytes, size_t freed_blocks);
 
     Allocator& allocator_for_size(size_t);
 
@@ -114,6 +169,38 @@ private:
     size_t m_max_allocations_between_gc { 10000 };
     size_t m_allocations_since_last_gc { false };
 
+    // Cells allocated since the last collection. Everything that survives a collection is promoted.
+    Vector<Cell*> m_young_cells;
+    Vector<Cell*> m_old_cells_without_write_barriers;
+    size_t m_live_cells_after_last_full_collection { 0 };
+    size_t m_cells_promoted_since_last_full_collection { 0 };
+
+    CollectionStatistics m_young_collection_statistics;
+    CollectionStatistics m_full_collection_statistics;
+    CollectionStatistics m_incremental_step_statistics;
+
+    // Full collections mark incrementally, a slice every few allocations, using an explicit mark stack.
+    // Cells that get written to after being marked are remembered by Cell::write_barrier() and scanned again at the end.
+    bool m_is_marking { false };
+    Vector<Cell*> m_mark_stack;
+    HashTable<Cell*> m_cells_written_while_marking;
+
+    // Whether the current full collection drains the mark stack with several threads. That's
+    // decided when marking starts, by how large the heap is.
+    bool m_is_marking_in_parallel { false };
+    size_t m_marking_thread_count { 1 };
+    OwnPtr<LibThread::ThreadPool> m_marking_thread_pool;
+
+    struct SweepStatistics {
+        size_t live_cells { 0 };
+        size_t live_cell_bytes { 0 };
+        size_t collected_cells { 0 };
+        size_t collected_cell_bytes { 0 };
+        size_t freed_blocks { 0 };
+    };
+    SweepStatistics m_sweep_statistics;
+    IntrusiveList<HeapBlock, &HeapBlock::m_sweep_list_node> m_blocks_to_sweep;
+
     bool m_should_collect_on_every_allocation { false };
 
     VM& m_vm;
@@ -125,6 +212,7 @@ private:
 
     size_t m_gc_deferrals { 0 };
     bool m_should_gc_when_deferral_ends { false };
+    CollectionType m_collection_type_when_deferral_ends { CollectionType::CollectYoungGarbage };
 
     bool m_collecting_garbage { false };
 };
@@ -65,6 +65,11 @@ public:
 
     Heap& heap() { return m_heap; }
 
+    // Set when an old cell in this block gets a new edge, so that young collections
+    // only have to rescan the old cells in dirty blocks.
+    bool is_dirty() const { return m_dirty; }
+    void set_dirty(bool b) { m_dirty = b; }
+
     static HeapBlock* from_cell(const Cell* cell)
     {
         return reinterpret_cast<HeapBlock*>((FlatPtr)cell & ~(block_size - 1));
@@ -82,6 +87,10 @@ public:
 
     IntrusiveListNode m_list_node;
 
+    // Blocks are swept lazily after a full collection has finished marking.
+    bool needs_sweep() const { return m_sweep_list_node.is_in_list(); }
+    IntrusiveListNode m_sweep_list_node;
+
 private:
     HeapBlock(Heap&, size_t cell_size);
 
@@ -103,8 +112,17 @@ private:
 
     Heap& m_heap;
     size_t m_cell_size { 0 };
+    bool m_dirty { false };
     FreelistEntry* m_freelist { nullptr };
     alignas(Cell) u8 m_storage[];
 };
 
+ALWAYS_INLINE void Cell::write_barrier()
+{
+    if (m_old)
+        HeapBlock::from_cell(this)->set_dirty(true);
+    if (m_mark)
+        did_write_while_marked();
+}
+
 }
@@ -27,6 +27,7 @@
 #include <AK/Badge.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Error.h>
 #include <LibJS/Runtime/GlobalObject.h>
@@ -73,9 +74,16 @@ Value Interpreter::run(GlobalObject& global_object, const Program& program)
     global_call_frame.scope = &global_object;
     ASSERT(!vm.exception());
     global_call_frame.is_strict_mode = program.is_strict_mode();
+    global_call_frame.frame_slots.resize(program.frame_slot_count());
+    for (auto& slot : global_call_frame.frame_slots)
+        slot = js_undefined();
     vm.push_call_frame(global_call_frame, global_object);
     ASSERT(!vm.exception());
-    auto result = program.execute(*this, global_object);
+    Value result;
+    if (vm.bytecode_enabled())
+        result = Bytecode::Interpreter(*this).run(global_object, program.bytecode_executable(vm));
+    else
+        result = program.execute(*this, global_object);
     vm.pop_call_frame();
     return result;
 }
@@ -111,6 +119,8 @@ void Interpreter::enter_scope(const ScopeNode& scope_node, ScopeType scope_type,
                 global_object.put(declarator.id().string(), js_undefined());
                 if (exception())
                     return;
+            } else if (declarator.id().has_frame_slot()) {
+                vm().frame_slot(declarator.id().frame_slot()) = js_undefined();
             } else {
                 scope_variables_with_declaration_kind.set(declarator.id().string(), { js_undefined(), declaration.declaration_kind() });
             }
@@ -167,10 +177,10 @@ Value Interpreter::execute_statement(GlobalObject& global_object, const Statemen
     enter_scope(block, scope_type, global_object);
 
     if (block.children().is_empty())
-        vm().set_last_value({}, js_undefined());
+        vm().set_last_value(Badge<Interpreter> {}, js_undefined());
 
     for (auto& node : block.children()) {
-        vm().set_last_value({}, node.execute(*this, global_object));
+        vm().set_last_value(Badge<Interpreter> {}, node.execute(*this, global_object));
         if (vm().should_unwind()) {
             if (!block.label().is_null() && vm().should_unwind_until(ScopeType::Breakable, block.label()))
                 vm().stop_unwind();
@@ -40,10 +40,16 @@ HashMap<String, TokenType> Lexer::s_three_char_tokens;
 HashMap<String, TokenType> Lexer::s_two_char_tokens;
 HashMap<char, TokenType> Lexer::s_single_char_tokens;
 
-Lexer::Lexer(StringView source)
+Lexer::Lexer(StringView source, size_t start_offset, size_t line_number, size_t line_column)
     : m_source(source)
+    , m_position(start_offset)
     , m_current_token(TokenType::Eof, {}, StringView(nullptr), StringView(nullptr), 0, 0)
+    , m_line_number(line_number)
+    , m_line_column(line_column - 1)
 {
+    ASSERT(start_offset <= source.length());
+    ASSERT(line_column > 0);
+
     if (s_keywords.is_empty()) {
         s_keywords.set("await", TokenType::Await);
         s_keywords.set("break", TokenType::Break);
@@ -36,7 +36,8 @@ namespace JS {
 
 class Lexer {
 public:
-    explicit Lexer(StringView source);
+    // The first token is read from start_offset, which is at the given line and column.
+    explicit Lexer(StringView source, size_t start_offset = 0, size_t line_number = 1, size_t line_column = 1);
 
     Token next();
 
@@ -57,27 +57,158 @@ public:
         , m_mask(mask)
     {
         if (m_mask & Var)
-            m_parser.m_parser_state.m_var_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
+            m_parser.m_var_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
         if (m_mask & Let)
-            m_parser.m_parser_state.m_let_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
+            m_parser.m_let_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
         if (m_mask & Function)
-            m_parser.m_parser_state.m_function_scopes.append(NonnullRefPtrVector<FunctionDeclaration>());
+            m_parser.m_function_scopes.append(NonnullRefPtrVector<FunctionDeclaration>());
     }
 
     ~ScopePusher()
     {
         if (m_mask & Var)
-            m_parser.m_parser_state.m_var_scopes.take_last();
+            m_parser.m_var_scopes.take_last();
         if (m_mask & Let)
-            m_parser.m_parser_state.m_let_scopes.take_last();
+            m_parser.m_let_scopes.take_last();
         if (m_mask & Function)
-            m_parser.m_parser_state.m_function_scopes.take_last();
+            m_parser.m_function_scopes.take_last();
     }
 
     Parser& m_parser;
     unsigned m_mask { 0 };
 };
 
+// Resolves the identifiers referenced inside a scope to the bindings declared by it.
+// Bindings that are never accessed dynamically are given a slot in the CallFrame of
+// the enclosing function (or program), so that reading or writing them doesn't have
+// to look up their name in a LexicalEnvironment. Whatever can't be resolved here is
+// left for the enclosing scope.
+class FrameSlotScope {
+public:
+    enum class Type {
+        Program,
+        Function,
+        Block,
+        Catch,
+        With,
+    };
+
+    FrameSlotScope(Parser& parser, Type type)
+        : m_parser(parser)
+        , m_type(type)
+        , m_parent(parser.m_frame_slot_scope)
+        , m_first_reference(parser.m_references.size())
+    {
+        if (m_type == Type::Program || m_type == Type::Function)
+            m_function_scope = this;
+        else if (m_parent)
+            m_function_scope = m_parent->m_function_scope;
+        m_parser.m_frame_slot_scope = this;
+    }
+
+    ~FrameSlotScope()
+    {
+        resolve();
+        m_parser.m_frame_slot_scope = m_parent;
+    }
+
+    void declare(const FlyString& name, bool is_const = false)
+    {
+        auto& binding = m_bindings.ensure(name);
+        binding.is_const |= is_const;
+    }
+
+    void declare(const VariableDeclaration& declaration)
+    {
+        for (auto& declarator : declaration.declarations())
+            declare(declarator.id().string(), declaration.declaration_kind() == DeclarationKind::Const);
+    }
+
+    void declare(const NonnullRefPtrVector<VariableDeclaration>& declarations)
+    {
+        for (auto& declaration : declarations)
+            declare(declaration);
+    }
+
+    void declare(Vector<FunctionNode::Parameter>& parameters)
+    {
+        for (auto& parameter : parameters)
+            m_bindings.ensure(parameter.name).parameters.append(&parameter);
+    }
+
+    void resolve()
+    {
+        if (m_is_resolved)
+            return;
+        m_is_resolved = true;
+
+        auto& references = m_parser.m_references;
+        size_t unresolved_count = m_first_reference;
+        for (size_t i = m_first_reference; i < references.size(); ++i) {
+            auto& reference = references[i];
+            auto it = m_bindings.find(reference.name);
+            if (it == m_bindings.end()) {
+                // Dynamic references don't need to hold on to their identifier, which might
+                // be part of a function body that is dropped once it has been parsed.
+                if (m_type == Type::Function || m_type == Type::With) {
+                    reference.is_dynamic = true;
+                    reference.identifier = nullptr;
+                }
+                if (i != unresolved_count)
+                    references[unresolved_count] = move(reference);
+                ++unresolved_count;
+                continue;
+            }
+            if (reference.is_dynamic)
+                it->value.is_dynamic = true;
+            else
+                it->value.identifiers.append(reference.identifier.release_nonnull());
+        }
+        // Nothing outside a program can refer to anything inside of it.
+        references.shrink(m_parent && m_type != Type::Program ? unresolved_count : m_first_reference);
+
+        // Bindings in the global scope are properties of the global object, and the
+        // catch parameter lives in the scope object created when an exception is caught.
+        if (m_type == Type::Program || m_type == Type::Catch || !m_function_scope)
+            return;
+
+        for (auto& it : m_bindings) {
+            auto& binding = it.value;
+            // The arguments object is looked up by name when it is first used.
+            if (binding.is_dynamic || it.key == "arguments")
+                continue;
+            auto slot = m_function_scope->m_frame_slot_count++;
+            for (auto& identifier : binding.identifiers)
+                identifier.set_frame_slot(slot, binding.is_const);
+            for (auto* parameter : binding.parameters)
+                parameter->frame_slot = slot;
+        }
+    }
+
+    size_t frame_slot_count() const
+    {
+        ASSERT(m_function_scope == this);
+        return m_frame_slot_count;
+    }
+
+private:
+    struct Binding {
+        NonnullRefPtrVector<Identifier> identifiers;
+        Vector<FunctionNode::Parameter*> parameters;
+        bool is_const { false };
+        bool is_dynamic { false };
+    };
+
+    Parser& m_parser;
+    Type m_type;
+    FrameSlotScope* m_parent { nullptr };
+    FrameSlotScope* m_function_scope { nullptr };
+    size_t m_first_reference { 0 };
+    HashMap<FlyString, Binding> m_bindings;
+    size_t m_frame_slot_count { 0 };
+    bool m_is_resolved { false };
+};
+
 class OperatorPrecedenceTable {
 public:
     constexpr OperatorPrecedenceTable()
@@ -203,6 +334,35 @@ Parser::Parser(Lexer lexer)
 {
 }
 
+void Parser::enable_lazy_function_bodies(const String& source)
+{
+    ASSERT(source.characters() == m_parser_state.m_lexer.source().characters_without_null_termination());
+    m_lazy_function_source = source;
+}
+
+RefPtr<FunctionDeclaration> Parser::parse_lazy_function(const LazyFunctionBody& lazy_body, String& error)
+{
+    auto& start = lazy_body.function_start();
+    Parser parser(Lexer(lazy_body.source(), lazy_body.function_offset(), start.line, start.column));
+    parser.m_lazy_function_source = lazy_body.source();
+    auto& parser_context = lazy_body.parser_context();
+    parser.m_parser_state.m_strict_mode = parser_context.strict_mode;
+    parser.m_parser_state.m_in_break_context = parser_context.in_break_context;
+    parser.m_parser_state.m_in_continue_context = parser_context.in_continue_context;
+
+    // The scopes around the function only collect what the function declares for itself, and
+    // anything that it refers to by name is looked up at runtime, like it was the first time.
+    ScopePusher scope(parser, ScopePusher::Var | ScopePusher::Let | ScopePusher::Function);
+    FrameSlotScope frame_slot_scope(parser, FrameSlotScope::Type::Program);
+    auto function = parser.parse_function_node<FunctionDeclaration>();
+    // Skipping over the body only caught the errors that can be told from its tokens.
+    if (parser.has_errors()) {
+        error = parser.errors().first().to_string();
+        return nullptr;
+    }
+    return function;
+}
+
 Associativity Parser::operator_associativity(TokenType type) const
 {
     switch (type) {
@@ -246,8 +406,10 @@ Associativity Parser::operator_associativity(TokenType type) const
 
 NonnullRefPtr<Program> Parser::parse_program()
 {
+    Arena::Scope arena_scope(m_node_arena);
     auto rule_start = push_start();
     ScopePusher scope(*this, ScopePusher::Var | ScopePusher::Let | ScopePusher::Function);
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Program);
     auto program = adopt(*new Program({ rule_start.position(), position() }));
 
     bool first = true;
@@ -271,13 +433,15 @@ NonnullRefPtr<Program> Parser::parse_program()
         }
         first = false;
     }
-    if (m_parser_state.m_var_scopes.size() == 1) {
-        program->add_variables(m_parser_state.m_var_scopes.last());
-        program->add_variables(m_parser_state.m_let_scopes.last());
-        program->add_functions(m_parser_state.m_function_scopes.last());
+    if (m_var_scopes.size() == 1) {
+        program->add_variables(m_var_scopes.last());
+        program->add_variables(m_let_scopes.last());
+        program->add_functions(m_function_scopes.last());
     } else {
         syntax_error("Unclosed scope");
     }
+    frame_slot_scope.resolve();
+    program->set_frame_slot_count(frame_slot_scope.frame_slot_count());
     program->source_range().end = position();
     return program;
 }
@@ -289,8 +453,12 @@ NonnullRefPtr<Declaration> Parser::parse_declaration()
     case TokenType::Class:
         return parse_class_declaration();
     case TokenType::Function: {
-        auto declaration = parse_function_node<FunctionDeclaration>();
-        m_parser_state.m_function_scopes.last().append(declaration);
+        u8 parse_options = FunctionNodeParseOptions::CheckForFunctionAndName;
+        if (!m_lazy_function_source.is_null())
+            parse_options |= FunctionNodeParseOptions::ParseBodyLazily;
+        auto declaration = parse_function_node<FunctionDeclaration>(parse_options);
+        m_function_scopes.last().append(declaration);
+        add_dynamic_reference(declaration->name());
         return declaration;
     }
     case TokenType::Let:
@@ -362,13 +530,14 @@ NonnullRefPtr<Statement> Parser::parse_statement()
 RefPtr<FunctionExpression> Parser::try_parse_arrow_function_expression(bool expect_parens)
 {
     save_state();
-    m_parser_state.m_var_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
+    m_var_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
     auto rule_start = push_start();
 
     ArmedScopeGuard state_rollback_guard = [&] {
-        m_parser_state.m_var_scopes.take_last();
+        m_var_scopes.take_last();
         load_state();
     };
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Function);
 
     Vector<FunctionNode::Parameter> parameters;
     i32 function_length = -1;
@@ -378,9 +547,9 @@ RefPtr<FunctionExpression> Parser::try_parse_arrow_function_expression(bool expe
         // parameter, maybe a trailing comma. If we have a new syntax error afterwards we
         // check if it's about a wrong token (something like duplicate parameter name must
         // not abort), know parsing failed and rollback the parser state.
-        auto previous_syntax_errors = m_parser_state.m_errors.size();
+        auto previous_syntax_errors = m_errors.size();
         parameters = parse_function_parameters(function_length, FunctionNodeParseOptions::IsArrowFunction);
-        if (m_parser_state.m_errors.size() > previous_syntax_errors && m_parser_state.m_errors[previous_syntax_errors].message.starts_with("Unexpected token"))
+        if (m_errors.size() > previous_syntax_errors && m_errors[previous_syntax_errors].message.starts_with("Unexpected token"))
             return nullptr;
         if (!match(TokenType::ParenClose))
             return nullptr;
@@ -435,7 +604,13 @@ RefPtr<FunctionExpression> Parser::try_parse_arrow_function_expression(bool expe
         state_rollback_guard.disarm();
         discard_saved_state();
         auto body = function_body_result.release_nonnull();
-        return create_ast_node<FunctionExpression>({ rule_start.position(), position() }, "", move(body), move(parameters), function_length, m_parser_state.m_var_scopes.take_last(), is_strict, true);
+        // NOTE: Variables declared with `var` in an arrow function are not part of its
+        //       environment (see ScriptFunction::create_environment()), so they aren't
+        //       declared here either.
+        frame_slot_scope.declare(parameters);
+        frame_slot_scope.resolve();
+        body->set_frame_slot_count(frame_slot_scope.frame_slot_count());
+        return create_ast_node<FunctionExpression>({ rule_start.position(), position() }, "", move(body), move(parameters), function_length, m_var_scopes.take_last(), is_strict, true);
     }
 
     return nullptr;
@@ -491,7 +666,9 @@ RefPtr<MetaProperty> Parser::try_parse_new_target_expression()
 NonnullRefPtr<ClassDeclaration> Parser::parse_class_declaration()
 {
     auto rule_start = push_start();
-    return create_ast_node<ClassDeclaration>({ rule_start.position(), position() }, parse_class_expression(true));
+    auto class_expression = parse_class_expression(true);
+    add_dynamic_reference(class_expression->name());
+    return create_ast_node<ClassDeclaration>({ rule_start.position(), position() }, move(class_expression));
 }
 
 NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_name)
@@ -608,7 +785,7 @@ NonnullRefPtr<ClassExpression> Parser::parse_class_expression(bool expect_class_
             // constructor(... args){ super (...args);}
             auto super_call = create_ast_node<CallExpression>({ rule_start.position(), position() }, create_ast_node<SuperExpression>({ rule_start.position(), position() }), Vector { CallExpression::Argument { create_ast_node<Identifier>({ rule_start.position(), position() }, "args"), true } });
             constructor_body->append(create_ast_node<ExpressionStatement>({ rule_start.position(), position() }, move(super_call)));
-            constructor_body->add_variables(m_parser_state.m_var_scopes.last());
+            constructor_body->add_variables(m_var_scopes.last());
 
             constructor = create_ast_node<FunctionExpression>({ rule_start.position(), position() }, class_name, move(constructor_body), Vector { FunctionNode::Parameter { "args", nullptr, true } }, 0, NonnullRefPtrVector<VariableDeclaration>(), true);
         } else {
@@ -651,7 +828,9 @@ NonnullRefPtr<Expression> Parser::parse_primary_expression()
         auto arrow_function_result = try_parse_arrow_function_expression(false);
         if (!arrow_function_result.is_null())
             return arrow_function_result.release_nonnull();
-        return create_ast_node<Identifier>({ rule_start.position(), position() }, consume().value());
+        auto identifier = create_ast_node<Identifier>({ rule_start.position(), position() }, consume().value());
+        add_reference(identifier);
+        return identifier;
     }
     case TokenType::NumericLiteral:
         return create_ast_node<NumericLiteral>({ rule_start.position(), position() }, consume_and_validate_numeric_literal().double_value());
@@ -812,7 +991,9 @@ NonnullRefPtr<ObjectExpression> Parser::parse_object_expression()
                 property_name = parse_property_key();
             } else {
                 property_name = create_ast_node<StringLiteral>({ rule_start.position(), position() }, identifier);
-                property_value = create_ast_node<Identifier>({ rule_start.position(), position() }, identifier);
+                auto reference = create_ast_node<Identifier>({ rule_start.position(), position() }, identifier);
+                add_reference(reference);
+                property_value = move(reference);
             }
         } else {
             property_name = parse_property_key();
@@ -889,6 +1070,14 @@ NonnullRefPtr<ArrayExpression> Parser::parse_array_expression()
 NonnullRefPtr<StringLiteral> Parser::parse_string_literal(Token token, bool in_template_literal)
 {
     auto rule_start = push_start();
+    auto string = validated_string_value(token, in_template_literal);
+    auto is_use_strict_directive = !in_template_literal && (token.value() == "'use strict'" || token.value() == "\"use strict\"");
+
+    return create_ast_node<StringLiteral>({ rule_start.position(), position() }, string, is_use_strict_directive);
+}
+
+String Parser::validated_string_value(const Token& token, bool in_template_literal)
+{
     auto status = Token::StringValueStatus::Ok;
     auto string = token.string_value(status);
     if (status != Token::StringValueStatus::Ok) {
@@ -911,10 +1100,7 @@ NonnullRefPtr<StringLiteral> Parser::parse_string_literal(Token token, bool in_t
         if (!message.is_empty())
             syntax_error(message, Position { token.line_number(), token.line_column() });
     }
-
-    auto is_use_strict_directive = !in_template_literal && (token.value() == "'use strict'" || token.value() == "\"use strict\"");
-
-    return create_ast_node<StringLiteral>({ rule_start.position(), position() }, string, is_use_strict_directive);
+    return string;
 }
 
 NonnullRefPtr<TemplateLiteral> Parser::parse_template_literal(bool is_tagged)
@@ -1275,6 +1461,7 @@ NonnullRefPtr<BlockStatement> Parser::parse_block_statement(bool& is_strict)
 {
     auto rule_start = push_start();
     ScopePusher scope(*this, ScopePusher::Let);
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Block);
     auto block = create_ast_node<BlockStatement>({ rule_start.position(), position() });
     consume(TokenType::CurlyOpen);
 
@@ -1306,21 +1493,32 @@ NonnullRefPtr<BlockStatement> Parser::parse_block_statement(bool& is_strict)
     m_parser_state.m_strict_mode = initial_strict_mode_state;
     m_parser_state.m_string_legacy_octal_escape_sequence_in_scope = false;
     consume(TokenType::CurlyClose);
-    block->add_variables(m_parser_state.m_let_scopes.last());
-    block->add_functions(m_parser_state.m_function_scopes.last());
+    block->add_variables(m_let_scopes.last());
+    block->add_functions(m_function_scopes.last());
+    frame_slot_scope.declare(m_let_scopes.last());
     return block;
 }
 
 template<typename FunctionNodeType>
 NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options)
 {
+    Arena::Scope arena_scope(m_node_arena);
     auto rule_start = push_start();
     ASSERT(!(parse_options & FunctionNodeParseOptions::IsGetterFunction && parse_options & FunctionNodeParseOptions::IsSetterFunction));
 
+    bool parse_body_lazily = parse_options & FunctionNodeParseOptions::ParseBodyLazily;
+    size_t function_offset = 0;
+    LazyFunctionBody::ParserContext parser_context;
+    if (parse_body_lazily) {
+        function_offset = m_parser_state.m_current_token.value().characters_without_null_termination() - m_lazy_function_source.characters();
+        parser_context = { m_parser_state.m_strict_mode, m_parser_state.m_in_break_context, m_parser_state.m_in_continue_context };
+    }
+
     TemporaryChange super_property_access_rollback(m_parser_state.m_allow_super_property_lookup, !!(parse_options & FunctionNodeParseOptions::AllowSuperPropertyLookup));
     TemporaryChange super_constructor_call_rollback(m_parser_state.m_allow_super_constructor_call, !!(parse_options & FunctionNodeParseOptions::AllowSuperConstructorCall));
 
     ScopePusher scope(*this, ScopePusher::Var | ScopePusher::Function);
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Function);
 
     String name;
     if (parse_options & FunctionNodeParseOptions::CheckForFunctionAndName) {
@@ -1343,9 +1541,22 @@ NonnullRefPtr<FunctionNodeType> Parser::parse_function_node(u8 parse_options)
     });
 
     bool is_strict = false;
+    if (parse_body_lazily) {
+        auto body_start = position();
+        frame_slot_scope.declare(parameters);
+        skip_function_body(is_strict);
+        frame_slot_scope.resolve();
+        auto lazy_body = create_ast_node<LazyFunctionBody>({ body_start, position() }, m_lazy_function_source, function_offset, rule_start.position(), parser_context);
+        return create_ast_node<FunctionNodeType>({ rule_start.position(), position() }, name, move(lazy_body), move(parameters), function_length, NonnullRefPtrVector<VariableDeclaration>(), is_strict);
+    }
+
     auto body = parse_block_statement(is_strict);
-    body->add_variables(m_parser_state.m_var_scopes.last());
-    body->add_functions(m_parser_state.m_function_scopes.last());
+    body->add_variables(m_var_scopes.last());
+    body->add_functions(m_function_scopes.last());
+    frame_slot_scope.declare(parameters);
+    frame_slot_scope.declare(m_var_scopes.last());
+    frame_slot_scope.resolve();
+    body->set_frame_slot_count(frame_slot_scope.frame_slot_count());
     return create_ast_node<FunctionNodeType>({ rule_start.position(), position() }, name, move(body), move(parameters), function_length, NonnullRefPtrVector<VariableDeclaration>(), is_strict);
 }
 
@@ -1441,7 +1652,9 @@ NonnullRefPtr<VariableDeclaration> Parser::parse_variable_declaration(bool for_l
         } else if (!for_loop_variable_declaration && declaration_kind == DeclarationKind::Const) {
             syntax_error("Missing initializer in 'const' variable declaration");
         }
-        declarations.append(create_ast_node<VariableDeclarator>({ rule_start.position(), position() }, create_ast_node<Identifier>({ rule_start.position(), position() }, move(id)), move(init)));
+        auto identifier = create_ast_node<Identifier>({ rule_start.position(), position() }, move(id));
+        add_reference(identifier);
+        declarations.append(create_ast_node<VariableDeclarator>({ rule_start.position(), position() }, move(identifier), move(init)));
         if (match(TokenType::Comma)) {
             consume();
             continue;
@@ -1453,9 +1666,9 @@ NonnullRefPtr<VariableDeclaration> Parser::parse_variable_declaration(bool for_l
 
     auto declaration = create_ast_node<VariableDeclaration>({ rule_start.position(), position() }, declaration_kind, move(declarations));
     if (declaration_kind == DeclarationKind::Var)
-        m_parser_state.m_var_scopes.last().append(declaration);
+        m_var_scopes.last().append(declaration);
     else
-        m_parser_state.m_let_scopes.last().append(declaration);
+        m_let_scopes.last().append(declaration);
     return declaration;
 }
 
@@ -1631,6 +1844,7 @@ NonnullRefPtr<WithStatement> Parser::parse_with_statement()
 
     consume(TokenType::ParenClose);
 
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::With);
     auto body = parse_statement();
     return create_ast_node<WithStatement>({ rule_start.position(), position() }, move(object), move(body));
 }
@@ -1665,11 +1879,13 @@ NonnullRefPtr<CatchClause> Parser::parse_catch_clause()
     auto rule_start = push_start();
     consume(TokenType::Catch);
 
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Catch);
     String parameter;
     if (match(TokenType::ParenOpen)) {
         consume();
         parameter = consume(TokenType::Identifier).value();
         consume(TokenType::ParenClose);
+        frame_slot_scope.declare(parameter);
     }
 
     auto body = parse_block_statement();
@@ -1687,7 +1903,7 @@ NonnullRefPtr<IfStatement> Parser::parse_if_statement()
         ScopePusher scope(*this, ScopePusher::Let);
         auto block = create_ast_node<BlockStatement>({ rule_start.position(), position() });
         block->append(parse_declaration());
-        block->add_functions(m_parser_state.m_function_scopes.last());
+        block->add_functions(m_function_scopes.last());
         return block;
     };
 
@@ -1725,6 +1941,11 @@ NonnullRefPtr<Statement> Parser::parse_for_statement()
     consume(TokenType::ParenOpen);
 
     bool in_scope = false;
+    ScopeGuard let_scope_guard([&] {
+        if (in_scope)
+            m_let_scopes.take_last();
+    });
+    FrameSlotScope frame_slot_scope(*this, FrameSlotScope::Type::Block);
     RefPtr<ASTNode> init;
     if (!match(TokenType::Semicolon)) {
         if (match_expression()) {
@@ -1733,10 +1954,12 @@ NonnullRefPtr<Statement> Parser::parse_for_statement()
                 return parse_for_in_of_statement(*init);
         } else if (match_variable_declaration()) {
             if (!match(TokenType::Var)) {
-                m_parser_state.m_let_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
+                m_let_scopes.append(NonnullRefPtrVector<VariableDeclaration>());
                 in_scope = true;
             }
             init = parse_variable_declaration(true);
+            if (in_scope)
+                frame_slot_scope.declare(static_cast<VariableDeclaration&>(*init));
             if (match_for_in_of())
                 return parse_for_in_of_statement(*init);
             if (static_cast<VariableDeclaration&>(*init).declaration_kind() == DeclarationKind::Const) {
@@ -1767,10 +1990,6 @@ NonnullRefPtr<Statement> Parser::parse_for_statement()
     TemporaryChange continue_change(m_parser_state.m_in_continue_context, true);
     auto body = parse_statement();
 
-    if (in_scope) {
-        m_parser_state.m_let_scopes.take_last();
-    }
-
     return create_ast_node<ForStatement>({ rule_start.position(), position() }, move(init), move(test), move(update), move(body));
 }
 
@@ -2007,6 +2226,87 @@ Token Parser::consume_and_validate_numeric_literal()
     return token;
 }
 
+// Skips over a function body without building any nodes for it. Only the errors that can be told
+// from its tokens alone are reported, the rest turn up when the function is parsed for real. Since
+// there's no telling what the body declares, every name in it is taken as a dynamic reference.
+void Parser::skip_function_body(bool& is_strict)
+{
+    TemporaryChange strict_mode_rollback(m_parser_state.m_strict_mode, m_parser_state.m_strict_mode);
+    if (m_parser_state.m_strict_mode)
+        is_strict = true;
+    consume(TokenType::CurlyOpen);
+
+    // Like in parse_block_statement(), the directive has to be a first statement of its own.
+    auto value = m_parser_state.m_current_token.value();
+    if (match(TokenType::StringLiteral) && (value == "'use strict'" || value == "\"use strict\"")) {
+        consume();
+        if (!match_secondary_expression() && !match(TokenType::Comma) && !match(TokenType::TemplateLiteralStart)) {
+            is_strict = true;
+            m_parser_state.m_strict_mode = true;
+        }
+    }
+
+    Vector<TokenType, 16> closing_tokens;
+    closing_tokens.append(TokenType::CurlyClose);
+    auto previous_type = TokenType::CurlyOpen;
+    while (!closing_tokens.is_empty()) {
+        auto type = m_parser_state.m_current_token.type();
+        switch (type) {
+        case TokenType::CurlyOpen:
+            closing_tokens.append(TokenType::CurlyClose);
+            break;
+        case TokenType::ParenOpen:
+            closing_tokens.append(TokenType::ParenClose);
+            break;
+        case TokenType::BracketOpen:
+            closing_tokens.append(TokenType::BracketClose);
+            break;
+        case TokenType::TemplateLiteralExprStart:
+            closing_tokens.append(TokenType::TemplateLiteralExprEnd);
+            break;
+        case TokenType::TemplateLiteralExprEnd:
+            if (previous_type == TokenType::TemplateLiteralExprStart)
+                syntax_error("Empty template literal expression block");
+            [[fallthrough]];
+        case TokenType::CurlyClose:
+        case TokenType::ParenClose:
+        case TokenType::BracketClose:
+            if (type != closing_tokens.last()) {
+                expected(Token::name(closing_tokens.last()));
+                return;
+            }
+            closing_tokens.take_last();
+            break;
+        case TokenType::Identifier:
+            if (previous_type != TokenType::Period && previous_type != TokenType::QuestionMarkPeriod)
+                add_dynamic_reference(m_parser_state.m_current_token.value());
+            break;
+        case TokenType::StringLiteral:
+        case TokenType::TemplateLiteralString:
+            validated_string_value(m_parser_state.m_current_token, type == TokenType::TemplateLiteralString);
+            break;
+        case TokenType::NumericLiteral:
+            consume_and_validate_numeric_literal();
+            previous_type = type;
+            continue;
+        case TokenType::UnterminatedTemplateLiteral:
+            syntax_error("Unterminated template literal");
+            return;
+        case TokenType::Eof:
+        case TokenType::Invalid:
+        case TokenType::UnterminatedStringLiteral:
+        case TokenType::UnterminatedRegexLiteral:
+            expected(Token::name(closing_tokens.last()));
+            return;
+        default:
+            break;
+        }
+        previous_type = type;
+        consume();
+    }
+    m_parser_state.m_string_legacy_octal_escape_sequence_in_scope = false;
+}
+
 void Parser::expected(const char* what)
 {
     auto message = m_parser_state.m_current_token.message();
@@ -2027,18 +2327,41 @@ void Parser::syntax_error(const String& message, Optional<Position> position)
 {
     if (!position.has_value())
         position = this->position();
-    m_parser_state.m_errors.append({ message, position });
+    m_errors.append({ message, position });
 }
 
 void Parser::save_state()
 {
-    m_saved_state.append(m_parser_state);
+    SavedState saved_state { m_parser_state };
+    saved_state.error_count = m_errors.size();
+    saved_state.reference_count = m_references.size();
+    saved_state.var_scope_depth = m_var_scopes.size();
+    saved_state.var_scope_size = m_var_scopes.is_empty() ? 0 : m_var_scopes.last().size();
+    saved_state.let_scope_depth = m_let_scopes.size();
+    saved_state.let_scope_size = m_let_scopes.is_empty() ? 0 : m_let_scopes.last().size();
+    saved_state.function_scope_depth = m_function_scopes.size();
+    saved_state.function_scope_size = m_function_scopes.is_empty() ? 0 : m_function_scopes.last().size();
+    m_saved_state.append(move(saved_state));
 }
 
 void Parser::load_state()
 {
     ASSERT(!m_saved_state.is_empty());
-    m_parser_state = m_saved_state.take_last();
+    auto saved_state = m_saved_state.take_last();
+    m_parser_state = move(saved_state.parser_state);
+    m_errors.shrink(saved_state.error_count);
+    m_references.shrink(saved_state.reference_count);
+
+    // Any scope that was entered since has been left again, so only declarations added to the
+    // innermost ones have to be taken out.
+    auto restore_scope = [](auto& scopes, size_t depth, size_t size) {
+        ASSERT(scopes.size() == depth);
+        if (depth)
+            scopes.last().shrink(size);
+    };
+    restore_scope(m_var_scopes, saved_state.var_scope_depth, saved_state.var_scope_size);
+    restore_scope(m_let_scopes, saved_state.let_scope_depth, saved_state.let_scope_size);
+    restore_scope(m_function_scopes, saved_state.function_scope_depth, saved_state.function_scope_size);
 }
 
 void Parser::discard_saved_state()
@@ -2046,4 +2369,15 @@ void Parser::discard_saved_state()
     m_saved_state.take_last();
 }
 
+void Parser::add_reference(NonnullRefPtr<Identifier> identifier)
+{
+    auto name = identifier->string();
+    m_references.append({ move(name), move(identifier), false });
+}
+
+void Parser::add_dynamic_reference(const FlyString& name)
+{
+    m_references.append({ name, nullptr, true });
+}
+
 }
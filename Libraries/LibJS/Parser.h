@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Arena.h>
 #include <AK/HashTable.h>
 #include <AK/NonnullRefPtr.h>
 #include <AK/StringBuilder.h>
@@ -36,6 +37,8 @@
 
 namespace JS {
 
+class FrameSlotScope;
+
 enum class Associativity {
     Left,
     Right
@@ -49,6 +52,7 @@ struct FunctionNodeParseOptions {
         IsGetterFunction = 1 << 3,
         IsSetterFunction = 1 << 4,
         IsArrowFunction = 1 << 5,
+        ParseBodyLazily = 1 << 6,
     };
 };
 
@@ -56,6 +60,13 @@ class Parser {
 public:
     explicit Parser(Lexer lexer);
 
+    // Makes the parser skip over the bodies of function declarations, and leave parsing them to
+    // when the functions are first called (see LazyFunctionBody). Most functions in large scripts
+    // never are. The source has to be the one the Lexer reads, it's kept until then.
+    void enable_lazy_function_bodies(const String& source);
+    // Returns null and the first error if the function has syntax errors that skipping its body didn't catch.
+    static RefPtr<FunctionDeclaration> parse_lazy_function(const LazyFunctionBody&, String& error);
+
     NonnullRefPtr<Program> parse_program();
 
     template<typename FunctionNodeType>
@@ -135,11 +146,11 @@ public:
         }
     };
 
-    bool has_errors() const { return m_parser_state.m_errors.size(); }
-    const Vector<Error>& errors() const { return m_parser_state.m_errors; }
+    bool has_errors() const { return m_errors.size(); }
+    const Vector<Error>& errors() const { return m_errors; }
     void print_errors() const
     {
-        for (auto& error : m_parser_state.m_errors) {
+        for (auto& error : m_errors) {
             auto hint = error.source_location_hint(m_parser_state.m_lexer.source());
             if (!hint.is_empty())
                 warnln("{}", hint);
@@ -149,6 +160,7 @@ public:
 
 private:
     friend class ScopePusher;
+    friend class FrameSlotScope;
 
     Associativity operator_associativity(TokenType) const;
     bool match_expression() const;
@@ -167,9 +179,13 @@ private:
     Token consume(TokenType type);
     Token consume_and_validate_numeric_literal();
     void consume_or_insert_semicolon();
+    String validated_string_value(const Token&, bool in_template_literal);
+    void skip_function_body(bool& is_strict);
     void save_state();
     void load_state();
     void discard_saved_state();
+    void add_reference(NonnullRefPtr<Identifier>);
+    void add_dynamic_reference(const FlyString& name);
     Position position() const;
 
     struct RulePosition {
@@ -200,13 +216,11 @@ private:
 
     [[nodiscard]] RulePosition push_start() { return { *this, position() }; }
 
+    // Everything that save_state() copies. The errors and scopes live outside of it, as they
+    // only grow while a saved state is around: load_state() just cuts them back to their size.
     struct ParserState {
         Lexer m_lexer;
         Token m_current_token;
-        Vector<Error> m_errors;
-        Vector<NonnullRefPtrVector<VariableDeclaration>> m_var_scopes;
-        Vector<NonnullRefPtrVector<VariableDeclaration>> m_let_scopes;
-        Vector<NonnullRefPtrVector<FunctionDeclaration>> m_function_scopes;
         HashTable<StringView> m_labels_in_scope;
         bool m_strict_mode { false };
         bool m_allow_super_property_lookup { false };
@@ -220,8 +234,38 @@ private:
         explicit ParserState(Lexer);
     };
 
+    // An identifier that still has to be resolved to the binding it refers to.
+    // Dynamic references (ones that happen by name at runtime, like declaring a
+    // function, or that cross a function or `with` boundary) keep whatever binding
+    // they resolve to out of the CallFrame.
+    struct IdentifierReference {
+        FlyString name;
+        RefPtr<Identifier> identifier;
+        bool is_dynamic { false };
+    };
+
+    struct SavedState {
+        ParserState parser_state;
+        size_t error_count { 0 };
+        size_t reference_count { 0 };
+        size_t var_scope_depth { 0 };
+        size_t var_scope_size { 0 };
+        size_t let_scope_depth { 0 };
+        size_t let_scope_size { 0 };
+        size_t function_scope_depth { 0 };
+        size_t function_scope_size { 0 };
+    };
+
     Vector<Position> m_rule_starts;
     ParserState m_parser_state;
-    Vector<ParserState> m_saved_state;
+    Vector<SavedState> m_saved_state;
+    Vector<Error> m_errors;
+    Vector<NonnullRefPtrVector<VariableDeclaration>> m_var_scopes;
+    Vector<NonnullRefPtrVector<VariableDeclaration>> m_let_scopes;
+    Vector<NonnullRefPtrVector<FunctionDeclaration>> m_function_scopes;
+    FrameSlotScope* m_frame_slot_scope { nullptr };
+    Vector<IdentifierReference> m_references;
+    String m_lazy_function_source;
+    Arena m_node_arena;
 };
 }
@@ -0,0 +1,1388 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Arena.h>
+#include <AK/HashMap.h>
+#include <AK/Hex.h>
+#include <AK/MappedFile.h>
+#include <AK/MemoryStream.h>
+#include <AK/TypeCasts.h>
+#include <LibCore/File.h>
+#include <LibCrypto/Checksum/CRC32.h>
+#include <LibCrypto/Hash/SHA2.h>
+#include <LibJS/AST.h>
+#include <LibJS/ProgramCache.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace JS {
+
+// An entry starts with the magic, the format version, the hash of the source and a CRC32 of the rest
+// of the entry. That begins with the number of strings and nodes, followed by the strings themselves. The rest is the tree of nodes, in
+// pre-order. Each node starts with its NodeType and source range, followed by its fields, and then
+// by its label if it's a statement. Nodes that are referenced from more than one place (like the
+// declarations in ScopeNode::variables()) are written once, and referred to by their index in the
+// pre-order afterwards. Integers are LEB128-encoded, and strings are referred to by their index in
+// the string table, where 0 stands for the null string.
+//
+// Bump the version whenever any of this, or anything about what the parser puts into the AST, changes.
+static constexpr u8 s_magic[] = { 'L', 'J', 'S', 'P' };
+static constexpr u32 s_format_version = 1;
+
+using Digest = Crypto::Hash::SHA256::DigestType;
+
+enum class NodeType : u8 {
+    Null,
+    BackReference,
+
+    // Statements, which are followed by their label.
+    EmptyStatement,
+    ErrorStatement,
+    ExpressionStatement,
+    Program,
+    BlockStatement,
+    ErrorDeclaration,
+    FunctionDeclaration,
+    ReturnStatement,
+    IfStatement,
+    WhileStatement,
+    DoWhileStatement,
+    WithStatement,
+    ForStatement,
+    ForInStatement,
+    ForOfStatement,
+    ClassDeclaration,
+    VariableDeclaration,
+    TryStatement,
+    ThrowStatement,
+    SwitchStatement,
+    BreakStatement,
+    ContinueStatement,
+    DebuggerStatement,
+
+    // Everything else.
+    FunctionExpression,
+    ErrorExpression,
+    BinaryExpression,
+    LogicalExpression,
+    UnaryExpression,
+    SequenceExpression,
+    BooleanLiteral,
+    NumericLiteral,
+    BigIntLiteral,
+    StringLiteral,
+    NullLiteral,
+    RegExpLiteral,
+    Identifier,
+    ClassMethod,
+    SuperExpression,
+    ClassExpression,
+    SpreadExpression,
+    ThisExpression,
+    CallExpression,
+    NewExpression,
+    AssignmentExpression,
+    UpdateExpression,
+    VariableDeclarator,
+    ObjectProperty,
+    ObjectExpression,
+    ArrayExpression,
+    TemplateLiteral,
+    TaggedTemplateLiteral,
+    MemberExpression,
+    MetaProperty,
+    ConditionalExpression,
+    CatchClause,
+    SwitchCase,
+};
+
+static bool is_statement(NodeType type)
+{
+    return type >= NodeType::EmptyStatement && type <= NodeType::DebuggerStatement;
+}
+
+static Digest hash_source(const StringView& source)
+{
+    return Crypto::Hash::SHA256::hash(source);
+}
+
+static void write_leb128(OutputStream& stream, size_t value)
+{
+    do {
+        u8 byte = value & 0x7f;
+        value >>= 7;
+        if (value)
+            byte |= 0x80;
+        stream << byte;
+    } while (value);
+}
+
+class Encoder {
+public:
+    ByteBuffer encode(const Digest&, const Program&);
+
+private:
+    static NodeType node_type(const ASTNode&);
+
+    void write_unsigned(size_t value) { write_leb128(m_stream, value); }
+    void write_bool(bool value) { write_unsigned(value); }
+    void write_double(double);
+    void write_string(const String&);
+    void write_range(const SourceRange&);
+
+    void encode_node(const ASTNode*);
+    void encode_fields(NodeType, const ASTNode&);
+    void encode_scope(const ScopeNode&);
+    void encode_function(const FunctionNode&);
+
+    template<typename T>
+    void encode_vector(const NonnullRefPtrVector<T>& nodes)
+    {
+        write_unsigned(nodes.size());
+        for (auto& node : nodes)
+            encode_node(&node);
+    }
+
+    DuplexMemoryStream m_stream;
+    HashMap<const ASTNode*, size_t> m_node_indices;
+    HashMap<String, size_t> m_string_indices;
+    Vector<String> m_strings;
+    bool m_has_unstorable_function { false };
+};
+
+NodeType Encoder::node_type(const ASTNode& node)
+{
+    // Roughly ordered by how common the nodes are. NewExpression has to come before CallExpression.
+    if (is<Identifier>(node))
+        return NodeType::Identifier;
+    if (is<MemberExpression>(node))
+        return NodeType::MemberExpression;
+    if (is<NewExpression>(node))
+        return NodeType::NewExpression;
+    if (is<CallExpression>(node))
+        return NodeType::CallExpression;
+    if (is<StringLiteral>(node))
+        return NodeType::StringLiteral;
+    if (is<NumericLiteral>(node))
+        return NodeType::NumericLiteral;
+    if (is<ExpressionStatement>(node))
+        return NodeType::ExpressionStatement;
+    if (is<BinaryExpression>(node))
+        return NodeType::BinaryExpression;
+    if (is<AssignmentExpression>(node))
+        return NodeType::AssignmentExpression;
+    if (is<VariableDeclarator>(node))
+        return NodeType::VariableDeclarator;
+    if (is<VariableDeclaration>(node))
+        return NodeType::VariableDeclaration;
+    if (is<BlockStatement>(node))
+        return NodeType::BlockStatement;
+    if (is<FunctionExpression>(node))
+        return NodeType::FunctionExpression;
+    if (is<ReturnStatement>(node))
+        return NodeType::ReturnStatement;
+    if (is<IfStatement>(node))
+        return NodeType::IfStatement;
+    if (is<ObjectProperty>(node))
+        return NodeType::ObjectProperty;
+    if (is<ObjectExpression>(node))
+        return NodeType::ObjectExpression;
+    if (is<ArrayExpression>(node))
+        return NodeType::ArrayExpression;
+    if (is<UnaryExpression>(node))
+        return NodeType::UnaryExpression;
+    if (is<LogicalExpression>(node))
+        return NodeType::LogicalExpression;
+    if (is<UpdateExpression>(node))
+        return NodeType::UpdateExpression;
+    if (is<BooleanLiteral>(node))
+        return NodeType::BooleanLiteral;
+    if (is<NullLiteral>(node))
+        return NodeType::NullLiteral;
+    if (is<ThisExpression>(node))
+        return NodeType::ThisExpression;
+    if (is<ConditionalExpression>(node))
+        return NodeType::ConditionalExpression;
+    if (is<FunctionDeclaration>(node))
+        return NodeType::FunctionDeclaration;
+    if (is<TemplateLiteral>(node))
+        return NodeType::TemplateLiteral;
+    if (is<ForStatement>(node))
+        return NodeType::ForStatement;
+    if (is<ForInStatement>(node))
+        return NodeType::ForInStatement;
+    if (is<ForOfStatement>(node))
+        return NodeType::ForOfStatement;
+    if (is<WhileStatement>(node))
+        return NodeType::WhileStatement;
+    if (is<DoWhileStatement>(node))
+        return NodeType::DoWhileStatement;
+    if (is<ThrowStatement>(node))
+        return NodeType::ThrowStatement;
+    if (is<TryStatement>(node))
+        return NodeType::TryStatement;
+    if (is<CatchClause>(node))
+        return NodeType::CatchClause;
+    if (is<SwitchStatement>(node))
+        return NodeType::SwitchStatement;
+    if (is<SwitchCase>(node))
+        return NodeType::SwitchCase;
+    if (is<BreakStatement>(node))
+        return NodeType::BreakStatement;
+    if (is<ContinueStatement>(node))
+        return NodeType::ContinueStatement;
+    if (is<SpreadExpression>(node))
+        return NodeType::SpreadExpression;
+    if (is<SequenceExpression>(node))
+        return NodeType::SequenceExpression;
+    if (is<RegExpLiteral>(node))
+        return NodeType::RegExpLiteral;
+    if (is<BigIntLiteral>(node))
+        return NodeType::BigIntLiteral;
+    if (is<ClassDeclaration>(node))
+        return NodeType::ClassDeclaration;
+    if (is<ClassExpression>(node))
+        return NodeType::ClassExpression;
+    if (is<ClassMethod>(node))
+        return NodeType::ClassMethod;
+    if (is<SuperExpression>(node))
+        return NodeType::SuperExpression;
+    if (is<TaggedTemplateLiteral>(node))
+        return NodeType::TaggedTemplateLiteral;
+    if (is<MetaProperty>(node))
+        return NodeType::MetaProperty;
+    if (is<WithStatement>(node))
+        return NodeType::WithStatement;
+    if (is<EmptyStatement>(node))
+        return NodeType::EmptyStatement;
+    if (is<DebuggerStatement>(node))
+        return NodeType::DebuggerStatement;
+    if (is<Program>(node))
+        return NodeType::Program;
+    if (is<ErrorStatement>(node))
+        return NodeType::ErrorStatement;
+    if (is<ErrorDeclaration>(node))
+        return NodeType::ErrorDeclaration;
+    if (is<ErrorExpression>(node))
+        return NodeType::ErrorExpression;
+    ASSERT_NOT_REACHED();
+}
+
+void Encoder::write_double(double value)
+{
+    u64 bits;
+    __builtin_memcpy(&bits, &value, sizeof(bits));
+    m_stream << LittleEndian<u64>(bits);
+}
+
+void Encoder::write_string(const String& string)
+{
+    if (string.is_null()) {
+        write_unsigned(0);
+        return;
+    }
+    auto it = m_string_indices.find(string);
+    if (it != m_string_indices.end()) {
+        write_unsigned(it->value);
+        return;
+    }
+    m_strings.append(string);
+    m_string_indices.set(string, m_strings.size());
+    write_unsigned(m_strings.size());
+}
+
+void Encoder::write_range(const SourceRange& range)
+{
+    write_unsigned(range.start.line);
+    write_unsigned(range.start.column);
+    write_unsigned(range.end.line);
+    write_unsigned(range.end.column);
+}
+
+ByteBuffer Encoder::encode(const Digest& digest, const Program& program)
+{
+    encode_node(&program);
+    if (m_has_unstorable_function)
+        return {};
+
+    DuplexMemoryStream contents;
+    write_leb128(contents, m_strings.size());
+    write_leb128(contents, m_node_indices.size());
+    for (auto& string : m_strings) {
+        write_leb128(contents, string.length());
+        contents << string.bytes();
+    }
+    contents << m_stream.copy_into_contiguous_buffer().bytes();
+    auto contents_buffer = contents.copy_into_contiguous_buffer();
+
+    DuplexMemoryStream entry;
+    entry << ReadonlyBytes { s_magic, sizeof(s_magic) };
+    entry << LittleEndian<u32>(s_format_version);
+    entry << ReadonlyBytes { digest.immutable_data(), Digest::Size };
+    entry << LittleEndian<u32>(Crypto::Checksum::CRC32(contents_buffer).digest());
+    entry << contents_buffer.bytes();
+    return entry.copy_into_contiguous_buffer();
+}
+
+void Encoder::encode_node(const ASTNode* node)
+{
+    if (!node) {
+        write_unsigned((size_t)NodeType::Null);
+        return;
+    }
+    auto it = m_node_indices.find(node);
+    if (it != m_node_indices.end()) {
+        write_unsigned((size_t)NodeType::BackReference);
+        write_unsigned(it->value);
+        return;
+    }
+    m_node_indices.set(node, m_node_indices.size());
+
+    auto type = node_type(*node);
+    write_unsigned((size_t)type);
+    write_range(node->source_range());
+    encode_fields(type, *node);
+    if (is_statement(type))
+        write_string(static_cast<const Statement&>(*node).label());
+}
+
+void Encoder::encode_scope(const ScopeNode& scope)
+{
+    write_unsigned(scope.frame_slot_count());
+    encode_vector(scope.children());
+    encode_vector(scope.variables());
+    encode_vector(scope.functions());
+}
+
+void Encoder::encode_function(const FunctionNode& function)
+{
+    write_string(function.name());
+    // Entries always hold complete programs, so functions whose bodies were skipped are parsed now.
+    auto* complete_function = &function;
+    if (is<LazyFunctionBody>(function.body())) {
+        complete_function = static_cast<const LazyFunctionBody&>(function.body()).function();
+        // A syntax error that would only be thrown once the function is called can't be stored.
+        if (!complete_function) {
+            m_has_unstorable_function = true;
+            return;
+        }
+    }
+    encode_node(&complete_function->body());
+    write_unsigned(complete_function->parameters().size());
+    for (auto& parameter : complete_function->parameters()) {
+        write_string(parameter.name);
+        encode_node(parameter.default_value.ptr());
+        write_bool(parameter.is_rest);
+        write_unsigned(parameter.frame_slot.has_value() ? parameter.frame_slot.value() + 1 : 0);
+    }
+    write_unsigned(complete_function->function_length());
+    encode_vector(complete_function->variables());
+    write_bool(complete_function->is_strict_mode());
+}
+
+void Encoder::encode_fields(NodeType type, const ASTNode& node)
+{
+    switch (type) {
+    case NodeType::EmptyStatement:
+    case NodeType::ErrorStatement:
+    case NodeType::ErrorDeclaration:
+    case NodeType::DebuggerStatement:
+    case NodeType::ErrorExpression:
+    case NodeType::NullLiteral:
+    case NodeType::SuperExpression:
+    case NodeType::ThisExpression:
+        break;
+    case NodeType::ExpressionStatement:
+        encode_node(&static_cast<const ExpressionStatement&>(node).expression());
+        break;
+    case NodeType::Program:
+        encode_scope(static_cast<const Program&>(node));
+        write_bool(static_cast<const Program&>(node).is_strict_mode());
+        break;
+    case NodeType::BlockStatement:
+        encode_scope(static_cast<const BlockStatement&>(node));
+        break;
+    case NodeType::FunctionDeclaration:
+        encode_function(static_cast<const FunctionDeclaration&>(node));
+        break;
+    case NodeType::FunctionExpression:
+        encode_function(static_cast<const FunctionExpression&>(node));
+        write_bool(static_cast<const FunctionExpression&>(node).is_arrow_function());
+        break;
+    case NodeType::ReturnStatement:
+        encode_node(static_cast<const ReturnStatement&>(node).argument());
+        break;
+    case NodeType::IfStatement: {
+        auto& statement = static_cast<const IfStatement&>(node);
+        encode_node(&statement.predicate());
+        encode_node(&statement.consequent());
+        encode_node(statement.alternate());
+        break;
+    }
+    case NodeType::WhileStatement: {
+        auto& statement = static_cast<const WhileStatement&>(node);
+        encode_node(&statement.test());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::DoWhileStatement: {
+        auto& statement = static_cast<const DoWhileStatement&>(node);
+        encode_node(&statement.test());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::WithStatement: {
+        auto& statement = static_cast<const WithStatement&>(node);
+        encode_node(&statement.object());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::ForStatement: {
+        auto& statement = static_cast<const ForStatement&>(node);
+        encode_node(statement.init());
+        encode_node(statement.test());
+        encode_node(statement.update());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::ForInStatement: {
+        auto& statement = static_cast<const ForInStatement&>(node);
+        encode_node(&statement.lhs());
+        encode_node(&statement.rhs());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::ForOfStatement: {
+        auto& statement = static_cast<const ForOfStatement&>(node);
+        encode_node(&statement.lhs());
+        encode_node(&statement.rhs());
+        encode_node(&statement.body());
+        break;
+    }
+    case NodeType::ClassDeclaration:
+        encode_node(&static_cast<const ClassDeclaration&>(node).class_expression());
+        break;
+    case NodeType::VariableDeclaration: {
+        auto& declaration = static_cast<const VariableDeclaration&>(node);
+        write_unsigned((size_t)declaration.declaration_kind());
+        encode_vector(declaration.declarations());
+        break;
+    }
+    case NodeType::TryStatement: {
+        auto& statement = static_cast<const TryStatement&>(node);
+        encode_node(&statement.block());
+        encode_node(statement.handler());
+        encode_node(statement.finalizer());
+        break;
+    }
+    case NodeType::ThrowStatement:
+        encode_node(&static_cast<const ThrowStatement&>(node).argument());
+        break;
+    case NodeType::SwitchStatement: {
+        auto& statement = static_cast<const SwitchStatement&>(node);
+        encode_node(&statement.discriminant());
+        encode_vector(statement.cases());
+        break;
+    }
+    case NodeType::BreakStatement:
+        write_string(static_cast<const BreakStatement&>(node).target_label());
+        break;
+    case NodeType::ContinueStatement:
+        write_string(static_cast<const ContinueStatement&>(node).target_label());
+        break;
+    case NodeType::BinaryExpression: {
+        auto& expression = static_cast<const BinaryExpression&>(node);
+        write_unsigned((size_t)expression.op());
+        encode_node(&expression.lhs());
+        encode_node(&expression.rhs());
+        break;
+    }
+    case NodeType::LogicalExpression: {
+        auto& expression = static_cast<const LogicalExpression&>(node);
+        write_unsigned((size_t)expression.op());
+        encode_node(&expression.lhs());
+        encode_node(&expression.rhs());
+        break;
+    }
+    case NodeType::UnaryExpression: {
+        auto& expression = static_cast<const UnaryExpression&>(node);
+        write_unsigned((size_t)expression.op());
+        encode_node(&expression.lhs());
+        break;
+    }
+    case NodeType::SequenceExpression:
+        encode_vector(static_cast<const SequenceExpression&>(node).expressions());
+        break;
+    case NodeType::BooleanLiteral:
+        write_bool(static_cast<const BooleanLiteral&>(node).value());
+        break;
+    case NodeType::NumericLiteral:
+        write_double(static_cast<const NumericLiteral&>(node).value());
+        break;
+    case NodeType::BigIntLiteral:
+        write_string(static_cast<const BigIntLiteral&>(node).value());
+        break;
+    case NodeType::StringLiteral: {
+        auto& literal = static_cast<const StringLiteral&>(node);
+        write_string(literal.value());
+        write_bool(literal.is_use_strict_directive());
+        break;
+    }
+    case NodeType::RegExpLiteral: {
+        auto& literal = static_cast<const RegExpLiteral&>(node);
+        write_string(literal.content());
+        write_string(literal.flags());
+        break;
+    }
+    case NodeType::Identifier: {
+        auto& identifier = static_cast<const Identifier&>(node);
+        write_string(identifier.string());
+        if (!identifier.has_frame_slot()) {
+            write_unsigned(0);
+            break;
+        }
+        write_unsigned(identifier.frame_slot() + 1);
+        write_bool(identifier.is_const_frame_slot());
+        break;
+    }
+    case NodeType::ClassMethod: {
+        auto& method = static_cast<const ClassMethod&>(node);
+        encode_node(&method.key());
+        encode_node(&method.function());
+        write_unsigned((size_t)method.kind());
+        write_bool(method.is_static());
+        break;
+    }
+    case NodeType::ClassExpression: {
+        auto& expression = static_cast<const ClassExpression&>(node);
+        write_string(expression.name());
+        encode_node(expression.constructor());
+        encode_node(expression.super_class());
+        encode_vector(expression.methods());
+        break;
+    }
+    case NodeType::SpreadExpression:
+        encode_node(&static_cast<const SpreadExpression&>(node).target());
+        break;
+    case NodeType::CallExpression:
+    case NodeType::NewExpression: {
+        auto& expression = static_cast<const CallExpression&>(node);
+        encode_node(&expression.callee());
+        write_unsigned(expression.arguments().size());
+        for (auto& argument : expression.arguments()) {
+            encode_node(argument.value.ptr());
+            write_bool(argument.is_spread);
+        }
+        break;
+    }
+    case NodeType::AssignmentExpression: {
+        auto& expression = static_cast<const AssignmentExpression&>(node);
+        write_unsigned((size_t)expression.op());
+        encode_node(&expression.lhs());
+        encode_node(&expression.rhs());
+        break;
+    }
+    case NodeType::UpdateExpression: {
+        auto& expression = static_cast<const UpdateExpression&>(node);
+        write_unsigned((size_t)expression.op());
+        encode_node(&expression.argument());
+        write_bool(expression.is_prefixed());
+        break;
+    }
+    case NodeType::VariableDeclarator: {
+        auto& declarator = static_cast<const VariableDeclarator&>(node);
+        encode_node(&declarator.id());
+        encode_node(declarator.init());
+        break;
+    }
+    case NodeType::ObjectProperty: {
+        auto& property = static_cast<const ObjectProperty&>(node);
+        encode_node(&property.key());
+        encode_node(property.value_or_null());
+        write_unsigned((size_t)property.type());
+        write_bool(property.is_method());
+        break;
+    }
+    case NodeType::ObjectExpression:
+        encode_vector(static_cast<const ObjectExpression&>(node).properties());
+        break;
+    case NodeType::ArrayExpression: {
+        auto& elements = static_cast<const ArrayExpression&>(node).elements();
+        write_unsigned(elements.size());
+        for (auto& element : elements)
+            encode_node(element.ptr());
+        break;
+    }
+    case NodeType::TemplateLiteral: {
+        auto& literal = static_cast<const TemplateLiteral&>(node);
+        encode_vector(literal.expressions());
+        encode_vector(literal.raw_strings());
+        break;
+    }
+    case NodeType::TaggedTemplateLiteral: {
+        auto& literal = static_cast<const TaggedTemplateLiteral&>(node);
+        encode_node(&literal.tag());
+        encode_node(&literal.template_literal());
+        break;
+    }
+    case NodeType::MemberExpression: {
+        auto& expression = static_cast<const MemberExpression&>(node);
+        encode_node(&expression.object());
+        encode_node(&expression.property());
+        write_bool(expression.is_computed());
+        break;
+    }
+    case NodeType::MetaProperty:
+        write_unsigned((size_t)static_cast<const MetaProperty&>(node).type());
+        break;
+    case NodeType::ConditionalExpression: {
+        auto& expression = static_cast<const ConditionalExpression&>(node);
+        encode_node(&expression.test());
+        encode_node(&expression.consequent());
+        encode_node(&expression.alternate());
+        break;
+    }
+    case NodeType::CatchClause: {
+        auto& clause = static_cast<const CatchClause&>(node);
+        write_string(clause.parameter());
+        encode_node(&clause.body());
+        break;
+    }
+    case NodeType::SwitchCase: {
+        auto& switch_case = static_cast<const SwitchCase&>(node);
+        encode_node(switch_case.test());
+        encode_vector(switch_case.consequent());
+        break;
+    }
+    case NodeType::Null:
+    case NodeType::BackReference:
+        ASSERT_NOT_REACHED();
+    }
+}
+
+class Decoder {
+public:
+    explicit Decoder(ReadonlyBytes bytes)
+        : m_stream(bytes)
+    {
+    }
+
+    ~Decoder()
+    {
+        // Damaged entries can leave errors behind in the stream, but we've given up on those anyway.
+        m_stream.handle_any_error();
+    }
+
+    RefPtr<Program> decode(const Digest&);
+
+private:
+    bool fail()
+    {
+        m_failed = true;
+        return false;
+    }
+
+    size_t read_unsigned();
+    size_t read_count();
+    bool read_bool() { return read_unsigned() != 0; }
+    double read_double();
+    const String& read_string();
+    FlyString read_fly_string();
+    SourceRange read_range();
+    bool check_frame_slot(size_t);
+
+    template<typename Enum>
+    Enum read_enum(Enum last_value)
+    {
+        auto value = read_unsigned();
+        if (value > (size_t)last_value) {
+            fail();
+            return last_value;
+        }
+        return (Enum)value;
+    }
+
+    // Returns nullptr both for a null node and on failure, so check m_failed where that matters.
+    RefPtr<ASTNode> decode_node();
+    RefPtr<ASTNode> decode_fields(NodeType, const SourceRange&);
+    bool decode_scope(ScopeNode&, bool owns_frame);
+
+    template<typename FunctionNodeType>
+    RefPtr<ASTNode> decode_function(const SourceRange&);
+
+    template<typename T>
+    RefPtr<T> decode()
+    {
+        auto node = decode_node();
+        if constexpr (IsSame<T, ASTNode>::value) {
+            return node;
+        } else {
+            if (!node)
+                return nullptr;
+            if (!is<T>(*node)) {
+                fail();
+                return nullptr;
+            }
+            return static_ptr_cast<T>(node);
+        }
+    }
+
+    template<typename T>
+    RefPtr<T> decode_nonnull()
+    {
+        auto node = decode<T>();
+        if (!node)
+            fail();
+        return node;
+    }
+
+    template<typename T>
+    bool decode_vector(NonnullRefPtrVector<T>& nodes)
+    {
+        auto count = read_count();
+        nodes.ensure_capacity(count);
+        for (size_t i = 0; i < count; ++i) {
+            auto node = decode_nonnull<T>();
+            if (!node)
+                return false;
+            nodes.append(node.release_nonnull());
+        }
+        return !m_failed;
+    }
+
+    InputMemoryStream m_stream;
+    bool m_failed { false };
+    Vector<String> m_strings;
+    Vector<FlyString> m_fly_strings;
+    Vector<RefPtr<ASTNode>> m_nodes;
+    Vector<size_t> m_frame_slot_counts;
+    bool m_next_scope_owns_frame { false };
+    Arena m_node_arena;
+};
+
+size_t Decoder::read_unsigned()
+{
+    size_t value = 0;
+    if (m_failed || !m_stream.read_LEB128_unsigned(value))
+        fail();
+    return value;
+}
+
+size_t Decoder::read_count()
+{
+    // Whatever is counted takes up at least a byte each, which keeps damaged counts from turning into huge allocations.
+    auto count = read_unsigned();
+    if (count > m_stream.remaining()) {
+        fail();
+        return 0;
+    }
+    return count;
+}
+
+double Decoder::read_double()
+{
+    LittleEndian<u64> bits;
+    if (m_failed)
+        return 0;
+    if ((m_stream >> bits).handle_any_error()) {
+        fail();
+        return 0;
+    }
+    u64 raw_bits = bits;
+    double value;
+    __builtin_memcpy(&value, &raw_bits, sizeof(value));
+    return value;
+}
+
+const String& Decoder::read_string()
+{
+    auto index = read_unsigned();
+    if (index >= m_strings.size()) {
+        fail();
+        return m_strings[0];
+    }
+    return m_strings[index];
+}
+
+FlyString Decoder::read_fly_string()
+{
+    auto index = read_unsigned();
+    if (index >= m_strings.size()) {
+        fail();
+        return {};
+    }
+    if (m_fly_strings[index].is_null() && !m_strings[index].is_null())
+        m_fly_strings[index] = m_strings[index];
+    return m_fly_strings[index];
+}
+
+SourceRange Decoder::read_range()
+{
+    SourceRange range;
+    range.start.line = read_unsigned();
+    range.start.column = read_unsigned();
+    range.end.line = read_unsigned();
+    range.end.column = read_unsigned();
+    return range;
+}
+
+bool Decoder::check_frame_slot(size_t slot)
+{
+    if (m_frame_slot_counts.is_empty() || slot >= m_frame_slot_counts.last())
+        return fail();
+    return true;
+}
+
+RefPtr<Program> Decoder::decode(const Digest& digest)
+{
+    u8 magic[sizeof(s_magic)];
+    LittleEndian<u32> version;
+    u8 source_digest[Digest::Size];
+    LittleEndian<u32> checksum;
+    m_stream >> Bytes { magic, sizeof(magic) } >> version >> Bytes { source_digest, sizeof(source_digest) } >> checksum;
+    if (m_stream.handle_any_error())
+        return nullptr;
+    if (__builtin_memcmp(magic, s_magic, sizeof(magic)) || version != s_format_version)
+        return nullptr;
+    if (__builtin_memcmp(source_digest, digest.immutable_data(), Digest::Size))
+        return nullptr;
+    if (Crypto::Checksum::CRC32(m_stream.bytes().slice(m_stream.offset())).digest() != checksum)
+        return nullptr;
+
+    auto string_count = read_count();
+    auto node_count = read_count();
+    m_strings.ensure_capacity(string_count + 1);
+    m_strings.append(String {});
+    for (size_t i = 0; i < string_count && !m_failed; ++i) {
+        auto length = read_count();
+        if (m_failed)
+            break;
+        m_strings.append(StringView { m_stream.bytes().offset_pointer(m_stream.offset()), length });
+        m_stream.discard_or_error(length);
+    }
+    m_fly_strings.resize(m_strings.size());
+    m_nodes.ensure_capacity(node_count);
+
+    Arena::Scope arena_scope(m_node_arena);
+    auto program = decode<Program>();
+    if (m_failed || m_stream.remaining() || !program)
+        return nullptr;
+    return program;
+}
+
+RefPtr<ASTNode> Decoder::decode_node()
+{
+    auto type = read_enum(NodeType::SwitchCase);
+    if (m_failed || type == NodeType::Null)
+        return nullptr;
+    if (type == NodeType::BackReference) {
+        auto index = read_unsigned();
+        // Nodes can only be referred to once they are complete, which also rules out cycles.
+        if (index >= m_nodes.size() || !m_nodes[index]) {
+            fail();
+            return nullptr;
+        }
+        return m_nodes[index];
+    }
+
+    auto index = m_nodes.size();
+    m_nodes.append(nullptr);
+    auto range = read_range();
+    auto node = decode_fields(type, range);
+    if (m_failed || !node) {
+        fail();
+        return nullptr;
+    }
+    if (is_statement(type))
+        static_cast<Statement&>(*node).set_label(read_fly_string());
+    m_nodes[index] = node;
+    return node;
+}
+
+bool Decoder::decode_scope(ScopeNode& scope, bool owns_frame)
+{
+    auto frame_slot_count = read_count();
+    scope.set_frame_slot_count(frame_slot_count);
+    if (owns_frame)
+        m_frame_slot_counts.append(frame_slot_count);
+
+    auto child_count = read_count();
+    for (size_t i = 0; i < child_count; ++i) {
+        auto child = decode_nonnull<Statement>();
+        if (!child)
+            break;
+        scope.append(child.release_nonnull());
+    }
+    NonnullRefPtrVector<VariableDeclaration> variables;
+    NonnullRefPtrVector<FunctionDeclaration> functions;
+    if (decode_vector(variables))
+        decode_vector(functions);
+    scope.add_variables(move(variables));
+    scope.add_functions(move(functions));
+
+    if (owns_frame)
+        m_frame_slot_counts.take_last();
+    return !m_failed;
+}
+
+template<typename FunctionNodeType>
+RefPtr<ASTNode> Decoder::decode_function(const SourceRange& range)
+{
+    auto name = read_fly_string();
+    m_next_scope_owns_frame = true;
+    auto body = decode_nonnull<ScopeNode>();
+    m_next_scope_owns_frame = false;
+    if (!body)
+        return nullptr;
+
+    // Parameters live in the frame of the function body.
+    m_frame_slot_counts.append(body->frame_slot_count());
+    Vector<FunctionNode::Parameter> parameters;
+    auto parameter_count = read_count();
+    parameters.ensure_capacity(parameter_count);
+    for (size_t i = 0; i < parameter_count && !m_failed; ++i) {
+        FunctionNode::Parameter parameter;
+        parameter.name = read_fly_string();
+        parameter.default_value = decode<Expression>();
+        parameter.is_rest = read_bool();
+        if (auto slot = read_unsigned()) {
+            check_frame_slot(slot - 1);
+            parameter.frame_slot = slot - 1;
+        }
+        parameters.append(move(parameter));
+    }
+    auto function_length = (i32)read_unsigned();
+    NonnullRefPtrVector<VariableDeclaration> variables;
+    decode_vector(variables);
+    auto is_strict_mode = read_bool();
+    m_frame_slot_counts.take_last();
+    if (m_failed)
+        return nullptr;
+
+    if constexpr (IsSame<FunctionNodeType, FunctionExpression>::value) {
+        auto is_arrow_function = read_bool();
+        return create_ast_node<FunctionExpression>(range, name, body.release_nonnull(), move(parameters), function_length, move(variables), is_strict_mode, is_arrow_function);
+    } else {
+        return create_ast_node<FunctionDeclaration>(range, name, body.release_nonnull(), move(parameters), function_length, move(variables), is_strict_mode);
+    }
+}
+
+RefPtr<ASTNode> Decoder::decode_fields(NodeType type, const SourceRange& range)
+{
+    switch (type) {
+    case NodeType::EmptyStatement:
+        return create_ast_node<EmptyStatement>(range);
+    case NodeType::ErrorStatement:
+        return create_ast_node<ErrorStatement>(range);
+    case NodeType::ErrorDeclaration:
+        return create_ast_node<ErrorDeclaration>(range);
+    case NodeType::DebuggerStatement:
+        return create_ast_node<DebuggerStatement>(range);
+    case NodeType::ErrorExpression:
+        return create_ast_node<ErrorExpression>(range);
+    case NodeType::NullLiteral:
+        return create_ast_node<NullLiteral>(range);
+    case NodeType::SuperExpression:
+        return create_ast_node<SuperExpression>(range);
+    case NodeType::ThisExpression:
+        return create_ast_node<ThisExpression>(range);
+    case NodeType::ExpressionStatement: {
+        auto expression = decode_nonnull<Expression>();
+        if (!expression)
+            return nullptr;
+        return create_ast_node<ExpressionStatement>(range, expression.release_nonnull());
+    }
+    case NodeType::Program: {
+        auto program = create_ast_node<Program>(range);
+        if (!decode_scope(*program, true))
+            return nullptr;
+        if (read_bool())
+            program->set_strict_mode();
+        return program;
+    }
+    case NodeType::BlockStatement: {
+        auto block = create_ast_node<BlockStatement>(range);
+        if (!decode_scope(*block, exchange(m_next_scope_owns_frame, false)))
+            return nullptr;
+        return block;
+    }
+    case NodeType::FunctionDeclaration:
+        return decode_function<FunctionDeclaration>(range);
+    case NodeType::FunctionExpression:
+        return decode_function<FunctionExpression>(range);
+    case NodeType::ReturnStatement:
+        return create_ast_node<ReturnStatement>(range, decode<Expression>());
+    case NodeType::IfStatement: {
+        auto predicate = decode_nonnull<Expression>();
+        auto consequent = decode_nonnull<Statement>();
+        auto alternate = decode<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<IfStatement>(range, predicate.release_nonnull(), consequent.release_nonnull(), move(alternate));
+    }
+    case NodeType::WhileStatement: {
+        auto test = decode_nonnull<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<WhileStatement>(range, test.release_nonnull(), body.release_nonnull());
+    }
+    case NodeType::DoWhileStatement: {
+        auto test = decode_nonnull<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<DoWhileStatement>(range, test.release_nonnull(), body.release_nonnull());
+    }
+    case NodeType::WithStatement: {
+        auto object = decode_nonnull<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<WithStatement>(range, object.release_nonnull(), body.release_nonnull());
+    }
+    case NodeType::ForStatement: {
+        auto init = decode<ASTNode>();
+        auto test = decode<Expression>();
+        auto update = decode<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ForStatement>(range, move(init), move(test), move(update), body.release_nonnull());
+    }
+    case NodeType::ForInStatement: {
+        auto lhs = decode_nonnull<ASTNode>();
+        auto rhs = decode_nonnull<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ForInStatement>(range, lhs.release_nonnull(), rhs.release_nonnull(), body.release_nonnull());
+    }
+    case NodeType::ForOfStatement: {
+        auto lhs = decode_nonnull<ASTNode>();
+        auto rhs = decode_nonnull<Expression>();
+        auto body = decode_nonnull<Statement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ForOfStatement>(range, lhs.release_nonnull(), rhs.release_nonnull(), body.release_nonnull());
+    }
+    case NodeType::ClassDeclaration: {
+        auto class_expression = decode_nonnull<ClassExpression>();
+        if (!class_expression)
+            return nullptr;
+        return create_ast_node<ClassDeclaration>(range, class_expression.release_nonnull());
+    }
+    case NodeType::VariableDeclaration: {
+        auto declaration_kind = read_enum(DeclarationKind::Const);
+        NonnullRefPtrVector<VariableDeclarator> declarations;
+        if (!decode_vector(declarations))
+            return nullptr;
+        return create_ast_node<VariableDeclaration>(range, declaration_kind, move(declarations));
+    }
+    case NodeType::TryStatement: {
+        auto block = decode_nonnull<BlockStatement>();
+        auto handler = decode<CatchClause>();
+        auto finalizer = decode<BlockStatement>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<TryStatement>(range, block.release_nonnull(), move(handler), move(finalizer));
+    }
+    case NodeType::ThrowStatement: {
+        auto argument = decode_nonnull<Expression>();
+        if (!argument)
+            return nullptr;
+        return create_ast_node<ThrowStatement>(range, argument.release_nonnull());
+    }
+    case NodeType::SwitchStatement: {
+        auto discriminant = decode_nonnull<Expression>();
+        NonnullRefPtrVector<SwitchCase> cases;
+        if (!discriminant || !decode_vector(cases))
+            return nullptr;
+        return create_ast_node<SwitchStatement>(range, discriminant.release_nonnull(), move(cases));
+    }
+    case NodeType::BreakStatement:
+        return create_ast_node<BreakStatement>(range, read_fly_string());
+    case NodeType::ContinueStatement:
+        return create_ast_node<ContinueStatement>(range, read_fly_string());
+    case NodeType::BinaryExpression: {
+        auto op = read_enum(BinaryOp::InstanceOf);
+        auto lhs = decode_nonnull<Expression>();
+        auto rhs = decode_nonnull<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<BinaryExpression>(range, op, lhs.release_nonnull(), rhs.release_nonnull());
+    }
+    case NodeType::LogicalExpression: {
+        auto op = read_enum(LogicalOp::NullishCoalescing);
+        auto lhs = decode_nonnull<Expression>();
+        auto rhs = decode_nonnull<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<LogicalExpression>(range, op, lhs.release_nonnull(), rhs.release_nonnull());
+    }
+    case NodeType::UnaryExpression: {
+        auto op = read_enum(UnaryOp::Delete);
+        auto lhs = decode_nonnull<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<UnaryExpression>(range, op, lhs.release_nonnull());
+    }
+    case NodeType::SequenceExpression: {
+        NonnullRefPtrVector<Expression> expressions;
+        if (!decode_vector(expressions))
+            return nullptr;
+        return create_ast_node<SequenceExpression>(range, move(expressions));
+    }
+    case NodeType::BooleanLiteral:
+        return create_ast_node<BooleanLiteral>(range, read_bool());
+    case NodeType::NumericLiteral:
+        return create_ast_node<NumericLiteral>(range, read_double());
+    case NodeType::BigIntLiteral:
+        return create_ast_node<BigIntLiteral>(range, read_string());
+    case NodeType::StringLiteral: {
+        auto& value = read_string();
+        auto is_use_strict_directive = read_bool();
+        return create_ast_node<StringLiteral>(range, value, is_use_strict_directive);
+    }
+    case NodeType::RegExpLiteral: {
+        auto& content = read_string();
+        auto& flags = read_string();
+        return create_ast_node<RegExpLiteral>(range, content, flags);
+    }
+    case NodeType::Identifier: {
+        auto identifier = create_ast_node<Identifier>(range, read_fly_string());
+        if (auto slot = read_unsigned()) {
+            auto is_const = read_bool();
+            if (!check_frame_slot(slot - 1))
+                return nullptr;
+            identifier->set_frame_slot(slot - 1, is_const);
+        }
+        return identifier;
+    }
+    case NodeType::ClassMethod: {
+        auto key = decode_nonnull<Expression>();
+        auto function = decode_nonnull<FunctionExpression>();
+        auto kind = read_enum(ClassMethod::Kind::Setter);
+        auto is_static = read_bool();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ClassMethod>(range, key.release_nonnull(), function.release_nonnull(), kind, is_static);
+    }
+    case NodeType::ClassExpression: {
+        auto& name = read_string();
+        auto constructor = decode<FunctionExpression>();
+        auto super_class = decode<Expression>();
+        NonnullRefPtrVector<ClassMethod> methods;
+        if (!decode_vector(methods))
+            return nullptr;
+        return create_ast_node<ClassExpression>(range, name, move(constructor), move(super_class), move(methods));
+    }
+    case NodeType::SpreadExpression: {
+        auto target = decode_nonnull<Expression>();
+        if (!target)
+            return nullptr;
+        return create_ast_node<SpreadExpression>(range, target.release_nonnull());
+    }
+    case NodeType::CallExpression:
+    case NodeType::NewExpression: {
+        auto callee = decode_nonnull<Expression>();
+        Vector<CallExpression::Argument> arguments;
+        auto argument_count = read_count();
+        arguments.ensure_capacity(argument_count);
+        for (size_t i = 0; i < argument_count && !m_failed; ++i) {
+            auto value = decode_nonnull<Expression>();
+            auto is_spread = read_bool();
+            if (value)
+                arguments.append({ value.release_nonnull(), is_spread });
+        }
+        if (m_failed)
+            return nullptr;
+        if (type == NodeType::NewExpression)
+            return create_ast_node<NewExpression>(range, callee.release_nonnull(), move(arguments));
+        return create_ast_node<CallExpression>(range, callee.release_nonnull(), move(arguments));
+    }
+    case NodeType::AssignmentExpression: {
+        auto op = read_enum(AssignmentOp::NullishAssignment);
+        auto lhs = decode_nonnull<Expression>();
+        auto rhs = decode_nonnull<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<AssignmentExpression>(range, op, lhs.release_nonnull(), rhs.release_nonnull());
+    }
+    case NodeType::UpdateExpression: {
+        auto op = read_enum(UpdateOp::Decrement);
+        auto argument = decode_nonnull<Expression>();
+        auto is_prefixed = read_bool();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<UpdateExpression>(range, op, argument.release_nonnull(), is_prefixed);
+    }
+    case NodeType::VariableDeclarator: {
+        auto id = decode_nonnull<Identifier>();
+        auto init = decode<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<VariableDeclarator>(range, id.release_nonnull(), move(init));
+    }
+    case NodeType::ObjectProperty: {
+        auto key = decode_nonnull<Expression>();
+        auto value = decode<Expression>();
+        auto property_type = read_enum(ObjectProperty::Type::Spread);
+        auto is_method = read_bool();
+        if (!value && property_type != ObjectProperty::Type::Spread)
+            fail();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ObjectProperty>(range, key.release_nonnull(), move(value), property_type, is_method);
+    }
+    case NodeType::ObjectExpression: {
+        NonnullRefPtrVector<ObjectProperty> properties;
+        if (!decode_vector(properties))
+            return nullptr;
+        return create_ast_node<ObjectExpression>(range, move(properties));
+    }
+    case NodeType::ArrayExpression: {
+        Vector<RefPtr<Expression>> elements;
+        auto element_count = read_count();
+        elements.ensure_capacity(element_count);
+        for (size_t i = 0; i < element_count && !m_failed; ++i)
+            elements.append(decode<Expression>());
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ArrayExpression>(range, move(elements));
+    }
+    case NodeType::TemplateLiteral: {
+        NonnullRefPtrVector<Expression> expressions;
+        NonnullRefPtrVector<Expression> raw_strings;
+        if (!decode_vector(expressions) || !decode_vector(raw_strings))
+            return nullptr;
+        return create_ast_node<TemplateLiteral>(range, move(expressions), move(raw_strings));
+    }
+    case NodeType::TaggedTemplateLiteral: {
+        auto tag = decode_nonnull<Expression>();
+        auto template_literal = decode_nonnull<TemplateLiteral>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<TaggedTemplateLiteral>(range, tag.release_nonnull(), template_literal.release_nonnull());
+    }
+    case NodeType::MemberExpression: {
+        auto object = decode_nonnull<Expression>();
+        auto property = decode_nonnull<Expression>();
+        auto is_computed = read_bool();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<MemberExpression>(range, object.release_nonnull(), property.release_nonnull(), is_computed);
+    }
+    case NodeType::MetaProperty:
+        return create_ast_node<MetaProperty>(range, read_enum(MetaProperty::Type::ImportMeta));
+    case NodeType::ConditionalExpression: {
+        auto test = decode_nonnull<Expression>();
+        auto consequent = decode_nonnull<Expression>();
+        auto alternate = decode_nonnull<Expression>();
+        if (m_failed)
+            return nullptr;
+        return create_ast_node<ConditionalExpression>(range, test.release_nonnull(), consequent.release_nonnull(), alternate.release_nonnull());
+    }
+    case NodeType::CatchClause: {
+        auto parameter = read_fly_string();
+        auto body = decode_nonnull<BlockStatement>();
+        if (!body)
+            return nullptr;
+        return create_ast_node<CatchClause>(range, parameter, body.release_nonnull());
+    }
+    case NodeType::SwitchCase: {
+        auto test = decode<Expression>();
+        NonnullRefPtrVector<Statement> consequent;
+        if (!decode_vector(consequent))
+            return nullptr;
+        return create_ast_node<SwitchCase>(range, move(test), move(consequent));
+    }
+    case NodeType::Null:
+    case NodeType::BackReference:
+        break;
+    }
+    ASSERT_NOT_REACHED();
+}
+
+ByteBuffer ProgramCache::serialize(const StringView& source, const Program& program)
+{
+    return Encoder().encode(hash_source(source), program);
+}
+
+RefPtr<Program> ProgramCache::deserialize(const StringView& source, ReadonlyBytes bytes)
+{
+    return Decoder(bytes).decode(hash_source(source));
+}
+
+ProgramCache::ProgramCache(String directory)
+    : m_directory(move(directory))
+{
+}
+
+static String path_for(const String& directory, const Digest& digest)
+{
+    return String::formatted("{}/{}.jsc", directory, encode_hex({ digest.immutable_data(), Digest::Size }));
+}
+
+RefPtr<Program> ProgramCache::load(const StringView& source) const
+{
+    auto digest = hash_source(source);
+    auto path = path_for(m_directory, digest);
+    // Misses are expected, so check before MappedFile gets to complain about the file not being there.
+    if (!Core::File::exists(path))
+        return nullptr;
+    MappedFile file(path);
+    if (!file.is_valid())
+        return nullptr;
+    return Decoder({ (const u8*)file.data(), file.size() }).decode(digest);
+}
+
+void ProgramCache::store(const StringView& source, const Program& program) const
+{
+    auto digest = hash_source(source);
+    auto entry = Encoder().encode(digest, program);
+    if (entry.is_null())
+        return;
+
+    if (mkdir(m_directory.characters(), 0755) < 0 && errno != EEXIST)
+        return;
+
+    // Entries are written under a temporary name and then renamed, so that a concurrent load never sees half of one.
+    auto path = path_for(m_directory, digest);
+    auto temporary_path = String::formatted("{}.{}", path, getpid());
+    auto file_or_error = Core::File::open(temporary_path, (Core::IODevice::OpenMode)(Core::IODevice::WriteOnly | Core::IODevice::Truncate));
+    if (file_or_error.is_error())
+        return;
+    auto file = file_or_error.value();
+    bool written = file->write(entry.data(), entry.size());
+    file->close();
+    if (!written || rename(temporary_path.characters(), path.characters()) < 0)
+        unlink(temporary_path.characters());
+}
+
+}
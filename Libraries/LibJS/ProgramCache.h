@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/ByteBuffer.h>
+#include <AK/RefPtr.h>
+#include <AK/String.h>
+#include <LibJS/Forward.h>
+
+namespace JS {
+
+// A directory of parsed programs, so that scripts that are loaded over and over again don't have
+// to be lexed and parsed every time. Entries are named after a SHA-256 hash of the source they were
+// parsed from, and hold a versioned binary encoding of the AST that includes everything the parser
+// worked out on top of the syntax: declared variables and functions, frame slots and strictness.
+//
+// Entries are decoded straight out of a mapping of the file. Anything that doesn't check out (an
+// older format version, a different source, a truncated or otherwise damaged file) is a miss.
+class ProgramCache {
+public:
+    // The directory is created when the first entry is stored, but its parent has to exist.
+    explicit ProgramCache(String directory);
+
+    RefPtr<Program> load(const StringView& source) const;
+
+    // Only store programs that parsed without errors, since there's no way to report them on a hit.
+    // This includes the errors in function bodies that the parser skipped, which are parsed now.
+    // Failing to write the entry isn't an error, the program just won't come from the cache next time.
+    void store(const StringView& source, const Program&) const;
+
+    // Returns a null buffer for programs that store() wouldn't store.
+    static ByteBuffer serialize(const StringView& source, const Program&);
+    static RefPtr<Program> deserialize(const StringView& source, ReadonlyBytes);
+
+private:
+    String m_directory;
+};
+
+}
@@ -28,6 +28,7 @@
 
 #include <AK/Function.h>
 #include <AK/HashTable.h>
+#include <AK/QuickSort.h>
 #include <AK/ScopeGuard.h>
 #include <AK/StringBuilder.h>
 #include <LibJS/Runtime/Array.h>
@@ -37,6 +38,7 @@
 #include <LibJS/Runtime/Function.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/ObjectPrototype.h>
+#include <LibJS/Runtime/ProxyObject.h>
 #include <LibJS/Runtime/Value.h>
 
 namespace JS {
@@ -115,6 +117,26 @@ static size_t get_length(VM& vm, Object& object)
     return length_property.to_size_t(object.global_object());
 }
 
+// Arrays with a packed element kind have a plain value at every index below their length,
+// so their elements can be read straight out of their storage.
+static Array* packed_array(Object& object)
+{
+    if (!is<Array>(object) || !is_packed(object.indexed_properties().element_kind()))
+        return nullptr;
+    return static_cast<Array*>(&object);
+}
+
+// Storing to an index of an object can only end up calling a setter if something in its
+// prototype chain has indexed properties.
+static bool has_indexed_properties_in_prototype_chain(Object& object)
+{
+    for (auto* prototype = object.prototype(); prototype; prototype = prototype->prototype()) {
+        if (is<ProxyObject>(*prototype) || !prototype->indexed_properties().is_empty())
+            return true;
+    }
+    return false;
+}
+
 static void for_each_item(VM& vm, GlobalObject& global_object, const String& name, AK::Function<IterationDecision(size_t index, Value value, Value callback_result)> callback, bool skip_empty = true)
 {
     auto* this_object = vm.this_value(global_object).to_object(global_object);
@@ -132,7 +154,12 @@ static void for_each_item(VM& vm, GlobalObject& global_object, const String& nam
     auto this_value = vm.argument(1);
 
     for (size_t i = 0; i < initial_length; ++i) {
-        auto value = this_object->get(i);
+        Value value;
+        // The callback may have changed the array, so this has to be checked every time.
+        if (auto* array = packed_array(*this_object); array && i < array->indexed_properties().array_like_size())
+            value = array->indexed_properties().packed_elements()[i];
+        else
+            value = this_object->get(i);
         if (vm.exception())
             return;
         if (value.is_empty()) {
@@ -178,13 +205,15 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::map)
     if (vm.exception())
         return {};
     auto* new_array = Array::create(global_object);
-    new_array->indexed_properties().set_array_like_size(initial_length);
     for_each_item(vm, global_object, "map", [&](auto index, auto, auto callback_result) {
         if (vm.exception())
             return IterationDecision::Break;
         new_array->define_property(index, callback_result);
         return IterationDecision::Continue;
     });
+    // Only give the new array its full length at the end, so that it stays packed if there were no holes.
+    if (new_array->indexed_properties().array_like_size() < initial_length)
+        new_array->indexed_properties().set_array_like_size(initial_length);
     return Value(new_array);
 }
 
@@ -461,6 +490,26 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::index_of)
             from_index = max(length + from_index, 0);
     }
     auto search_element = vm.argument(0);
+    if (auto* array = packed_array(*this_object)) {
+        auto& elements = array->indexed_properties().packed_elements();
+        auto end = min((size_t)length, elements.size());
+        if (array->indexed_properties().element_kind() == ElementKind::PackedAny) {
+            for (size_t i = from_index; i < end; ++i) {
+                if (strict_eq(elements[i], search_element))
+                    return Value((i32)i);
+            }
+            return Value(-1);
+        }
+        // Arrays of numbers can't contain anything else, and NaN is never equal to itself.
+        if (!search_element.is_number())
+            return Value(-1);
+        auto number = search_element.as_double();
+        for (size_t i = from_index; i < end; ++i) {
+            if (elements[i].as_double() == number)
+                return Value((i32)i);
+        }
+        return Value(-1);
+    }
     for (i32 i = from_index; i < length; ++i) {
         auto element = this_object->get(i);
         if (vm.exception())
@@ -708,6 +757,44 @@ static void array_merge_sort(VM& vm, GlobalObject& global_object, Function* comp
     }
 }
 
+// Sorts a packed array of numbers and strings the way sort() does without a compare function.
+// Converting each element to a string once up front is a lot cheaper than converting both sides
+// of every comparison. Returns false if the array contains anything else.
+static bool sort_packed_array_by_string_keys(Array& array)
+{
+    struct Entry {
+        String key;
+        Value value;
+        size_t index;
+    };
+
+    auto& elements = array.indexed_properties().packed_elements();
+    Vector<Entry> entries;
+    entries.ensure_capacity(elements.size());
+    for (size_t i = 0; i < elements.size(); ++i) {
+        auto value = elements[i];
+        if (value.is_string())
+            entries.unchecked_append({ value.as_string().string(), value, i });
+        else if (value.is_number())
+            entries.unchecked_append({ value.to_string_without_side_effects(), value, i });
+        else
+            return false;
+    }
+
+    // Comparing the original indices of equal keys keeps the sort stable.
+    quick_sort(entries, [](auto& a, auto& b) {
+        if (a.key.view() < b.key.view())
+            return true;
+        if (b.key.view() < a.key.view())
+            return false;
+        return a.index < b.index;
+    });
+
+    for (size_t i = 0; i < entries.size(); ++i)
+        array.indexed_properties().put(&array, i, entries[i].value);
+    return true;
+}
+
 JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
 {
     auto* array = vm.this_value(global_object).to_object(global_object);
@@ -724,6 +811,13 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::sort)
     if (vm.exception())
         return {};
 
+    if (callback.is_undefined()) {
+        if (auto* packed = packed_array(*array); packed && !has_indexed_properties_in_prototype_chain(*packed)) {
+            if (sort_packed_array_by_string_keys(*packed))
+                return array;
+        }
+    }
+
     MarkedValueList values_to_sort(vm.heap());
 
     for (size_t i = 0; i < original_length; ++i) {
@@ -1022,6 +1116,12 @@ JS_DEFINE_NATIVE_FUNCTION(ArrayPrototype::fill)
     else
         to = min(relative_end, length);
 
+    if (is<Array>(*this_object) && this_object->indexed_properties().has_simple_storage() && this_object->is_extensible()
+        && to <= this_object->indexed_properties().array_like_size() && !has_indexed_properties_in_prototype_chain(*this_object)) {
+        this_object->indexed_properties().fill(from, to, vm.argument(0));
+        return this_object;
+    }
+
     for (size_t i = from; i < to; i++) {
         this_object->put(i, vm.argument(0));
         if (vm.exception())
@@ -55,4 +55,9 @@ VM& Cell::vm() const
     return heap().vm();
 }
 
+void Cell::did_write_while_marked()
+{
+    heap().did_write_to_marked_cell({}, *this);
+}
+
 }
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Atomic.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
 #include <AK/Noncopyable.h>
@@ -45,10 +46,24 @@ public:
 
     bool is_marked() const { return m_mark; }
     void set_marked(bool b) { m_mark = b; }
+    // Returns false if the cell was marked already. Marking threads may race for the same cell, only one of them gets it.
+    bool try_mark() { return !m_mark.exchange(true); }
 
     bool is_live() const { return m_live; }
     void set_live(bool b) { m_live = b; }
 
+    // Cells start out young and become old once they survive a collection.
+    bool is_old() const { return m_old; }
+    void set_old(bool b) { m_old = b; }
+
+    bool has_write_barriers() const { return m_has_write_barriers; }
+    void set_has_write_barriers(bool b) { m_has_write_barriers = b; }
+
+    // Cells that have write barriers (see Heap::has_write_barriers) must call this right after
+    // storing a new edge to another cell anywhere but in their constructor, so that the next
+    // young collection rescans them.
+    void write_barrier();
+
     virtual const char* class_name() const = 0;
 
     class Visitor {
@@ -69,8 +84,12 @@ protected:
     Cell() { }
 
 private:
-    bool m_mark { false };
+    void did_write_while_marked();
+
+    Atomic<bool, AK::memory_order_relaxed> m_mark { false };
     bool m_live { true };
+    bool m_old { false };
+    bool m_has_write_barriers { false };
 };
 
 }
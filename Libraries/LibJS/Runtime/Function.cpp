@@ -86,11 +86,21 @@ BoundFunction* Function::bind(Value bound_this_value, Vector<Value> arguments)
     return heap().allocate<BoundFunction>(global_object(), global_object(), target_function, bound_this_object, move(all_bound_arguments), computed_length, constructor_prototype);
 }
 
+Shape& Function::shape_for_instances(GlobalObject& global_object, Object& prototype)
+{
+    if (!m_shape_for_instances || m_shape_for_instances->prototype() != &prototype) {
+        m_shape_for_instances = global_object.new_object_shape()->create_prototype_transition(&prototype);
+        write_barrier();
+    }
+    return *m_shape_for_instances;
+}
+
 void Function::visit_edges(Visitor& visitor)
 {
     Object::visit_edges(visitor);
 
     visitor.visit(m_bound_this);
+    visitor.visit(m_shape_for_instances);
 
     for (auto argument : m_bound_arguments)
         visitor.visit(argument);
@@ -57,13 +57,21 @@ public:
     const Vector<Value>& bound_arguments() const { return m_bound_arguments; }
 
     Value home_object() const { return m_home_object; }
-    void set_home_object(Value home_object) { m_home_object = home_object; }
+    void set_home_object(Value home_object)
+    {
+        m_home_object = home_object;
+        write_barrier();
+    }
 
     ConstructorKind constructor_kind() const { return m_constructor_kind; };
     void set_constructor_kind(ConstructorKind constructor_kind) { m_constructor_kind = constructor_kind; }
 
     virtual bool is_strict_mode() const { return false; }
 
+    // The shape of a freshly constructed object with the given prototype. Sharing it
+    // between all objects this function constructs lets them share transitions too.
+    Shape& shape_for_instances(GlobalObject&, Object& prototype);
+
 protected:
     explicit Function(Object& prototype);
     Function(Object& prototype, Value bound_this, Vector<Value> bound_arguments);
@@ -74,6 +82,7 @@ private:
     Vector<Value> m_bound_arguments;
     Value m_home_object;
     ConstructorKind m_constructor_kind = ConstructorKind::Base;
+    Shape* m_shape_for_instances { nullptr };
 };
 
 }
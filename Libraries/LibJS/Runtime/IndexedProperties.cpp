@@ -25,6 +25,7 @@
  */
 
 #include <AK/QuickSort.h>
+#include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Runtime/Accessor.h>
 #include <LibJS/Runtime/IndexedProperties.h>
 
@@ -34,74 +35,133 @@ SimpleIndexedPropertyStorage::SimpleIndexedPropertyStorage(Vector<Value>&& initi
     : m_array_size(initial_values.size())
     , m_packed_elements(move(initial_values))
 {
+    for (auto& value : m_packed_elements)
+        update_element_kind(value);
+}
+
+void SimpleIndexedPropertyStorage::update_element_kind(Value value)
+{
+    switch (m_element_kind) {
+    case ElementKind::PackedInt32:
+        if (!value.is_int32())
+            m_element_kind = value.is_number() ? ElementKind::PackedDouble : ElementKind::PackedAny;
+        break;
+    case ElementKind::PackedDouble:
+        if (!value.is_number())
+            m_element_kind = ElementKind::PackedAny;
+        break;
+    default:
+        break;
+    }
+    if (value.is_empty())
+        m_element_kind = ElementKind::Holey;
 }
 
 bool SimpleIndexedPropertyStorage::has_index(u32 index) const
 {
-    return index < m_array_size && !m_packed_elements[index].is_empty();
+    return index < m_packed_elements.size() && !m_packed_elements[index].is_empty();
 }
 
 Optional<ValueAndAttributes> SimpleIndexedPropertyStorage::get(u32 index) const
 {
     if (index >= m_array_size)
         return {};
+    if (index >= m_packed_elements.size())
+        return ValueAndAttributes {};
     return ValueAndAttributes { m_packed_elements[index], default_attributes };
 }
 
 void SimpleIndexedPropertyStorage::put(u32 index, Value value, PropertyAttributes attributes)
 {
     ASSERT(attributes == default_attributes);
-    ASSERT(index < SPARSE_ARRAY_THRESHOLD);
+    ASSERT(index < m_packed_elements.size() + SPARSE_ARRAY_THRESHOLD);
 
-    if (index >= m_array_size) {
+    if (index >= m_array_size)
         m_array_size = index + 1;
-        if (index >= m_packed_elements.size())
-            m_packed_elements.resize(index + MIN_PACKED_RESIZE_AMOUNT >= SPARSE_ARRAY_THRESHOLD ? SPARSE_ARRAY_THRESHOLD : index + MIN_PACKED_RESIZE_AMOUNT);
+    if (index >= m_packed_elements.size()) {
+        if (index > m_packed_elements.size())
+            m_element_kind = ElementKind::Holey;
+        // resize() on its own would reallocate on every append.
+        m_packed_elements.grow_capacity(index + 1);
+        m_packed_elements.resize(index + 1);
     }
     m_packed_elements[index] = value;
+    update_element_kind(value);
 }
 
 void SimpleIndexedPropertyStorage::remove(u32 index)
 {
-    if (index < m_array_size)
+    if (index < m_packed_elements.size()) {
         m_packed_elements[index] = {};
+        m_element_kind = ElementKind::Holey;
+    }
 }
 
 void SimpleIndexedPropertyStorage::insert(u32 index, Value value, PropertyAttributes attributes)
 {
     ASSERT(attributes == default_attributes);
-    ASSERT(index < SPARSE_ARRAY_THRESHOLD);
+    ASSERT(index < m_packed_elements.size() + SPARSE_ARRAY_THRESHOLD);
     m_array_size++;
-    ASSERT(m_array_size <= SPARSE_ARRAY_THRESHOLD);
+    if (index > m_packed_elements.size()) {
+        m_element_kind = ElementKind::Holey;
+        m_packed_elements.resize(index);
+    }
     m_packed_elements.insert(index, value);
+    update_element_kind(value);
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_first()
 {
     m_array_size--;
+    if (m_packed_elements.is_empty())
+        return {};
     return { m_packed_elements.take_first(), default_attributes };
 }
 
 ValueAndAttributes SimpleIndexedPropertyStorage::take_last()
 {
     m_array_size--;
-    auto last_element = m_packed_elements[m_array_size];
-    m_packed_elements[m_array_size] = {};
-    return { last_element, default_attributes };
+    if (m_array_size >= m_packed_elements.size())
+        return {};
+    return { m_packed_elements.take_last(), default_attributes };
 }
 
 void SimpleIndexedPropertyStorage::set_array_like_size(size_t new_size)
 {
-    ASSERT(new_size <= SPARSE_ARRAY_THRESHOLD);
+    if (new_size > m_packed_elements.size())
+        m_element_kind = ElementKind::Holey;
+    else
+        m_packed_elements.shrink(new_size);
     m_array_size = new_size;
-    m_packed_elements.resize(new_size);
+}
+
+void SimpleIndexedPropertyStorage::fill(u32 from, u32 to, Value value)
+{
+    ASSERT(from <= to && to <= m_array_size);
+    ASSERT(from < m_packed_elements.size() + SPARSE_ARRAY_THRESHOLD);
+    if (to > m_packed_elements.size())
+        m_packed_elements.resize(to);
+    for (size_t i = from; i < to; ++i)
+        m_packed_elements[i] = value;
+
+    // Filling all of a holey array is the usual way of initializing `new Array(length)`.
+    if (m_element_kind == ElementKind::Holey && from == 0 && to == m_array_size && !value.is_empty())
+        m_element_kind = ElementKind::PackedInt32;
+    update_element_kind(value);
 }
 
 GenericIndexedPropertyStorage::GenericIndexedPropertyStorage(SimpleIndexedPropertyStorage&& storage)
 {
     m_array_size = storage.array_like_size();
-    for (auto& element : move(storage.m_packed_elements))
-        m_packed_elements.append({ element, default_attributes });
+    auto& elements = storage.m_packed_elements;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (i < SPARSE_ARRAY_THRESHOLD)
+            m_packed_elements.append({ elements[i], default_attributes });
+        else if (!elements[i].is_empty())
+            m_sparse_elements.set(i, { elements[i], default_attributes });
+    }
+    m_packed_elements.resize(min(m_array_size, (size_t)SPARSE_ARRAY_THRESHOLD));
+    elements.clear();
 }
 
 bool GenericIndexedPropertyStorage::has_index(u32 index) const
@@ -195,7 +255,9 @@ ValueAndAttributes GenericIndexedPropertyStorage::take_last()
     ASSERT(m_array_size > 0);
     m_array_size--;
 
-    if (m_array_size <= SPARSE_ARRAY_THRESHOLD) {
+    if (m_array_size < SPARSE_ARRAY_THRESHOLD) {
+        if (m_array_size >= m_packed_elements.size())
+            return {};
         auto last_element = m_packed_elements[m_array_size];
         m_packed_elements[m_array_size] = {};
         return last_element;
@@ -263,14 +325,7 @@ ValueAndAttributes IndexedPropertyIterator::value_and_attributes(Object* this_ob
 
 void IndexedPropertyIterator::skip_empty_indices()
 {
-    auto indices = m_indexed_properties.indices();
-    for (auto i : indices) {
-        if (i < m_index)
-            continue;
-        m_index = i;
-        return;
-    }
-    m_index = m_indexed_properties.array_like_size();
+    m_index = m_indexed_properties.next_index_at_or_after(m_index);
 }
 
 Optional<ValueAndAttributes> IndexedProperties::get(Object* this_object, u32 index, bool evaluate_accessors) const
@@ -289,12 +344,22 @@ Optional<ValueAndAttributes> IndexedProperties::get(Object* this_object, u32 ind
     return result;
 }
 
+// Simple storage keeps every element up to the highest index in one Vector, so it only
+// takes stores that don't leave a large gap after the existing elements.
+static bool fits_in_simple_storage(const IndexedPropertyStorage& storage, u32 index, PropertyAttributes attributes)
+{
+    if (!storage.is_simple_storage() || attributes != default_attributes)
+        return false;
+    return index < storage.size() + SPARSE_ARRAY_THRESHOLD;
+}
+
 void IndexedProperties::put(Object* this_object, u32 index, Value value, PropertyAttributes attributes, bool evaluate_accessors)
 {
-    if (m_storage->is_simple_storage() && (index >= SPARSE_ARRAY_THRESHOLD || attributes != default_attributes))
+    if (m_storage->is_simple_storage() && !fits_in_simple_storage(*m_storage, index, attributes))
         switch_to_generic_storage();
     if (m_storage->is_simple_storage() || !evaluate_accessors) {
         m_storage->put(index, value, attributes);
+        write_barrier();
         return;
     }
 
@@ -304,6 +369,7 @@ void IndexedProperties::put(Object* this_object, u32 index, Value value, Propert
         value_here.value().value.as_accessor().call_setter(this_object, value);
     } else {
         m_storage->put(index, value, attributes);
+        write_barrier();
     }
 }
 
@@ -320,9 +386,10 @@ bool IndexedProperties::remove(u32 index)
 
 void IndexedProperties::insert(u32 index, Value value, PropertyAttributes attributes)
 {
-    if (m_storage->is_simple_storage() && (index >= SPARSE_ARRAY_THRESHOLD || attributes != default_attributes || array_like_size() == SPARSE_ARRAY_THRESHOLD))
+    if (m_storage->is_simple_storage() && !fits_in_simple_storage(*m_storage, index, attributes))
         switch_to_generic_storage();
     m_storage->insert(index, move(value), attributes);
+    write_barrier();
 }
 
 ValueAndAttributes IndexedProperties::take_first(Object* this_object)
@@ -350,24 +417,59 @@ void IndexedProperties::append_all(Object* this_object, const IndexedProperties&
         const auto& element = it.value_and_attributes(this_object, evaluate_accessors);
         if (this_object && this_object->vm().exception())
             return;
-        m_storage->put(m_storage->array_like_size(), element.value, element.attributes);
+        auto index = m_storage->array_like_size();
+        if (m_storage->is_simple_storage() && !fits_in_simple_storage(*m_storage, index, element.attributes))
+            switch_to_generic_storage();
+        m_storage->put(index, element.value, element.attributes);
+        write_barrier();
     }
 }
 
 void IndexedProperties::set_array_like_size(size_t new_size)
 {
-    if (m_storage->is_simple_storage() && new_size > SPARSE_ARRAY_THRESHOLD)
-        switch_to_generic_storage();
     m_storage->set_array_like_size(new_size);
 }
 
+void IndexedProperties::fill(u32 from, u32 to, Value value)
+{
+    ASSERT(m_storage->is_simple_storage());
+    if (from >= to)
+        return;
+    if (from < m_storage->size() + SPARSE_ARRAY_THRESHOLD) {
+        static_cast<SimpleIndexedPropertyStorage&>(*m_storage).fill(from, to, value);
+    } else {
+        switch_to_generic_storage();
+        for (u32 i = from; i < to; ++i)
+            m_storage->put(i, value);
+    }
+    write_barrier();
+}
+
+u32 IndexedProperties::next_index_at_or_after(u32 index) const
+{
+    if (m_storage->is_simple_storage()) {
+        // There's nothing past the end of the elements Vector, however large array_like_size() is.
+        auto& elements = static_cast<const SimpleIndexedPropertyStorage&>(*m_storage).elements();
+        for (; index < elements.size(); ++index) {
+            if (!elements[index].is_empty())
+                return index;
+        }
+        return array_like_size();
+    }
+    for (auto i : indices()) {
+        if (i >= index)
+            return i;
+    }
+    return array_like_size();
+}
+
 Vector<u32> IndexedProperties::indices() const
 {
     Vector<u32> indices;
     if (m_storage->is_simple_storage()) {
         const auto& storage = static_cast<const SimpleIndexedPropertyStorage&>(*m_storage);
         const auto& elements = storage.elements();
-        indices.ensure_capacity(storage.array_like_size());
+        indices.ensure_capacity(storage.size());
         for (size_t i = 0; i < elements.size(); ++i) {
             if (!elements.at(i).is_empty())
                 indices.unchecked_append(i);
@@ -375,7 +477,7 @@ Vector<u32> IndexedProperties::indices() const
     } else {
         const auto& storage = static_cast<const GenericIndexedPropertyStorage&>(*m_storage);
         const auto packed_elements = storage.packed_elements();
-        indices.ensure_capacity(storage.array_like_size());
+        indices.ensure_capacity(storage.size());
         for (size_t i = 0; i < packed_elements.size(); ++i) {
             if (!packed_elements.at(i).value.is_empty())
                 indices.unchecked_append(i);
@@ -387,6 +489,14 @@ Vector<u32> IndexedProperties::indices() const
     return indices;
 }
 
+void IndexedProperties::write_barrier()
+{
+    // We only ever live inside an Object, so this finds the cell we belong to.
+    auto* block = HeapBlock::from_cell(reinterpret_cast<const Cell*>(this));
+    if (auto* cell = block->cell_from_possible_pointer(reinterpret_cast<FlatPtr>(this)))
+        cell->write_barrier();
+}
+
 void IndexedProperties::switch_to_generic_storage()
 {
     auto& storage = static_cast<SimpleIndexedPropertyStorage&>(*m_storage);
@@ -44,6 +44,18 @@ class IndexedProperties;
 class IndexedPropertyIterator;
 class GenericIndexedPropertyStorage;
 
+// What the elements of a SimpleIndexedPropertyStorage are known to be. The packed kinds have no holes
+// below array_like_size(), and hold only int32s, only numbers, or anything, respectively. Stores only
+// ever move an array towards Holey, which is also what GenericIndexedPropertyStorage always reports.
+enum class ElementKind : u8 {
+    PackedInt32,
+    PackedDouble,
+    PackedAny,
+    Holey,
+};
+
+inline bool is_packed(ElementKind kind) { return kind != ElementKind::Holey; }
+
 class IndexedPropertyStorage {
 public:
     virtual ~IndexedPropertyStorage() {};
@@ -62,6 +74,7 @@ public:
     virtual void set_array_like_size(size_t new_size) = 0;
 
     virtual bool is_simple_storage() const { return false; }
+    virtual ElementKind element_kind() const { return ElementKind::Holey; }
 };
 
 class SimpleIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -83,13 +96,21 @@ public:
     virtual void set_array_like_size(size_t new_size) override;
 
     virtual bool is_simple_storage() const override { return true; }
+    virtual ElementKind element_kind() const override { return m_element_kind; }
+
+    // Indices from elements().size() up to array_like_size() are holes.
     const Vector<Value>& elements() const { return m_packed_elements; }
 
+    void fill(u32 from, u32 to, Value);
+
 private:
     friend GenericIndexedPropertyStorage;
 
+    void update_element_kind(Value);
+
     size_t m_array_size { 0 };
     Vector<Value> m_packed_elements;
+    ElementKind m_element_kind { ElementKind::PackedInt32 };
 };
 
 class GenericIndexedPropertyStorage final : public IndexedPropertyStorage {
@@ -167,6 +188,21 @@ public:
 
     Vector<u32> indices() const;
 
+    ElementKind element_kind() const { return m_storage->element_kind(); }
+
+    // Only meant for packed element kinds, where every index below array_like_size() has a plain value.
+    const Vector<Value>& packed_elements() const
+    {
+        ASSERT(is_packed(element_kind()));
+        return static_cast<const SimpleIndexedPropertyStorage&>(*m_storage).elements();
+    }
+
+    // Elements in simple storage are plain values with the default attributes.
+    bool has_simple_storage() const { return m_storage->is_simple_storage(); }
+
+    // Stores value at every index in [from, to). Only meant for simple storage.
+    void fill(u32 from, u32 to, Value value);
+
     template<typename Callback>
     void for_each_value(Callback callback)
     {
@@ -182,6 +218,10 @@ public:
     }
 
 private:
+    friend IndexedPropertyIterator;
+
+    u32 next_index_at_or_after(u32 index) const;
+    void write_barrier();
     void switch_to_generic_storage();
 
     NonnullOwnPtr<IndexedPropertyStorage> m_storage { make<SimpleIndexedPropertyStorage>() };
@@ -139,6 +139,7 @@ bool Object::set_prototype(Object* new_prototype)
         return true;
     }
     m_shape = m_shape->create_prototype_transition(new_prototype);
+    write_barrier();
     return true;
 }
 
@@ -346,6 +347,7 @@ void Object::set_shape(Shape& new_shape)
 {
     m_storage.resize(new_shape.property_count());
     m_shape = &new_shape;
+    write_barrier();
 }
 
 bool Object::define_property(const StringOrSymbol& property_name, const Object& descriptor, bool throw_exceptions)
@@ -492,6 +494,7 @@ bool Object::put_own_property(Object& this_object, const StringOrSymbol& propert
         m_shape->add_property_without_transition(property_name, attributes);
         m_storage.resize(m_shape->property_count());
         m_storage[m_shape->property_count() - 1] = value;
+        write_barrier();
         return true;
     }
 
@@ -564,6 +567,7 @@ bool Object::put_own_property(Object& this_object, const StringOrSymbol& propert
         call_native_property_setter(value_here.as_native_property(), &this_object, value);
     } else {
         m_storage[metadata.value().offset] = value;
+        write_barrier();
     }
     return true;
 }
@@ -656,6 +660,7 @@ void Object::ensure_shape_is_unique()
         return;
 
     m_shape = m_shape->create_unique_clone();
+    write_barrier();
 }
 
 Value Object::get_by_index(u32 property_index) const
@@ -778,6 +783,8 @@ bool Object::put(const PropertyName& property_name, Value value, Value receiver)
                 call_native_property_setter(value_here.as_native_property(), receiver, value);
                 return true;
             }
+            // A data property shadows any setters further up the prototype chain.
+            break;
         }
         object = object->prototype();
         if (vm().exception())
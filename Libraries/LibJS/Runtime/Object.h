@@ -29,6 +29,7 @@
 #include <AK/HashMap.h>
 #include <AK/String.h>
 #include <LibJS/Forward.h>
+#include <LibJS/Heap/HeapBlock.h>
 #include <LibJS/Runtime/Cell.h>
 #include <LibJS/Runtime/IndexedProperties.h>
 #include <LibJS/Runtime/MarkedValueList.h>
@@ -131,7 +132,11 @@ public:
 
     const IndexedProperties& indexed_properties() const { return m_indexed_properties; }
     IndexedProperties& indexed_properties() { return m_indexed_properties; }
-    void set_indexed_property_elements(Vector<Value>&& values) { m_indexed_properties = IndexedProperties(move(values)); }
+    void set_indexed_property_elements(Vector<Value>&& values)
+    {
+        m_indexed_properties = IndexedProperties(move(values));
+        write_barrier();
+    }
 
     Value invoke(const StringOrSymbol& property_name, Optional<MarkedValueList> arguments = {});
 
@@ -150,6 +155,8 @@ protected:
     virtual bool put_by_index(u32 property_index, Value);
 
 private:
+    friend class PropertyCache;
+
     bool put_own_property(Object& this_object, const StringOrSymbol& property_name, Value, PropertyAttributes attributes, PutOwnPropertyMode = PutOwnPropertyMode::Put, bool throw_exceptions = true);
     bool put_own_property_by_index(Object& this_object, u32 property_index, Value, PropertyAttributes attributes, PutOwnPropertyMode = PutOwnPropertyMode::Put, bool throw_exceptions = true);
 
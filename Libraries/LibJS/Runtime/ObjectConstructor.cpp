@@ -91,7 +91,7 @@ JS_DEFINE_NATIVE_FUNCTION(ObjectConstructor::get_own_property_names)
     for (auto& it : object->shape().property_table_ordered()) {
         if (!it.key.is_string())
             continue;
-        result->indexed_properties().append(js_string(vm, it.key.as_string()));
+        result->indexed_properties().append(js_interned_string(vm, it.key.as_string()));
     }
 
     return result;
@@ -24,6 +24,7 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/StringBuilder.h>
 #include <LibJS/Runtime/PrimitiveString.h>
 #include <LibJS/Runtime/VM.h>
 
@@ -31,6 +32,14 @@ namespace JS {
 
 PrimitiveString::PrimitiveString(String string)
     : m_string(move(string))
+    , m_length(m_string.length())
+{
+}
+
+PrimitiveString::PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs)
+    : m_lhs(&lhs)
+    , m_rhs(&rhs)
+    , m_length(lhs.length() + rhs.length())
 {
 }
 
@@ -38,13 +47,38 @@ PrimitiveString::~PrimitiveString()
 {
 }
 
+void PrimitiveString::visit_edges(Cell::Visitor& visitor)
+{
+    visitor.visit(m_lhs);
+    visitor.visit(m_rhs);
+}
+
+void PrimitiveString::flatten() const
+{
+    // Ropes built in a loop are as deep as the loop is long, so walk them without recursing.
+    StringBuilder builder(m_length);
+    Vector<const PrimitiveString*> pending;
+    pending.append(this);
+    while (!pending.is_empty()) {
+        auto* string = pending.take_last();
+        if (string->is_rope()) {
+            pending.append(string->m_rhs);
+            pending.append(string->m_lhs);
+        } else {
+            builder.append(string->m_string);
+        }
+    }
+    m_string = builder.to_string();
+    m_lhs = nullptr;
+    m_rhs = nullptr;
+}
+
 PrimitiveString* js_string(Heap& heap, String string)
 {
-    if (string.is_empty())
-        return &heap.vm().empty_string();
+    static constexpr size_t max_interned_string_length = 16;
 
-    if (string.length() == 1 && (u8)string.characters()[0] < 0x80)
-        return &heap.vm().single_ascii_character_string(string.characters()[0]);
+    if (string.length() <= max_interned_string_length)
+        return &heap.vm().intern_string(move(string));
 
     return heap.allocate_without_global_object<PrimitiveString>(move(string));
 }
@@ -54,4 +88,27 @@ PrimitiveString* js_string(VM& vm, String string)
     return js_string(vm.heap(), move(string));
 }
 
+PrimitiveString* js_interned_string(VM& vm, String string)
+{
+    return &vm.intern_string(move(string));
+}
+
+PrimitiveString* js_string_concatenation(Heap& heap, PrimitiveString& lhs, PrimitiveString& rhs)
+{
+    // Short strings are cheaper to copy than to keep around as a pair of cells.
+    static constexpr size_t min_rope_length = 32;
+
+    if (!lhs.length())
+        return &rhs;
+    if (!rhs.length())
+        return &lhs;
+    if (lhs.length() + rhs.length() >= min_rope_length)
+        return heap.allocate_without_global_object<PrimitiveString>(lhs, rhs);
+
+    StringBuilder builder(lhs.length() + rhs.length());
+    builder.append(lhs.string());
+    builder.append(rhs.string());
+    return js_string(heap, builder.to_string());
+}
+
 }
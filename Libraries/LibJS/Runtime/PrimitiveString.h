@@ -34,17 +34,35 @@ namespace JS {
 class PrimitiveString final : public Cell {
 public:
     explicit PrimitiveString(String);
+    PrimitiveString(PrimitiveString& lhs, PrimitiveString& rhs);
     virtual ~PrimitiveString();
 
-    const String& string() const { return m_string; }
+    // Concatenations are kept as ropes, which get flattened the first time their contents are needed.
+    bool is_rope() const { return m_lhs; }
+    size_t length() const { return m_length; }
+
+    const String& string() const
+    {
+        if (is_rope())
+            flatten();
+        return m_string;
+    }
 
 private:
     virtual const char* class_name() const override { return "PrimitiveString"; }
+    virtual void visit_edges(Cell::Visitor&) override;
+
+    void flatten() const;
 
-    String m_string;
+    mutable String m_string;
+    mutable PrimitiveString* m_lhs { nullptr };
+    mutable PrimitiveString* m_rhs { nullptr };
+    size_t m_length { 0 };
 };
 
 PrimitiveString* js_string(Heap&, String);
 PrimitiveString* js_string(VM&, String);
+PrimitiveString* js_interned_string(VM&, String);
+PrimitiveString* js_string_concatenation(Heap&, PrimitiveString& lhs, PrimitiveString& rhs);
 
 }
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibJS/Runtime/Object.h>
+#include <LibJS/Runtime/PropertyCache.h>
+#include <LibJS/Runtime/ProxyObject.h>
+#include <LibJS/Runtime/Shape.h>
+#include <LibJS/Runtime/VM.h>
+
+namespace JS {
+
+PropertyCache::Statistics PropertyCache::s_statistics;
+
+Object* PropertyCache::holder_if_unchanged(Object& object, const Entry& entry)
+{
+    Object* holder = &object;
+    for (size_t i = 0; i < entry.prototype_count; ++i) {
+        holder = holder->shape().prototype();
+        if (!holder || holder->shape().id() != entry.prototype_shape_ids[i])
+            return nullptr;
+    }
+    return holder;
+}
+
+Value PropertyCache::get(Object& object, const PropertyName& property_name)
+{
+    ASSERT(property_name.is_string());
+
+    auto shape_id = object.shape().id();
+    for (auto& entry : m_entries) {
+        if (entry.shape_id != shape_id)
+            continue;
+        auto* holder = holder_if_unchanged(object, entry);
+        if (!holder)
+            break;
+        auto value = holder->m_storage[entry.offset];
+        // NOTE: Defining a native property over a data property doesn't change its attributes.
+        if (value.is_accessor() || value.is_native_property())
+            break;
+        ++s_statistics.get_hits;
+        return value.value_or(js_undefined());
+    }
+
+    ++s_statistics.get_misses;
+    auto value = object.get(property_name);
+    if (!object.vm().exception())
+        add_get_entry(object, property_name.to_string_or_symbol());
+    return value;
+}
+
+void PropertyCache::add_get_entry(Object& object, const StringOrSymbol& property_name)
+{
+    Entry entry;
+    entry.shape_id = object.shape().id();
+    Object* holder = &object;
+    for (;;) {
+        // Proxies have their own [[Get]], and their prototype() may call into a trap.
+        if (is<ProxyObject>(*holder))
+            return;
+        auto metadata = holder->shape().lookup(property_name);
+        if (metadata.has_value()) {
+            auto value = holder->m_storage[metadata.value().offset];
+            if (value.is_accessor() || value.is_native_property())
+                return;
+            entry.offset = metadata.value().offset;
+            add_entry(entry);
+            return;
+        }
+        if (entry.prototype_count == max_prototype_depth)
+            return;
+        holder = holder->shape().prototype();
+        if (!holder)
+            return;
+        entry.prototype_shape_ids[entry.prototype_count++] = holder->shape().id();
+    }
+}
+
+bool PropertyCache::try_put(Object& object, const Entry& entry, Value value)
+{
+    if (!entry.new_shape) {
+        auto value_here = object.m_storage[entry.offset];
+        if (value_here.is_accessor() || value_here.is_native_property())
+            return false;
+        object.m_storage[entry.offset] = value;
+        object.write_barrier();
+        return true;
+    }
+
+    if (entry.new_shape->id() != entry.new_shape_id || !object.is_extensible())
+        return false;
+    if (!holder_if_unchanged(object, entry))
+        return false;
+    object.set_shape(*entry.new_shape);
+    object.m_storage[entry.offset] = value;
+    object.write_barrier();
+    return true;
+}
+
+void PropertyCache::put(Object& object, const PropertyName& property_name, Value value)
+{
+    ASSERT(property_name.is_string());
+
+    auto shape_id = object.shape().id();
+    for (auto& entry : m_entries) {
+        if (entry.shape_id != shape_id)
+            continue;
+        if (!try_put(object, entry, value))
+            break;
+        ++s_statistics.put_hits;
+        return;
+    }
+
+    ++s_statistics.put_misses;
+    object.put(property_name, value);
+    if (!object.vm().exception())
+        add_put_entry(object, shape_id, property_name.to_string_or_symbol());
+}
+
+void PropertyCache::add_put_entry(Object& object, u64 old_shape_id, const StringOrSymbol& property_name)
+{
+    if (is<ProxyObject>(object))
+        return;
+
+    auto& shape = object.shape();
+    auto metadata = shape.lookup(property_name);
+    if (!metadata.has_value())
+        return;
+
+    Entry entry;
+    entry.offset = metadata.value().offset;
+
+    if (shape.id() == old_shape_id) {
+        auto value = object.m_storage[entry.offset];
+        if (!metadata.value().attributes.is_writable() || value.is_accessor() || value.is_native_property())
+            return;
+        entry.shape_id = old_shape_id;
+        add_entry(entry);
+        return;
+    }
+
+    // The put added the property. If that happened through a regular transition, the new shape
+    // is kept alive by the old one for as long as objects of the old shape can reach this cache.
+    if (shape.is_unique() || shape.transition_type() != Shape::TransitionType::Put || !shape.previous()
+        || shape.previous()->id() != old_shape_id || entry.offset != shape.property_count() - 1)
+        return;
+
+    entry.shape_id = old_shape_id;
+    entry.new_shape = &shape;
+    entry.new_shape_id = shape.id();
+    for (auto* prototype = shape.prototype(); prototype; prototype = prototype->shape().prototype()) {
+        if (entry.prototype_count == max_prototype_depth || is<ProxyObject>(*prototype))
+            return;
+        entry.prototype_shape_ids[entry.prototype_count++] = prototype->shape().id();
+    }
+    add_entry(entry);
+}
+
+void PropertyCache::add_entry(const Entry& entry)
+{
+    for (auto& existing_entry : m_entries) {
+        if (existing_entry.shape_id == entry.shape_id) {
+            existing_entry = entry;
+            return;
+        }
+    }
+    // Past this point the site is megamorphic, and we leave it to the slow path.
+    if (m_entries.size() < max_entries)
+        m_entries.append(entry);
+}
+
+}
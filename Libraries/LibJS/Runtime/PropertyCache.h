@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Types.h>
+#include <AK/Vector.h>
+#include <LibJS/Forward.h>
+#include <LibJS/Runtime/Value.h>
+
+namespace JS {
+
+// An inline cache for a property access site with a fixed property name, i.e.
+// `object.name` or `object.name = value`. For up to max_entries shapes it
+// remembers where the property was found (or which shape adding it leads to),
+// so repeated accesses on objects of those shapes skip the property table.
+// A cache serves either gets or puts, never both.
+class PropertyCache {
+public:
+    struct Statistics {
+        size_t get_hits { 0 };
+        size_t get_misses { 0 };
+        size_t put_hits { 0 };
+        size_t put_misses { 0 };
+    };
+
+    static const Statistics& statistics() { return s_statistics; }
+
+    Value get(Object&, const PropertyName&);
+    void put(Object&, const PropertyName&, Value);
+
+private:
+    static constexpr size_t max_entries = 4;
+    static constexpr size_t max_prototype_depth = 4;
+
+    struct Entry {
+        u64 shape_id { 0 };
+        // The shapes of the prototypes walked to find the property (or, for
+        // puts that add it, the whole prototype chain). Any of them changing
+        // may mean the property is now found somewhere else.
+        u64 prototype_shape_ids[max_prototype_depth] {};
+        u8 prototype_count { 0 };
+        u32 offset { 0 };
+        Shape* new_shape { nullptr };
+        u64 new_shape_id { 0 };
+    };
+
+    static Object* holder_if_unchanged(Object&, const Entry&);
+    static bool try_put(Object&, const Entry&, Value);
+
+    void add_get_entry(Object&, const StringOrSymbol&);
+    void add_put_entry(Object&, u64 old_shape_id, const StringOrSymbol&);
+    void add_entry(const Entry&);
+
+    static Statistics s_statistics;
+
+    Vector<Entry> m_entries;
+};
+
+}
@@ -145,7 +145,7 @@ public:
     Value to_value(VM& vm) const
     {
         if (is_string())
-            return js_string(vm, m_string);
+            return js_interned_string(vm, m_string);
         if (is_number())
             return Value(m_number);
         if (is_symbol())
@@ -41,6 +41,15 @@ void Reference::put(GlobalObject& global_object, Value value)
         return;
     }
 
+    if (is_frame_slot()) {
+        if (m_const_frame_slot) {
+            vm.throw_exception<TypeError>(global_object, ErrorType::InvalidAssignToConst);
+            return;
+        }
+        vm.frame_slot(*m_frame_slot) = value;
+        return;
+    }
+
     if (is_local_variable() || is_global_variable()) {
         if (is_local_variable())
             vm.set_variable(m_name.to_string(), value, global_object);
@@ -81,6 +90,9 @@ Value Reference::get(GlobalObject& global_object)
         return {};
     }
 
+    if (is_frame_slot())
+        return vm.frame_slot(*m_frame_slot);
+
     if (is_local_variable() || is_global_variable()) {
         Value value;
         if (is_local_variable())
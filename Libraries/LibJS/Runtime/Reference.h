@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include <AK/Optional.h>
 #include <AK/String.h>
 #include <LibJS/Runtime/PropertyName.h>
 #include <LibJS/Runtime/Value.h>
@@ -60,6 +61,15 @@ public:
     {
     }
 
+    enum FrameSlotTag { FrameSlot };
+    Reference(FrameSlotTag, const String& name, size_t frame_slot, bool is_const)
+        : m_base(js_null())
+        , m_name(name)
+        , m_frame_slot(frame_slot)
+        , m_const_frame_slot(is_const)
+    {
+    }
+
     Value base() const { return m_base; }
     const PropertyName& name() const { return m_name; }
     bool is_strict() const { return m_strict; }
@@ -85,6 +95,11 @@ public:
         return m_global_variable;
     }
 
+    bool is_frame_slot() const
+    {
+        return m_frame_slot.has_value();
+    }
+
     void put(GlobalObject&, Value);
     Value get(GlobalObject&);
 
@@ -96,6 +111,8 @@ private:
     bool m_strict { false };
     bool m_local_variable { false };
     bool m_global_variable { false };
+    Optional<size_t> m_frame_slot;
+    bool m_const_frame_slot { false };
 };
 
 }
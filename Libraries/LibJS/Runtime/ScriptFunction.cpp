@@ -26,6 +26,7 @@
 
 #include <AK/Function.h>
 #include <LibJS/AST.h>
+#include <LibJS/Bytecode/Interpreter.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/Error.h>
@@ -87,17 +88,34 @@ void ScriptFunction::visit_edges(Visitor& visitor)
     visitor.visit(m_parent_scope);
 }
 
+const Statement& ScriptFunction::body() const
+{
+    // Function declarations may have been skipped over when they were parsed. The parameters are
+    // parsed again along with the body, as the frame slots they get depend on it.
+    if (is<LazyFunctionBody>(*m_body)) {
+        if (auto* function = static_cast<const LazyFunctionBody&>(*m_body).function()) {
+            m_body = function->body();
+            m_parameters = function->parameters();
+        }
+    }
+    return m_body;
+}
+
 LexicalEnvironment* ScriptFunction::create_environment()
 {
+    auto& body = this->body();
+
     HashMap<FlyString, Variable> variables;
     for (auto& parameter : m_parameters) {
-        variables.set(parameter.name, { js_undefined(), DeclarationKind::Var });
+        if (!parameter.frame_slot.has_value())
+            variables.set(parameter.name, { js_undefined(), DeclarationKind::Var });
     }
 
-    if (is<ScopeNode>(body())) {
-        for (auto& declaration : static_cast<const ScopeNode&>(body()).variables()) {
+    if (is<ScopeNode>(body)) {
+        for (auto& declaration : static_cast<const ScopeNode&>(body).variables()) {
             for (auto& declarator : declaration.declarations()) {
-                variables.set(declarator.id().string(), { js_undefined(), DeclarationKind::Var });
+                if (!declarator.id().has_frame_slot())
+                    variables.set(declarator.id().string(), { js_undefined(), DeclarationKind::Var });
             }
         }
     }
@@ -126,6 +144,18 @@ Value ScriptFunction::execute_function_body()
 
     VM::InterpreterExecutionScope scope(*interpreter);
 
+    auto& body = this->body();
+    if (is<LazyFunctionBody>(body)) {
+        vm.throw_exception<SyntaxError>(global_object(), static_cast<const LazyFunctionBody&>(body).syntax_error());
+        return {};
+    }
+    if (is<ScopeNode>(body)) {
+        auto& frame_slots = vm.call_frame().frame_slots;
+        frame_slots.resize(static_cast<const ScopeNode&>(body).frame_slot_count());
+        for (auto& slot : frame_slots)
+            slot = js_undefined();
+    }
+
     auto& call_frame_args = vm.call_frame().arguments;
     for (size_t i = 0; i < m_parameters.size(); ++i) {
         auto parameter = m_parameters[i];
@@ -144,10 +174,18 @@ Value ScriptFunction::execute_function_body()
         } else {
             argument_value = js_undefined();
         }
-        vm.current_scope()->put_to_scope(parameter.name, { argument_value, DeclarationKind::Var });
+        if (parameter.frame_slot.has_value())
+            vm.frame_slot(*parameter.frame_slot) = argument_value;
+        else
+            vm.current_scope()->put_to_scope(parameter.name, { argument_value, DeclarationKind::Var });
+    }
+
+    if (vm.bytecode_enabled() && is<ScopeNode>(body)) {
+        auto& executable = static_cast<const ScopeNode&>(body).bytecode_executable(vm);
+        return Bytecode::Interpreter(*interpreter).run(global_object(), executable);
     }
 
-    return interpreter->execute_statement(global_object(), m_body, ScopeType::Function);
+    return interpreter->execute_statement(global_object(), body, ScopeType::Function);
 }
 
 Value ScriptFunction::call()
@@ -41,7 +41,7 @@ public:
     virtual void initialize(GlobalObject&) override;
     virtual ~ScriptFunction();
 
-    const Statement& body() const { return m_body; }
+    const Statement& body() const;
     const Vector<FunctionNode::Parameter>& parameters() const { return m_parameters; };
 
     virtual Value call() override;
@@ -65,8 +65,8 @@ private:
     JS_DECLARE_NATIVE_GETTER(name_getter);
 
     FlyString m_name;
-    NonnullRefPtr<Statement> m_body;
-    const Vector<FunctionNode::Parameter> m_parameters;
+    mutable NonnullRefPtr<Statement> m_body;
+    mutable Vector<FunctionNode::Parameter> m_parameters;
     ScopeObject* m_parent_scope { nullptr };
     i32 m_function_length { 0 };
     bool m_is_strict { false };
@@ -30,6 +30,12 @@
 
 namespace JS {
 
+u64 Shape::next_id()
+{
+    static u64 s_next_id = 1;
+    return s_next_id++;
+}
+
 Shape* Shape::create_unique_clone() const
 {
     ASSERT(m_global_object);
@@ -50,6 +56,7 @@ Shape* Shape::create_put_transition(const StringOrSymbol& property_name, Propert
         return existing_shape;
     auto* new_shape = heap().allocate_without_global_object<Shape>(*this, property_name, attributes, TransitionType::Put);
     m_forward_transitions.set(key, new_shape);
+    write_barrier();
     return new_shape;
 }
 
@@ -60,6 +67,7 @@ Shape* Shape::create_configure_transition(const StringOrSymbol& property_name, P
         return existing_shape;
     auto* new_shape = heap().allocate_without_global_object<Shape>(*this, property_name, attributes, TransitionType::Configure);
     m_forward_transitions.set(key, new_shape);
+    write_barrier();
     return new_shape;
 }
 
@@ -192,6 +200,15 @@ void Shape::add_property_to_unique_shape(const StringOrSymbol& property_name, Pr
     ASSERT(!m_property_table->contains(property_name));
     m_property_table->set(property_name, { m_property_table->size(), attributes });
     ++m_property_count;
+    m_id = next_id();
+    write_barrier();
+}
+
+void Shape::set_prototype_without_transition(Object* new_prototype)
+{
+    m_prototype = new_prototype;
+    m_id = next_id();
+    write_barrier();
 }
 
 void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_name, PropertyAttributes attributes)
@@ -202,6 +219,7 @@ void Shape::reconfigure_property_in_unique_shape(const StringOrSymbol& property_
     ASSERT(it != m_property_table->end());
     it->value.attributes = attributes;
     m_property_table->set(property_name, it->value);
+    m_id = next_id();
 }
 
 void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_name, size_t offset)
@@ -215,6 +233,7 @@ void Shape::remove_property_from_unique_shape(const StringOrSymbol& property_nam
         if (it.value.offset > offset)
             --it.value.offset;
     }
+    m_id = next_id();
 }
 
 void Shape::add_property_without_transition(const StringOrSymbol& property_name, PropertyAttributes attributes)
@@ -222,6 +241,8 @@ void Shape::add_property_without_transition(const StringOrSymbol& property_name,
     ensure_property_table();
     if (m_property_table->set(property_name, { m_property_count, attributes }) == AK::HashSetResult::InsertedNewEntry)
         ++m_property_count;
+    m_id = next_id();
+    write_barrier();
 }
 
 }
@@ -83,6 +83,13 @@ public:
     Object* prototype() { return m_prototype; }
     const Object* prototype() const { return m_prototype; }
 
+    // Unique to each shape and replaced whenever the shape is modified in place,
+    // so that PropertyCache can key on it without keeping the shape alive.
+    u64 id() const { return m_id; }
+
+    TransitionType transition_type() const { return m_transition_type; }
+    const Shape* previous() const { return m_previous; }
+
     Optional<PropertyMetadata> lookup(const StringOrSymbol&) const;
     const HashMap<StringOrSymbol, PropertyMetadata>& property_table() const;
     size_t property_count() const;
@@ -94,7 +101,7 @@ public:
 
     Vector<Property> property_table_ordered() const;
 
-    void set_prototype_without_transition(Object* new_prototype) { m_prototype = new_prototype; }
+    void set_prototype_without_transition(Object* new_prototype);
 
     void remove_property_from_unique_shape(const StringOrSymbol&, size_t offset);
     void add_property_to_unique_shape(const StringOrSymbol&, PropertyAttributes attributes);
@@ -106,6 +113,8 @@ private:
 
     void ensure_property_table() const;
 
+    static u64 next_id();
+
     PropertyAttributes m_attributes { 0 };
     TransitionType m_transition_type : 6 { TransitionType::Invalid };
     bool m_unique : 1 { false };
@@ -119,6 +128,7 @@ private:
     StringOrSymbol m_property_name;
     Object* m_prototype { nullptr };
     size_t m_property_count { 0 };
+    u64 m_id { next_id() };
 };
 
 }
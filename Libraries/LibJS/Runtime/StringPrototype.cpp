@@ -263,7 +263,7 @@ JS_DEFINE_NATIVE_GETTER(StringPrototype::length_getter)
     auto* string_object = typed_this(vm, global_object);
     if (!string_object)
         return {};
-    return Value((i32)string_object->primitive_string().string().length());
+    return Value((i32)string_object->primitive_string().length());
 }
 
 JS_DEFINE_NATIVE_FUNCTION(StringPrototype::to_string)
@@ -103,6 +103,8 @@ void VM::gather_roots(HashTable<Cell*>& roots)
     roots.set(m_empty_string);
     for (auto* string : m_single_ascii_character_strings)
         roots.set(string);
+    for (auto& it : m_interned_strings)
+        roots.set(it.value);
 
     roots.set(m_scope_object_shape);
     roots.set(m_exception);
@@ -118,6 +120,10 @@ void VM::gather_roots(HashTable<Cell*>& roots)
             if (argument.is_cell())
                 roots.set(argument.as_cell());
         }
+        for (auto& value : call_frame->frame_slots) {
+            if (value.is_cell())
+                roots.set(value.as_cell());
+        }
         roots.set(call_frame->scope);
     }
 
@@ -141,6 +147,27 @@ Symbol* VM::get_global_symbol(const String& description)
     return new_global_symbol;
 }
 
+PrimitiveString& VM::intern_string(String string)
+{
+    // The interned strings are kept alive until the table fills up, so don't let it grow without bound.
+    static constexpr size_t max_interned_strings = 4096;
+
+    if (string.is_empty())
+        return empty_string();
+    if (string.length() == 1 && (u8)string.characters()[0] < 0x80)
+        return single_ascii_character_string(string.characters()[0]);
+
+    auto it = m_interned_strings.find(string);
+    if (it != m_interned_strings.end())
+        return *it->value;
+
+    if (m_interned_strings.size() >= max_interned_strings)
+        m_interned_strings.clear();
+    auto* primitive_string = m_heap.allocate_without_global_object<PrimitiveString>(string);
+    m_interned_strings.set(move(string), primitive_string);
+    return *primitive_string;
+}
+
 void VM::set_variable(const FlyString& name, Value value, GlobalObject& global_object, bool first_assignment)
 {
     if (m_call_stack.size()) {
@@ -230,18 +257,16 @@ Value VM::construct(Function& function, Function& new_target, Optional<MarkedVal
 
     Object* new_object = nullptr;
     if (function.constructor_kind() == Function::ConstructorKind::Base) {
-        new_object = Object::create_empty(global_object);
-        environment->bind_this_value(global_object, new_object);
+        auto prototype = new_target.get(names.prototype);
         if (exception())
             return {};
-        auto prototype = new_target.get(names.prototype);
+        if (prototype.is_object())
+            new_object = heap().allocate<Object>(global_object, new_target.shape_for_instances(global_object, prototype.as_object()));
+        else
+            new_object = Object::create_empty(global_object);
+        environment->bind_this_value(global_object, new_object);
         if (exception())
             return {};
-        if (prototype.is_object()) {
-            new_object->set_prototype(&prototype.as_object());
-            if (exception())
-                return {};
-        }
     }
 
     // If we are a Derived constructor, |this| has not been constructed before super is called.
@@ -61,6 +61,8 @@ struct CallFrame {
     Vector<Value> arguments;
     Array* arguments_object { nullptr };
     ScopeObject* scope { nullptr };
+    // Bindings the parser resolved to a fixed index, see Identifier::frame_slot().
+    Vector<Value> frame_slots;
     bool is_strict_mode { false };
 };
 
@@ -72,6 +74,14 @@ public:
     bool should_log_exceptions() const { return m_should_log_exceptions; }
     void set_should_log_exceptions(bool b) { m_should_log_exceptions = b; }
 
+    // When enabled, programs and function bodies are compiled to bytecode
+    // and run by the Bytecode::Interpreter instead of walking the AST.
+    bool bytecode_enabled() const { return m_bytecode_enabled; }
+    void set_bytecode_enabled(bool b) { m_bytecode_enabled = b; }
+
+    bool should_dump_bytecode() const { return m_should_dump_bytecode; }
+    void set_should_dump_bytecode(bool b) { m_should_dump_bytecode = b; }
+
     Heap& heap() { return m_heap; }
     const Heap& heap() const { return m_heap; }
 
@@ -113,6 +123,10 @@ public:
         return *m_single_ascii_character_strings[character];
     }
 
+    // Returns the one PrimitiveString for this string. Only meant for short strings
+    // and property names, which tend to be created over and over again.
+    PrimitiveString& intern_string(String);
+
     void push_call_frame(CallFrame& call_frame, GlobalObject& global_object)
     {
         ASSERT(!exception());
@@ -138,6 +152,8 @@ public:
     const ScopeObject* current_scope() const { return call_frame().scope; }
     ScopeObject* current_scope() { return call_frame().scope; }
 
+    Value& frame_slot(size_t index) { return call_frame().frame_slots[index]; }
+
     bool in_strict_mode() const;
 
     template<typename Callback>
@@ -173,6 +189,7 @@ public:
 
     Value last_value() const { return m_last_value; }
     void set_last_value(Badge<Interpreter>, Value value) { m_last_value = value; }
+    void set_last_value(Badge<Bytecode::Interpreter>, Value value) { m_last_value = value; }
 
     const StackInfo& stack_info() const { return m_stack_info; };
 
@@ -267,6 +284,7 @@ private:
 
     PrimitiveString* m_empty_string { nullptr };
     PrimitiveString* m_single_ascii_character_strings[128] {};
+    HashMap<String, PrimitiveString*> m_interned_strings;
 
 #define __JS_ENUMERATE(SymbolName, snake_name) \
     Symbol* m_well_known_symbol_##snake_name { nullptr };
@@ -276,6 +294,8 @@ private:
     Shape* m_scope_object_shape { nullptr };
 
     bool m_should_log_exceptions { false };
+    bool m_bytecode_enabled { false };
+    bool m_should_dump_bytecode { false };
 };
 
 template<>
@@ -217,7 +217,7 @@ bool Value::is_array() const
 Array& Value::as_array()
 {
     ASSERT(is_array());
-    return static_cast<Array&>(*m_value.as_object);
+    return static_cast<Array&>(as_object());
 }
 
 bool Value::is_function() const
@@ -249,21 +249,21 @@ bool Value::is_regexp(GlobalObject& global_object) const
 
 String Value::to_string_without_side_effects() const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return "undefined";
     case Type::Null:
         return "null";
     case Type::Boolean:
-        return m_value.as_bool ? "true" : "false";
+        return as_bool() ? "true" : "false";
     case Type::Number:
-        return double_to_string(m_value.as_double);
+        return double_to_string(as_double());
     case Type::String:
-        return m_value.as_string->string();
+        return as_string().string();
     case Type::Symbol:
-        return m_value.as_symbol->to_string();
+        return as_symbol().to_string();
     case Type::BigInt:
-        return m_value.as_bigint->to_string();
+        return as_bigint().to_string();
     case Type::Object:
         return String::formatted("[object {}]", as_object().class_name());
     case Type::Accessor:
@@ -287,22 +287,22 @@ PrimitiveString* Value::to_primitive_string(GlobalObject& global_object)
 
 String Value::to_string(GlobalObject& global_object, bool legacy_null_to_empty_string) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return "undefined";
     case Type::Null:
         return !legacy_null_to_empty_string ? "null" : String::empty();
     case Type::Boolean:
-        return m_value.as_bool ? "true" : "false";
+        return as_bool() ? "true" : "false";
     case Type::Number:
-        return double_to_string(m_value.as_double);
+        return double_to_string(as_double());
     case Type::String:
-        return m_value.as_string->string();
+        return as_string().string();
     case Type::Symbol:
         global_object.vm().throw_exception<TypeError>(global_object, ErrorType::Convert, "symbol", "string");
         return {};
     case Type::BigInt:
-        return m_value.as_bigint->big_integer().to_base10();
+        return as_bigint().big_integer().to_base10();
     case Type::Object: {
         auto primitive_value = to_primitive(PreferredType::String);
         if (global_object.vm().exception())
@@ -316,22 +316,22 @@ String Value::to_string(GlobalObject& global_object, bool legacy_null_to_empty_s
 
 bool Value::to_boolean() const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
     case Type::Null:
         return false;
     case Type::Boolean:
-        return m_value.as_bool;
+        return as_bool();
     case Type::Number:
         if (is_nan())
             return false;
-        return m_value.as_double != 0;
+        return as_double() != 0;
     case Type::String:
-        return !m_value.as_string->string().is_empty();
+        return !as_string().string().is_empty();
     case Type::Symbol:
         return true;
     case Type::BigInt:
-        return m_value.as_bigint->big_integer() != BIGINT_ZERO;
+        return as_bigint().big_integer() != BIGINT_ZERO;
     case Type::Object:
         return true;
     default:
@@ -352,21 +352,21 @@ Value Value::to_primitive(PreferredType preferred_type) const
 
 Object* Value::to_object(GlobalObject& global_object) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
     case Type::Null:
         global_object.vm().throw_exception<TypeError>(global_object, ErrorType::ToObjectNullOrUndef);
         return nullptr;
     case Type::Boolean:
-        return BooleanObject::create(global_object, m_value.as_bool);
+        return BooleanObject::create(global_object, as_bool());
     case Type::Number:
-        return NumberObject::create(global_object, m_value.as_double);
+        return NumberObject::create(global_object, as_double());
     case Type::String:
-        return StringObject::create(global_object, *m_value.as_string);
+        return StringObject::create(global_object, const_cast<PrimitiveString&>(as_string()));
     case Type::Symbol:
-        return SymbolObject::create(global_object, *m_value.as_symbol);
+        return SymbolObject::create(global_object, const_cast<Symbol&>(as_symbol()));
     case Type::BigInt:
-        return BigIntObject::create(global_object, *m_value.as_bigint);
+        return BigIntObject::create(global_object, const_cast<BigInt&>(as_bigint()));
     case Type::Object:
         return &const_cast<Object&>(as_object());
     default:
@@ -387,15 +387,15 @@ Value Value::to_numeric(GlobalObject& global_object) const
 
 Value Value::to_number(GlobalObject& global_object) const
 {
-    switch (m_type) {
+    switch (type()) {
     case Type::Undefined:
         return js_nan();
     case Type::Null:
         return Value(0);
     case Type::Boolean:
-        return Value(m_value.as_bool ? 1 : 0);
+        return Value(as_bool() ? 1 : 0);
     case Type::Number:
-        return Value(m_value.as_double);
+        return Value(as_double());
     case Type::String: {
         auto string = as_string().string().trim_whitespace();
         if (string.is_empty())
@@ -467,6 +467,8 @@ BigInt* Value::to_bigint(GlobalObject& global_object) const
 
 i32 Value::as_i32() const
 {
+    if (is_int32())
+        return static_cast<i32>(m_value);
     return static_cast<i32>(as_double());
 }
 
@@ -769,16 +771,13 @@ Value add(GlobalObject& global_object, Value lhs, Value rhs)
         return {};
 
     if (lhs_primitive.is_string() || rhs_primitive.is_string()) {
-        auto lhs_string = lhs_primitive.to_string(global_object.global_object());
+        auto* lhs_string = lhs_primitive.to_primitive_string(global_object.global_object());
         if (global_object.vm().exception())
             return {};
-        auto rhs_string = rhs_primitive.to_string(global_object.global_object());
+        auto* rhs_string = rhs_primitive.to_primitive_string(global_object.global_object());
         if (global_object.vm().exception())
             return {};
-        StringBuilder builder(lhs_string.length() + rhs_string.length());
-        builder.append(lhs_string);
-        builder.append(rhs_string);
-        return js_string(global_object.heap(), builder.to_string());
+        return js_string_concatenation(global_object.heap(), *lhs_string, *rhs_string);
     }
 
     auto lhs_numeric = lhs_primitive.to_numeric(global_object.global_object());
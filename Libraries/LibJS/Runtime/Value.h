@@ -29,6 +29,7 @@
 #include <AK/Assertions.h>
 #include <AK/Format.h>
 #include <AK/Forward.h>
+#include <AK/NumericLimits.h>
 #include <AK/String.h>
 #include <AK/Types.h>
 #include <LibJS/Forward.h>
@@ -61,32 +62,38 @@ public:
         Number,
     };
 
-    bool is_empty() const { return m_type == Type::Empty; }
-    bool is_undefined() const { return m_type == Type::Undefined; }
-    bool is_null() const { return m_type == Type::Null; }
-    bool is_number() const { return m_type == Type::Number; }
-    bool is_string() const { return m_type == Type::String; }
-    bool is_object() const { return m_type == Type::Object; }
-    bool is_boolean() const { return m_type == Type::Boolean; }
-    bool is_symbol() const { return m_type == Type::Symbol; }
-    bool is_accessor() const { return m_type == Type::Accessor; };
-    bool is_bigint() const { return m_type == Type::BigInt; };
-    bool is_native_property() const { return m_type == Type::NativeProperty; }
-    bool is_nullish() const { return is_null() || is_undefined(); }
-    bool is_cell() const { return is_string() || is_accessor() || is_object() || is_bigint() || is_symbol() || is_native_property(); }
+    bool is_empty() const { return m_value == EMPTY_VALUE; }
+    bool is_undefined() const { return m_value == UNDEFINED_VALUE; }
+    bool is_null() const { return m_value == NULL_VALUE; }
+    bool is_number() const { return m_value < (SPECIAL_TAG << TAG_SHIFT); }
+    bool is_string() const { return tag() == STRING_TAG; }
+    bool is_object() const { return tag() == OBJECT_TAG; }
+    bool is_boolean() const { return (m_value | 1) == TRUE_VALUE; }
+    bool is_symbol() const { return tag() == SYMBOL_TAG; }
+    bool is_accessor() const { return tag() == ACCESSOR_TAG; };
+    bool is_bigint() const { return tag() == BIGINT_TAG; };
+    bool is_native_property() const { return tag() == NATIVE_PROPERTY_TAG; }
+    bool is_nullish() const { return (m_value | 1) == NULL_VALUE; }
+    bool is_cell() const { return tag() >= STRING_TAG; }
     bool is_array() const;
     bool is_function() const;
     bool is_regexp(GlobalObject& global_object) const;
 
-    bool is_nan() const { return is_number() && __builtin_isnan(as_double()); }
+    // A number that is stored as an i32 rather than as a double. Whether a
+    // number is one or the other is not observable from JavaScript.
+    bool is_int32() const { return tag() == INT32_TAG; }
+
+    bool is_nan() const { return m_value == CANONICAL_NAN; }
     bool is_infinity() const { return is_number() && __builtin_isinf(as_double()); }
     bool is_positive_infinity() const { return is_number() && __builtin_isinf_sign(as_double()) > 0; }
     bool is_negative_infinity() const { return is_number() && __builtin_isinf_sign(as_double()) < 0; }
     bool is_positive_zero() const { return is_number() && 1.0 / as_double() == INFINITY; }
     bool is_negative_zero() const { return is_number() && 1.0 / as_double() == -INFINITY; }
-    bool is_integer() const { return is_finite_number() && (i32)as_double() == as_double(); }
+    bool is_integer() const { return is_int32() || (is_finite_number() && (i32)as_double() == as_double()); }
     bool is_finite_number() const
     {
+        if (is_int32())
+            return true;
         if (!is_number())
             return false;
         auto number = as_double();
@@ -94,147 +101,195 @@ public:
     }
 
     Value()
-        : m_type(Type::Empty)
+        : m_value(EMPTY_VALUE)
     {
     }
 
     explicit Value(bool value)
-        : m_type(Type::Boolean)
+        : m_value(value ? TRUE_VALUE : FALSE_VALUE)
     {
-        m_value.as_bool = value;
     }
 
     explicit Value(double value)
-        : m_type(Type::Number)
     {
-        m_value.as_double = value;
+        if (__builtin_isnan(value)) {
+            m_value = CANONICAL_NAN;
+            return;
+        }
+        __builtin_memcpy(&m_value, &value, sizeof(value));
     }
 
     explicit Value(unsigned value)
-        : m_type(Type::Number)
     {
-        m_value.as_double = static_cast<double>(value);
+        if (value > NumericLimits<i32>::max()) {
+            *this = Value(static_cast<double>(value));
+            return;
+        }
+        m_value = encode(INT32_TAG, value);
     }
 
     explicit Value(i32 value)
-        : m_type(Type::Number)
+        : m_value(encode(INT32_TAG, static_cast<u32>(value)))
     {
-        m_value.as_double = value;
     }
 
     Value(const Object* object)
-        : m_type(object ? Type::Object : Type::Null)
+        : m_value(object ? encode(OBJECT_TAG, object) : NULL_VALUE)
     {
-        m_value.as_object = const_cast<Object*>(object);
     }
 
     Value(const PrimitiveString* string)
-        : m_type(Type::String)
+        : m_value(encode(STRING_TAG, string))
     {
-        m_value.as_string = const_cast<PrimitiveString*>(string);
     }
 
     Value(const Symbol* symbol)
-        : m_type(Type::Symbol)
+        : m_value(encode(SYMBOL_TAG, symbol))
     {
-        m_value.as_symbol = const_cast<Symbol*>(symbol);
     }
 
     Value(const Accessor* accessor)
-        : m_type(Type::Accessor)
+        : m_value(encode(ACCESSOR_TAG, accessor))
     {
-        m_value.as_accessor = const_cast<Accessor*>(accessor);
     }
 
     Value(const BigInt* bigint)
-        : m_type(Type::BigInt)
+        : m_value(encode(BIGINT_TAG, bigint))
     {
-        m_value.as_bigint = const_cast<BigInt*>(bigint);
     }
 
     Value(const NativeProperty* native_property)
-        : m_type(Type::NativeProperty)
+        : m_value(encode(NATIVE_PROPERTY_TAG, native_property))
     {
-        m_value.as_native_property = const_cast<NativeProperty*>(native_property);
     }
 
     explicit Value(Type type)
-        : m_type(type)
     {
+        switch (type) {
+        case Type::Empty:
+            m_value = EMPTY_VALUE;
+            break;
+        case Type::Undefined:
+            m_value = UNDEFINED_VALUE;
+            break;
+        case Type::Null:
+            m_value = NULL_VALUE;
+            break;
+        default:
+            ASSERT_NOT_REACHED();
+        }
     }
 
-    Type type() const { return m_type; }
+    Type type() const
+    {
+        if (is_number())
+            return Type::Number;
+        switch (tag()) {
+        case SPECIAL_TAG:
+            if (is_boolean())
+                return Type::Boolean;
+            if (is_undefined())
+                return Type::Undefined;
+            if (is_null())
+                return Type::Null;
+            return Type::Empty;
+        case STRING_TAG:
+            return Type::String;
+        case SYMBOL_TAG:
+            return Type::Symbol;
+        case OBJECT_TAG:
+            return Type::Object;
+        case ACCESSOR_TAG:
+            return Type::Accessor;
+        case BIGINT_TAG:
+            return Type::BigInt;
+        case NATIVE_PROPERTY_TAG:
+            return Type::NativeProperty;
+        default:
+            ASSERT_NOT_REACHED();
+        }
+    }
 
     double as_double() const
     {
-        ASSERT(type() == Type::Number);
-        return m_value.as_double;
+        ASSERT(is_number());
+        if (is_int32())
+            return static_cast<i32>(m_value);
+        double value;
+        __builtin_memcpy(&value, &m_value, sizeof(value));
+        return value;
     }
 
     bool as_bool() const
     {
-        ASSERT(type() == Type::Boolean);
-        return m_value.as_bool;
+        ASSERT(is_boolean());
+        return m_value == TRUE_VALUE;
     }
 
     Object& as_object()
     {
-        ASSERT(type() == Type::Object);
-        return *m_value.as_object;
+        ASSERT(is_object());
+        return *decode<Object>();
     }
 
     const Object& as_object() const
     {
-        ASSERT(type() == Type::Object);
-        return *m_value.as_object;
+        ASSERT(is_object());
+        return *decode<Object>();
     }
 
     PrimitiveString& as_string()
     {
         ASSERT(is_string());
-        return *m_value.as_string;
+        return *decode<PrimitiveString>();
     }
 
     const PrimitiveString& as_string() const
     {
         ASSERT(is_string());
-        return *m_value.as_string;
+        return *decode<PrimitiveString>();
     }
 
     Symbol& as_symbol()
     {
         ASSERT(is_symbol());
-        return *m_value.as_symbol;
+        return *decode<Symbol>();
     }
 
     const Symbol& as_symbol() const
     {
         ASSERT(is_symbol());
-        return *m_value.as_symbol;
+        return *decode<Symbol>();
     }
 
     Cell* as_cell()
     {
         ASSERT(is_cell());
-        return m_value.as_cell;
+        return decode<Cell>();
     }
 
     Accessor& as_accessor()
     {
         ASSERT(is_accessor());
-        return *m_value.as_accessor;
+        return *decode<Accessor>();
     }
 
     BigInt& as_bigint()
     {
         ASSERT(is_bigint());
-        return *m_value.as_bigint;
+        return *decode<BigInt>();
+    }
+
+    const BigInt& as_bigint() const
+    {
+        ASSERT(is_bigint());
+        return *decode<BigInt>();
     }
 
     NativeProperty& as_native_property()
     {
         ASSERT(is_native_property());
-        return *m_value.as_native_property;
+        return *decode<NativeProperty>();
     }
 
     Array& as_array();
@@ -267,22 +322,61 @@ public:
         return *this;
     }
 
+    // If the given bits are a NaN-boxed cell, returns the cell pointer in them.
+    // Used by the garbage collector when it scans the stack for pointers.
+    static FlatPtr cell_pointer_from_bits(u64 bits)
+    {
+        if ((bits >> TAG_SHIFT) < STRING_TAG)
+            return 0;
+        return static_cast<FlatPtr>(bits & PAYLOAD_MASK);
+    }
+
 private:
-    Type m_type { Type::Empty };
-
-    union {
-        bool as_bool;
-        double as_double;
-        PrimitiveString* as_string;
-        Symbol* as_symbol;
-        Object* as_object;
-        Cell* as_cell;
-        Accessor* as_accessor;
-        BigInt* as_bigint;
-        NativeProperty* as_native_property;
-    } m_value;
+    // Values are NaN-boxed into 64 bits. Doubles are stored as they are, with
+    // every NaN canonicalized to a single quiet NaN. Everything else goes into
+    // the negative quiet NaN space that frees up: a 16-bit tag followed by a
+    // 48-bit payload, which is enough for cell pointers on all our targets.
+    static constexpr u64 TAG_SHIFT = 48;
+    static constexpr u64 PAYLOAD_MASK = 0x0000'FFFF'FFFF'FFFF;
+    static constexpr u64 CANONICAL_NAN = 0x7FF8'0000'0000'0000;
+
+    static constexpr u64 INT32_TAG = 0xFFF8;
+    static constexpr u64 SPECIAL_TAG = 0xFFF9;
+    static constexpr u64 STRING_TAG = 0xFFFA;
+    static constexpr u64 SYMBOL_TAG = 0xFFFB;
+    static constexpr u64 OBJECT_TAG = 0xFFFC;
+    static constexpr u64 ACCESSOR_TAG = 0xFFFD;
+    static constexpr u64 BIGINT_TAG = 0xFFFE;
+    static constexpr u64 NATIVE_PROPERTY_TAG = 0xFFFF;
+
+    // The payloads of the special values are chosen so that booleans and
+    // nullish values only differ from one another in the lowest bit.
+    static constexpr u64 EMPTY_VALUE = SPECIAL_TAG << TAG_SHIFT;
+    static constexpr u64 UNDEFINED_VALUE = SPECIAL_TAG << TAG_SHIFT | 2;
+    static constexpr u64 NULL_VALUE = SPECIAL_TAG << TAG_SHIFT | 3;
+    static constexpr u64 FALSE_VALUE = SPECIAL_TAG << TAG_SHIFT | 4;
+    static constexpr u64 TRUE_VALUE = SPECIAL_TAG << TAG_SHIFT | 5;
+
+    static u64 encode(u64 tag, u32 payload) { return tag << TAG_SHIFT | payload; }
+
+    template<typename T>
+    static u64 encode(u64 tag, const T* cell)
+    {
+        auto payload = reinterpret_cast<FlatPtr>(cell);
+        ASSERT(!(payload & ~PAYLOAD_MASK));
+        return tag << TAG_SHIFT | payload;
+    }
+
+    template<typename T>
+    T* decode() const { return reinterpret_cast<T*>(static_cast<FlatPtr>(m_value & PAYLOAD_MASK)); }
+
+    u64 tag() const { return m_value >> TAG_SHIFT; }
+
+    u64 m_value { EMPTY_VALUE };
 };
 
+static_assert(sizeof(Value) == sizeof(u64));
+
 inline Value js_undefined()
 {
     return Value(Value::Type::Undefined);
@@ -0,0 +1,99 @@
+test("shadowed bindings in nested blocks", () => {
+    let a = 1;
+    {
+        let a = 2;
+        {
+            let a = 3;
+            expect(a).toBe(3);
+        }
+        expect(a).toBe(2);
+    }
+    expect(a).toBe(1);
+});
+
+test("block bindings start out undefined every time the block is entered", () => {
+    const values = [];
+    for (let i = 0; i < 3; ++i) {
+        let value;
+        if (i === 1) value = i;
+        values.push(value);
+    }
+    expect(values).toEqual([undefined, 1, undefined]);
+});
+
+test("bindings captured by a closure stay shared with it", () => {
+    let counter = 0;
+    const increment = () => ++counter;
+    increment();
+    counter += 10;
+    increment();
+    expect(counter).toBe(12);
+});
+
+test("parameters", () => {
+    function f(a, b = a * 2, ...rest) {
+        a++;
+        return [a, b, rest.length];
+    }
+    expect(f(1)).toEqual([2, 2, 0]);
+    expect(f(1, 5, 6, 7)).toEqual([2, 5, 2]);
+
+    function g(x, x) {
+        return x;
+    }
+    expect(g(1, 2)).toBe(2);
+
+    function h(x) {
+        var x;
+        return x;
+    }
+    expect(h(3)).toBe(3);
+});
+
+test("const bindings", () => {
+    const a = 1;
+    expect(() => {
+        {
+            const b = 2;
+            b = 3;
+        }
+    }).toThrowWithMessage(TypeError, "Invalid assignment to const variable");
+    expect(a).toBe(1);
+});
+
+test("for..in and for..of bindings", () => {
+    const keys = [];
+    for (const key in { a: 1, b: 2 }) keys.push(key);
+    expect(keys).toEqual(["a", "b"]);
+
+    let sum = 0;
+    for (let value of [1, 2, 3]) sum += value;
+    expect(sum).toBe(6);
+});
+
+test("typeof and delete", () => {
+    let a = "foo";
+    expect(typeof a).toBe("string");
+    expect(typeof doesNotExist).toBe("undefined");
+    expect(delete a).toBeFalse();
+    expect(a).toBe("foo");
+});
+
+test("with statement", () => {
+    var a = 1;
+    let b = 2;
+    with ({ a: 3 }) {
+        expect(a).toBe(3);
+        expect(b).toBe(2);
+        a = 4;
+    }
+    expect(a).toBe(1);
+});
+
+test("function declarations", () => {
+    var f = 1;
+    {
+        function f() {}
+    }
+    expect(typeof f).toBe("function");
+});
@@ -0,0 +1,102 @@
+test("large arrays built by pushing", () => {
+    const a = [];
+    for (let i = 0; i < 10000; ++i) a.push(i);
+    expect(a).toHaveLength(10000);
+    expect(a[9999]).toBe(9999);
+    expect(a.pop()).toBe(9999);
+    expect(a).toHaveLength(9999);
+    expect(a.indexOf(5000)).toBe(5000);
+});
+
+test("elements changing from int32 to double to anything", () => {
+    const a = [1, 2, 3];
+    expect(a.indexOf(2)).toBe(1);
+    expect(a.indexOf("2")).toBe(-1);
+    a.push(4.5);
+    expect(a.indexOf(4.5)).toBe(3);
+    expect(a.indexOf(NaN)).toBe(-1);
+    a.push("foo");
+    expect(a.indexOf("foo")).toBe(4);
+    expect(a.indexOf(1, 1)).toBe(-1);
+    expect([-0].indexOf(0)).toBe(0);
+});
+
+test("holes", () => {
+    const a = [1, 2, 3];
+    a[10] = 4;
+    expect(a).toHaveLength(11);
+    expect(a[5]).toBeUndefined();
+    expect(Object.keys(a)).toEqual(["0", "1", "2", "10"]);
+
+    const visited = [];
+    a.forEach((value, index) => visited.push(index));
+    expect(visited).toEqual([0, 1, 2, 10]);
+
+    const mapped = a.map(x => x * 2);
+    expect(mapped).toHaveLength(11);
+    expect(mapped[10]).toBe(8);
+    expect(5 in mapped).toBeFalse();
+});
+
+test("huge lengths don't allocate elements", () => {
+    const a = [];
+    a.length = 2147483647;
+    expect(a).toHaveLength(2147483647);
+    a[0] = 1;
+    expect(a[0]).toBe(1);
+    a[2000000000] = 2;
+    expect(a[2000000000]).toBe(2);
+    expect(Object.keys(a)).toEqual(["0", "2000000000"]);
+});
+
+test("filling new arrays", () => {
+    const a = new Array(1000).fill(7);
+    expect(a).toHaveLength(1000);
+    expect(a.indexOf(7)).toBe(0);
+    expect(a.indexOf(8)).toBe(-1);
+    expect(a.map(x => x + 1)[999]).toBe(8);
+
+    const b = new Array(5).fill(0, 1, 3);
+    expect(b).toEqual([undefined, 0, 0, undefined, undefined]);
+    expect(0 in b).toBeFalse();
+});
+
+test("fill calls setters in the prototype chain", () => {
+    const prototype = [];
+    let stored;
+    Object.defineProperty(prototype, 1, {
+        set(value) {
+            stored = value;
+        },
+    });
+    const a = new Array(3);
+    Object.setPrototypeOf(a, prototype);
+    a.fill(5);
+    expect(stored).toBe(5);
+});
+
+test("callbacks changing the array while it's being iterated", () => {
+    const a = [1, 2, 3, 4];
+    const visited = [];
+    a.forEach((value, index) => {
+        visited.push(value);
+        if (index === 0) a[2] = "changed";
+        if (index === 1) a.pop();
+    });
+    expect(visited).toEqual([1, 2, "changed"]);
+});
+
+test("sorting packed arrays of numbers and strings", () => {
+    const numbers = [];
+    for (let i = 0; i < 1000; ++i) numbers.push((i * 7919) % 1000);
+    numbers.sort();
+    expect(numbers.slice(0, 5)).toEqual([0, 1, 10, 100, 101]);
+    expect(numbers[999]).toBe(999);
+
+    expect([3, 1.5, -2, "b", "a", 10].sort()).toEqual([-2, 1.5, 10, 3, "a", "b"]);
+    expect(["b", "ab", "a", "", "aa"].sort()).toEqual(["", "a", "aa", "ab", "b"]);
+
+    const keys = [1, "1", 1.0, "1"];
+    const sorted = keys.sort();
+    expect(sorted.map(x => typeof x)).toEqual(["number", "string", "number", "string"]);
+});
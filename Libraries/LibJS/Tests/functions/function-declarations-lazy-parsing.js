@@ -0,0 +1,107 @@
+// test-js skips over the bodies of function declarations at first, and parses them when they're
+// first called. Apart from when some syntax errors are thrown, none of that should be observable.
+
+test("calling a function before and after its declaration", () => {
+    expect(square(3)).toBe(9);
+    function square(x) {
+        return x * x;
+    }
+    expect(square(4)).toBe(16);
+});
+
+test("nested and recursive declarations", () => {
+    function outer(n) {
+        function middle(m) {
+            function inner(k) {
+                return k <= 1 ? 1 : k * inner(k - 1);
+            }
+            return inner(m) + n;
+        }
+        return middle(n);
+    }
+    expect(outer(4)).toBe(28);
+    expect(outer(5)).toBe(125);
+});
+
+test("closures and parameters", () => {
+    function counter(start = 0, step = () => 1) {
+        var start;
+        let count = start;
+        function next() {
+            count += step();
+            return count;
+        }
+        return next;
+    }
+    const next = counter(10, () => 5);
+    expect(next()).toBe(15);
+    expect(next()).toBe(20);
+    expect(counter()()).toBe(1);
+
+    function capturedDefault(a, get = () => a) {
+        a = 2;
+        return get();
+    }
+    expect(capturedDefault(1)).toBe(2);
+
+    function rest(first, ...others) {
+        return arguments.length + others.length + first;
+    }
+    expect(rest(1, 2, 3)).toBe(6);
+});
+
+test("strict mode is inherited", () => {
+    function strict() {
+        "use strict";
+        function inner() {
+            return isStrictMode();
+        }
+        return inner();
+    }
+    expect(strict()).toBeTrue();
+
+    function sloppy() {
+        function inner() {
+            return isStrictMode();
+        }
+        return inner();
+    }
+    expect(sloppy()).toBeFalse();
+});
+
+test("declarations inside loops and template literals", () => {
+    let result = "";
+    for (let i = 0; i < 3; ++i) {
+        function describe(value) {
+            return `<${value}>`;
+        }
+        result += describe(i);
+    }
+    expect(result).toBe("<0><1><2>");
+
+    const string = `${(function () {
+        function inTemplate() {
+            return `{${"nested"}}`;
+        }
+        return inTemplate();
+    })()}!`;
+    expect(string).toBe("{nested}!");
+});
+
+test("functions that are never called", () => {
+    function neverCalled() {
+        return doesNotExist.property;
+    }
+    expect(typeof neverCalled).toBe("function");
+    expect(neverCalled).toHaveLength(0);
+    expect(neverCalled.name).toBe("neverCalled");
+});
+
+test("syntax errors that skipping over the body doesn't catch", () => {
+    function broken() {
+        var = 1;
+    }
+    expect(typeof broken).toBe("function");
+    expect(broken).toThrowWithMessage(SyntaxError, "Unexpected token Equals. Expected Identifier");
+    expect(broken).toThrowWithMessage(SyntaxError, "Unexpected token Equals. Expected Identifier");
+});
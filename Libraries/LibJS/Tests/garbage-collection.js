@@ -0,0 +1,43 @@
+// These allocate enough to trigger several young collections while old objects
+// (made old by the explicit gc() calls) are given edges to freshly allocated ones.
+
+test("properties added to old objects survive young collections", () => {
+    const holder = {};
+    gc();
+    for (let i = 0; i < 20000; ++i) holder["p" + (i % 100)] = { value: "v" + i };
+    for (let i = 0; i < 100; ++i) expect(holder["p" + i].value).toBe("v" + (19900 + i));
+});
+
+test("elements stored into old arrays survive young collections", () => {
+    const array = new Array(100).fill(null);
+    gc();
+    for (let i = 0; i < 20000; ++i) array[i % 100] = [i, "e" + i];
+    for (let i = 0; i < 100; ++i) expect(array[i][1]).toBe("e" + (19900 + i));
+
+    const pushed = [];
+    gc();
+    for (let i = 0; i < 20000; ++i) pushed.push({ i });
+    expect(pushed.reduce((sum, entry) => sum + entry.i, 0)).toBe(199990000);
+});
+
+test("closure variables of old scopes survive young collections", () => {
+    let captured = null;
+    const set = value => (captured = value);
+    gc();
+    for (let i = 0; i < 20000; ++i) set({ text: "c" + i });
+    expect(captured.text).toBe("c19999");
+});
+
+test("prototypes and accessors set on old objects survive young collections", () => {
+    const object = {};
+    gc();
+    for (let i = 0; i < 20000; ++i) Object.setPrototypeOf(object, { marker: "m" + i });
+    expect(object.marker).toBe("m19999");
+
+    gc();
+    for (let i = 0; i < 20000; ++i) {
+        const text = "g" + i;
+        Object.defineProperty(object, "accessor", { get: () => text, configurable: true });
+    }
+    expect(object.accessor).toBe("g19999");
+});
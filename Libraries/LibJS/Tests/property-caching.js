@@ -0,0 +1,96 @@
+const create = prototype => Object.setPrototypeOf({}, prototype);
+const get = o => o.foo;
+const put = (o, value) => {
+    o.foo = value;
+};
+
+test("same access site with objects of different shapes", () => {
+    const objects = [{ foo: 1 }, { bar: 0, foo: 2 }, { baz: 0, bar: 0, foo: 3 }, { a: 0, foo: 4 }];
+    objects.push({ b: 0, foo: 5 }, { c: 0, foo: 6 }, create({ foo: 7 }), {});
+    for (let i = 0; i < 3; ++i) {
+        expect(objects.map(get)).toEqual([1, 2, 3, 4, 5, 6, 7, undefined]);
+        objects.forEach((o, j) => put(o, j + 10));
+        expect(objects.map(get)).toEqual([10, 11, 12, 13, 14, 15, 16, 17]);
+        objects.forEach((o, j) => put(o, j + 1));
+        delete objects[7].foo;
+    }
+});
+
+test("changes to the prototype chain", () => {
+    const base = {};
+    const proto = create(base);
+    const o = create(proto);
+    base.foo = 1;
+    expect(get(o)).toBe(1);
+    proto.foo = 2;
+    expect(get(o)).toBe(2);
+    delete proto.foo;
+    expect(get(o)).toBe(1);
+    Object.setPrototypeOf(o, { foo: 3 });
+    expect(get(o)).toBe(3);
+    Object.defineProperty(Object.getPrototypeOf(o), "foo", { get: () => 4 });
+    expect(get(o)).toBe(4);
+});
+
+test("own property turned into an accessor", () => {
+    const o = { foo: 1 };
+    expect(get(o)).toBe(1);
+    let stored;
+    Object.defineProperty(o, "foo", { get: () => 2, set: value => (stored = value) });
+    expect(get(o)).toBe(2);
+    put(o, 3);
+    expect(stored).toBe(3);
+});
+
+test("adding a property", () => {
+    function Point() {}
+    const a = new Point();
+    const b = new Point();
+    put(a, 1);
+    put(b, 2);
+    expect(get(a)).toBe(1);
+    expect(get(b)).toBe(2);
+
+    let stored;
+    Object.defineProperty(Point.prototype, "foo", { set: value => (stored = value) });
+    const c = new Point();
+    put(c, 3);
+    expect(stored).toBe(3);
+    expect(Object.getOwnPropertyNames(c)).toEqual([]);
+
+    const d = Object.preventExtensions(new Point());
+    put(new Point(), 4);
+    put(d, 5);
+    expect(Object.getOwnPropertyNames(d)).toEqual([]);
+});
+
+test("non-writable properties", () => {
+    const o = { foo: 1 };
+    put(o, 2);
+    Object.defineProperty(o, "foo", { writable: false });
+    put(o, 3);
+    expect(get(o)).toBe(2);
+});
+
+test("own data properties shadow setters on the prototype", () => {
+    let called = false;
+    const o = create({
+        set foo(value) {
+            called = true;
+        },
+    });
+    Object.defineProperty(o, "foo", { value: 1, writable: true });
+    put(o, 2);
+    expect(called).toBeFalse();
+    expect(get(o)).toBe(2);
+});
+
+test("constructor with a replaced prototype", () => {
+    function F() {}
+    const a = new F();
+    F.prototype = { foo: 1 };
+    const b = new F();
+    expect(get(a)).toBeUndefined();
+    expect(get(b)).toBe(1);
+    expect(Object.getPrototypeOf(b)).toBe(F.prototype);
+});
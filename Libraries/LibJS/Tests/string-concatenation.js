@@ -0,0 +1,50 @@
+test("strings built in a loop", () => {
+    let string = "";
+    for (let i = 0; i < 100000; ++i) string += "x";
+    expect(string.length).toBe(100000);
+    expect(string.charAt(99999)).toBe("x");
+    expect(string.indexOf("y")).toBe(-1);
+
+    let digits = "";
+    for (let i = 0; i < 10; ++i) digits = i + digits;
+    expect(digits).toBe("9876543210");
+});
+
+test("long concatenations compare equal to the same string built in one piece", () => {
+    const left = "abcdefghijklmnopqrstuvwxyz";
+    const right = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    const concatenated = left + right;
+    expect(concatenated).toBe("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ");
+    expect(concatenated === left.concat(right)).toBeTrue();
+    expect(concatenated < left + "z").toBeTrue();
+    expect(concatenated.length).toBe(52);
+});
+
+test("concatenations of non-strings", () => {
+    const object = { toString: () => "an object that is long enough to matter" };
+    expect("" + object + 1 + true + null).toBe("an object that is long enough to matter1truenull");
+    expect(1 + 2 + "three that is long enough to matter").toBe("3three that is long enough to matter");
+});
+
+test("template literals", () => {
+    let string = "";
+    for (let i = 0; i < 1000; ++i) string = `${string}${i % 10}`;
+    expect(string.length).toBe(1000);
+    expect(string.substring(0, 12)).toBe("012345678901");
+});
+
+test("long concatenations as property keys", () => {
+    const object = {};
+    const key = "a property name that is fairly long" + "!";
+    object[key] = 1;
+    expect(object["a property name that is fairly long!"]).toBe(1);
+    expect(Object.keys(object)).toEqual(["a property name that is fairly long!"]);
+});
+
+test("concatenations survive garbage collection", () => {
+    let string = "";
+    for (let i = 0; i < 1000; ++i) string += "part " + i + ", ";
+    gc();
+    expect(string.startsWith("part 0, part 1, ")).toBeTrue();
+    expect(string.endsWith("part 999, ")).toBeTrue();
+});
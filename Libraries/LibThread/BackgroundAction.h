@@ -28,33 +28,14 @@
 
 #include <AK/Function.h>
 #include <AK/NonnullRefPtr.h>
-#include <AK/Optional.h>
-#include <AK/Queue.h>
-#include <LibCore/Event.h>
-#include <LibCore/EventLoop.h>
 #include <LibCore/Object.h>
-#include <LibThread/Lock.h>
-#include <LibThread/Thread.h>
+#include <LibThread/Future.h>
+#include <LibThread/ThreadPool.h>
 
 namespace LibThread {
 
 template<typename Result>
-class BackgroundAction;
-
-class BackgroundActionBase {
-    template<typename Result>
-    friend class BackgroundAction;
-
-private:
-    BackgroundActionBase() { }
-
-    static Lockable<Queue<Function<void()>>>& all_actions();
-    static Thread& background_thread();
-};
-
-template<typename Result>
-class BackgroundAction final : public Core::Object
-    , private BackgroundActionBase {
+class BackgroundAction final : public Core::Object {
     C_OBJECT(BackgroundAction);
 
 public:
@@ -67,31 +48,23 @@ public:
 
     virtual ~BackgroundAction() { }
 
+    Future<Result>& future() { return *m_future; }
+
 private:
     BackgroundAction(Function<Result()> action, Function<void(Result)> on_complete)
-        : Core::Object(&background_thread())
-        , m_action(move(action))
-        , m_on_complete(move(on_complete))
+        : Core::Object(nullptr)
+        , m_future(ThreadPool::the().run(move(action)))
     {
-        LOCKER(all_actions().lock());
-
-        all_actions().resource().enqueue([this] {
-            m_result = m_action();
-            if (m_on_complete) {
-                Core::EventLoop::current().post_event(*this, make<Core::DeferredInvocationEvent>([this](auto&) {
-                    m_on_complete(m_result.release_value());
-                    this->remove_from_parent();
-                }));
-                Core::EventLoop::wake();
-            } else {
-                this->remove_from_parent();
-            }
-        });
+        // The future outlives us if need be, so on_complete is still called
+        // on this thread's event loop when nobody holds on to the action.
+        if (on_complete) {
+            m_future->on_complete = [on_complete = move(on_complete)](Result& result) {
+                on_complete(move(result));
+            };
+        }
     }
 
-    Function<Result()> m_action;
-    Function<void(Result)> m_on_complete;
-    Optional<Result> m_result;
+    NonnullRefPtr<Future<Result>> m_future;
 };
 
 }
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Function.h>
+#include <AK/Optional.h>
+#include <LibCore/Event.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Object.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+class ThreadPool;
+
+// The result of a job submitted with ThreadPool::run(). A future belongs to
+// the event loop of the thread that created it: on_complete is invoked there
+// once the job has finished, so it may safely touch that thread's state.
+// await() blocks the calling thread until the result is available instead.
+template<typename Result>
+class Future final : public Core::Object {
+    C_OBJECT(Future);
+    friend class ThreadPool;
+
+public:
+    virtual ~Future() override
+    {
+        pthread_cond_destroy(&m_condition);
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    Function<void(Result&)> on_complete;
+
+    bool is_resolved() const
+    {
+        pthread_mutex_lock(&m_mutex);
+        bool resolved = m_result.has_value();
+        pthread_mutex_unlock(&m_mutex);
+        return resolved;
+    }
+
+    Result& await()
+    {
+        pthread_mutex_lock(&m_mutex);
+        while (!m_result.has_value())
+            pthread_cond_wait(&m_condition, &m_mutex);
+        pthread_mutex_unlock(&m_mutex);
+        return m_result.value();
+    }
+
+private:
+    Future()
+        : Core::Object(nullptr)
+        , m_origin_event_loop(Core::EventLoop::current())
+    {
+        pthread_mutex_init(&m_mutex, nullptr);
+        pthread_cond_init(&m_condition, nullptr);
+    }
+
+    // Called on the worker thread that ran the job. The caller holds a reference
+    // on our behalf, which is dropped on the origin event loop after on_complete.
+    void resolve(Result&& result)
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_result = move(result);
+        pthread_cond_broadcast(&m_condition);
+        pthread_mutex_unlock(&m_mutex);
+
+        m_origin_event_loop.post_event(*this, make<Core::DeferredInvocationEvent>([this](auto&) {
+            if (on_complete)
+                on_complete(m_result.value());
+            unref();
+        }));
+        Core::EventLoop::wake();
+    }
+
+    Core::EventLoop& m_origin_event_loop;
+    mutable pthread_mutex_t m_mutex;
+    pthread_cond_t m_condition;
+    Optional<Result> m_result;
+};
+
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/MergeSort.h>
+#include <AK/NonnullRefPtrVector.h>
+#include <AK/Span.h>
+#include <AK/StdLibExtras.h>
+#include <AK/Vector.h>
+#include <AK/kmalloc.h>
+#include <LibThread/Thread.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+namespace Detail {
+
+// Below this many elements per thread, starting threads costs more than it saves.
+static constexpr size_t parallel_sort_min_elements_per_thread = 16384;
+
+inline size_t pick_thread_count(size_t element_count, size_t requested_thread_count)
+{
+    size_t thread_count = requested_thread_count;
+    if (thread_count == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processors > 0 ? processors : 1;
+    }
+    return max((size_t)1, min(thread_count, element_count / parallel_sort_min_elements_per_thread));
+}
+
+// Calls callback(0) ... callback(count - 1), each on its own thread. The
+// calling thread takes the first one, and returns once all are done.
+template<typename Callback>
+void run_in_parallel(size_t count, Callback callback)
+{
+    NonnullRefPtrVector<Thread> threads;
+    for (size_t i = 1; i < count; ++i) {
+        threads.append(Thread::construct([&callback, i] {
+            callback(i);
+            return 0;
+        },
+            "ParallelSort"));
+        threads.last().start();
+    }
+    if (count > 0)
+        callback(0);
+    for (auto& thread : threads)
+        [[maybe_unused]] auto result = thread.join();
+}
+
+// Returns how many of the first `diagonal` elements of the stable merge of
+// `left` and `right` come from `left`.
+template<typename T, typename LessThan>
+size_t merge_split_point(size_t diagonal, T* left, size_t left_size, T* right, size_t right_size, LessThan& less_than)
+{
+    size_t low = diagonal > right_size ? diagonal - right_size : 0;
+    size_t high = min(diagonal, left_size);
+    while (low < high) {
+        size_t i = low + (high - low) / 2;
+        size_t j = diagonal - i;
+        // Ties are taken from the left, so left[i] is part of the prefix unless right[j - 1] is strictly smaller.
+        if (j > 0 && i < left_size && !less_than(right[j - 1], left[i]))
+            low = i + 1;
+        else
+            high = i;
+    }
+    return low;
+}
+
+}
+
+/* Sorts `values` by sorting one chunk per thread with merge_sort() and then
+ * merging the sorted chunks pairwise, with each merge split across threads as
+ * well. The sort is stable. `less_than` is called from several threads at
+ * once, so it must not modify any shared state. Passing 0 as `thread_count`
+ * uses one thread per online processor; small inputs are sorted on the
+ * calling thread.
+ */
+template<typename T, typename LessThan>
+void parallel_sort(Span<T> values, LessThan less_than, size_t thread_count = 0)
+{
+    size_t size = values.size();
+    thread_count = Detail::pick_thread_count(size, thread_count);
+    if (thread_count == 1) {
+        merge_sort(values, less_than);
+        return;
+    }
+
+    Vector<size_t> runs;
+    for (size_t i = 0; i < thread_count; ++i)
+        runs.append(size * i / thread_count);
+    runs.append(size);
+
+    Detail::run_in_parallel(thread_count, [&](size_t chunk) {
+        auto part = values.slice(runs[chunk], runs[chunk + 1] - runs[chunk]);
+        merge_sort(part, less_than);
+    });
+
+    struct MergeJob {
+        size_t left_start;
+        size_t left_end;
+        size_t right_start;
+        size_t right_end;
+        size_t out_start;
+    };
+
+    // The merge rounds alternate between `values` and `buffer`. The buffer starts out
+    // as raw memory, so the first round moves elements into it by construction.
+    T* buffer = static_cast<T*>(kmalloc(sizeof(T) * size));
+    bool buffer_initialized = false;
+    T* source = values.data();
+    T* destination = buffer;
+
+    while (runs.size() > 2) {
+        size_t run_count = runs.size() - 1;
+        Vector<size_t> merged_runs;
+        Vector<MergeJob> jobs;
+        for (size_t run = 0; run < run_count; run += 2) {
+            size_t left_start = runs[run];
+            size_t right_start = runs[min(run + 1, run_count)];
+            size_t right_end = runs[min(run + 2, run_count)];
+            size_t left_size = right_start - left_start;
+            size_t right_size = right_end - right_start;
+            merged_runs.append(left_start);
+
+            // Split the merge into pieces of about equal output size. The split points
+            // are found up front, since the pieces move elements out of `source` as
+            // soon as they start running.
+            size_t pieces = max((size_t)1, (right_end - left_start) * thread_count / size);
+            size_t previous_left = 0;
+            size_t previous_right = 0;
+            for (size_t piece = 1; piece <= pieces; ++piece) {
+                size_t diagonal = (left_size + right_size) * piece / pieces;
+                size_t left = Detail::merge_split_point(diagonal, source + left_start, left_size, source + right_start, right_size, less_than);
+                size_t right = diagonal - left;
+                jobs.append({ left_start + previous_left, left_start + left, right_start + previous_right, right_start + right, left_start + previous_left + previous_right });
+                previous_left = left;
+                previous_right = right;
+            }
+        }
+        merged_runs.append(size);
+
+        bool construct = destination == buffer && !buffer_initialized;
+        size_t worker_count = min(thread_count, jobs.size());
+        Detail::run_in_parallel(worker_count, [&](size_t worker) {
+            for (size_t job_index = worker; job_index < jobs.size(); job_index += worker_count) {
+                auto& job = jobs[job_index];
+                size_t left = job.left_start;
+                size_t right = job.right_start;
+                size_t out = job.out_start;
+                while (left < job.left_end || right < job.right_end) {
+                    T* next;
+                    if (left < job.left_end && (right == job.right_end || !less_than(source[right], source[left])))
+                        next = &source[left++];
+                    else
+                        next = &source[right++];
+                    if (construct)
+                        new (&destination[out++]) T(move(*next));
+                    else
+                        destination[out++] = move(*next);
+                }
+            }
+        });
+
+        buffer_initialized = true;
+        swap(source, destination);
+        runs = move(merged_runs);
+    }
+
+    Detail::run_in_parallel(thread_count, [&](size_t chunk) {
+        size_t start = size * chunk / thread_count;
+        size_t end = size * (chunk + 1) / thread_count;
+        for (size_t i = start; i < end; ++i) {
+            if (source == buffer)
+                values[i] = move(buffer[i]);
+            buffer[i].~T();
+        }
+    });
+    kfree(buffer);
+}
+
+template<typename T, typename LessThan>
+void parallel_sort(Vector<T>& values, LessThan less_than, size_t thread_count = 0)
+{
+    parallel_sort(values.span(), move(less_than), thread_count);
+}
+
+// There is deliberately no thread count here: parallel_sort(values, 4) would pick the overload
+// above, with 4 as the comparator.
+template<typename T>
+void parallel_sort(Vector<T>& values)
+{
+    parallel_sort(values.span(), [](auto& a, auto& b) { return a < b; });
+}
+
+/* Moves the elements for which `predicate` returns true in front of the ones
+ * for which it returns false, keeping the relative order within both groups,
+ * and returns the number of elements in the first group. The predicate is
+ * called exactly once per element, from several threads at once.
+ */
+template<typename T, typename Predicate>
+size_t parallel_partition(Span<T> values, Predicate predicate, size_t thread_count = 0)
+{
+    size_t size = values.size();
+    thread_count = Detail::pick_thread_count(size, thread_count);
+
+    Vector<size_t> chunks;
+    for (size_t i = 0; i <= thread_count; ++i)
+        chunks.append(size * i / thread_count);
+
+    Vector<u8> matches;
+    matches.resize(size);
+    Vector<size_t> match_counts;
+    match_counts.resize(thread_count);
+    Detail::run_in_parallel(thread_count, [&](size_t chunk) {
+        size_t count = 0;
+        for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; ++i) {
+            matches[i] = predicate(values[i]);
+            count += matches[i];
+        }
+        match_counts[chunk] = count;
+    });
+
+    size_t total_matches = 0;
+    for (auto count : match_counts)
+        total_matches += count;
+
+    T* buffer = static_cast<T*>(kmalloc(sizeof(T) * size));
+    Detail::run_in_parallel(thread_count, [&](size_t chunk) {
+        // Matches from this chunk go after the ones from all previous chunks, and
+        // likewise for the non-matches, which start right after the last match.
+        size_t match_offset = 0;
+        for (size_t i = 0; i < chunk; ++i)
+            match_offset += match_counts[i];
+        size_t mismatch_offset = total_matches + chunks[chunk] - match_offset;
+        for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; ++i) {
+            size_t index = matches[i] ? match_offset++ : mismatch_offset++;
+            new (&buffer[index]) T(move(values[i]));
+        }
+    });
+
+    Detail::run_in_parallel(thread_count, [&](size_t chunk) {
+        for (size_t i = chunks[chunk]; i < chunks[chunk + 1]; ++i) {
+            values[i] = move(buffer[i]);
+            buffer[i].~T();
+        }
+    });
+    kfree(buffer);
+
+    return total_matches;
+}
+
+template<typename T, typename Predicate>
+size_t parallel_partition(Vector<T>& values, Predicate predicate, size_t thread_count = 0)
+{
+    return parallel_partition(values.span(), move(predicate), thread_count);
+}
+
+}
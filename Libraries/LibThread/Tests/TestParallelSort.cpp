@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibThread/ParallelSort.h>
+
+// Enough elements that asking for several threads actually gets them.
+static constexpr size_t element_count = 100'003;
+
+struct Entry {
+    u32 key;
+    size_t original_index;
+};
+
+static Vector<Entry> make_entries(u32 distinct_keys)
+{
+    Vector<Entry> entries;
+    entries.ensure_capacity(element_count);
+    u32 state = 12345;
+    for (size_t i = 0; i < element_count; ++i) {
+        state = state * 1103515245 + 12345;
+        entries.append({ (state >> 8) % distinct_keys, i });
+    }
+    return entries;
+}
+
+static bool is_sorted_and_stable(const Vector<Entry>& entries)
+{
+    for (size_t i = 1; i < entries.size(); ++i) {
+        if (entries[i - 1].key > entries[i].key)
+            return false;
+        if (entries[i - 1].key == entries[i].key && entries[i - 1].original_index > entries[i].original_index)
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE(uses_several_threads)
+{
+    EXPECT_EQ(LibThread::Detail::pick_thread_count(element_count, 2), 2u);
+    EXPECT_EQ(LibThread::Detail::pick_thread_count(element_count, 3), 3u);
+    EXPECT_EQ(LibThread::Detail::pick_thread_count(element_count, 4), 4u);
+    EXPECT_EQ(LibThread::Detail::pick_thread_count(100, 4), 1u);
+}
+
+TEST_CASE(sort_is_sorted_and_stable)
+{
+    // An odd thread count leaves a run without a partner in the first merge round.
+    for (size_t thread_count : { 2, 3, 4, 5 }) {
+        auto entries = make_entries(1000);
+        LibThread::parallel_sort(
+            entries, [](auto& a, auto& b) { return a.key < b.key; }, thread_count);
+        EXPECT_EQ(entries.size(), element_count);
+        EXPECT(is_sorted_and_stable(entries));
+    }
+}
+
+TEST_CASE(sort_with_many_equal_keys)
+{
+    auto entries = make_entries(3);
+    LibThread::parallel_sort(
+        entries, [](auto& a, auto& b) { return a.key < b.key; }, 4);
+    EXPECT(is_sorted_and_stable(entries));
+}
+
+TEST_CASE(sort_already_sorted_and_reversed)
+{
+    Vector<int> ascending;
+    Vector<int> descending;
+    for (size_t i = 0; i < element_count; ++i) {
+        ascending.append(i);
+        descending.append(element_count - i - 1);
+    }
+    auto less_than = [](int a, int b) { return a < b; };
+    LibThread::parallel_sort(ascending, less_than, 4);
+    LibThread::parallel_sort(descending, less_than, 4);
+    for (size_t i = 0; i < element_count; ++i) {
+        EXPECT_EQ(ascending[i], (int)i);
+        EXPECT_EQ(descending[i], (int)i);
+    }
+}
+
+TEST_CASE(sort_non_trivial_type)
+{
+    Vector<String> strings;
+    for (size_t i = 0; i < element_count; ++i)
+        strings.append(String::format("%08zu", (i * 7919) % element_count));
+    LibThread::parallel_sort(
+        strings, [](auto& a, auto& b) { return a < b; }, 3);
+    for (size_t i = 0; i < element_count; ++i)
+        EXPECT_EQ(strings[i], String::format("%08zu", i));
+}
+
+TEST_CASE(partition_is_stable)
+{
+    for (size_t thread_count : { 2, 3, 4 }) {
+        auto entries = make_entries(1000);
+        size_t expected_matches = 0;
+        for (auto& entry : entries)
+            expected_matches += entry.key % 3 == 0;
+
+        size_t matches = LibThread::parallel_partition(
+            entries, [](auto& entry) { return entry.key % 3 == 0; }, thread_count);
+        EXPECT_EQ(matches, expected_matches);
+        EXPECT_EQ(entries.size(), element_count);
+
+        bool all_in_place = true;
+        bool stable = true;
+        for (size_t i = 0; i < entries.size(); ++i) {
+            if ((entries[i].key % 3 == 0) != (i < matches))
+                all_in_place = false;
+            if (i > 0 && i != matches && entries[i - 1].original_index > entries[i].original_index)
+                stable = false;
+        }
+        EXPECT(all_in_place);
+        EXPECT(stable);
+    }
+}
+
+TEST_CASE(partition_with_no_or_all_matches)
+{
+    auto entries = make_entries(1000);
+    EXPECT_EQ(LibThread::parallel_partition(
+                  entries, [](auto&) { return false; }, 4),
+        0u);
+    for (size_t i = 0; i < entries.size(); ++i)
+        EXPECT_EQ(entries[i].original_index, i);
+
+    EXPECT_EQ(LibThread::parallel_partition(
+                  entries, [](auto&) { return true; }, 4),
+        element_count);
+    for (size_t i = 0; i < entries.size(); ++i)
+        EXPECT_EQ(entries[i].original_index, i);
+}
+
+TEST_MAIN(ParallelSort)
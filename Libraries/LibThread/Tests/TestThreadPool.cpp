@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Atomic.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/EventLoop.h>
+#include <LibThread/ThreadPool.h>
+#include <pthread.h>
+#include <sched.h>
+
+using LibThread::ThreadPool;
+
+// The main event loop can't be replaced once it's gone, so all tests share this one.
+static Core::EventLoop& event_loop()
+{
+    static Core::EventLoop* s_event_loop;
+    if (!s_event_loop)
+        s_event_loop = new Core::EventLoop;
+    return *s_event_loop;
+}
+
+TEST_CASE(submitted_jobs_all_run)
+{
+    Atomic<size_t> ran_count { 0 };
+    {
+        ThreadPool pool(4);
+        EXPECT_EQ(pool.thread_count(), 4u);
+        for (size_t i = 0; i < 1000; ++i)
+            pool.submit([&] { ++ran_count; });
+        while (ran_count.load() < 1000)
+            sched_yield();
+    }
+    EXPECT_EQ(ran_count.load(), 1000u);
+}
+
+TEST_CASE(jobs_submitted_from_jobs_run)
+{
+    Atomic<size_t> ran_count { 0 };
+    ThreadPool pool(3);
+    for (size_t i = 0; i < 10; ++i) {
+        pool.submit([&] {
+            for (size_t j = 0; j < 100; ++j)
+                pool.submit([&] { ++ran_count; });
+        });
+    }
+    while (ran_count.load() < 1000)
+        sched_yield();
+    EXPECT_EQ(ran_count.load(), 1000u);
+}
+
+TEST_CASE(future_completes_on_origin_event_loop)
+{
+    auto& loop = event_loop();
+    ThreadPool pool(2);
+    auto origin_thread = pthread_self();
+
+    size_t completed_count = 0;
+    bool completed_on_origin_thread = true;
+    Vector<NonnullRefPtr<LibThread::Future<int>>> futures;
+    for (int i = 0; i < 10; ++i) {
+        auto future = pool.run<int>([i] { return i * i; });
+        future->on_complete = [&, i](int& result) {
+            EXPECT_EQ(result, i * i);
+            if (!pthread_equal(pthread_self(), origin_thread))
+                completed_on_origin_thread = false;
+            if (++completed_count == 10)
+                loop.quit(0);
+        };
+        futures.append(move(future));
+    }
+    loop.exec();
+    loop.unquit();
+
+    EXPECT_EQ(completed_count, 10u);
+    EXPECT(completed_on_origin_thread);
+    for (int i = 0; i < 10; ++i) {
+        EXPECT(futures[i]->is_resolved());
+        EXPECT_EQ(futures[i]->await(), i * i);
+    }
+}
+
+TEST_CASE(future_await)
+{
+    auto& loop = event_loop();
+    ThreadPool pool(1);
+    auto future = pool.run<String>([] { return String("done"); });
+    EXPECT_EQ(future->await(), "done");
+
+    // The completion is still delivered, and releases the pool's reference to the future.
+    bool completed = false;
+    future->on_complete = [&](auto&) {
+        completed = true;
+        loop.quit(0);
+    };
+    loop.exec();
+    loop.unquit();
+    EXPECT(completed);
+}
+
+static ThreadPool* s_pools_seen[8];
+
+static void* get_the_pool(void* argument)
+{
+    s_pools_seen[(FlatPtr)argument] = &ThreadPool::the();
+    return nullptr;
+}
+
+TEST_CASE(the_pool_is_created_once)
+{
+    pthread_t threads[8];
+    for (size_t i = 0; i < 8; ++i)
+        pthread_create(&threads[i], nullptr, get_the_pool, (void*)(FlatPtr)i);
+    for (auto& thread : threads)
+        pthread_join(thread, nullptr);
+    for (auto* pool : s_pools_seen)
+        EXPECT_EQ(pool, &ThreadPool::the());
+}
+
+TEST_MAIN(ThreadPool)
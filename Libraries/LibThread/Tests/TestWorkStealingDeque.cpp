@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/TestSuite.h>
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibThread/WorkStealingDeque.h>
+#include <pthread.h>
+#include <sched.h>
+
+using LibThread::WorkStealingDeque;
+
+TEST_CASE(pop_is_lifo_and_steal_is_fifo)
+{
+    WorkStealingDeque<size_t> deque;
+    EXPECT(deque.is_empty());
+    EXPECT(!deque.pop().has_value());
+    EXPECT(!deque.steal().has_value());
+
+    for (size_t i = 0; i < 4; ++i)
+        deque.push(i);
+    EXPECT(!deque.is_empty());
+    EXPECT_EQ(deque.pop().value(), 3u);
+    EXPECT_EQ(deque.steal().value(), 0u);
+    EXPECT_EQ(deque.pop().value(), 2u);
+    EXPECT_EQ(deque.steal().value(), 1u);
+    EXPECT(deque.is_empty());
+    EXPECT(!deque.pop().has_value());
+    EXPECT(!deque.steal().has_value());
+}
+
+TEST_CASE(grows_past_initial_capacity)
+{
+    WorkStealingDeque<size_t> deque(4);
+    for (size_t i = 0; i < 100; ++i)
+        deque.push(i);
+    for (size_t i = 0; i < 10; ++i)
+        EXPECT_EQ(deque.steal().value(), i);
+    for (size_t i = 100; i < 200; ++i)
+        deque.push(i);
+    for (size_t i = 200; i > 10; --i)
+        EXPECT_EQ(deque.pop().value(), i - 1);
+    EXPECT(deque.is_empty());
+}
+
+// The owner popping and a thief stealing the very last element is the one place where the
+// two ends meet. Exactly one of them has to get it.
+static constexpr size_t last_element_rounds = 20'000;
+static WorkStealingDeque<size_t> s_last_element_deque;
+static Atomic<size_t> s_round_started { 0 };
+static Atomic<size_t> s_round_finished { 0 };
+static Atomic<size_t> s_stolen_count { 0 };
+
+static void* last_element_thief(void*)
+{
+    for (size_t round = 1; round <= last_element_rounds; ++round) {
+        while (s_round_started.load() != round)
+            sched_yield();
+        if (auto value = s_last_element_deque.steal(); value.has_value()) {
+            if (value.value() == round)
+                ++s_stolen_count;
+        }
+        s_round_finished.store(round);
+    }
+    return nullptr;
+}
+
+TEST_CASE(owner_and_thief_race_for_last_element)
+{
+    pthread_t thief;
+    pthread_create(&thief, nullptr, last_element_thief, nullptr);
+
+    size_t popped_count = 0;
+    size_t lost_count = 0;
+    size_t duplicate_count = 0;
+    for (size_t round = 1; round <= last_element_rounds; ++round) {
+        s_last_element_deque.push(round);
+        size_t stolen_before = s_stolen_count.load();
+        s_round_started.store(round);
+        auto value = s_last_element_deque.pop();
+        while (s_round_finished.load() != round)
+            sched_yield();
+        bool stolen = s_stolen_count.load() != stolen_before;
+        if (value.has_value()) {
+            EXPECT_EQ(value.value(), round);
+            ++popped_count;
+        }
+        if (value.has_value() && stolen)
+            ++duplicate_count;
+        if (!value.has_value() && !stolen)
+            ++lost_count;
+        EXPECT(s_last_element_deque.is_empty());
+    }
+    pthread_join(thief, nullptr);
+
+    EXPECT_EQ(duplicate_count, 0u);
+    EXPECT_EQ(lost_count, 0u);
+    EXPECT_EQ(popped_count + s_stolen_count.load(), last_element_rounds);
+}
+
+// The owner keeps pushing and popping while several thieves steal. Every item must be taken
+// exactly once.
+static constexpr size_t thief_count = 3;
+static constexpr size_t stress_item_count = 200'000;
+static WorkStealingDeque<size_t> s_stress_deque(16);
+static Atomic<u8> s_taken[stress_item_count];
+static Atomic<size_t> s_taken_count { 0 };
+static Atomic<bool> s_taken_twice { false };
+
+static void take(size_t item)
+{
+    if (s_taken[item].exchange(1) != 0)
+        s_taken_twice = true;
+    ++s_taken_count;
+}
+
+static void* stress_thief(void*)
+{
+    while (s_taken_count.load() < stress_item_count) {
+        if (auto item = s_stress_deque.steal(); item.has_value())
+            take(item.value());
+        else
+            sched_yield();
+    }
+    return nullptr;
+}
+
+TEST_CASE(stress_owner_and_thieves)
+{
+    pthread_t thieves[thief_count];
+    for (auto& thief : thieves)
+        pthread_create(&thief, nullptr, stress_thief, nullptr);
+
+    for (size_t item = 0; item < stress_item_count; ++item) {
+        s_stress_deque.push(item);
+        // Pop every third item right away, so that both ends stay busy.
+        if (item % 3 == 0) {
+            if (auto popped = s_stress_deque.pop(); popped.has_value())
+                take(popped.value());
+        }
+    }
+    while (!s_stress_deque.is_empty()) {
+        if (auto item = s_stress_deque.pop(); item.has_value())
+            take(item.value());
+    }
+
+    for (auto& thief : thieves)
+        pthread_join(thief, nullptr);
+
+    EXPECT_EQ(s_taken_count.load(), stress_item_count);
+    EXPECT(!s_taken_twice.load());
+    EXPECT(s_stress_deque.is_empty());
+}
+
+TEST_MAIN(WorkStealingDeque)
@@ -29,6 +29,8 @@
 #include <string.h>
 #include <unistd.h>
 
+//#define THREAD_DEBUG
+
 LibThread::Thread::Thread(Function<int()> action, StringView thread_name)
     : Core::Object(nullptr)
     , m_action(move(action))
@@ -53,16 +55,19 @@ void LibThread::Thread::start()
         nullptr,
         [](void* arg) -> void* {
             Thread* self = static_cast<Thread*>(arg);
+            // The thread names itself, since it may already be gone by the time
+            // pthread_create() returns to the creating thread.
+            if (!self->m_thread_name.is_empty()) {
+                int rc = pthread_setname_np(pthread_self(), self->m_thread_name.characters());
+                ASSERT(rc == 0);
+            }
             int exit_code = self->m_action();
-            self->m_tid = 0;
-            return (void*)exit_code;
+            return (void*)(FlatPtr)exit_code;
         },
         static_cast<void*>(this));
 
     ASSERT(rc == 0);
-    if (!m_thread_name.is_empty()) {
-        rc = pthread_setname_np(m_tid, m_thread_name.characters());
-        ASSERT(rc == 0);
-    }
+#ifdef THREAD_DEBUG
     dbgln("Started thread \"{}\", tid = {}", m_thread_name, m_tid);
+#endif
 }
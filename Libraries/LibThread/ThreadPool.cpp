@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/NonnullRefPtr.h>
+#include <LibThread/Thread.h>
+#include <LibThread/ThreadPool.h>
+#include <LibThread/WorkStealingDeque.h>
+#include <unistd.h>
+
+namespace LibThread {
+
+struct ThreadPool::Worker {
+    explicit Worker(u32 seed)
+        : random_state(seed)
+    {
+    }
+
+    WorkStealingDeque<Job*> deque;
+    RefPtr<Thread> thread;
+    ThreadPool* pool { nullptr };
+    u32 random_state;
+};
+
+__thread ThreadPool::Worker* ThreadPool::s_current_worker;
+
+static ThreadPool* s_the;
+static pthread_once_t s_the_once = PTHREAD_ONCE_INIT;
+
+ThreadPool& ThreadPool::the()
+{
+    // The first calls may come from several threads at once. The pool is never destroyed,
+    // so that exiting doesn't have to wait for the workers.
+    pthread_once(&s_the_once, [] {
+        s_the = new ThreadPool;
+    });
+    return *s_the;
+}
+
+ThreadPool::ThreadPool(size_t thread_count, const String& name)
+{
+    if (thread_count == 0) {
+        long processors = sysconf(_SC_NPROCESSORS_ONLN);
+        thread_count = processors > 0 ? processors : 1;
+    }
+
+    pthread_mutex_init(&m_mutex, nullptr);
+    pthread_cond_init(&m_condition, nullptr);
+
+    // All workers have to exist before any of them starts looking for someone to steal from.
+    for (size_t i = 0; i < thread_count; ++i) {
+        m_workers.append(make<Worker>(0x9e3779b9 * (i + 1)));
+        m_workers.last().pool = this;
+    }
+    for (auto& worker : m_workers) {
+        worker.thread = Thread::construct([this, &worker] {
+            worker_main(worker);
+            return 0;
+        },
+            name);
+        worker.thread->start();
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    pthread_mutex_lock(&m_mutex);
+    m_stopping = true;
+    pthread_cond_broadcast(&m_condition);
+    pthread_mutex_unlock(&m_mutex);
+
+    for (auto& worker : m_workers)
+        [[maybe_unused]] auto result = worker.thread->join();
+
+    // Jobs that never got to run are dropped.
+    for (auto& worker : m_workers) {
+        while (!worker.deque.is_empty())
+            delete worker.deque.pop().value();
+    }
+    while (!m_injected_jobs.is_empty())
+        delete m_injected_jobs.dequeue();
+
+    pthread_cond_destroy(&m_condition);
+    pthread_mutex_destroy(&m_mutex);
+}
+
+void ThreadPool::submit(Function<void()> function)
+{
+    auto* job = new Job(move(function));
+    if (s_current_worker && s_current_worker->pool == this) {
+        s_current_worker->deque.push(job);
+    } else {
+        pthread_mutex_lock(&m_mutex);
+        m_injected_jobs.enqueue(job);
+        ++m_injected_job_count;
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    // Pairs with the increment in wait_for_jobs(): either the sleeper sees the new
+    // job before going to sleep, or we see the sleeper and wake it up.
+    AK::atomic_thread_fence(AK::memory_order_seq_cst);
+    if (m_sleeping_worker_count.load() > 0) {
+        pthread_mutex_lock(&m_mutex);
+        pthread_cond_signal(&m_condition);
+        pthread_mutex_unlock(&m_mutex);
+    }
+}
+
+void ThreadPool::worker_main(Worker& worker)
+{
+    s_current_worker = &worker;
+    while (!m_stopping) {
+        if (auto* job = find_job(worker)) {
+            (*job)();
+            delete job;
+            continue;
+        }
+        wait_for_jobs();
+    }
+    s_current_worker = nullptr;
+}
+
+ThreadPool::Job* ThreadPool::find_job(Worker& worker)
+{
+    if (auto job = worker.deque.pop(); job.has_value())
+        return job.value();
+
+    if (m_injected_job_count.load(AK::memory_order_relaxed) > 0) {
+        Job* job = nullptr;
+        pthread_mutex_lock(&m_mutex);
+        if (!m_injected_jobs.is_empty()) {
+            job = m_injected_jobs.dequeue();
+            --m_injected_job_count;
+        }
+        pthread_mutex_unlock(&m_mutex);
+        if (job)
+            return job;
+    }
+
+    // Start at a random victim, so that thieves spread out instead of all
+    // going after the first worker.
+    worker.random_state ^= worker.random_state << 13;
+    worker.random_state ^= worker.random_state >> 17;
+    worker.random_state ^= worker.random_state << 5;
+    size_t first_victim = worker.random_state % m_workers.size();
+    for (size_t i = 0; i < m_workers.size(); ++i) {
+        auto& victim = m_workers[(first_victim + i) % m_workers.size()];
+        if (&victim == &worker)
+            continue;
+        if (auto job = victim.deque.steal(); job.has_value())
+            return job.value();
+    }
+    return nullptr;
+}
+
+bool ThreadPool::has_pending_jobs() const
+{
+    if (m_injected_job_count.load() > 0)
+        return true;
+    for (auto& worker : m_workers) {
+        if (!worker.deque.is_empty())
+            return true;
+    }
+    return false;
+}
+
+void ThreadPool::wait_for_jobs()
+{
+    pthread_mutex_lock(&m_mutex);
+    ++m_sleeping_worker_count;
+    while (!m_stopping && !has_pending_jobs())
+        pthread_cond_wait(&m_condition, &m_mutex);
+    --m_sleeping_worker_count;
+    pthread_mutex_unlock(&m_mutex);
+}
+
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Function.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Queue.h>
+#include <AK/String.h>
+#include <LibThread/Future.h>
+#include <pthread.h>
+
+namespace LibThread {
+
+// A fixed set of worker threads with one work-stealing deque each. Jobs
+// submitted from a worker go onto that worker's own deque, so that work a job
+// spawns stays warm in its cache; jobs from other threads go through a shared
+// queue. Idle workers take from the shared queue, then steal from the other
+// workers, and sleep once there is nothing left anywhere.
+class ThreadPool {
+    AK_MAKE_NONCOPYABLE(ThreadPool);
+    AK_MAKE_NONMOVABLE(ThreadPool);
+
+public:
+    // The shared pool, with one worker per online processor.
+    static ThreadPool& the();
+
+    explicit ThreadPool(size_t thread_count = 0, const String& name = "ThreadPool");
+    ~ThreadPool();
+
+    size_t thread_count() const { return m_workers.size(); }
+
+    void submit(Function<void()>);
+
+    // Runs `action` on the pool. The calling thread must have an event loop,
+    // since that is where the future's on_complete will be invoked.
+    template<typename Result>
+    NonnullRefPtr<Future<Result>> run(Function<Result()> action)
+    {
+        auto future = Future<Result>::construct();
+        // Keeps the future alive until it has been resolved and the completion
+        // has been delivered, even if the caller lets go of it.
+        future->ref();
+        submit([future = future.ptr(), action = move(action)] {
+            future->resolve(action());
+        });
+        return future;
+    }
+
+private:
+    struct Worker;
+    using Job = Function<void()>;
+
+    void worker_main(Worker&);
+    Job* find_job(Worker&);
+    bool has_pending_jobs() const;
+    void wait_for_jobs();
+
+    static __thread Worker* s_current_worker;
+
+    NonnullOwnPtrVector<Worker> m_workers;
+    Queue<Job*> m_injected_jobs;
+    Atomic<size_t> m_injected_job_count { 0 };
+    Atomic<size_t> m_sleeping_worker_count { 0 };
+    Atomic<bool> m_stopping { false };
+    mutable pthread_mutex_t m_mutex;
+    pthread_cond_t m_condition;
+};
+
+}
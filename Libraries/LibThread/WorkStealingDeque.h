@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#pragma once
+
+#include <AK/Assertions.h>
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/NumericLimits.h>
+#include <AK/NonnullOwnPtrVector.h>
+#include <AK/Optional.h>
+#include <AK/Types.h>
+
+namespace LibThread {
+
+// A Chase-Lev work-stealing deque of pointers. The owning thread pushes and
+// pops at the bottom, like a stack, while any other thread may steal from the
+// top. Only the owner ever allocates; buffers outgrown while a thief might
+// still be reading them are kept around until the deque is destroyed.
+template<typename T>
+class WorkStealingDeque {
+    AK_MAKE_NONCOPYABLE(WorkStealingDeque);
+    AK_MAKE_NONMOVABLE(WorkStealingDeque);
+
+public:
+    explicit WorkStealingDeque(size_t initial_capacity = 64)
+        : m_buffer(new Buffer(initial_capacity))
+    {
+    }
+
+    ~WorkStealingDeque()
+    {
+        delete m_buffer.load(AK::memory_order_relaxed);
+    }
+
+    // Must only be called by the owning thread.
+    void push(T value)
+    {
+        size_t bottom = m_bottom.load(AK::memory_order_relaxed);
+        size_t top = m_top.load(AK::memory_order_acquire);
+        auto* buffer = m_buffer.load(AK::memory_order_relaxed);
+        if (bottom - top >= buffer->capacity())
+            buffer = grow(buffer, top, bottom);
+        buffer->put(bottom, value);
+        m_bottom.store(bottom + 1, AK::memory_order_release);
+    }
+
+    // Must only be called by the owning thread.
+    Optional<T> pop()
+    {
+        size_t bottom = m_bottom.load(AK::memory_order_relaxed) - 1;
+        auto* buffer = m_buffer.load(AK::memory_order_relaxed);
+        m_bottom.store(bottom, AK::memory_order_relaxed);
+        AK::atomic_thread_fence(AK::memory_order_seq_cst);
+        size_t top = m_top.load(AK::memory_order_relaxed);
+
+        ssize_t remaining = bottom - top;
+        if (remaining < 0) {
+            m_bottom.store(bottom + 1, AK::memory_order_relaxed);
+            return {};
+        }
+
+        T value = buffer->get(bottom);
+        if (remaining > 0)
+            return value;
+
+        // This was the last element, so a thief may be going for it as well.
+        bool won = m_top.compare_exchange_strong(top, top + 1, AK::memory_order_seq_cst);
+        m_bottom.store(bottom + 1, AK::memory_order_relaxed);
+        if (!won)
+            return {};
+        return value;
+    }
+
+    // May be called from any thread. Returns nothing if the deque is empty, or
+    // if another thread took the element first.
+    Optional<T> steal()
+    {
+        size_t top = m_top.load(AK::memory_order_acquire);
+        AK::atomic_thread_fence(AK::memory_order_seq_cst);
+        size_t bottom = m_bottom.load(AK::memory_order_acquire);
+        if ((ssize_t)(bottom - top) <= 0)
+            return {};
+
+        auto* buffer = m_buffer.load(AK::memory_order_acquire);
+        T value = buffer->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, AK::memory_order_seq_cst))
+            return {};
+        return value;
+    }
+
+    // Only a snapshot when other threads are pushing or stealing.
+    bool is_empty() const
+    {
+        size_t bottom = m_bottom.load(AK::memory_order_acquire);
+        size_t top = m_top.load(AK::memory_order_acquire);
+        return (ssize_t)(bottom - top) <= 0;
+    }
+
+private:
+    class Buffer {
+        AK_MAKE_NONCOPYABLE(Buffer);
+        AK_MAKE_NONMOVABLE(Buffer);
+
+    public:
+        explicit Buffer(size_t capacity)
+            : m_mask(capacity - 1)
+        {
+            ASSERT(capacity && !(capacity & m_mask));
+            ASSERT(capacity <= NumericLimits<ssize_t>::max() / sizeof(Atomic<T>));
+            m_slots = new Atomic<T>[capacity];
+        }
+
+        ~Buffer() { delete[] m_slots; }
+
+        size_t capacity() const { return m_mask + 1; }
+        T get(size_t index) const { return m_slots[index & m_mask].load(AK::memory_order_relaxed); }
+        void put(size_t index, T value) { m_slots[index & m_mask].store(value, AK::memory_order_relaxed); }
+
+    private:
+        size_t m_mask;
+        Atomic<T>* m_slots { nullptr };
+    };
+
+    Buffer* grow(Buffer* buffer, size_t top, size_t bottom)
+    {
+        auto* new_buffer = new Buffer(buffer->capacity() * 2);
+        for (size_t i = top; i != bottom; ++i)
+            new_buffer->put(i, buffer->get(i));
+        m_retired_buffers.append(adopt_own(*buffer));
+        m_buffer.store(new_buffer, AK::memory_order_release);
+        return new_buffer;
+    }
+
+    Atomic<size_t> m_top { 0 };
+    Atomic<size_t> m_bottom { 0 };
+    Atomic<Buffer*> m_buffer;
+    NonnullOwnPtrVector<Buffer> m_retired_buffers;
+};
+
+}
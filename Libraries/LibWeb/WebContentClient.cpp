@@ -42,6 +42,7 @@ void WebContentClient::handshake()
     auto response = send_sync<Messages::WebContentServer::Greet>(getpid());
     set_my_client_id(response->client_id());
     set_server_pid(response->server_pid());
+    offer_message_ring();
 }
 
 void WebContentClient::handle(const Messages::WebContentClient::DidPaint& message)
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibCore/ArgsParser.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <stdio.h>
+#include <time.h>
+
+// Runs the Array.prototype functions that have fast paths for packed arrays (see ElementKind
+// in LibJS/Runtime/IndexedProperties.h) over arrays of a few thousand elements.
+
+struct Script {
+    const char* name;
+    const char* source;
+};
+
+static const Script s_scripts[] = {
+    { "push-pop",
+        "const a = [];"
+        "for (let round = 0; round < 10; ++round) {"
+        "    for (let i = 0; i < 20000; ++i) a.push(i);"
+        "    while (a.length) a.pop();"
+        "}" },
+    { "for-each",
+        "const a = [];"
+        "for (let i = 0; i < 5000; ++i) a.push(i * 0.5);"
+        "let sum = 0;"
+        "for (let round = 0; round < 20; ++round) a.forEach(x => { sum += x; });" },
+    { "map",
+        "const a = [];"
+        "for (let i = 0; i < 5000; ++i) a.push(i);"
+        "for (let round = 0; round < 20; ++round) a.map(x => x * 2);" },
+    { "index-of",
+        "const a = [];"
+        "for (let i = 0; i < 5000; ++i) a.push(i);"
+        "let found = 0;"
+        "for (let i = 0; i < 2000; ++i) found += a.indexOf(i * 2);" },
+    { "sort",
+        "for (let round = 0; round < 5; ++round) {"
+        "    const a = [];"
+        "    for (let i = 0; i < 5000; ++i) a.push((i * 7919) % 5000);"
+        "    a.sort();"
+        "}" },
+    { "fill",
+        "for (let round = 0; round < 50; ++round) new Array(10000).fill(round);" },
+    { "indexed-loop",
+        "const a = new Array(10000).fill(1);"
+        "let sum = 0;"
+        "for (let round = 0; round < 10; ++round)"
+        "    for (let i = 0; i < a.length; ++i) sum += a[i];" },
+};
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+    bool run_bytecode = false;
+    int runs = 5;
+    const char* only_script = nullptr;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(run_bytecode, "Run using the bytecode interpreter", "bytecode", 'b');
+    args_parser.add_option(runs, "Number of times to run each script", "runs", 'n', "count");
+    args_parser.add_positional_argument(only_script, "Only run the script with this name", "script", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    auto vm = JS::VM::create();
+    vm->set_bytecode_enabled(run_bytecode);
+
+    for (auto& script : s_scripts) {
+        if (only_script && StringView(only_script) != script.name)
+            continue;
+
+        auto program = JS::Parser(JS::Lexer(script.source)).parse_program();
+
+        u64 best_ns = NumericLimits<u64>::max();
+        for (int run = 0; run < runs; ++run) {
+            auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+            JS::VM::InterpreterExecutionScope scope(*interpreter);
+
+            auto start = now_ns();
+            interpreter->run(interpreter->global_object(), *program);
+            best_ns = min(best_ns, now_ns() - start);
+            if (vm->exception()) {
+                fprintf(stderr, "%s: uncaught exception\n", script.name);
+                return 1;
+            }
+        }
+
+        printf("%-20s %8.2f ms\n", script.name, best_ns / 1e6);
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/String.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
+#include <stdio.h>
+#include <time.h>
+
+// Compares formatting with format string literals, which are parsed at compile time
+// by CheckedFormatString, against the same format strings passed as a StringView,
+// which vformat() has to parse on every call.
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+static int s_duration_ms = 200;
+
+template<typename Callback>
+static double measure_ns_per_call(Callback callback)
+{
+    StringBuilder builder;
+    u64 calls = 0;
+    u64 start = now_ns();
+    u64 elapsed = 0;
+    do {
+        for (int i = 0; i < 1000; ++i) {
+            builder.clear();
+            callback(builder, i);
+        }
+        calls += 1000;
+        elapsed = now_ns() - start;
+    } while (elapsed < (u64)s_duration_ms * 1'000'000);
+    return (double)elapsed / calls;
+}
+
+static void report(const char* name, double compiled_ns, double runtime_ns)
+{
+    printf("%-32s %12.1f %12.1f %8.2fx\n", name, runtime_ns, compiled_ns, runtime_ns / compiled_ns);
+}
+
+#define BENCHMARK_FORMAT(fmtstr, ...)                                                                                        \
+    report(fmtstr,                                                                                                           \
+        measure_ns_per_call([&](StringBuilder& builder, [[maybe_unused]] int i) { builder.appendff(fmtstr, __VA_ARGS__); }), \
+        measure_ns_per_call([&](StringBuilder& builder, [[maybe_unused]] int i) { builder.appendff(StringView { fmtstr }, __VA_ARGS__); }))
+
+int main(int argc, char** argv)
+{
+    Core::ArgsParser args_parser;
+    args_parser.add_option(s_duration_ms, "Time to spend on each measurement", "duration", 'd', "ms");
+    args_parser.parse(argc, argv);
+
+    String name = "WindowServer";
+    const char* path = "/usr/lib/libgui.so";
+
+    printf("%-32s %12s %12s %9s\n", "Format string", "runtime ns", "compiled ns", "speedup");
+    BENCHMARK_FORMAT("Hello, {}!", "world");
+    BENCHMARK_FORMAT("{}", i);
+    BENCHMARK_FORMAT("{} {} {}", i, i * 2, i * 3);
+    BENCHMARK_FORMAT("{:08x}", i);
+    BENCHMARK_FORMAT("{:>16}|{:<8}|", name, i);
+    BENCHMARK_FORMAT("{}({}:{}): mapped {} at {:p}", name, 12, i, path, path);
+    BENCHMARK_FORMAT("[{:*^{}}] {:.{}}", i, 12, path, 8);
+    return 0;
+}
@@ -0,0 +1,295 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/HashTable.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <stdio.h>
+#include <time.h>
+
+// Compares AK::HashTable against the open-addressing table it replaced
+// (one bucket per slot, double hashing, 60% load factor), which is kept here
+// in a trimmed-down form, for a few key types and table sizes.
+
+namespace Previous {
+
+template<typename T, typename TraitsForT = Traits<T>>
+class HashTable {
+    struct Bucket {
+        bool used;
+        bool deleted;
+        alignas(T) u8 storage[sizeof(T)];
+
+        T* slot() { return reinterpret_cast<T*>(storage); }
+    };
+
+public:
+    HashTable() { }
+    ~HashTable()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_buckets[i].used)
+                m_buckets[i].slot()->~T();
+        }
+        kfree(m_buckets);
+    }
+
+    size_t size() const { return m_size; }
+
+    bool contains(const T& value) const { return lookup(value); }
+
+    void set(T&& value)
+    {
+        auto& bucket = lookup_for_writing(value);
+        if (bucket.used) {
+            *bucket.slot() = move(value);
+            return;
+        }
+        new (bucket.slot()) T(move(value));
+        bucket.used = true;
+        if (bucket.deleted) {
+            bucket.deleted = false;
+            --m_deleted_count;
+        }
+        ++m_size;
+    }
+
+    bool remove(const T& value)
+    {
+        auto* bucket = lookup(value);
+        if (!bucket)
+            return false;
+        bucket->slot()->~T();
+        bucket->used = false;
+        bucket->deleted = true;
+        --m_size;
+        ++m_deleted_count;
+        return true;
+    }
+
+    class Iterator {
+    public:
+        bool operator!=(const Iterator& other) const { return m_bucket != other.m_bucket; }
+        T& operator*() { return *m_bucket->slot(); }
+        void operator++()
+        {
+            do {
+                ++m_bucket;
+            } while (m_bucket != m_end && !m_bucket->used);
+        }
+
+    private:
+        friend HashTable;
+        Iterator(Bucket* bucket, Bucket* end)
+            : m_bucket(bucket)
+            , m_end(end)
+        {
+        }
+
+        Bucket* m_bucket { nullptr };
+        Bucket* m_end { nullptr };
+    };
+
+    Iterator begin()
+    {
+        for (size_t i = 0; i < m_capacity; ++i) {
+            if (m_buckets[i].used)
+                return Iterator(&m_buckets[i], m_buckets + m_capacity);
+        }
+        return end();
+    }
+    Iterator end() { return Iterator(m_buckets + m_capacity, m_buckets + m_capacity); }
+
+private:
+    void rehash(size_t new_capacity)
+    {
+        new_capacity = max(new_capacity, static_cast<size_t>(4));
+        auto* old_buckets = m_buckets;
+        auto old_capacity = m_capacity;
+        m_buckets = (Bucket*)kmalloc(sizeof(Bucket) * new_capacity);
+        __builtin_memset(m_buckets, 0, sizeof(Bucket) * new_capacity);
+        m_capacity = new_capacity;
+        m_deleted_count = 0;
+        for (size_t i = 0; i < old_capacity; ++i) {
+            auto& old_bucket = old_buckets[i];
+            if (old_bucket.used) {
+                auto& bucket = lookup_for_writing(*old_bucket.slot());
+                new (bucket.slot()) T(move(*old_bucket.slot()));
+                bucket.used = true;
+                old_bucket.slot()->~T();
+            }
+        }
+        kfree(old_buckets);
+    }
+
+    Bucket* lookup(const T& value) const
+    {
+        if (!m_size)
+            return nullptr;
+        auto hash = TraitsForT::hash(value);
+        for (;;) {
+            auto& bucket = m_buckets[hash % m_capacity];
+            if (bucket.used && TraitsForT::equals(*bucket.slot(), value))
+                return &bucket;
+            if (!bucket.used && !bucket.deleted)
+                return nullptr;
+            hash = double_hash(hash);
+        }
+    }
+
+    Bucket& lookup_for_writing(const T& value)
+    {
+        if (auto* bucket = lookup(value))
+            return *bucket;
+        if ((m_size + m_deleted_count + 1) * 100 >= m_capacity * 60)
+            rehash(m_capacity * 2);
+        auto hash = TraitsForT::hash(value);
+        for (;;) {
+            auto& bucket = m_buckets[hash % m_capacity];
+            if (!bucket.used)
+                return bucket;
+            hash = double_hash(hash);
+        }
+    }
+
+    Bucket* m_buckets { nullptr };
+    size_t m_size { 0 };
+    size_t m_capacity { 0 };
+    size_t m_deleted_count { 0 };
+};
+
+}
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+template<typename Callback>
+static double measure_ns_per_element(size_t element_count, Callback callback)
+{
+    // Repeat small tables until we've spent at least 10ms on them.
+    size_t rounds = 0;
+    u64 start = now_ns();
+    u64 elapsed = 0;
+    do {
+        callback();
+        ++rounds;
+        elapsed = now_ns() - start;
+    } while (elapsed < 10'000'000);
+    return (double)elapsed / rounds / element_count;
+}
+
+static volatile size_t s_sink;
+
+template<template<typename> typename Table, typename T>
+static void run_operations(const Vector<T>& keys, const Vector<T>& missing_keys, double results[])
+{
+    size_t count = keys.size();
+    size_t result = 0;
+
+    results[0] = measure_ns_per_element(count, [&] {
+        Table<T> table;
+        for (auto& key : keys)
+            table.set(T(key));
+        result += table.size();
+    });
+
+    Table<T> table;
+    for (auto& key : keys)
+        table.set(T(key));
+
+    results[1] = measure_ns_per_element(count, [&] {
+        for (auto& key : keys)
+            result += table.contains(key);
+    });
+
+    results[2] = measure_ns_per_element(count, [&] {
+        for (auto& key : missing_keys)
+            result += table.contains(key);
+    });
+
+    results[3] = measure_ns_per_element(count, [&] {
+        for (auto& value : table)
+            result += Traits<T>::hash(value);
+    });
+
+    // Remove and put back half of the keys, so every round sees the same table.
+    results[4] = measure_ns_per_element(count, [&] {
+        for (size_t i = 0; i < count; i += 2)
+            result += table.remove(keys[i]);
+        for (size_t i = 0; i < count; i += 2)
+            table.set(T(keys[i]));
+    });
+
+    s_sink = result;
+}
+
+template<typename T>
+using CurrentHashTable = HashTable<T>;
+
+template<typename T>
+using PreviousHashTable = Previous::HashTable<T>;
+
+template<typename T, typename MakeKey>
+static void run_benchmark(const char* key_type, MakeKey make_key)
+{
+    static const char* operation_names[] = { "insert", "hit", "miss", "iterate", "erase" };
+    for (size_t count : { 16u, 1024u, 65536u, 1048576u }) {
+        Vector<T> keys;
+        Vector<T> missing_keys;
+        for (size_t i = 0; i < count; ++i) {
+            keys.append(make_key(i * 2));
+            missing_keys.append(make_key(i * 2 + 1));
+        }
+
+        double previous[5];
+        double current[5];
+        run_operations<PreviousHashTable>(keys, missing_keys, previous);
+        run_operations<CurrentHashTable>(keys, missing_keys, current);
+        for (size_t i = 0; i < 5; ++i)
+            printf("%-8s %-8s %8zu %10.2f %10.2f %7.2fx\n", key_type, operation_names[i], count, previous[i], current[i], previous[i] / current[i]);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* type = nullptr;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_positional_argument(type, "Only run the benchmark for this key type (int, string)", "type", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    printf("%-8s %-8s %8s %10s %10s %8s  (ns per element)\n", "keys", "op", "count", "previous", "current", "speedup");
+    if (!type || StringView(type) == "int")
+        run_benchmark<u32>("int", [](size_t i) { return (u32)(i * 2654435761u); });
+    if (!type || StringView(type) == "string")
+        run_benchmark<String>("string", [](size_t i) { return String::formatted("key-{}", i); });
+    return 0;
+}
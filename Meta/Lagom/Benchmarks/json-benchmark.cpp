@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonStreamParser.h>
+#include <AK/JsonValue.h>
+#include <AK/JsonView.h>
+#include <AK/MappedFile.h>
+#include <AK/MemoryStream.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
+#include <stdio.h>
+#include <time.h>
+
+// Compares the ways of reading JSON in AK: building a JsonValue tree, pulling tokens out of
+// a JsonStreamParser, and looking at the source text through a JsonDocumentView. By default
+// this uses a made-up document shaped like /proc/all, but any JSON file can be given instead.
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+template<typename Callback>
+static double measure_ns_per_run(Callback& callback)
+{
+    // Keep going for at least 200ms, so that small documents get more than a single run.
+    u64 runs = 0;
+    u64 start = now_ns();
+    u64 elapsed = 0;
+    do {
+        callback();
+        ++runs;
+        elapsed = now_ns() - start;
+    } while (elapsed < 200'000'000);
+    return (double)elapsed / runs;
+}
+
+static String make_process_list(size_t process_count)
+{
+    StringBuilder builder;
+    builder.append('[');
+    for (size_t pid = 0; pid < process_count; ++pid) {
+        if (pid)
+            builder.append(',');
+        builder.appendff(R"({{"pid":{},"pgid":{},"pgp":{},"sid":{},"uid":100,"gid":100,"ppid":1,"nfds":{},)", pid, pid, pid, pid, pid % 32);
+        builder.appendff(R"("name":"Process #{}","executable":"/bin/process-{}","tty":"/dev/tty0","pledge":"stdio rpath","veil":"",)", pid, pid);
+        builder.appendff(R"("amount_virtual":{},"amount_resident":{},"amount_shared":4096,"amount_dirty_private":0,)", pid * 4096, pid * 1024);
+        builder.append(R"("amount_clean_inode":0,"amount_purgeable_volatile":0,"amount_purgeable_nonvolatile":0,"threads":[)");
+        for (size_t tid = 0; tid < 1 + pid % 4; ++tid) {
+            if (tid)
+                builder.append(',');
+            builder.appendff(R"({{"tid":{},"times_scheduled":{},"name":"Thread {}","state":"Running","ticks_user":{},"ticks_kernel":{},)", pid * 8 + tid, pid * 100, tid, pid * 3, pid * 2);
+            builder.append(R"("cpu":0,"priority":30,"effective_priority":30,"syscall_count":1234,"inode_faults":0,"zero_faults":12,"cow_faults":3,)");
+            builder.append(R"("unix_socket_read_bytes":0,"unix_socket_write_bytes":0,"ipv4_socket_read_bytes":0,"ipv4_socket_write_bytes":0,)");
+            builder.append(R"("file_read_bytes":65536,"file_write_bytes":0})");
+        }
+        builder.append("]}");
+    }
+    builder.append(']');
+    return builder.to_string();
+}
+
+static volatile u64 s_sink;
+
+// Touches every value the way a consumer would, so that the lazy approaches don't get away with doing nothing.
+static u64 walk(const JsonValue& value)
+{
+    if (value.is_array()) {
+        u64 sum = 0;
+        value.as_array().for_each([&](auto& element) { sum += walk(element); });
+        return sum;
+    }
+    if (value.is_object()) {
+        u64 sum = 0;
+        value.as_object().for_each_member([&](auto& key, auto& member) { sum += key.length() + walk(member); });
+        return sum;
+    }
+    if (value.is_string())
+        return value.as_string().length();
+    return value.to_number<u64>();
+}
+
+static u64 walk(const JsonValueView& value)
+{
+    if (value.is_array()) {
+        u64 sum = 0;
+        value.for_each([&](auto& element) { sum += walk(element); });
+        return sum;
+    }
+    if (value.is_object()) {
+        u64 sum = 0;
+        value.for_each_member([&](auto& key, auto& member) { sum += key.length() + walk(member); });
+        return sum;
+    }
+    if (value.is_string())
+        return value.string_needs_unescaping() ? value.as_string().length() : value.as_string_view().length();
+    return value.to_number<u64>();
+}
+
+static u64 walk(JsonStreamParser& parser)
+{
+    u64 sum = 0;
+    for (;;) {
+        auto token = parser.next();
+        switch (token.type) {
+        case JsonStreamParser::TokenType::Key:
+        case JsonStreamParser::TokenType::String:
+            sum += token.text.length();
+            break;
+        case JsonStreamParser::TokenType::Number:
+            sum += token.number().value_or(JsonValue()).to_number<u64>();
+            break;
+        case JsonStreamParser::TokenType::EndOfDocument:
+        case JsonStreamParser::TokenType::Error:
+            return sum;
+        default:
+            break;
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    int process_count = 1000;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(process_count, "Number of processes in the generated document", "processes", 'p', "count");
+    args_parser.add_positional_argument(path, "JSON file to read instead of a generated document", "path", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    String generated;
+    MappedFile mapped_file;
+    StringView source;
+    if (path) {
+        mapped_file = MappedFile(path);
+        if (!mapped_file.is_valid()) {
+            fprintf(stderr, "Failed to map %s\n", path);
+            return 1;
+        }
+        source = { (const char*)mapped_file.data(), mapped_file.size() };
+    } else {
+        generated = make_process_list(process_count);
+        source = generated;
+    }
+
+    if (!JsonDocumentView::parse(source).has_value()) {
+        fprintf(stderr, "Not a valid JSON document\n");
+        return 1;
+    }
+
+    struct Benchmark {
+        const char* name;
+        Function<void()> run;
+    };
+    Benchmark benchmarks[] = {
+        { "JsonValue parse", [&] { s_sink = JsonValue::from_string(source).has_value(); } },
+        { "JsonValue parse+walk", [&] { s_sink = walk(JsonValue::from_string(source).value()); } },
+        { "JsonStreamParser walk", [&] {
+             InputMemoryStream stream { source.bytes() };
+             JsonStreamParser parser(stream);
+             s_sink = walk(parser);
+         } },
+        { "JsonDocumentView parse", [&] { s_sink = JsonDocumentView::parse(source).has_value(); } },
+        { "JsonDocumentView parse+walk", [&] { s_sink = walk(JsonDocumentView::parse(source).value().root()); } },
+    };
+
+    printf("Document: %zu bytes\n", source.length());
+    printf("%-28s %10s %10s\n", "", "ms/run", "MiB/s");
+    for (auto& benchmark : benchmarks) {
+        auto ns = measure_ns_per_run(benchmark.run);
+        printf("%-28s %10.2f %10.1f\n", benchmark.name, ns / 1e6, source.length() / (ns / 1e9) / MiB);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Atomic.h>
+#include <AK/LockFreeStack.h>
+#include <AK/MPMCQueue.h>
+#include <AK/Queue.h>
+#include <AK/SPSCQueue.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <time.h>
+
+// Measures the throughput of the lock-free SPSCQueue, MPMCQueue and LockFreeStack
+// against the usual alternative of a plain Queue or Vector behind a mutex. Every
+// thread moves the same number of items; producers and consumers yield when the
+// queue is full or empty, so the numbers stay meaningful on machines with fewer
+// cores than threads.
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+static int s_items_per_thread = 1'000'000;
+
+class LockedQueue {
+public:
+    LockedQueue() { pthread_mutex_init(&m_mutex, nullptr); }
+    ~LockedQueue() { pthread_mutex_destroy(&m_mutex); }
+
+    bool try_enqueue(u32 value)
+    {
+        pthread_mutex_lock(&m_mutex);
+        bool can_enqueue = m_queue.size() < 1024;
+        if (can_enqueue)
+            m_queue.enqueue(value);
+        pthread_mutex_unlock(&m_mutex);
+        return can_enqueue;
+    }
+
+    Optional<u32> try_dequeue()
+    {
+        Optional<u32> value;
+        pthread_mutex_lock(&m_mutex);
+        if (!m_queue.is_empty())
+            value = m_queue.dequeue();
+        pthread_mutex_unlock(&m_mutex);
+        return value;
+    }
+
+private:
+    pthread_mutex_t m_mutex;
+    Queue<u32> m_queue;
+};
+
+class LockedStack {
+public:
+    LockedStack() { pthread_mutex_init(&m_mutex, nullptr); }
+    ~LockedStack() { pthread_mutex_destroy(&m_mutex); }
+
+    void push(u32 value)
+    {
+        pthread_mutex_lock(&m_mutex);
+        m_stack.append(value);
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    Optional<u32> pop()
+    {
+        Optional<u32> value;
+        pthread_mutex_lock(&m_mutex);
+        if (!m_stack.is_empty())
+            value = m_stack.take_last();
+        pthread_mutex_unlock(&m_mutex);
+        return value;
+    }
+
+private:
+    pthread_mutex_t m_mutex;
+    Vector<u32> m_stack;
+};
+
+template<typename QueueType>
+struct QueueBenchmark {
+    QueueType queue;
+    Atomic<u64> checksum { 0 };
+
+    static void* produce(void* argument)
+    {
+        auto& self = *static_cast<QueueBenchmark*>(argument);
+        for (int i = 0; i < s_items_per_thread;) {
+            if (self.queue.try_enqueue(i))
+                ++i;
+            else
+                sched_yield();
+        }
+        return nullptr;
+    }
+
+    static void* consume(void* argument)
+    {
+        auto& self = *static_cast<QueueBenchmark*>(argument);
+        u64 sum = 0;
+        for (int i = 0; i < s_items_per_thread;) {
+            auto value = self.queue.try_dequeue();
+            if (value.has_value()) {
+                sum += value.value();
+                ++i;
+            } else {
+                sched_yield();
+            }
+        }
+        self.checksum += sum;
+        return nullptr;
+    }
+};
+
+template<typename QueueType>
+static double measure_queue(int producers, int consumers)
+{
+    auto* benchmark = new QueueBenchmark<QueueType>;
+    Vector<pthread_t> threads;
+    u64 start = now_ns();
+    for (int i = 0; i < producers + consumers; ++i) {
+        pthread_t thread;
+        pthread_create(&thread, nullptr, i < producers ? QueueBenchmark<QueueType>::produce : QueueBenchmark<QueueType>::consume, benchmark);
+        threads.append(thread);
+    }
+    for (auto thread : threads)
+        pthread_join(thread, nullptr);
+    double elapsed_s = (now_ns() - start) / 1e9;
+
+    u64 expected = (u64)producers * s_items_per_thread * (s_items_per_thread - 1) / 2;
+    if (benchmark->checksum.load() != expected)
+        fprintf(stderr, "Checksum mismatch!\n");
+    delete benchmark;
+    return (double)producers * s_items_per_thread / elapsed_s / 1e6;
+}
+
+template<typename StackType>
+static void* stack_worker(void* argument)
+{
+    auto& stack = *static_cast<StackType*>(argument);
+    for (int i = 0; i < s_items_per_thread; ++i) {
+        stack.push(i);
+        [[maybe_unused]] auto value = stack.pop();
+    }
+    return nullptr;
+}
+
+template<typename StackType>
+static double measure_stack(int thread_count)
+{
+    StackType stack;
+    Vector<pthread_t> threads;
+    u64 start = now_ns();
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_t thread;
+        pthread_create(&thread, nullptr, stack_worker<StackType>, &stack);
+        threads.append(thread);
+    }
+    for (auto thread : threads)
+        pthread_join(thread, nullptr);
+    double elapsed_s = (now_ns() - start) / 1e9;
+    return (double)thread_count * s_items_per_thread / elapsed_s / 1e6;
+}
+
+int main(int argc, char** argv)
+{
+    int thread_count = 4;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(s_items_per_thread, "Number of items each thread moves", "items", 'n', "count");
+    args_parser.add_option(thread_count, "Number of producers, consumers and stack threads", "threads", 't', "count");
+    args_parser.parse(argc, argv);
+
+    printf("%-36s %10s %10s\n", "Million items per second", "mutex", "lock-free");
+    printf("%-36s %10.2f %10.2f\n", "SPSCQueue, 1 producer, 1 consumer",
+        measure_queue<LockedQueue>(1, 1), measure_queue<SPSCQueue<u32, 1024>>(1, 1));
+    printf("%-36s %10.2f %10.2f\n", "MPMCQueue, 1 producer, 1 consumer",
+        measure_queue<LockedQueue>(1, 1), measure_queue<MPMCQueue<u32, 1024>>(1, 1));
+    char label[64];
+    snprintf(label, sizeof(label), "MPMCQueue, %d producers, %d consumers", thread_count, thread_count);
+    printf("%-36s %10.2f %10.2f\n", label,
+        measure_queue<LockedQueue>(thread_count, thread_count), measure_queue<MPMCQueue<u32, 1024>>(thread_count, thread_count));
+    snprintf(label, sizeof(label), "LockFreeStack, %d threads", thread_count);
+    printf("%-36s %10.2f %10.2f\n", label,
+        measure_stack<LockedStack>(thread_count), measure_stack<LockFreeStack<u32>>(thread_count));
+
+    return 0;
+}
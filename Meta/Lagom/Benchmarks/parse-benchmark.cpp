@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Arena.h>
+#include <AK/Function.h>
+#include <AK/MappedFile.h>
+#include <AK/RefCounted.h>
+#include <AK/StringBuilder.h>
+#include <LibCore/ArgsParser.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/ProgramCache.h>
+#include <Shell/Parser.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <time.h>
+
+// Measures how long the LibJS and Shell parsers take on large inputs and how much heap the
+// resulting ASTs occupy, also with function bodies left for later, how long loading the same
+// JavaScript AST from a ProgramCache entry takes instead, and compares allocating small nodes
+// from an Arena with allocating them from the heap. By default this parses made-up sources,
+// but a JavaScript file can be given instead.
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+template<typename Callback>
+static double measure_ns_per_run(Callback& callback)
+{
+    // Keep going for at least 200ms, so that small inputs get more than a single run.
+    u64 runs = 0;
+    u64 start = now_ns();
+    u64 elapsed = 0;
+    do {
+        callback();
+        ++runs;
+        elapsed = now_ns() - start;
+    } while (elapsed < 200'000'000);
+    return (double)elapsed / runs;
+}
+
+static size_t heap_in_use()
+{
+    return mallinfo2().uordblks;
+}
+
+static String make_javascript(size_t function_count)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < function_count; ++i) {
+        builder.appendff("function f{}(a, b, c) {{\n", i);
+        builder.appendff("    var x = a * {} + b / (c - 1), y = [a, b, c, \"item {}\"];\n", i, i);
+        builder.append("    for (let i = 0; i < y.length; ++i) {\n");
+        builder.append("        if (y[i] !== undefined && typeof y[i] === \"number\")\n");
+        builder.append("            x += y[i] ? y[i] : -1;\n");
+        builder.append("    }\n");
+        builder.appendff("    return {{ x: x, y: y, name: \"f{}\", call: () => f{}(x, a, b) }};\n", i, i);
+        builder.append("}\n");
+    }
+    return builder.to_string();
+}
+
+static String make_shell_script(size_t function_count)
+{
+    StringBuilder builder;
+    for (size_t i = 0; i < function_count; ++i) {
+        builder.appendff("f{}(a b) {{\n", i);
+        builder.appendff("    for x in ($a $b {}) {{ echo \"item $x\" | grep -v {} > /tmp/out{} }}\n", i, i, i);
+        builder.append("    if test $a -eq $b { echo same } else { echo $(expr $a + $b) }\n");
+        builder.append("}\n");
+    }
+    return builder.to_string();
+}
+
+struct Node
+    : public RefCounted<Node>
+    , public ArenaAllocated {
+    Node(RefPtr<Node> left, RefPtr<Node> right)
+        : left(move(left))
+        , right(move(right))
+    {
+    }
+    RefPtr<Node> left;
+    RefPtr<Node> right;
+    u64 value { 0 };
+};
+
+static RefPtr<Node> make_tree(int depth)
+{
+    if (!depth)
+        return nullptr;
+    return adopt(*new Node(make_tree(depth - 1), make_tree(depth - 1)));
+}
+
+struct ArenaNode {
+    ArenaNode* left;
+    ArenaNode* right;
+    u64 value { 0 };
+};
+
+static ArenaNode* make_arena_tree(Arena& arena, int depth)
+{
+    if (!depth)
+        return nullptr;
+    auto* left = make_arena_tree(arena, depth - 1);
+    auto* right = make_arena_tree(arena, depth - 1);
+    return &arena.make<ArenaNode>(ArenaNode { left, right });
+}
+
+static volatile u64 s_sink;
+
+int main(int argc, char** argv)
+{
+    const char* path = nullptr;
+    int function_count = 5000;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(function_count, "Number of functions in the generated sources", "functions", 'f', "count");
+    args_parser.add_positional_argument(path, "JavaScript file to parse instead of a generated one", "path", Core::ArgsParser::Required::No);
+    args_parser.parse(argc, argv);
+
+    String generated_javascript;
+    MappedFile mapped_file;
+    StringView javascript;
+    if (path) {
+        mapped_file = MappedFile(path);
+        if (!mapped_file.is_valid()) {
+            fprintf(stderr, "Failed to map %s\n", path);
+            return 1;
+        }
+        javascript = { (const char*)mapped_file.data(), mapped_file.size() };
+    } else {
+        generated_javascript = make_javascript(function_count);
+        javascript = generated_javascript;
+    }
+    auto shell_script = make_shell_script(function_count);
+    // Lazily parsed function bodies are parsed from a source that they keep alive.
+    String javascript_string = javascript;
+
+    ByteBuffer cached_javascript;
+    {
+        JS::Parser parser { JS::Lexer(javascript) };
+        auto program = parser.parse_program();
+        if (!parser.has_errors())
+            cached_javascript = JS::ProgramCache::serialize(javascript, program);
+    }
+
+    // The ASTs are kept around until the next run, so that the runs include tearing them down.
+    RefPtr<JS::Program> javascript_ast;
+    RefPtr<Shell::AST::Node> shell_ast;
+
+    struct Benchmark {
+        const char* name;
+        size_t input_size;
+        Function<bool()> parse;
+    };
+    Benchmark benchmarks[] = {
+        { "LibJS parse", javascript.length(), [&] {
+             JS::Parser parser { JS::Lexer(javascript) };
+             javascript_ast = parser.parse_program();
+             return !parser.has_errors();
+         } },
+        { "LibJS lazy parse", javascript.length(), [&] {
+             JS::Parser parser { JS::Lexer(javascript_string) };
+             parser.enable_lazy_function_bodies(javascript_string);
+             javascript_ast = parser.parse_program();
+             return !parser.has_errors();
+         } },
+        { "LibJS cache load", javascript.length(), [&] {
+             javascript_ast = JS::ProgramCache::deserialize(javascript, cached_javascript);
+             return !javascript_ast.is_null();
+         } },
+        { "Shell parse", shell_script.length(), [&] {
+             shell_ast = Shell::Parser(shell_script).parse();
+             return shell_ast && !shell_ast->is_syntax_error();
+         } },
+    };
+
+    printf("%-20s %10s %10s %10s %12s\n", "", "KiB", "ms/run", "MiB/s", "AST KiB");
+    for (auto& benchmark : benchmarks) {
+        auto heap_before = heap_in_use();
+        if (!benchmark.parse()) {
+            fprintf(stderr, "%s: failed to parse\n", benchmark.name);
+            return 1;
+        }
+        auto ast_size = heap_in_use() - heap_before;
+
+        auto run = [&] { s_sink = benchmark.parse(); };
+        auto ns = measure_ns_per_run(run);
+        printf("%-20s %10zu %10.2f %10.1f %12zu\n", benchmark.name, benchmark.input_size / KiB, ns / 1e6, benchmark.input_size / (ns / 1e9) / MiB, ast_size / KiB);
+        javascript_ast = nullptr;
+        shell_ast = nullptr;
+    }
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("Peak RSS: %ld KiB\n\n", usage.ru_maxrss);
+
+    // A complete binary tree of 2^16 - 1 nodes, built and then thrown away.
+    constexpr int tree_depth = 16;
+    auto heap_nodes = [&] { s_sink = (bool)make_tree(tree_depth); };
+    auto arena_allocated_nodes = [&] {
+        Arena arena;
+        Arena::Scope scope(arena);
+        s_sink = (bool)make_tree(tree_depth);
+    };
+    auto arena_nodes = [&] {
+        Arena arena;
+        s_sink = (bool)make_arena_tree(arena, tree_depth);
+    };
+
+    printf("%-40s %10s\n", "", "ns/node");
+    double node_count = (1 << tree_depth) - 1;
+    printf("%-40s %10.1f\n", "RefPtr<Node> on the heap", measure_ns_per_run(heap_nodes) / node_count);
+    printf("%-40s %10.1f\n", "RefPtr<Node> in an Arena::Scope", measure_ns_per_run(arena_allocated_nodes) / node_count);
+    printf("%-40s %10.1f\n", "Arena::make<Node>()", measure_ns_per_run(arena_nodes) / node_count);
+    return 0;
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/MergeSort.h>
+#include <AK/QuickSort.h>
+#include <AK/String.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibThread/ParallelSort.h>
+#include <stdio.h>
+#include <time.h>
+
+// Compares the old dual pivot quick sort against intro_sort(), merge_sort() and
+// LibThread's parallel_sort() on integers, Strings and records sorted with a
+// comparator. Each cell is the best of a few runs, in milliseconds. The dual pivot
+// quick sort is skipped on inputs where it degrades to quadratic time and recursion
+// depth, which is what intro_sort() fixes.
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+static int s_runs = 5;
+static u32 s_random_state = 0x2545f491;
+
+static u32 next_random()
+{
+    s_random_state ^= s_random_state << 13;
+    s_random_state ^= s_random_state >> 17;
+    s_random_state ^= s_random_state << 5;
+    return s_random_state;
+}
+
+template<typename T, typename Sort>
+static double measure_ms(const Vector<T>& input, Sort sort)
+{
+    double best = 0;
+    for (int run = 0; run < s_runs; ++run) {
+        Vector<T> values = input;
+        u64 start = now_ns();
+        sort(values);
+        double elapsed = (now_ns() - start) / 1'000'000.0;
+        if (run == 0 || elapsed < best)
+            best = elapsed;
+    }
+    return best;
+}
+
+template<typename T, typename LessThan>
+static void benchmark(const char* name, const Vector<T>& input, LessThan less_than, bool skip_dual_pivot = false)
+{
+    printf("%-24s", name);
+    if (skip_dual_pivot)
+        printf(" %12s", "(quadratic)");
+    else
+        printf(" %12.2f", measure_ms(input, [&](auto& values) { dual_pivot_quick_sort(values, 0, values.size() - 1, less_than); }));
+    printf(" %12.2f", measure_ms(input, [&](auto& values) { intro_sort(values, 0, values.size() - 1, less_than); }));
+    printf(" %12.2f", measure_ms(input, [&](auto& values) { merge_sort(values, less_than); }));
+    printf(" %12.2f\n", measure_ms(input, [&](auto& values) { LibThread::parallel_sort(values, less_than); }));
+}
+
+struct Record {
+    String name;
+    int age;
+    double score;
+};
+
+int main(int argc, char** argv)
+{
+    int count = 1'000'000;
+    int string_count = 200'000;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(count, "Number of integers and records to sort", "count", 'n', "count");
+    args_parser.add_option(string_count, "Number of strings to sort", "strings", 's', "count");
+    args_parser.add_option(s_runs, "Number of runs per measurement", "runs", 'r', "count");
+    args_parser.parse(argc, argv);
+
+    auto int_less_than = [](int a, int b) { return a < b; };
+
+    Vector<int> random_ints;
+    Vector<int> sorted_ints;
+    Vector<int> reversed_ints;
+    Vector<int> few_unique_ints;
+    for (int i = 0; i < count; ++i) {
+        random_ints.append(next_random());
+        sorted_ints.append(i);
+        reversed_ints.append(count - i);
+        few_unique_ints.append(next_random() % 16);
+    }
+
+    Vector<String> strings;
+    for (int i = 0; i < string_count; ++i)
+        strings.append(String::formatted("item-{:x}-{}", next_random(), i % 100));
+
+    Vector<Record> records;
+    for (int i = 0; i < count; ++i)
+        records.append({ String::number(i), (int)(next_random() % 100), (next_random() % 10000) / 100.0 });
+
+    printf("%-24s %12s %12s %12s %12s\n", "Workload", "dual pivot", "intro_sort", "merge_sort", "parallel");
+    benchmark("int (random)", random_ints, int_less_than);
+    benchmark("int (sorted)", sorted_ints, int_less_than, true);
+    benchmark("int (reversed)", reversed_ints, int_less_than, true);
+    benchmark("int (16 unique values)", few_unique_ints, int_less_than, true);
+    benchmark("String", strings, [](auto& a, auto& b) { return a < b; });
+    benchmark("Record (comparator)", records, [](auto& a, auto& b) {
+        if (a.score != b.score)
+            return a.score < b.score;
+        return a.age < b.age;
+    });
+
+    printf("\n%-24s %12s %12s\n", "Partition", "1 thread", "parallel");
+    auto is_even = [](int value) { return value % 2 == 0; };
+    printf("%-24s %12.2f %12.2f\n", "int (random)",
+        measure_ms(random_ints, [&](auto& values) { LibThread::parallel_partition(values, is_even, 1); }),
+        measure_ms(random_ints, [&](auto& values) { LibThread::parallel_partition(values, is_even); }));
+
+    return 0;
+}
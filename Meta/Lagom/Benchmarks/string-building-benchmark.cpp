@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibCore/ArgsParser.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <stdio.h>
+#include <time.h>
+
+// Runs a handful of scripts that build up large strings piece by piece, which is quadratic
+// if every concatenation copies both of its operands. The last ones read the strings back
+// and churn through property names, to keep an eye on flattening and interning as well.
+
+struct Script {
+    const char* name;
+    const char* source;
+};
+
+static const Script s_scripts[] = {
+    { "append-characters",
+        "let s = '';"
+        "for (let i = 0; i < 200000; ++i) s += 'x';"
+        "s.length;" },
+    { "append-numbers",
+        "let s = '';"
+        "for (let i = 0; i < 100000; ++i) s += i + ',';"
+        "s.length;" },
+    { "prepend",
+        "let s = '';"
+        "for (let i = 0; i < 50000; ++i) s = 'line ' + i + '\\n' + s;"
+        "s.length;" },
+    { "template-literal",
+        "let s = '';"
+        "for (let i = 0; i < 50000; ++i) s = `${s}<td>${i}</td>`;"
+        "s.length;" },
+    { "array-join",
+        "const a = [];"
+        "for (let i = 0; i < 100000; ++i) a.push('item' + i);"
+        "a.join(', ').length;" },
+    { "build-and-read",
+        "let count = 0;"
+        "for (let round = 0; round < 100; ++round) {"
+        "    let s = '';"
+        "    for (let i = 0; i < 1000; ++i) s += 'ab';"
+        "    for (let i = 0; i < s.length; i += 100) if (s.charAt(i) === 'a') ++count;"
+        "}" },
+    { "property-names",
+        "const o = { alpha: 1, beta: 2, gamma: 3, delta: 4, epsilon: 5 };"
+        "let count = 0;"
+        "for (let i = 0; i < 20000; ++i) for (const key in o) count += key.length;" },
+};
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+int main(int argc, char** argv)
+{
+    bool run_bytecode = false;
+    int runs = 5;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(run_bytecode, "Run using the bytecode interpreter", "bytecode", 'b');
+    args_parser.add_option(runs, "Number of times to run each script", "runs", 'n', "count");
+    args_parser.parse(argc, argv);
+
+    auto vm = JS::VM::create();
+    vm->set_bytecode_enabled(run_bytecode);
+
+    for (auto& script : s_scripts) {
+        auto program = JS::Parser(JS::Lexer(script.source)).parse_program();
+
+        u64 best_ns = NumericLimits<u64>::max();
+        for (int run = 0; run < runs; ++run) {
+            auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+            JS::VM::InterpreterExecutionScope scope(*interpreter);
+
+            auto start = now_ns();
+            interpreter->run(interpreter->global_object(), *program);
+            best_ns = min(best_ns, now_ns() - start);
+            if (vm->exception()) {
+                fprintf(stderr, "%s: uncaught exception\n", script.name);
+                return 1;
+            }
+        }
+
+        printf("%-20s %8.2f ms\n", script.name, best_ns / 1e6);
+    }
+
+    return 0;
+}
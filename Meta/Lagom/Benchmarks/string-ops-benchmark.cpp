@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/MemMem.h>
+#include <AK/SIMDStringOps.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+// Compares the plain and vectorized string and memory functions from LibC
+// (see Libraries/LibC/string.cpp) over a range of buffer sizes.
+
+using AK::SIMD::u8x16;
+using AK::SIMD::u8x32;
+
+struct Buffers {
+    Vector<u8> source;
+    Vector<u8> destination;
+    size_t size { 0 };
+};
+
+struct Implementation {
+    const char* name;
+    void (*memcpy)(Buffers&);
+    void (*memset)(Buffers&);
+    size_t (*memchr)(Buffers&);
+    size_t (*strlen)(Buffers&);
+    size_t (*strchr)(Buffers&);
+    size_t (*memcmp)(Buffers&);
+    size_t (*memmem)(Buffers&);
+};
+
+// The buffers are filled with 'a's, and the things we search for are at the very end,
+// so every function has to look at every byte.
+static const u8 needle[] = { 'a', 'a', 'a', 'b' };
+
+namespace Plain {
+
+#if ARCH(I386) || ARCH(X86_64)
+static void memcpy(Buffers& buffers)
+{
+    void* destination = buffers.destination.data();
+    const void* source = buffers.source.data();
+    size_t size = buffers.size;
+    asm volatile("rep movsb"
+                 : "+D"(destination), "+S"(source), "+c"(size)::"memory");
+}
+
+static void memset(Buffers& buffers)
+{
+    void* destination = buffers.destination.data();
+    size_t size = buffers.size;
+    asm volatile("rep stosb"
+                 : "+D"(destination), "+c"(size)
+                 : "a"(0)
+                 : "memory");
+}
+#else
+static void memcpy(Buffers& buffers)
+{
+    for (size_t i = 0; i < buffers.size; ++i)
+        buffers.destination[i] = buffers.source[i];
+}
+
+static void memset(Buffers& buffers)
+{
+    for (size_t i = 0; i < buffers.size; ++i)
+        buffers.destination[i] = 0;
+}
+#endif
+
+static size_t memchr(Buffers& buffers)
+{
+    for (size_t i = 0; i < buffers.size; ++i) {
+        if (buffers.source[i] == 'b')
+            return i;
+    }
+    return 0;
+}
+
+static size_t strlen(Buffers& buffers)
+{
+    size_t length = 0;
+    while (buffers.source[length])
+        ++length;
+    return length;
+}
+
+static size_t strchr(Buffers& buffers)
+{
+    for (size_t i = 0;; ++i) {
+        if (buffers.source[i] == 'b' || !buffers.source[i])
+            return i;
+    }
+}
+
+static size_t memcmp(Buffers& buffers)
+{
+    for (size_t i = 0; i < buffers.size; ++i) {
+        if (buffers.source[i] != buffers.destination[i])
+            return i;
+    }
+    return 0;
+}
+
+static size_t memmem(Buffers& buffers)
+{
+    // This is what LibC's memmem() falls back to without SIMD.
+    size_t length = buffers.size;
+    auto* data = buffers.source.data();
+    if (length < sizeof(needle))
+        return 0;
+    if (length == sizeof(needle))
+        return !::memcmp(data, needle, length);
+    // AK::memmem() would take the vectorized path on x86_64, so call its building blocks ourselves.
+    auto* result = AK::bitap_bitwise(data, length, needle, sizeof(needle));
+    return (const u8*)result - data;
+}
+
+}
+
+#define DEFINE_VECTORIZED_IMPLEMENTATION(name, target_name, VectorType)                                                         \
+    namespace name {                                                                                                            \
+    [[gnu::target(target_name)]] static void memcpy(Buffers& buffers)                                                           \
+    {                                                                                                                           \
+        AK::SIMD::copy<VectorType>(buffers.destination.data(), buffers.source.data(), buffers.size);                            \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static void memset(Buffers& buffers)                                                           \
+    {                                                                                                                           \
+        AK::SIMD::fill<VectorType>(buffers.destination.data(), 0, buffers.size);                                                \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static size_t memchr(Buffers& buffers)                                                         \
+    {                                                                                                                           \
+        return AK::SIMD::find_byte<VectorType>(buffers.source.data(), buffers.size, 'b') - buffers.source.data();               \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static size_t strlen(Buffers& buffers)                                                         \
+    {                                                                                                                           \
+        return AK::SIMD::string_length<VectorType>((const char*)buffers.source.data());                                         \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static size_t strchr(Buffers& buffers)                                                         \
+    {                                                                                                                           \
+        auto* string = (const char*)buffers.source.data();                                                                      \
+        return AK::SIMD::find_byte_or_terminator<VectorType>(string, 'b') - string;                                             \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static size_t memcmp(Buffers& buffers)                                                         \
+    {                                                                                                                           \
+        return AK::SIMD::compare<VectorType>(buffers.source.data(), buffers.destination.data(), buffers.size);                  \
+    }                                                                                                                           \
+    [[gnu::target(target_name)]] static size_t memmem(Buffers& buffers)                                                         \
+    {                                                                                                                           \
+        auto* data = buffers.source.data();                                                                                     \
+        return AK::SIMD::find_substring<VectorType>(data, buffers.size, needle, sizeof(needle)) - data;                         \
+    }                                                                                                                           \
+    }
+
+#if ARCH(I386) || ARCH(X86_64)
+DEFINE_VECTORIZED_IMPLEMENTATION(SSE2, "sse2", u8x16)
+DEFINE_VECTORIZED_IMPLEMENTATION(AVX2, "avx2", u8x32)
+#endif
+
+#define IMPLEMENTATION(name) \
+    Implementation { #name, name::memcpy, name::memset, name::memchr, name::strlen, name::strchr, name::memcmp, name::memmem }
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+template<typename Callback>
+static double measure_ns_per_call(size_t size, size_t bytes_per_round, Callback callback)
+{
+    // Aim for roughly the same amount of work for every size, and keep going for at least 10ms.
+    size_t iterations = max<size_t>(bytes_per_round / size, 1);
+    u64 total_iterations = 0;
+    u64 start = now_ns();
+    u64 elapsed = 0;
+    do {
+        for (size_t i = 0; i < iterations; ++i)
+            callback();
+        total_iterations += iterations;
+        elapsed = now_ns() - start;
+    } while (elapsed < 10'000'000);
+    return (double)elapsed / total_iterations;
+}
+
+int main(int argc, char** argv)
+{
+    int bytes_per_round = 64 * MiB;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(bytes_per_round, "Number of bytes to process between timer checks", "bytes", 'b', "count");
+    args_parser.parse(argc, argv);
+
+    Vector<Implementation> implementations;
+    implementations.append(IMPLEMENTATION(Plain));
+#if ARCH(I386) || ARCH(X86_64)
+    if (__builtin_cpu_supports("sse2"))
+        implementations.append(IMPLEMENTATION(SSE2));
+    if (__builtin_cpu_supports("avx2"))
+        implementations.append(IMPLEMENTATION(AVX2));
+#endif
+
+    struct Operation {
+        const char* name;
+        Function<void(const Implementation&, Buffers&)> run;
+    };
+    Operation operations[] = {
+        { "memcpy", [](auto& implementation, auto& buffers) { implementation.memcpy(buffers); } },
+        { "memset", [](auto& implementation, auto& buffers) { implementation.memset(buffers); } },
+        { "memchr", [](auto& implementation, auto& buffers) { implementation.memchr(buffers); } },
+        { "strlen", [](auto& implementation, auto& buffers) { implementation.strlen(buffers); } },
+        { "strchr", [](auto& implementation, auto& buffers) { implementation.strchr(buffers); } },
+        { "memcmp", [](auto& implementation, auto& buffers) { implementation.memcmp(buffers); } },
+        { "memmem", [](auto& implementation, auto& buffers) { implementation.memmem(buffers); } },
+    };
+
+    printf("%-8s %9s", "function", "size");
+    for (auto& implementation : implementations)
+        printf(" %14s", implementation.name);
+    printf("  (ns per call, GiB/s)\n");
+
+    for (auto& operation : operations) {
+        for (size_t size : { 8u, 64u, 512u, 4 * KiB, 32 * KiB, 256 * KiB, 1 * MiB }) {
+            Buffers buffers;
+            buffers.size = size;
+            buffers.source.resize(size + 1);
+            buffers.destination.resize(size + 1);
+            ::memset(buffers.source.data(), 'a', size);
+            ::memset(buffers.destination.data(), 'a', size);
+            buffers.source[size - 1] = 'b';
+            buffers.source[size] = 0;
+
+            printf("%-8s %9zu", operation.name, size);
+            for (auto& implementation : implementations) {
+                auto ns = measure_ns_per_call(size, bytes_per_round, [&] {
+                    operation.run(implementation, buffers);
+                    asm volatile(""
+                                 :
+                                 :
+                                 : "memory");
+                });
+                printf(" %7.1f %6.2f", ns, size / ns / 1.073741824);
+            }
+            printf("\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <LibCore/ArgsParser.h>
+#include <LibJS/Interpreter.h>
+#include <LibJS/Lexer.h>
+#include <LibJS/Parser.h>
+#include <LibJS/Runtime/GlobalObject.h>
+#include <LibJS/Runtime/VM.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <time.h>
+
+// Runs a handful of array-heavy scripts the same way test-js runs its test files, and reports
+// how long each one takes and how much memory the arrays it leaves behind occupy. The size of
+// a JS::Value dominates the latter, since array elements are stored as plain Vector<Value>s.
+
+struct Script {
+    const char* name;
+    const char* source;
+};
+
+static const Script s_scripts[] = {
+    { "fill-and-sum",
+        "var a = [];"
+        "for (let i = 0; i < 200000; ++i) a.push(i * 0.5);"
+        "let sum = 0;"
+        "for (let i = 0; i < a.length; ++i) sum += a[i];" },
+    { "int32-arithmetic",
+        "var a = new Array(100000);"
+        "for (let i = 0; i < a.length; ++i) a[i] = i | 0;"
+        "for (let round = 0; round < 4; ++round)"
+        "    for (let i = 1; i < a.length; ++i) a[i] = (a[i - 1] + a[i]) & 0xffff;" },
+    { "mixed-elements",
+        "var a = [];"
+        "for (let i = 0; i < 100000; ++i) a.push(i % 3 === 0 ? i : i % 3 === 1 ? true : undefined);"
+        "let count = 0;"
+        "for (let i = 0; i < a.length; ++i) if (a[i] === true) ++count;" },
+    { "nested-arrays",
+        "var a = [];"
+        "for (let i = 0; i < 2000; ++i) {"
+        "    const row = [];"
+        "    for (let j = 0; j < 50; ++j) row.push(i + j);"
+        "    a.push(row);"
+        "}"
+        "let sum = 0;"
+        "for (let i = 0; i < a.length; ++i) for (let j = 0; j < a[i].length; ++j) sum += a[i][j];" },
+    { "map-filter-reduce",
+        "var a = [];"
+        "for (let i = 0; i < 50000; ++i) a.push(i);"
+        "a = a.map(x => x * 2).filter(x => x % 3 === 0);"
+        "a.reduce((acc, x) => acc + x, 0);" },
+};
+
+static u64 now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+static size_t heap_in_use()
+{
+    return mallinfo2().uordblks;
+}
+
+int main(int argc, char** argv)
+{
+    bool run_bytecode = false;
+    int runs = 5;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(run_bytecode, "Run using the bytecode interpreter", "bytecode", 'b');
+    args_parser.add_option(runs, "Number of times to run each script", "runs", 'n', "count");
+    args_parser.parse(argc, argv);
+
+    auto vm = JS::VM::create();
+    vm->set_bytecode_enabled(run_bytecode);
+
+    printf("sizeof(JS::Value): %zu bytes\n", sizeof(JS::Value));
+
+    for (auto& script : s_scripts) {
+        auto program = JS::Parser(JS::Lexer(script.source)).parse_program();
+
+        u64 best_ns = NumericLimits<u64>::max();
+        size_t retained_bytes = 0;
+        for (int run = 0; run < runs; ++run) {
+            auto interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
+            JS::VM::InterpreterExecutionScope scope(*interpreter);
+
+            // Collect whatever is left of the previous run first, so it doesn't get in the way.
+            interpreter->heap().collect_garbage();
+            auto heap_before = heap_in_use();
+            auto start = now_ns();
+            interpreter->run(interpreter->global_object(), *program);
+            best_ns = min(best_ns, now_ns() - start);
+            if (vm->exception()) {
+                fprintf(stderr, "%s: uncaught exception\n", script.name);
+                return 1;
+            }
+
+            // Everything but the global `a` is garbage by now.
+            interpreter->heap().collect_garbage();
+            auto heap_after = heap_in_use();
+            retained_bytes = heap_after > heap_before ? heap_after - heap_before : 0;
+        }
+
+        printf("%-20s %8.2f ms %10zu KiB retained\n", script.name, best_ns / 1e6, retained_bytes / KiB);
+    }
+
+    return 0;
+}
@@ -2124,32 +2124,34 @@ ReadWriteRedirection::~ReadWriteRedirection()
 void Sequence::dump(int level) const
 {
     Node::dump(level);
-    m_left->dump(level + 1);
-    m_right->dump(level + 1);
+    for (auto& entry : m_entries)
+        entry.dump(level + 1);
 }
 
 RefPtr<Value> Sequence::run(RefPtr<Shell> shell)
 {
-    auto left = m_left->to_lazy_evaluated_commands(shell);
-    // This could happen if a comment is next to a command.
-    if (left.size() == 1) {
-        auto& command = left.first();
-        if (command.argv.is_empty() && command.redirections.is_empty() && command.next_chain.is_empty())
-            return m_right->run(shell);
+    Vector<Command> all_commands;
+    for (auto& entry : m_entries) {
+        if (!all_commands.is_empty()) {
+            auto& last_command = all_commands.last();
+            // This could happen if a comment is next to a command.
+            if (last_command.argv.is_empty() && last_command.redirections.is_empty() && last_command.next_chain.is_empty()) {
+                all_commands.take_last();
+            } else if (last_command.should_wait) {
+                last_command.next_chain.append(NodeWithAction { entry, NodeWithAction::Sequence });
+                continue;
+            }
+        }
+        all_commands.append(entry.to_lazy_evaluated_commands(shell));
     }
 
-    if (left.last().should_wait)
-        left.last().next_chain.append(NodeWithAction { *m_right, NodeWithAction::Sequence });
-    else
-        left.append(m_right->to_lazy_evaluated_commands(shell));
-
-    return create<CommandSequenceValue>(move(left));
+    return create<CommandSequenceValue>(move(all_commands));
 }
 
 void Sequence::highlight_in_editor(Line::Editor& editor, Shell& shell, HighlightMetadata metadata)
 {
-    m_left->highlight_in_editor(editor, shell, metadata);
-    m_right->highlight_in_editor(editor, shell, metadata);
+    for (auto& entry : m_entries)
+        entry.highlight_in_editor(editor, shell, metadata);
 }
 
 HitTestResult Sequence::hit_test_position(size_t offset)
@@ -2157,29 +2159,31 @@ HitTestResult Sequence::hit_test_position(size_t offset)
     if (!position().contains(offset))
         return {};
 
-    auto result = m_left->hit_test_position(offset);
-    if (result.matching_node) {
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        auto result = m_entries[i].hit_test_position(offset);
+        if (!result.matching_node)
+            continue;
         if (!result.closest_command_node)
-            result.closest_command_node = m_right;
+            result.closest_command_node = m_entries[min(i + 1, m_entries.size() - 1)];
         return result;
     }
 
-    result = m_right->hit_test_position(offset);
-    if (!result.closest_command_node)
-        result.closest_command_node = m_right;
-    return result;
+    return {};
 }
 
-Sequence::Sequence(Position position, NonnullRefPtr<Node> left, NonnullRefPtr<Node> right, Position separator_position)
+Sequence::Sequence(Position position, NonnullRefPtrVector<Node> entries, Vector<Position> separator_positions)
     : Node(move(position))
-    , m_left(move(left))
-    , m_right(move(right))
-    , m_separator_position(separator_position)
+    , m_entries(move(entries))
+    , m_separator_positions(move(separator_positions))
 {
-    if (m_left->is_syntax_error())
-        set_is_syntax_error(m_left->syntax_error_node());
-    else if (m_right->is_syntax_error())
-        set_is_syntax_error(m_right->syntax_error_node());
+    ASSERT(m_entries.size() >= 2);
+    ASSERT(m_separator_positions.size() == m_entries.size() - 1);
+    for (auto& entry : m_entries) {
+        if (entry.is_syntax_error()) {
+            set_is_syntax_error(entry.syntax_error_node());
+            break;
+        }
+    }
 }
 
 Sequence::~Sequence()
@@ -29,6 +29,7 @@
 #include "Forward.h"
 #include "Job.h"
 #include "NodeVisitor.h"
+#include <AK/Arena.h>
 #include <AK/Format.h>
 #include <AK/InlineLinkedList.h>
 #include <AK/NonnullRefPtr.h>
@@ -400,7 +401,10 @@ private:
     String m_username;
 };
 
-class Node : public RefCounted<Node> {
+// Nodes made by the Parser are allocated from its Arenas, see Parser::parse_function_decl().
+class Node
+    : public RefCounted<Node>
+    , public ArenaAllocated {
 public:
     virtual void dump(int level) const = 0;
     virtual void for_each_entry(RefPtr<Shell> shell, Function<IterationDecision(NonnullRefPtr<Value>)> callback);
@@ -1078,14 +1082,14 @@ private:
 
 class Sequence final : public Node {
 public:
-    Sequence(Position, NonnullRefPtr<Node>, NonnullRefPtr<Node>, Position separator_position);
+    Sequence(Position, NonnullRefPtrVector<Node> entries, Vector<Position> separator_positions);
     virtual ~Sequence();
     virtual void visit(NodeVisitor& visitor) override { visitor.visit(this); }
 
-    const NonnullRefPtr<Node>& left() const { return m_left; }
-    const NonnullRefPtr<Node>& right() const { return m_right; }
+    const NonnullRefPtrVector<Node>& entries() const { return m_entries; }
 
-    const Position& separator_position() const { return m_separator_position; }
+    // The separator between entries()[i] and entries()[i + 1] is separator_positions()[i].
+    const Vector<Position>& separator_positions() const { return m_separator_positions; }
 
 private:
     NODE(Sequence);
@@ -1095,9 +1099,8 @@ private:
     virtual HitTestResult hit_test_position(size_t) override;
     virtual bool is_list() const override { return true; }
 
-    NonnullRefPtr<Node> m_left;
-    NonnullRefPtr<Node> m_right;
-    Position m_separator_position;
+    NonnullRefPtrVector<Node> m_entries;
+    Vector<Position> m_separator_positions;
 };
 
 class Subshell final : public Node {
@@ -137,6 +137,7 @@ static inline char to_byte(char a, char b)
 
 RefPtr<AST::Node> Parser::parse()
 {
+    Arena::Scope arena_scope(m_node_arena);
     m_offset = 0;
     m_line = { 0, 0 };
 
@@ -172,80 +173,100 @@ RefPtr<AST::Node> Parser::parse_sequence()
     consume_while(is_any_of(" \t\n;")); // ignore whitespaces or terminators without effect.
 
     auto rule_start = push_start();
-    auto var_decls = parse_variable_decls();
 
-    auto pos_before_seps = save_offset();
+    // Statements are collected into a single Sequence rather than nesting one per statement,
+    // so that long scripts don't need a deep stack to be parsed, run or destroyed.
+    NonnullRefPtrVector<AST::Node> entries;
+    Vector<AST::Position> separator_positions;
+    AST::Position pending_separator_position;
 
-    switch (peek()) {
-    case '}':
-        return var_decls;
-    case ';':
-    case '\n': {
-        if (!var_decls)
+    auto append_entry = [&](NonnullRefPtr<AST::Node> node) {
+        if (!entries.is_empty())
+            separator_positions.append(pending_separator_position);
+        entries.append(move(node));
+    };
+
+    // Parses one statement and its separator, and returns whether there may be more to come.
+    auto parse_entry = [&] {
+        auto statement_start = push_start();
+        auto var_decls = parse_variable_decls();
+
+        auto pos_before_seps = save_offset();
+
+        switch (peek()) {
+        case '}':
+            if (var_decls)
+                append_entry(var_decls.release_nonnull());
+            return false;
+        case ';':
+        case '\n': {
+            if (!var_decls)
+                break;
+
+            consume_while(is_any_of("\n;"));
+
+            auto pos_after_seps = save_offset();
+
+            append_entry(var_decls.release_nonnull());
+            pending_separator_position = { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_after_seps.line };
+            return true;
+        }
+        default:
             break;
+        }
 
-        consume_while(is_any_of("\n;"));
+        auto first = parse_function_decl();
 
-        auto pos_after_seps = save_offset();
+        if (!first)
+            first = parse_or_logical_sequence();
 
-        auto rest = parse_sequence();
-        if (rest)
-            return create<AST::Sequence>(
-                var_decls.release_nonnull(),
-                rest.release_nonnull(),
-                AST::Position { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_after_seps.line });
-        return var_decls;
-    }
-    default:
-        break;
-    }
+        bool has_var_decls = var_decls;
+        if (has_var_decls)
+            append_entry(var_decls.release_nonnull());
 
-    auto first = parse_function_decl();
+        if (!first)
+            return false;
 
-    if (!first)
-        first = parse_or_logical_sequence();
+        if (has_var_decls)
+            pending_separator_position = { pos_before_seps.offset, pos_before_seps.offset, pos_before_seps.line, pos_before_seps.line };
 
-    if (!first)
-        return var_decls;
+        consume_while(is_whitespace);
 
-    if (var_decls)
-        first = create<AST::Sequence>(
-            var_decls.release_nonnull(),
-            first.release_nonnull(),
-            AST::Position { pos_before_seps.offset, pos_before_seps.offset, pos_before_seps.line, pos_before_seps.line });
+        pos_before_seps = save_offset();
+        switch (peek()) {
+        case ';':
+        case '\n': {
+            consume_while(is_any_of("\n;"));
+            auto pos_after_seps = save_offset();
 
-    consume_while(is_whitespace);
+            append_entry(first.release_nonnull());
+            pending_separator_position = { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_after_seps.line }; // Sequence
+            return true;
+        }
+        case '&': {
+            consume();
+            auto pos_after_seps = save_offset();
 
-    pos_before_seps = save_offset();
-    switch (peek()) {
-    case ';':
-    case '\n': {
-        consume_while(is_any_of("\n;"));
-        auto pos_after_seps = save_offset();
-
-        if (auto expr = parse_sequence()) {
-            return create<AST::Sequence>(
-                first.release_nonnull(),
-                expr.release_nonnull(),
-                AST::Position { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_after_seps.line }); // Sequence
+            append_entry(create<AST::Background>(first.release_nonnull())); // Execute Background
+            pending_separator_position = { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_before_seps.line }; // Sequence Background Sequence
+            return true;
         }
-        return first;
-    }
-    case '&': {
-        consume();
-        auto pos_after_seps = save_offset();
-        auto bg = create<AST::Background>(first.release_nonnull()); // Execute Background
-        if (auto rest = parse_sequence())
-            return create<AST::Sequence>(
-                move(bg),
-                rest.release_nonnull(),
-                AST::Position { pos_before_seps.offset, pos_after_seps.offset, pos_before_seps.line, pos_before_seps.line }); // Sequence Background Sequence
+        default:
+            append_entry(first.release_nonnull());
+            return false;
+        }
+    };
 
-        return bg;
-    }
-    default:
-        return first;
-    }
+    while (parse_entry())
+        consume_while(is_any_of(" \t\n;"));
+
+    if (entries.is_empty())
+        return nullptr;
+
+    if (entries.size() == 1)
+        return entries.take_last();
+
+    return create<AST::Sequence>(move(entries), move(separator_positions));
 }
 
 RefPtr<AST::Node> Parser::parse_variable_decls()
@@ -363,7 +384,15 @@ RefPtr<AST::Node> Parser::parse_function_decl()
     }
 
     TemporaryChange controls { m_continuation_controls_allowed, false };
-    auto body = parse_toplevel();
+    RefPtr<AST::Node> body;
+    {
+        // The shell holds on to function bodies after the rest of the AST is gone, so each one gets
+        // an arena of its own. That way, a body only keeps its own (small) chunks alive, and not
+        // the ones shared with everything else that was parsed along with it.
+        Arena body_arena { function_body_arena_chunk_size };
+        Arena::Scope arena_scope(body_arena);
+        body = parse_toplevel();
+    }
 
     {
         RefPtr<AST::SyntaxError> syntax_error;
@@ -27,6 +27,7 @@
 #pragma once
 
 #include "AST.h"
+#include <AK/Arena.h>
 #include <AK/Function.h>
 #include <AK/RefPtr.h>
 #include <AK/String.h>
@@ -52,6 +53,7 @@ public:
 
 private:
     constexpr static size_t max_allowed_nested_rule_depth = 2048;
+    constexpr static size_t function_body_arena_chunk_size = 1 * KiB;
     RefPtr<AST::Node> parse_toplevel();
     RefPtr<AST::Node> parse_sequence();
     RefPtr<AST::Node> parse_function_decl();
@@ -142,6 +144,8 @@ private:
 
     bool m_is_in_brace_expansion_spec { false };
     bool m_continuation_controls_allowed { false };
+
+    Arena m_node_arena;
 };
 
 #if 0
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2020, the SerenityOS developers.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright notice, this
+ *    list of conditions and the following disclaimer.
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright notice,
+ *    this list of conditions and the following disclaimer in the documentation
+ *    and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/ProcessStatisticsReader.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+// Measures the rate at which the kernel TimerQueue can add, cancel and fire
+// timers. A number of "idle" threads are parked in long sleeps first, so that
+// the queue is populated like it would be on a busy system. Each clock has a
+// queue of its own, so they sleep on the realtime clock, like alarm() does.
+
+static Atomic<bool> s_stop { false };
+static Atomic<u64> s_fired { 0 };
+static Atomic<u64> s_oversleep_ns { 0 };
+
+static u64 to_ns(const timespec& ts)
+{
+    return (u64)ts.tv_sec * 1'000'000'000ull + ts.tv_nsec;
+}
+
+// Threads of ours that are blocked in a sleep, and so have a timer queued.
+static int count_sleeping_threads()
+{
+    auto all_processes = Core::ProcessStatisticsReader::get_all();
+    if (!all_processes.has_value())
+        return -1;
+    auto process = all_processes.value().get(getpid());
+    if (!process.has_value())
+        return -1;
+    int count = 0;
+    for (auto& thread : process.value().threads) {
+        if (thread.state == "Sleeping")
+            ++count;
+    }
+    return count;
+}
+
+static void* idle_sleeper(void*)
+{
+    while (!s_stop) {
+        timespec duration = { 3600, 0 };
+        clock_nanosleep(CLOCK_REALTIME, 0, &duration, nullptr);
+    }
+    return nullptr;
+}
+
+static void* short_sleeper(void*)
+{
+    while (!s_stop) {
+        timespec before;
+        timespec after;
+        timespec duration = { 0, 1'000'000 };
+        clock_gettime(CLOCK_MONOTONIC, &before);
+        if (clock_nanosleep(CLOCK_MONOTONIC, 0, &duration, nullptr) != 0)
+            continue;
+        clock_gettime(CLOCK_MONOTONIC, &after);
+        s_fired++;
+        auto slept = to_ns(after) - to_ns(before);
+        if (slept > to_ns(duration))
+            s_oversleep_ns += slept - to_ns(duration);
+    }
+    return nullptr;
+}
+
+static Vector<pthread_t> spawn_threads(int count, void* (*function)(void*))
+{
+    Vector<pthread_t> threads;
+    for (int i = 0; i < count; ++i) {
+        pthread_t thread;
+        if (pthread_create(&thread, nullptr, function, nullptr) != 0) {
+            perror("pthread_create");
+            break;
+        }
+        threads.append(thread);
+    }
+    return threads;
+}
+
+int main(int argc, char** argv)
+{
+    int idle_thread_count = 256;
+    int sleeper_thread_count = 16;
+    int iterations = 100000;
+    int fire_seconds = 5;
+
+    Core::ArgsParser args_parser;
+    args_parser.add_option(idle_thread_count, "Number of threads keeping a long timer queued", "idle-threads", 'i', "count");
+    args_parser.add_option(sleeper_thread_count, "Number of threads repeatedly sleeping for 1ms", "sleepers", 's', "count");
+    args_parser.add_option(iterations, "Number of add/cancel iterations", "iterations", 'n', "count");
+    args_parser.add_option(fire_seconds, "Duration of the fire benchmark", "duration", 'd', "seconds");
+    args_parser.parse(argc, argv);
+
+    auto idle_threads = spawn_threads(idle_thread_count, idle_sleeper);
+    // Give the idle threads a chance to queue their timers.
+    int queued_timers = count_sleeping_threads();
+    for (int i = 0; i < 100 && queued_timers >= 0 && queued_timers < (int)idle_threads.size(); ++i) {
+        usleep(10'000);
+        queued_timers = count_sleeping_threads();
+    }
+    if (queued_timers < 0)
+        fprintf(stderr, "Failed to read the thread states from /proc/all\n");
+    else
+        printf("Queued realtime timers: %d\n", queued_timers);
+
+    // Every call to alarm() cancels the previously queued alarm timer
+    // (if any) and queues a new one, both on the realtime clock's queue.
+    Core::ElapsedTimer timer(true);
+    timer.start();
+    for (int i = 0; i < iterations; ++i) {
+        alarm(1000 + i % 1000);
+        alarm(0);
+    }
+    auto elapsed_ms = max(timer.elapsed(), 1);
+    printf("Add/cancel: %d pairs in %dms (%llu pairs/s)\n", iterations, elapsed_ms, (u64)iterations * 1000 / elapsed_ms);
+
+    auto sleeper_threads = spawn_threads(sleeper_thread_count, short_sleeper);
+    timer.start();
+    sleep(fire_seconds);
+    s_stop = true;
+    elapsed_ms = max(timer.elapsed(), 1);
+    u64 fired = s_fired;
+    printf("Fire: %llu timers in %dms (%llu timers/s), average oversleep %lluus\n",
+        fired, elapsed_ms, fired * 1000 / elapsed_ms, fired ? s_oversleep_ns / fired / 1000 : 0);
+
+    for (auto thread : sleeper_threads)
+        pthread_join(thread, nullptr);
+
+    // The idle threads won't wake up on their own for a long time,
+    // so just let them go down with the process.
+    return 0;
+}
@@ -46,10 +46,10 @@ Print the value of EXPRESSION to standard output.)");
 }
 
 template<typename... Args>
-[[noreturn]] void fail(Args&&... args)
+[[noreturn]] void fail(const CheckedFormatString<typename IdentityType<Args>::Type...>& fmtstr, const Args&... args)
 {
     warn("ERROR: \e[31m");
-    warnln(args...);
+    warnln(fmtstr, args...);
     warn("\e[0m");
     exit(1);
 }
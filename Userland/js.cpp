@@ -36,6 +36,7 @@
 #include <LibJS/Console.h>
 #include <LibJS/Interpreter.h>
 #include <LibJS/Parser.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/ArrayBuffer.h>
 #include <LibJS/Runtime/BooleanObject.h>
@@ -47,6 +48,7 @@
 #include <LibJS/Runtime/NumberObject.h>
 #include <LibJS/Runtime/Object.h>
 #include <LibJS/Runtime/PrimitiveString.h>
+#include <LibJS/Runtime/PropertyCache.h>
 #include <LibJS/Runtime/ProxyObject.h>
 #include <LibJS/Runtime/RegExpObject.h>
 #include <LibJS/Runtime/ScriptFunction.h>
@@ -78,6 +80,8 @@ private:
 
 static bool s_dump_ast = false;
 static bool s_print_last_result = false;
+static bool s_print_property_cache_statistics = false;
+static OwnPtr<JS::ProgramCache> s_program_cache;
 static RefPtr<Line::Editor> s_editor;
 static String s_history_path = String::formatted("{}/.js-history", Core::StandardPaths::home_directory());
 static int s_repl_line_level = 0;
@@ -448,20 +452,33 @@ static bool write_to_file(const StringView& path)
     return true;
 }
 
-static bool parse_and_run(JS::Interpreter& interpreter, const StringView& source)
+// Only scripts loaded from files go through the program cache, there's no point in keeping REPL input around.
+static bool parse_and_run(JS::Interpreter& interpreter, const String& source, bool use_program_cache = false)
 {
-    auto parser = JS::Parser(JS::Lexer(source));
-    auto program = parser.parse_program();
+    auto* program_cache = use_program_cache ? s_program_cache.ptr() : nullptr;
+    RefPtr<JS::Program> program;
+    if (program_cache)
+        program = program_cache->load(source);
+
+    Optional<JS::Parser::Error> error;
+    if (!program) {
+        auto parser = JS::Parser(JS::Lexer(source));
+        parser.enable_lazy_function_bodies(source);
+        program = parser.parse_program();
+        if (parser.has_errors())
+            error = parser.errors()[0];
+        else if (program_cache)
+            program_cache->store(source, *program);
+    }
 
     if (s_dump_ast)
         program->dump(0);
 
-    if (parser.has_errors()) {
-        auto error = parser.errors()[0];
-        auto hint = error.source_location_hint(source);
+    if (error.has_value()) {
+        auto hint = error->source_location_hint(source);
         if (!hint.is_empty())
             outln("{}", hint);
-        vm->throw_exception<JS::SyntaxError>(interpreter.global_object(), error.to_string());
+        vm->throw_exception<JS::SyntaxError>(interpreter.global_object(), error->to_string());
     } else {
         interpreter.run(interpreter.global_object(), *program);
     }
@@ -569,7 +586,7 @@ JS_DEFINE_NATIVE_FUNCTION(ReplObject::load_file)
         } else {
             source = file_contents;
         }
-        parse_and_run(vm.interpreter(), source);
+        parse_and_run(vm.interpreter(), source, true);
     }
     return JS::Value(true);
 }
@@ -658,24 +675,50 @@ public:
     }
 };
 
+static void print_property_cache_statistics()
+{
+    auto print = [](const char* kind, size_t hits, size_t misses) {
+        auto total = hits + misses;
+        outln("Property {} cache: {} hits, {} misses ({}% hit rate)", kind, hits, misses, total ? hits * 100 / total : 0);
+    };
+    auto& statistics = JS::PropertyCache::statistics();
+    print("get", statistics.get_hits, statistics.get_misses);
+    print("put", statistics.put_hits, statistics.put_misses);
+}
+
 int main(int argc, char** argv)
 {
     bool gc_on_every_allocation = false;
     bool disable_syntax_highlight = false;
+    bool run_bytecode = false;
+    bool dump_bytecode = false;
+    int marking_thread_count = 0;
     const char* script_path = nullptr;
+    const char* program_cache_directory = nullptr;
 
     Core::ArgsParser args_parser;
     args_parser.set_general_help("This is a JavaScript interpreter.");
     args_parser.add_option(s_dump_ast, "Dump the AST", "dump-ast", 'A');
+    args_parser.add_option(run_bytecode, "Run using the bytecode interpreter", "bytecode", 'b');
+    args_parser.add_option(dump_bytecode, "Dump the bytecode", "dump-bytecode", 'd');
     args_parser.add_option(s_print_last_result, "Print last result", "print-last-result", 'l');
     args_parser.add_option(gc_on_every_allocation, "GC on every allocation", "gc-on-every-allocation", 'g');
+    args_parser.add_option(marking_thread_count, "Threads to mark large heaps with (default: one per processor)", "marking-threads", 'm', "count");
+    args_parser.add_option(s_print_property_cache_statistics, "Print property cache statistics on exit", "property-cache-stats", 'c');
     args_parser.add_option(disable_syntax_highlight, "Disable live syntax highlighting", "no-syntax-highlight", 's');
+    args_parser.add_option(program_cache_directory, "Keep parsed scripts in a cache directory", "program-cache", 'p', "path");
     args_parser.add_positional_argument(script_path, "Path to script file", "script", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
     bool syntax_highlight = !disable_syntax_highlight;
 
+    if (program_cache_directory)
+        s_program_cache = make<JS::ProgramCache>(program_cache_directory);
+
     vm = JS::VM::create();
+    vm->heap().set_marking_thread_count(max(marking_thread_count, 0));
+    vm->set_bytecode_enabled(run_bytecode || dump_bytecode);
+    vm->set_should_dump_bytecode(dump_bytecode);
     OwnPtr<JS::Interpreter> interpreter;
 
     interrupt_interpreter = [&] {
@@ -886,6 +929,8 @@ int main(int argc, char** argv)
         s_editor->on_tab_complete = move(complete);
         repl(*interpreter);
         s_editor->save_history(s_history_path);
+        if (s_print_property_cache_statistics)
+            print_property_cache_statistics();
     } else {
         interpreter = JS::Interpreter::create<JS::GlobalObject>(*vm);
         ReplConsoleClient console_client(interpreter->global_object().console());
@@ -910,7 +955,10 @@ int main(int argc, char** argv)
             source = file_contents;
         }
 
-        if (!parse_and_run(*interpreter, source))
+        bool success = parse_and_run(*interpreter, source, true);
+        if (s_print_property_cache_statistics)
+            print_property_cache_statistics();
+        if (!success)
             return 1;
     }
 
@@ -24,11 +24,148 @@
  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
+#include <AK/ByteBuffer.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/Queue.h>
+#include <Kernel/API/ProfileSampleRecord.h>
 #include <LibCore/ArgsParser.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/File.h>
+#include <errno.h>
 #include <serenity.h>
+#include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static volatile bool s_should_stop;
+
+static bool write_profile(const String& path, JsonArray&& events)
+{
+    JsonObject object;
+    object.set("pid", -1);
+    object.set("executable", "");
+    object.set("events", move(events));
+
+    auto file = Core::File::construct(path);
+    if (!file->open(Core::IODevice::WriteOnly)) {
+        fprintf(stderr, "Failed to open %s: %s\n", path.characters(), file->error_string());
+        return false;
+    }
+    auto json = object.to_string();
+    if (!file->write(json)) {
+        fprintf(stderr, "Failed to write %s: %s\n", path.characters(), file->error_string());
+        return false;
+    }
+    return true;
+}
+
+// Samples the whole system, and writes a new profile into the output directory every
+// few seconds, only keeping the most recent ones around.
+static int stream_profiles(const String& output_directory, int seconds_per_profile, int profiles_to_keep)
+{
+    auto device = Core::File::construct("/dev/profile");
+    if (!device->open(Core::IODevice::ReadOnly)) {
+        fprintf(stderr, "Failed to open /dev/profile: %s\n", device->error_string());
+        return 1;
+    }
+
+    if (mkdir(output_directory.characters(), 0700) < 0 && errno != EEXIST) {
+        perror("mkdir");
+        return 1;
+    }
+
+    if (profiling_enable(-1) < 0) {
+        perror("profiling_enable");
+        return 1;
+    }
+
+    signal(SIGINT, [](int) { s_should_stop = true; });
+    signal(SIGTERM, [](int) { s_should_stop = true; });
+
+    auto buffer = ByteBuffer::create_uninitialized(64 * KiB);
+    JsonArray events;
+    size_t lost_count = 0;
+    Queue<String> written_profiles;
+    int profile_index = 0;
+    Core::ElapsedTimer timer;
+    timer.start();
+
+    auto rotate = [&] {
+        auto path = String::formatted("{}/profile-{}.json", output_directory, profile_index++);
+        auto event_count = events.size();
+        if (!write_profile(path, move(events)))
+            return false;
+        printf("%s: %zu samples", path.characters(), event_count);
+        if (lost_count)
+            printf(", %zu lost", lost_count);
+        putchar('\n');
+        events = {};
+        lost_count = 0;
+
+        written_profiles.enqueue(path);
+        while (written_profiles.size() > (size_t)profiles_to_keep)
+            unlink(written_profiles.dequeue().characters());
+        return true;
+    };
+
+    int exit_code = 0;
+    while (!s_should_stop) {
+        auto nread = read(device->fd(), buffer.data(), buffer.size());
+        if (nread < 0) {
+            if (errno == EINTR)
+                continue;
+            perror("read");
+            exit_code = 1;
+            break;
+        }
+
+        size_t offset = 0;
+        while (offset + sizeof(ProfileSampleRecord) <= (size_t)nread) {
+            ProfileSampleRecord record;
+            memcpy(&record, buffer.data() + offset, sizeof(record));
+            offset += sizeof(record);
+            lost_count += record.lost_count;
+
+            JsonObject event;
+            event.set("type", "sample");
+            event.set("pid", record.pid);
+            event.set("tid", record.tid);
+            event.set("cpu", record.cpu);
+            event.set("timestamp", record.timestamp);
+            JsonArray stack;
+            for (u32 i = 0; i < record.frame_count; ++i) {
+                u32 address;
+                memcpy(&address, buffer.data() + offset, sizeof(address));
+                offset += sizeof(address);
+                stack.append(address);
+            }
+            event.set("stack", move(stack));
+            events.append(move(event));
+        }
+
+        if (timer.elapsed() >= seconds_per_profile * 1000) {
+            if (!rotate()) {
+                exit_code = 1;
+                break;
+            }
+            timer.start();
+        }
+
+        // The device never blocks, so don't spin on it when there's nothing new.
+        if (nread == 0)
+            usleep(100'000);
+    }
+
+    if (profiling_disable(-1) < 0)
+        perror("profiling_disable");
+    if (exit_code == 0 && !events.is_empty())
+        rotate();
+    return exit_code;
+}
 
 int main(int argc, char** argv)
 {
@@ -38,15 +175,43 @@ int main(int argc, char** argv)
     const char* cmd_argument = nullptr;
     bool enable = false;
     bool disable = false;
+    bool stream = false;
+    const char* output_directory = "/tmp/profiles";
+    int seconds_per_profile = 10;
+    int profiles_to_keep = 6;
+    int sample_interval = 0;
 
     args_parser.add_option(pid_argument, "Target PID", nullptr, 'p', "PID");
     args_parser.add_option(enable, "Enable", nullptr, 'e');
     args_parser.add_option(disable, "Disable", nullptr, 'd');
     args_parser.add_option(cmd_argument, "Command", nullptr, 'c', "command");
+    args_parser.add_option(stream, "Continuously profile the whole system", "stream", 's');
+    args_parser.add_option(output_directory, "Where to write streamed profiles", "output", 'o', "directory");
+    args_parser.add_option(seconds_per_profile, "How many seconds go into each streamed profile", "rotate", 'r', "seconds");
+    args_parser.add_option(profiles_to_keep, "How many streamed profiles to keep", "keep", 'k', "count");
+    args_parser.add_option(sample_interval, "Take a sample every this many timer ticks", "interval", 'i', "ticks");
 
     args_parser.parse(argc, argv);
 
+    if (sample_interval > 0) {
+        auto file = Core::File::construct("/proc/sys/profiling_sample_interval");
+        if (!file->open(Core::IODevice::WriteOnly) || !file->write(String::number(sample_interval))) {
+            fprintf(stderr, "Failed to set sample interval: %s\n", file->error_string());
+            return 1;
+        }
+    }
+
+    if (stream) {
+        if (seconds_per_profile <= 0 || profiles_to_keep <= 0) {
+            fprintf(stderr, "--rotate and --keep must be positive.\n");
+            return 1;
+        }
+        return stream_profiles(output_directory, seconds_per_profile, profiles_to_keep);
+    }
+
     if (!pid_argument && !cmd_argument) {
+        if (sample_interval > 0)
+            return 0;
         args_parser.print_usage(stdout, argv[0]);
         return 0;
     }
@@ -37,6 +37,7 @@
 #include <LibJS/Interpreter.h>
 #include <LibJS/Lexer.h>
 #include <LibJS/Parser.h>
+#include <LibJS/ProgramCache.h>
 #include <LibJS/Runtime/Array.h>
 #include <LibJS/Runtime/GlobalObject.h>
 #include <LibJS/Runtime/JSONObject.h>
@@ -49,6 +50,7 @@
 RefPtr<JS::VM> vm;
 
 static bool collect_on_every_allocation = false;
+static OwnPtr<JS::ProgramCache> program_cache;
 static String currently_running_test;
 
 enum class TestResult {
@@ -263,7 +265,13 @@ static Result<NonnullRefPtr<JS::Program>, ParserError> parse_file(const String&
     String test_file_string(reinterpret_cast<const char*>(contents.data()), contents.size());
     file->close();
 
+    if (program_cache) {
+        if (auto program = program_cache->load(test_file_string))
+            return Result<NonnullRefPtr<JS::Program>, ParserError>(program.release_nonnull());
+    }
+
     auto parser = JS::Parser(JS::Lexer(test_file_string));
+    parser.enable_lazy_function_bodies(test_file_string);
     auto program = parser.parse_program();
 
     if (parser.has_errors()) {
@@ -271,6 +279,9 @@ static Result<NonnullRefPtr<JS::Program>, ParserError> parse_file(const String&
         return Result<NonnullRefPtr<JS::Program>, ParserError>(ParserError { error, error.source_location_hint(test_file_string) });
     }
 
+    if (program_cache)
+        program_cache->store(test_file_string, program);
+
     return Result<NonnullRefPtr<JS::Program>, ParserError>(program);
 }
 
@@ -706,13 +717,17 @@ int main(int argc, char** argv)
 #endif
 
     bool print_times = false;
+    bool run_bytecode = false;
     bool test262_parser_tests = false;
     const char* specified_test_root = nullptr;
+    const char* program_cache_directory = nullptr;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(print_times, "Show duration of each test", "show-time", 't');
     args_parser.add_option(collect_on_every_allocation, "Collect garbage after every allocation", "collect-often", 'g');
+    args_parser.add_option(run_bytecode, "Run using the bytecode interpreter", "bytecode", 'b');
     args_parser.add_option(test262_parser_tests, "Run test262 parser tests", "test262-parser-tests", 0);
+    args_parser.add_option(program_cache_directory, "Keep parsed test files in a cache directory", "program-cache", 'p', "path");
     args_parser.add_positional_argument(specified_test_root, "Tests root directory", "path", Core::ArgsParser::Required::No);
     args_parser.parse(argc, argv);
 
@@ -752,7 +767,11 @@ int main(int argc, char** argv)
         return 1;
     }
 
+    if (program_cache_directory)
+        program_cache = make<JS::ProgramCache>(program_cache_directory);
+
     vm = JS::VM::create();
+    vm->set_bytecode_enabled(run_bytecode);
 
     if (test262_parser_tests)
         Test262ParserTestRunner(test_root, print_times).run();